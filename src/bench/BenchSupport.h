@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// 基準輔助：每個量測執行多輪取最快一輪；--quick 時縮小規模只跑一輪（ctest 用來確認基準仍可執行）
+namespace bench {
+
+inline bool IsQuick(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 執行 body rounds 輪，回傳最快一輪的微秒數
+template <typename Body>
+double MeasureMicroseconds(int rounds, Body&& body) {
+    double best = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (round == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+// 讓結果看起來被使用，避免編譯器把量測的計算最佳化掉
+inline void Consume(size_t value) {
+    static volatile size_t sink = 0;
+    sink = sink + value;
+}
+
+inline void Report(const char* name, double microseconds, const char* note = "") {
+    std::printf("%-48s %12.1f us  %s\n", name, microseconds, note);
+}
+
+} // namespace bench
@@ -0,0 +1,84 @@
+// config.json 載入基準：合成 10 / 1k / 100k 個圖示的設定檔，量測
+// JsonReader 單純掃描 token、FenceLayoutJson::Parse / Write，以及舊版 find / stoi 解析
+#include "BenchSupport.h"
+#include "LegacyConfigParser.h"
+#include "SyntheticLayout.h"
+#include "core/JsonReader.h"
+#include "widgets/FenceLayout.h"
+#include <cstdio>
+#include <string>
+
+namespace {
+
+size_t CountIcons(const FenceLayout& layout) {
+    size_t count = 0;
+    for (const auto& fence : layout.fences) {
+        count += fence.icons.size();
+    }
+    return count;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = bench::IsQuick(argc, argv);
+    const size_t sizes[] = { 10, 1000, 100000 };
+
+    for (size_t iconCount : sizes) {
+        if (quick && iconCount > 1000) {
+            break;
+        }
+
+        FenceLayout source = bench::MakeSyntheticLayout(iconCount);
+        std::string json = FenceLayoutJson::Write(source);
+        int rounds = quick ? 1 : (iconCount >= 100000 ? 5 : 50);
+
+        std::printf("\n%zu icons, %zu fences, %zu bytes\n", iconCount, source.fences.size(), json.size());
+
+        double scan = bench::MeasureMicroseconds(rounds, [&]() {
+            JsonReader reader(json.data(), json.size());
+            size_t tokens = 0;
+            while (reader.Next() != JsonReader::Token::End) {
+                if (reader.GetToken() == JsonReader::Token::Error) {
+                    std::fprintf(stderr, "JsonReader error at %zu\n", reader.GetOffset());
+                    break;
+                }
+                ++tokens;
+            }
+            bench::Consume(tokens);
+        });
+        bench::Report("JsonReader token scan", scan);
+
+        FenceLayout parsed;
+        double parse = bench::MeasureMicroseconds(rounds, [&]() {
+            FenceLayout layout;
+            FenceLayoutJson::Parse(json.data(), json.size(), layout);
+            bench::Consume(layout.fences.size());
+            parsed = std::move(layout);
+        });
+        bench::Report("FenceLayoutJson::Parse", parse);
+
+        double write = bench::MeasureMicroseconds(rounds, [&]() {
+            bench::Consume(FenceLayoutJson::Write(source, json.size()).size());
+        });
+        bench::Report("FenceLayoutJson::Write", write);
+
+        FenceLayout legacy;
+        double legacyParse = bench::MeasureMicroseconds(rounds, [&]() {
+            FenceLayout layout;
+            bench::ParseLegacyConfig(json, layout);
+            bench::Consume(layout.fences.size());
+            legacy = std::move(layout);
+        });
+        char note[64];
+        std::snprintf(note, sizeof(note), "(%.1fx Parse)", legacyParse / (parse > 0.0 ? parse : 1.0));
+        bench::Report("legacy find/stoi parse", legacyParse, note);
+
+        if (CountIcons(parsed) != iconCount || CountIcons(legacy) != iconCount) {
+            std::fprintf(stderr, "icon count mismatch: parsed %zu, legacy %zu, expected %zu\n",
+                         CountIcons(parsed), CountIcons(legacy), iconCount);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,238 @@
+// 柵欄圖示集合基準：10k 個圖示的排列、繪製裁切、點擊測試與選取走訪
+// FenceIconList（位置、旗標各自緊密排列）對照舊的結構陣列（每個圖示的熱欄位與路徑、名稱、圖示控制代碼交錯存放）
+#include "BenchSupport.h"
+#include "widgets/FenceIconGrid.h"
+#include "widgets/FenceIconList.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int32_t ICON_SIZE = 48;
+const int32_t ICON_SPACING = 10;
+const int32_t FENCE_WIDTH = 1200;
+const int32_t TITLE_BAR_HEIGHT = 32;
+const int32_t VIEW_HEIGHT = 800;
+
+// 冷資料（與 DesktopIcon 相同的欄位，控制代碼以指標代替）
+struct ColdIcon {
+    std::wstring filePath;
+    std::wstring displayName;
+    bool materialized;
+    void* handles[6];
+    std::wstring iconKey;
+    int cachedIconSize;
+    FenceIconPoint originalDesktopPos;
+    int originalDesktopIndex;
+};
+
+// 舊的結構：熱欄位（位置、選取）夾在冷資料之間
+struct LegacyIcon {
+    std::wstring filePath;
+    std::wstring displayName;
+    FenceIconPoint position;
+    bool materialized;
+    bool selected;
+    void* handles[6];
+    std::wstring iconKey;
+    int cachedIconSize;
+    FenceIconPoint originalDesktopPos;
+    int originalDesktopIndex;
+};
+
+ColdIcon MakeCold(size_t index) {
+    ColdIcon icon{};
+    icon.filePath = L"C:\\Users\\me\\Desktop\\Projects\\item" + std::to_wstring(index) + L".lnk";
+    icon.displayName = L"item" + std::to_wstring(index) + L" shortcut";
+    icon.iconKey = L"c:\\program files\\app" + std::to_wstring(index % 97) + L"\\app.exe,0";
+    icon.originalDesktopIndex = (int)index;
+    return icon;
+}
+
+// 與 FenceIconGrid::Arrange 相同的排列，寫入結構陣列
+int32_t LegacyArrange(std::vector<LegacyIcon>& icons, int32_t left, int32_t top, int32_t availableWidth) {
+    const int32_t cellWidth = FenceIconGrid::GetCellWidth(ICON_SIZE, ICON_SPACING);
+    const int32_t cellHeight = FenceIconGrid::GetCellHeight(ICON_SIZE, ICON_SPACING);
+    const int32_t iconsPerRow = (std::max)(1, availableWidth / cellWidth);
+    const int32_t offsetX = left + (cellWidth - ICON_SIZE) / 2;
+
+    int32_t column = 0;
+    int32_t y = top;
+    for (LegacyIcon& icon : icons) {
+        icon.position.x = offsetX + column * cellWidth;
+        icon.position.y = y;
+        if (++column >= iconsPerRow) {
+            column = 0;
+            y += cellHeight;
+        }
+    }
+    return iconsPerRow;
+}
+
+// 與 FenceIconGrid::HitTest 相同的範圍
+int LegacyHitTest(const std::vector<LegacyIcon>& icons, int32_t scrollOffset, int32_t x, int32_t y) {
+    const int32_t contentY = y + scrollOffset;
+    for (size_t i = 0; i < icons.size(); ++i) {
+        const FenceIconPoint& position = icons[i].position;
+        if (x >= position.x - 5 && x <= position.x + ICON_SIZE + 15 &&
+            contentY >= position.y - 5 && contentY <= position.y + ICON_SIZE + FenceIconGrid::LABEL_HEIGHT) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// PaintFence 的裁切：畫面內的圖示數
+bool IsOnScreen(const FenceIconPoint& position, int32_t scrollOffset) {
+    int32_t adjustedY = position.y - scrollOffset;
+    return adjustedY + ICON_SIZE + FenceIconGrid::LABEL_HEIGHT >= TITLE_BAR_HEIGHT && adjustedY < VIEW_HEIGHT;
+}
+
+void Report(const char* name, double legacy, double packed) {
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s (array of structs)", name);
+    bench::Report(label, legacy);
+    char note[64];
+    std::snprintf(note, sizeof(note), "(%.1fx)", legacy / (packed > 0.0 ? packed : 1.0));
+    std::snprintf(label, sizeof(label), "%s (FenceIconList)", name);
+    bench::Report(label, packed, note);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = bench::IsQuick(argc, argv);
+    const size_t count = quick ? 1000 : 10000;
+    const int rounds = quick ? 1 : 10;
+    const int repeat = quick ? 1 : 20;
+    std::printf("%zu icons, %d passes per round\n", count, repeat);
+
+    std::vector<LegacyIcon> legacy;
+    FenceIconList<ColdIcon> packed;
+    legacy.reserve(count);
+    packed.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        ColdIcon cold = MakeCold(i);
+        LegacyIcon icon{};
+        icon.filePath = cold.filePath;
+        icon.displayName = cold.displayName;
+        icon.iconKey = cold.iconKey;
+        icon.originalDesktopIndex = cold.originalDesktopIndex;
+        legacy.push_back(std::move(icon));
+        packed.Add(std::move(cold));
+    }
+    std::printf("sizeof: legacy icon %zu bytes, packed hot data %zu + %zu bytes\n", sizeof(LegacyIcon),
+                sizeof(FenceIconPoint), sizeof(uint8_t));
+
+    // 排列（視窗縮放時每次都要重排整個柵欄）
+    double legacyArrange = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < repeat; ++r) {
+            bench::Consume((size_t)LegacyArrange(legacy, r % 3, TITLE_BAR_HEIGHT, FENCE_WIDTH - r % 3));
+        }
+    });
+    double packedArrange = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < repeat; ++r) {
+            bench::Consume((size_t)FenceIconGrid::Arrange(packed.GetPositions(), packed.size(), ICON_SIZE,
+                                                          ICON_SPACING, r % 3, TITLE_BAR_HEIGHT, FENCE_WIDTH - r % 3));
+        }
+    });
+    for (size_t i = 0; i < count; ++i) {
+        const FenceIconPoint& a = legacy[i].position;
+        const FenceIconPoint& b = packed.GetPosition(i);
+        if (a.x != b.x || a.y != b.y) {
+            std::fprintf(stderr, "layout differs at %zu\n", i);
+            return 1;
+        }
+    }
+    Report("arrange", legacyArrange, packedArrange);
+
+    // 繪製裁切：走訪全部圖示找出畫面內的部分
+    const int32_t cellHeight = FenceIconGrid::GetCellHeight(ICON_SIZE, ICON_SPACING);
+    const int32_t contentHeight = legacy.back().position.y + cellHeight;
+    double legacyCull = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < repeat; ++r) {
+            int32_t scrollOffset = (int32_t)(contentHeight * (size_t)r / repeat);
+            size_t visible = 0;
+            for (const LegacyIcon& icon : legacy) {
+                visible += IsOnScreen(icon.position, scrollOffset) ? 1 : 0;
+            }
+            bench::Consume(visible);
+        }
+    });
+    double packedCull = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < repeat; ++r) {
+            int32_t scrollOffset = (int32_t)(contentHeight * (size_t)r / repeat);
+            const FenceIconPoint* positions = packed.GetPositions();
+            size_t visible = 0;
+            for (size_t i = 0; i < packed.size(); ++i) {
+                visible += IsOnScreen(positions[i], scrollOffset) ? 1 : 0;
+            }
+            bench::Consume(visible);
+        }
+    });
+    Report("paint culling", legacyCull, packedCull);
+
+    // 點擊測試：一半落在圖示上（位置隨機），一半落在空白處（走訪全部）
+    std::mt19937 rng(23);
+    std::vector<FenceIconPoint> clicks(256);
+    for (size_t i = 0; i < clicks.size(); ++i) {
+        if (i % 2 == 0) {
+            FenceIconPoint target = packed.GetPosition(rng() % count);
+            clicks[i] = FenceIconPoint{ target.x + ICON_SIZE / 2, target.y + ICON_SIZE / 2 };
+        } else {
+            clicks[i] = FenceIconPoint{ 2, (int32_t)(rng() % (uint32_t)contentHeight) };
+        }
+    }
+    const int clickRepeat = quick ? 1 : (int)clicks.size();
+    double legacyHit = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < clickRepeat; ++r) {
+            bench::Consume((size_t)LegacyHitTest(legacy, 0, clicks[r].x, clicks[r].y));
+        }
+    });
+    double packedHit = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < clickRepeat; ++r) {
+            bench::Consume((size_t)FenceIconGrid::HitTest(packed.GetPositions(), packed.size(), ICON_SIZE, 0,
+                                                          clicks[r].x, clicks[r].y));
+        }
+    });
+    for (const FenceIconPoint& click : clicks) {
+        if (LegacyHitTest(legacy, 0, click.x, click.y) !=
+            FenceIconGrid::HitTest(packed.GetPositions(), packed.size(), ICON_SIZE, 0, click.x, click.y)) {
+            std::fprintf(stderr, "hit test differs at (%d, %d)\n", click.x, click.y);
+            return 1;
+        }
+    }
+    Report("hit test", legacyHit, packedHit);
+
+    // 選取：全選後計算選取數（拖拉、刪除前的走訪）
+    double legacySelect = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < repeat; ++r) {
+            for (LegacyIcon& icon : legacy) {
+                icon.selected = (r & 1) == 0;
+            }
+            size_t selected = 0;
+            for (const LegacyIcon& icon : legacy) {
+                selected += icon.selected ? 1 : 0;
+            }
+            bench::Consume(selected);
+        }
+    });
+    double packedSelect = bench::MeasureMicroseconds(rounds, [&]() {
+        for (int r = 0; r < repeat; ++r) {
+            for (size_t i = 0; i < packed.size(); ++i) {
+                packed.SetSelected(i, (r & 1) == 0);
+            }
+            size_t selected = 0;
+            for (size_t i = 0; i < packed.size(); ++i) {
+                selected += packed.IsSelected(i) ? 1 : 0;
+            }
+            bench::Consume(selected);
+        }
+    });
+    Report("select all + count", legacySelect, packedSelect);
+    return 0;
+}
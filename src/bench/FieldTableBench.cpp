@@ -0,0 +1,164 @@
+// 欄位表基準：只含柵欄設定（沒有圖示）的設定檔，以欄位表解碼對照舊版 find / stoi，
+// 另外量測鍵名分派（完美雜湊對照逐一比較鍵名）與日誌內容的編碼 / 解碼
+#include "BenchSupport.h"
+#include "LegacyConfigParser.h"
+#include "core/FieldTable.h"
+#include "widgets/FenceLayout.h"
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+FenceLayout MakeSettingsLayout(size_t fenceCount) {
+    FenceLayout layout;
+    for (size_t i = 0; i < fenceCount; ++i) {
+        FenceLayoutFence fence;
+        fence.title = L"柵欄 " + std::to_wstring(i);
+        fence.x = (int32_t)(i % 8) * 320;
+        fence.y = (int32_t)(i / 8) * 240;
+        fence.width = 300;
+        fence.height = 220;
+        fence.expandedHeight = 220;
+        fence.isPinned = (i % 3) == 0;
+        fence.backgroundColor = 0x00F0E0D0 + (uint32_t)i;
+        fence.borderWidth = 1 + (int32_t)(i % 4);
+        fence.iconSpacing = 8;
+        fence.scrollOffset = (int32_t)(i % 50);
+        layout.fences.push_back(fence);
+    }
+    return layout;
+}
+
+// 欄位表出現之前的寫法：依序比較每個鍵名
+int FindByComparison(std::string_view key) {
+    static const std::string_view names[] = {
+        "title", "x", "y", "width", "height", "isCollapsed", "isPinned", "expandedHeight",
+        "iconSize", "alpha", "backgroundColor", "borderColor", "titleColor", "borderWidth",
+        "iconSpacing", "scrollOffset",
+    };
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); ++i) {
+        if (key == names[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SameSettings(const FenceLayoutFence& a, const FenceLayoutFence& b) {
+    return a.title == b.title && a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height &&
+           a.isPinned == b.isPinned && a.backgroundColor == b.backgroundColor &&
+           a.borderWidth == b.borderWidth && a.iconSpacing == b.iconSpacing && a.scrollOffset == b.scrollOffset;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = bench::IsQuick(argc, argv);
+    const size_t sizes[] = { 100, 2000 };
+
+    for (size_t fenceCount : sizes) {
+        if (quick && fenceCount > 100) {
+            break;
+        }
+
+        FenceLayout source = MakeSettingsLayout(fenceCount);
+        std::string json = FenceLayoutJson::Write(source);
+        int rounds = quick ? 1 : (fenceCount >= 2000 ? 50 : 500);
+        std::printf("\n%zu fences (settings only), %zu bytes\n", fenceCount, json.size());
+
+        FenceLayout parsed;
+        double table = bench::MeasureMicroseconds(rounds, [&]() {
+            FenceLayout layout;
+            FenceLayoutJson::Parse(json.data(), json.size(), layout);
+            bench::Consume(layout.fences.size());
+            parsed = std::move(layout);
+        });
+        bench::Report("FenceLayoutJson::Parse (field table)", table);
+
+        // 舊版對沒有圖示的柵欄會一路搜尋 "filePath" 到檔尾，耗時隨柵欄數平方成長，只跑少數幾輪
+        FenceLayout legacy;
+        double legacyParse = bench::MeasureMicroseconds(quick ? 1 : 3, [&]() {
+            FenceLayout layout;
+            bench::ParseLegacyConfig(json, layout);
+            bench::Consume(layout.fences.size());
+            legacy = std::move(layout);
+        });
+        char note[64];
+        std::snprintf(note, sizeof(note), "(%.1fx field table)", legacyParse / (table > 0.0 ? table : 1.0));
+        bench::Report("legacy find/stoi parse", legacyParse, note);
+
+        // 舊版不讀取 borderWidth 之後的欄位：這正是欄位表要消除的清單漂移
+        size_t restored = 0;
+        size_t legacyRestored = 0;
+        for (size_t i = 0; i < fenceCount && i < parsed.fences.size() && i < legacy.fences.size(); ++i) {
+            restored += SameSettings(source.fences[i], parsed.fences[i]) ? 1 : 0;
+            legacyRestored += SameSettings(source.fences[i], legacy.fences[i]) ? 1 : 0;
+        }
+        std::printf("%-48s %zu / %zu (legacy %zu)\n", "fences restored exactly", restored, fenceCount, legacyRestored);
+        if (restored != fenceCount) {
+            std::fprintf(stderr, "field table parse lost settings\n");
+            return 1;
+        }
+
+        double payload = bench::MeasureMicroseconds(rounds, [&]() {
+            size_t bytes = 0;
+            for (const auto& fence : source.fences) {
+                JournalPayloadWriter writer;
+                FENCE_LAYOUT_FENCE_FIELDS.WritePayload(writer, fence);
+                JournalPayloadReader reader(writer.GetData().data(), writer.GetData().size());
+                FenceLayoutFence decoded;
+                FENCE_LAYOUT_FENCE_FIELDS.ReadPayload(reader, decoded);
+                bytes += writer.GetData().size() + (decoded.width == fence.width ? 1 : 0);
+            }
+            bench::Consume(bytes);
+        });
+        bench::Report("journal payload write + read (field table)", payload);
+    }
+
+    // 鍵名分派：柵欄物件中的 16 個欄位鍵，加上不屬於欄位表的鍵
+    std::vector<std::string> keys;
+    const char* fenceKeys[] = {
+        "title", "x", "y", "width", "height", "isCollapsed", "isPinned", "expandedHeight", "iconSize",
+        "alpha", "backgroundColor", "borderColor", "titleColor", "borderWidth", "iconSpacing",
+        "scrollOffset", "icons", "unknownKey",
+    };
+    for (const char* key : fenceKeys) {
+        keys.emplace_back(key);
+    }
+
+    const int lookups = quick ? 1000 : 1000000;
+    std::printf("\n%d lookups x %zu keys\n", lookups, keys.size());
+    double hashed = bench::MeasureMicroseconds(quick ? 1 : 5, [&]() {
+        int sum = 0;
+        for (int n = 0; n < lookups; ++n) {
+            for (const auto& key : keys) {
+                sum += FENCE_LAYOUT_FENCE_FIELDS.Find(key);
+            }
+        }
+        bench::Consume((size_t)sum);
+    });
+    bench::Report("FieldTable::Find (perfect hash)", hashed);
+
+    double compared = bench::MeasureMicroseconds(quick ? 1 : 5, [&]() {
+        int sum = 0;
+        for (int n = 0; n < lookups; ++n) {
+            for (const auto& key : keys) {
+                sum += FindByComparison(key);
+            }
+        }
+        bench::Consume((size_t)sum);
+    });
+    char note[64];
+    std::snprintf(note, sizeof(note), "(%.1fx Find)", compared / (hashed > 0.0 ? hashed : 1.0));
+    bench::Report("key comparison chain", compared, note);
+
+    for (const auto& key : keys) {
+        if (FENCE_LAYOUT_FENCE_FIELDS.Find(key) != FindByComparison(key)) {
+            std::fprintf(stderr, "Find mismatch for %s\n", key.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
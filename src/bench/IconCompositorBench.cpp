@@ -0,0 +1,100 @@
+// 圖示合成基準：各版本的 BlendOver 對照純量版本
+// 典型圖示（外圍透明、中央不透明、邊緣半透明）與整片半透明（最壞情況，每個像素都要計算）
+#include "BenchSupport.h"
+#include "widgets/IconCompositor.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// 半徑為邊長 0.45 倍的圓形圖示，邊緣 2 像素漸變（預乘 alpha）
+std::vector<uint32_t> MakeRoundIcon(uint32_t size) {
+    std::vector<uint32_t> pixels(size_t(size) * size);
+    float center = (size - 1) * 0.5f;
+    float radius = size * 0.45f;
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            float dx = x - center;
+            float dy = y - center;
+            float coverage = (radius - (dx * dx + dy * dy) / radius) * 0.5f;
+            uint32_t alpha = coverage >= 1.0f ? 255 : coverage <= 0.0f ? 0 : (uint32_t)(coverage * 255.0f);
+            uint32_t r = 0x30 * alpha / 255;
+            uint32_t g = 0x90 * alpha / 255;
+            uint32_t b = 0xE0 * alpha / 255;
+            pixels[size_t(y) * size + x] = (alpha << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+    return pixels;
+}
+
+struct Sample {
+    const char* name;
+    std::vector<uint32_t> pixels;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = bench::IsQuick(argc, argv);
+    const uint32_t sizes[] = { 48, 256 };
+    const IconCompositor::Kernel kernels[] = {
+        IconCompositor::KERNEL_SSE2,
+        IconCompositor::KERNEL_AVX2,
+        IconCompositor::KERNEL_NEON,
+    };
+    std::printf("default kernel: %s\n", IconCompositor::GetKernelName(IconCompositor::GetDefaultKernel()));
+
+    for (uint32_t size : sizes) {
+        // 每輪合成的像素數大致相同（約 4M 像素）
+        int repeat = quick ? 1 : (int)((4u << 20) / (size * size));
+        int rounds = quick ? 1 : 10;
+        std::printf("\n%ux%u icon (x%d per round)\n", size, size, repeat);
+
+        Sample samples[] = {
+            { "round icon", MakeRoundIcon(size) },
+            { "translucent", std::vector<uint32_t>(size_t(size) * size, 0x80402010u) },
+        };
+        std::vector<uint32_t> background(size_t(size) * size, 0xFF2B5797u);
+        std::vector<uint32_t> target(background.size());
+
+        for (const Sample& sample : samples) {
+            double scalar = bench::MeasureMicroseconds(rounds, [&]() {
+                for (int r = 0; r < repeat; ++r) {
+                    target = background;
+                    IconCompositor::BlendOver(IconCompositor::KERNEL_SCALAR, target.data(), size,
+                                              sample.pixels.data(), size, size, size);
+                    bench::Consume(target[size_t(size) * size / 2]);
+                }
+            });
+            std::vector<uint32_t> expected = target;
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "scalar (%s)", sample.name);
+            bench::Report(name, scalar);
+
+            for (IconCompositor::Kernel kernel : kernels) {
+                if (!IconCompositor::IsSupported(kernel)) {
+                    continue;
+                }
+                double simd = bench::MeasureMicroseconds(rounds, [&]() {
+                    for (int r = 0; r < repeat; ++r) {
+                        target = background;
+                        IconCompositor::BlendOver(kernel, target.data(), size, sample.pixels.data(), size, size, size);
+                        bench::Consume(target[size_t(size) * size / 2]);
+                    }
+                });
+                if (target != expected) {
+                    std::fprintf(stderr, "%s differs from scalar\n", IconCompositor::GetKernelName(kernel));
+                    return 1;
+                }
+
+                char note[64];
+                std::snprintf(note, sizeof(note), "(%.1fx scalar)", scalar / (simd > 0.0 ? simd : 1.0));
+                std::snprintf(name, sizeof(name), "%s (%s)", IconCompositor::GetKernelName(kernel), sample.name);
+                bench::Report(name, simd, note);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// 變更日誌基準：追加數百萬筆紀錄，量測追加、開啟時回放、檔尾損毀時截斷，
+// 以及快照後 DiscardThrough 捨棄一半紀錄的時間，並核對回放與保留的筆數
+#include "BenchSupport.h"
+#include "core/MutationJournal.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+namespace {
+
+// 與 FencesWidget 的 JOURNAL_ICON_MOVED 相近的紀錄內容
+JournalPayloadWriter MakePayload(uint64_t index) {
+    JournalPayloadWriter payload;
+    payload.PutInt((int32_t)(index % 64));
+    payload.PutString(L"C:\\Users\\使用者\\Desktop\\捷徑 " + std::to_wstring(index % 1000) + L".lnk");
+    payload.PutInt((int32_t)(index % 1920));
+    payload.PutInt((int32_t)(index % 1080));
+    return payload;
+}
+
+bool Expect(const char* what, uint64_t actual, uint64_t expected) {
+    if (actual != expected) {
+        std::fprintf(stderr, "%s: %llu, expected %llu\n", what,
+                     (unsigned long long)actual, (unsigned long long)expected);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = bench::IsQuick(argc, argv);
+    const uint64_t recordCount = quick ? 20000 : 2000000;
+    const uint64_t snapshotSequence = recordCount / 2;
+
+    std::error_code error;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(error) /
+        ("JournalBench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(dir, error);
+    std::filesystem::path file = dir / "config.journal";
+    bool ok = true;
+
+    {
+        MutationJournal journal;
+        journal.Open(file.wstring(), 0, nullptr);
+        double append = bench::MeasureMicroseconds(1, [&]() {
+            for (uint64_t i = 0; i < recordCount; ++i) {
+                journal.Append((uint16_t)(1 + i % 8), MakePayload(i));
+            }
+        });
+        std::printf("\n%llu records, %llu bytes\n",
+                    (unsigned long long)recordCount, (unsigned long long)journal.GetFileSize());
+        char note[64];
+        std::snprintf(note, sizeof(note), "(%.2f us/record)", append / (double)recordCount);
+        bench::Report("Append", append, note);
+        ok &= Expect("last sequence after append", journal.GetLastSequence(), recordCount);
+    }
+
+    // 開啟時回放快照之後的紀錄
+    uint64_t replayed = 0;
+    double replay = bench::MeasureMicroseconds(quick ? 1 : 3, [&]() {
+        MutationJournal journal;
+        replayed = 0;
+        journal.Open(file.wstring(), snapshotSequence, [&](const MutationJournal::Record& record) {
+            JournalPayloadReader payload(record.payload, record.payloadSize);
+            payload.GetInt();
+            bench::Consume(payload.GetString().size());
+            if (payload.IsValid()) {
+                ++replayed;
+            }
+        });
+    });
+    bench::Report("Open + replay (after snapshot)", replay);
+    ok &= Expect("replayed records", replayed, recordCount - snapshotSequence);
+
+    // 最後一筆寫到一半：開啟時截掉殘缺的檔尾
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 5, error);
+    {
+        MutationJournal journal;
+        double truncate = bench::MeasureMicroseconds(1, [&]() {
+            journal.Open(file.wstring(), 0, nullptr);
+        });
+        bench::Report("Open + truncate torn tail", truncate);
+        ok &= Expect("records after torn tail", journal.GetRecordCount(), recordCount - 1);
+        ok &= Expect("file size after torn tail", journal.GetFileSize(), std::filesystem::file_size(file));
+        ok &= Expect("sequence after torn tail", journal.Append(1, MakePayload(0)), recordCount);
+
+        // 快照寫入完成：捨棄快照涵蓋的一半紀錄
+        double discard = bench::MeasureMicroseconds(1, [&]() {
+            journal.DiscardThrough(snapshotSequence);
+        });
+        bench::Report("DiscardThrough (half)", discard);
+        ok &= Expect("records after discard", journal.GetRecordCount(), recordCount - snapshotSequence);
+    }
+
+    {
+        MutationJournal journal;
+        uint64_t first = 0;
+        journal.Open(file.wstring(), 0, [&](const MutationJournal::Record& record) {
+            if (first == 0) {
+                first = record.sequence;
+            }
+        });
+        ok &= Expect("first sequence after discard", first, snapshotSequence + 1);
+        ok &= Expect("records after reopen", journal.GetRecordCount(), recordCount - snapshotSequence);
+    }
+
+    std::filesystem::remove_all(dir, error);
+    return ok ? 0 : 1;
+}
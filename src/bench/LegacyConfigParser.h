@@ -0,0 +1,105 @@
+#pragma once
+
+#include "core/StringCodec.h"
+#include "widgets/FenceLayout.h"
+#include <string>
+#include <string_view>
+
+// 舊版 FencesWidget::LoadConfiguration 的解析方式（find / substr / stoi），只作為基準的比較對象：
+// 整份檔案先轉為寬字串，每個欄位都從上一個位置重新 find，每個數值都建立一個子字串。
+// 去除了建立視窗與提取圖示的部分，其餘照舊（包含不還原轉義）。
+namespace bench {
+
+inline bool ParseLegacyConfig(std::string_view utf8, FenceLayout& layout) {
+    std::wstring json;
+    StringCodec::AppendWide(json, utf8);
+
+    if (json.find(L"\"fences\":") == std::wstring::npos) {
+        return false;
+    }
+
+    layout.fences.clear();
+    size_t pos = 0;
+    while ((pos = json.find(L"\"title\":", pos)) != std::wstring::npos) {
+        size_t titleStart = json.find(L'"', pos + 8) + 1;
+        size_t titleEnd = json.find(L'"', titleStart);
+
+        FenceLayoutFence fence;
+        fence.title = json.substr(titleStart, titleEnd - titleStart);
+
+        size_t xPos = json.find(L"\"x\":", titleEnd);
+        size_t yPos = json.find(L"\"y\":", xPos);
+        size_t wPos = json.find(L"\"width\":", yPos);
+        size_t hPos = json.find(L"\"height\":", wPos);
+
+        fence.x = std::stoi(json.substr(json.find(L':', xPos) + 1, 10));
+        fence.y = std::stoi(json.substr(json.find(L':', yPos) + 1, 10));
+        fence.width = std::stoi(json.substr(json.find(L':', wPos) + 1, 10));
+        fence.height = std::stoi(json.substr(json.find(L':', hPos) + 1, 10));
+
+        size_t collapsedPos = json.find(L"\"isCollapsed\":", hPos);
+        size_t pinnedPos = json.find(L"\"isPinned\":", hPos);
+        size_t expandedHeightPos = json.find(L"\"expandedHeight\":", hPos);
+        size_t iconSizePos = json.find(L"\"iconSize\":", hPos);
+        size_t alphaPos = json.find(L"\"alpha\":", hPos);
+        size_t bgColorPos = json.find(L"\"backgroundColor\":", hPos);
+        size_t borderColorPos = json.find(L"\"borderColor\":", hPos);
+        size_t titleColorPos = json.find(L"\"titleColor\":", hPos);
+
+        if (collapsedPos != std::wstring::npos) {
+            std::wstring value = json.substr(json.find(L':', collapsedPos) + 1, 10);
+            fence.isCollapsed = (value.find(L"true") != std::wstring::npos);
+        }
+        if (pinnedPos != std::wstring::npos) {
+            std::wstring value = json.substr(json.find(L':', pinnedPos) + 1, 10);
+            fence.isPinned = (value.find(L"true") != std::wstring::npos);
+        }
+        if (expandedHeightPos != std::wstring::npos) {
+            fence.expandedHeight = std::stoi(json.substr(json.find(L':', expandedHeightPos) + 1, 10));
+        }
+        if (iconSizePos != std::wstring::npos) {
+            fence.iconSize = std::stoi(json.substr(json.find(L':', iconSizePos) + 1, 10));
+        }
+        if (alphaPos != std::wstring::npos) {
+            fence.alpha = std::stoi(json.substr(json.find(L':', alphaPos) + 1, 10));
+        }
+        if (bgColorPos != std::wstring::npos) {
+            fence.backgroundColor = (uint32_t)std::stoul(json.substr(json.find(L':', bgColorPos) + 1, 15));
+        }
+        if (borderColorPos != std::wstring::npos) {
+            fence.borderColor = (uint32_t)std::stoul(json.substr(json.find(L':', borderColorPos) + 1, 15));
+        }
+        if (titleColorPos != std::wstring::npos) {
+            fence.titleColor = (uint32_t)std::stoul(json.substr(json.find(L':', titleColorPos) + 1, 15));
+        }
+
+        size_t iconsStart = json.find(L"\"icons\":", hPos);
+        size_t iconsEnd = json.find(L"]", iconsStart);
+        size_t iconPos = iconsStart;
+        while ((iconPos = json.find(L"\"filePath\":", iconPos)) != std::wstring::npos && iconPos < iconsEnd) {
+            size_t pathStart = json.find(L'"', iconPos + 11) + 1;
+            size_t pathEnd = json.find(L'"', pathStart);
+
+            FenceLayoutIcon icon;
+            icon.filePath = json.substr(pathStart, pathEnd - pathStart);
+
+            size_t oxPos = json.find(L"\"originalX\":", pathEnd);
+            size_t oyPos = json.find(L"\"originalY\":", oxPos);
+            size_t oiPos = json.find(L"\"originalIndex\":", oyPos);
+
+            icon.originalX = std::stoi(json.substr(json.find(L':', oxPos) + 1, 10));
+            icon.originalY = std::stoi(json.substr(json.find(L':', oyPos) + 1, 10));
+            icon.originalIndex = std::stoi(json.substr(json.find(L':', oiPos) + 1, 10));
+            fence.icons.push_back(icon);
+
+            iconPos = pathEnd;
+        }
+
+        layout.fences.push_back(std::move(fence));
+        pos = titleEnd;
+    }
+
+    return !layout.fences.empty();
+}
+
+} // namespace bench
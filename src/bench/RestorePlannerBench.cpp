@@ -0,0 +1,202 @@
+// 恢復規劃基準：10k 圖示的桌面上整批恢復圖示
+// 1. 規劃本身：佔用位元圖加位元掃描，對照逐圖示從起點逐格掃描的做法
+// 2. 宿主往返：DesktopIconController::Restore 對照舊版 RestoreDesktopIconsBatch 的流程
+//    （每個圖示逐一比對名稱找索引，沒有原始位置時整個桌面自動排列一次）
+#include "BenchSupport.h"
+#include "widgets/DesktopIconController.h"
+#include "widgets/DesktopRestorePlanner.h"
+#include "widgets/SimulatedDesktopIconHost.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// 逐圖示逐格掃描：每個需要空格的圖示都從起點一格一格往後找
+void PlanByLinearScan(const DesktopIconGrid& grid,
+                      const std::vector<DesktopIconPoint>& occupied,
+                      const std::vector<DesktopRestorePlanner::Request>& requests,
+                      std::vector<DesktopIconPoint>& positions) {
+    int64_t cellCount = (int64_t)grid.columns * grid.rows;
+    std::vector<bool> used((size_t)cellCount, false);
+    auto cellOf = [&](DesktopIconPoint p) -> int64_t {
+        if (p.x < 0 || p.y < 0 || p.x / grid.cellWidth >= grid.columns || p.y / grid.cellHeight >= grid.rows) {
+            return -1;
+        }
+        return (int64_t)(p.x / grid.cellWidth) * grid.rows + p.y / grid.cellHeight;
+    };
+    for (DesktopIconPoint p : occupied) {
+        int64_t cell = cellOf(p);
+        if (cell >= 0) {
+            used[(size_t)cell] = true;
+        }
+    }
+
+    positions.assign(requests.size(), DesktopIconPoint{ 0, 0 });
+    std::vector<size_t> deferred;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        int64_t cell = requests[i].hasSaved ? cellOf(requests[i].saved) : -1;
+        if (cell >= 0 && !used[(size_t)cell]) {
+            used[(size_t)cell] = true;
+            positions[i] = requests[i].saved;
+        } else {
+            deferred.push_back(i);
+        }
+    }
+    for (size_t i : deferred) {
+        int64_t start = requests[i].hasSaved ? cellOf(requests[i].saved) : 0;
+        start = (start >= 0) ? start : 0;
+        for (int64_t n = 0; n < cellCount; ++n) {
+            int64_t cell = (start + n) % cellCount;
+            if (!used[(size_t)cell]) {
+                used[(size_t)cell] = true;
+                positions[i] = { (int32_t)(cell / grid.rows) * grid.cellWidth, (int32_t)(cell % grid.rows) * grid.cellHeight };
+                break;
+            }
+        }
+    }
+}
+
+std::wstring PathOf(int index) {
+    wchar_t number[16];
+    swprintf(number, sizeof(number) / sizeof(number[0]), L"%05d", index);
+    return std::wstring(L"C:\\Users\\user\\Desktop\\item") + number + L".lnk";
+}
+
+// 舊版流程：每個圖示逐一讀取名稱找索引；有原始位置時設定位置，沒有時自動排列整個桌面
+void LegacyRestore(SimulatedDesktopIconHost& host, const std::vector<std::pair<std::wstring, DesktopIconPoint>>& icons) {
+    host.Connect();
+    host.BeginUpdate();
+    std::wstring text;
+    for (const auto& icon : icons) {
+        size_t slash = icon.first.find_last_of(L'\\');
+        std::wstring name = icon.first.substr(slash + 1);
+        std::wstring stem = name.substr(0, name.find_last_of(L'.'));
+
+        int index = -1;
+        int count = host.GetItemCount();
+        for (int i = 0; i < count && index < 0; ++i) {
+            if (host.GetItemText(i, text) && (text == name || text == stem)) {
+                index = i;
+            }
+        }
+        if (index < 0) {
+            continue;
+        }
+        if (icon.second.x >= 0 && icon.second.y >= 0) {
+            host.SetItemPosition(index, host.ScreenToList(icon.second));
+        } else {
+            host.Arrange();
+        }
+    }
+    host.EndUpdate();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = bench::IsQuick(argc, argv);
+    const int itemCount = quick ? 1000 : 10000;
+    const int restoreCount = itemCount / 10;
+    const int columns = 100;
+    std::mt19937 rng(7);
+
+    // 1. 規劃：桌面幾乎全滿（依格子順序排列），一半的圖示原始格子已被佔用、一半沒有原始位置
+    DesktopIconGrid grid = { 75, 100, columns, itemCount / columns + 20 };
+    std::vector<DesktopIconPoint> occupied;
+    for (int cell = 0; cell < itemCount; ++cell) {
+        occupied.push_back({ (cell / grid.rows) * grid.cellWidth, (cell % grid.rows) * grid.cellHeight });
+    }
+    std::vector<DesktopRestorePlanner::Request> requests;
+    for (int i = 0; i < restoreCount; ++i) {
+        if (i % 2 == 0) {
+            requests.push_back({ occupied[rng() % occupied.size()], true });
+        } else {
+            requests.push_back({ DesktopIconPoint{ 0, 0 }, false });
+        }
+    }
+
+    int rounds = quick ? 1 : 20;
+    std::printf("\n%d icons on a %dx%d grid, restoring %d\n", itemCount, grid.columns, grid.rows, restoreCount);
+
+    DesktopRestorePlanner planner;
+    std::vector<DesktopIconPoint> planned;
+    double bitmap = bench::MeasureMicroseconds(rounds, [&]() {
+        planner.Reset(grid);
+        for (DesktopIconPoint p : occupied) {
+            planner.MarkOccupied(p);
+        }
+        planner.Plan(requests, planned);
+        bench::Consume(planned.size());
+    });
+    bench::Report("DesktopRestorePlanner (bitmap + bit scan)", bitmap);
+
+    std::vector<DesktopIconPoint> scanned;
+    double linear = bench::MeasureMicroseconds(rounds, [&]() {
+        PlanByLinearScan(grid, occupied, requests, scanned);
+        bench::Consume(scanned.size());
+    });
+    char note[64];
+    std::snprintf(note, sizeof(note), "(%.1fx planner)", linear / (bitmap > 0.0 ? bitmap : 1.0));
+    bench::Report("per-icon linear cell scan", linear, note);
+
+    for (size_t i = 0; i < planned.size(); ++i) {
+        if (planned[i].x != scanned[i].x || planned[i].y != scanned[i].y) {
+            std::fprintf(stderr, "planner and linear scan disagree at %zu\n", i);
+            return 1;
+        }
+    }
+
+    // 2. 宿主往返：先隱藏要恢復的圖示，再整批恢復（一半有原始位置）
+    std::vector<std::pair<std::wstring, DesktopIconPoint>> icons;
+    std::vector<std::wstring> paths;
+    for (int i = 0; i < restoreCount; ++i) {
+        int index = (int)((size_t)i * 7919 % (size_t)itemCount);
+        DesktopIconPoint saved = (i % 2 == 0)
+            ? DesktopIconPoint{ (index % 20) * 75, (index / 20) * 100 }
+            : DesktopIconPoint{ -1, -1 };
+        icons.push_back({ PathOf(index), saved });
+        paths.push_back(PathOf(index));
+    }
+
+    SimulatedDesktopIconHost host;
+    DesktopIconController controller(host);
+    uint64_t controllerTrips = 0;
+    uint64_t controllerArranges = 0;
+    double batched = bench::MeasureMicroseconds(quick ? 1 : 5, [&]() {
+        host.Populate(itemCount, L"item");
+        controller.Invalidate();
+        controller.Hide(paths);
+        host.ResetCallCounts();
+        bench::Consume(controller.Restore(icons));
+        controllerTrips = host.GetCallCounts().GetRoundTrips();
+        controllerArranges = host.GetCallCounts().arrange;
+    });
+    bench::Report("DesktopIconController::Restore", batched);
+
+    uint64_t legacyTrips = 0;
+    uint64_t legacyArranges = 0;
+    double legacy = bench::MeasureMicroseconds(quick ? 1 : 2, [&]() {
+        host.Populate(itemCount, L"item");
+        controller.Invalidate();
+        controller.Hide(paths);
+        host.ResetCallCounts();
+        LegacyRestore(host, icons);
+        legacyTrips = host.GetCallCounts().GetRoundTrips();
+        legacyArranges = host.GetCallCounts().arrange;
+    });
+    std::snprintf(note, sizeof(note), "(%.1fx Restore)", legacy / (batched > 0.0 ? batched : 1.0));
+    bench::Report("legacy per-icon lookup + arrange", legacy, note);
+
+    std::printf("%-48s %12llu      (%llu arranges)\n", "round trips (controller)",
+                (unsigned long long)controllerTrips, (unsigned long long)controllerArranges);
+    std::printf("%-48s %12llu      (%llu arranges)\n", "round trips (legacy)",
+                (unsigned long long)legacyTrips, (unsigned long long)legacyArranges);
+    if (controllerArranges != 0 || controllerTrips >= legacyTrips) {
+        std::fprintf(stderr, "controller restore should not arrange and should need fewer round trips\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// 字串編碼基準：以 StringCodec 轉為 UTF-8 並做 JSON 轉義，對照舊版的
+// find / replace 轉義迴圈（StickyNotesWidget::SaveConfiguration）加上逐字元轉為 UTF-8
+#include "BenchSupport.h"
+#include "core/StringCodec.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+// 舊版：每種特殊字元各掃描一次整個字串，每次取代都搬移其後的內容
+// （舊版漏掉反斜線，這裡補上，工作量才與 AppendUtf8 相當）
+std::wstring LegacyEscape(const std::wstring& content) {
+    std::wstring escapedContent = content;
+    size_t pos = 0;
+    while ((pos = escapedContent.find(L"\\", pos)) != std::wstring::npos) {
+        escapedContent.replace(pos, 1, L"\\\\");
+        pos += 2;
+    }
+    pos = 0;
+    while ((pos = escapedContent.find(L"\"", pos)) != std::wstring::npos) {
+        escapedContent.replace(pos, 1, L"\\\"");
+        pos += 2;
+    }
+    pos = 0;
+    while ((pos = escapedContent.find(L"\n", pos)) != std::wstring::npos) {
+        escapedContent.replace(pos, 1, L"\\n");
+        pos += 2;
+    }
+    pos = 0;
+    while ((pos = escapedContent.find(L"\r", pos)) != std::wstring::npos) {
+        escapedContent.replace(pos, 1, L"");
+    }
+    return escapedContent;
+}
+
+// 舊版寫檔時的寬字元轉 UTF-8（逐字元，未處理代理對）
+std::string LegacyToUtf8(const std::wstring& text) {
+    std::string out;
+    for (wchar_t wc : text) {
+        uint32_t c = static_cast<uint32_t>(wc);
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (c < 0x800) {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | ((c >> 12) & 0x0F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return out;
+}
+
+struct Sample {
+    const char* name;
+    std::wstring text;
+};
+
+// 便利貼內容：多行、夾雜引號的中英文
+std::wstring MakeNote(size_t length, bool cjk) {
+    const wchar_t* ascii = L"Meeting at 10:00, bring the \"Q3\" report.\r\n";
+    const wchar_t* mixed = L"會議 10:00，記得帶「第三季」\"報告\"與 C:\\Reports 資料夾。\r\n";
+    std::wstring line = cjk ? mixed : ascii;
+    std::wstring text;
+    while (text.size() < length) {
+        text += line;
+    }
+    text.resize(length);
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = bench::IsQuick(argc, argv);
+    const size_t lengths[] = { 64, 4096, 65536 };
+
+    for (size_t length : lengths) {
+        if (quick && length > 4096) {
+            break;
+        }
+        Sample samples[] = {
+            { "ascii", MakeNote(length, false) },
+            { "mixed CJK", MakeNote(length, true) },
+            { "path", std::wstring(length, L'a') },
+        };
+        for (size_t i = 0; i < length; i += 16) {
+            samples[2].text[i] = L'\\';
+        }
+
+        int rounds = quick ? 1 : (length >= 65536 ? 50 : 2000);
+        int repeat = length < 4096 ? 100 : 1;
+        std::printf("\n%zu characters (x%d per round)\n", length, repeat);
+
+        for (const Sample& sample : samples) {
+            double codec = bench::MeasureMicroseconds(rounds, [&]() {
+                for (int r = 0; r < repeat; ++r) {
+                    std::string out;
+                    StringCodec::AppendUtf8(out, sample.text, true);
+                    bench::Consume(out.size());
+                }
+            });
+            double legacy = bench::MeasureMicroseconds(quick ? 1 : (length >= 65536 ? 3 : rounds), [&]() {
+                for (int r = 0; r < repeat; ++r) {
+                    bench::Consume(LegacyToUtf8(LegacyEscape(sample.text)).size());
+                }
+            });
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "StringCodec::AppendUtf8 escape (%s)", sample.name);
+            bench::Report(name, codec);
+            char note[64];
+            std::snprintf(note, sizeof(note), "(%.1fx AppendUtf8)", legacy / (codec > 0.0 ? codec : 1.0));
+            std::snprintf(name, sizeof(name), "legacy find/replace + UTF-8 (%s)", sample.name);
+            bench::Report(name, legacy, note);
+        }
+    }
+    return 0;
+}
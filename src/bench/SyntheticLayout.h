@@ -0,0 +1,41 @@
+#pragma once
+
+#include "widgets/FenceLayout.h"
+#include <string>
+
+// 基準用的合成柵欄佈局：每個柵欄 50 個圖示，標題與路徑含中文與反斜線
+namespace bench {
+
+const size_t SYNTHETIC_ICONS_PER_FENCE = 50;
+
+inline FenceLayout MakeSyntheticLayout(size_t iconCount) {
+    FenceLayout layout;
+    layout.journalSequence = 42;
+
+    size_t fenceCount = (iconCount + SYNTHETIC_ICONS_PER_FENCE - 1) / SYNTHETIC_ICONS_PER_FENCE;
+    for (size_t i = 0; i < fenceCount; ++i) {
+        FenceLayoutFence fence;
+        fence.title = L"柵欄 " + std::to_wstring(i);
+        fence.x = (int32_t)(i % 8) * 320;
+        fence.y = (int32_t)(i / 8) * 240;
+        fence.width = 300;
+        fence.height = 220;
+        fence.expandedHeight = 220;
+        fence.isPinned = (i % 3) == 0;
+
+        size_t first = i * SYNTHETIC_ICONS_PER_FENCE;
+        size_t last = (first + SYNTHETIC_ICONS_PER_FENCE < iconCount) ? first + SYNTHETIC_ICONS_PER_FENCE : iconCount;
+        for (size_t j = first; j < last; ++j) {
+            FenceLayoutIcon icon;
+            icon.filePath = L"C:\\Users\\user\\Desktop\\專案資料 " + std::to_wstring(j) + L".lnk";
+            icon.originalX = (int32_t)(j % 20) * 75;
+            icon.originalY = (int32_t)(j / 20 % 12) * 100;
+            icon.originalIndex = (int32_t)j;
+            fence.icons.push_back(icon);
+        }
+        layout.fences.push_back(fence);
+    }
+    return layout;
+}
+
+} // namespace bench
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "MutationJournal.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// 編譯期欄位表：以「鍵名 + 成員指標」描述結構中需要保存的欄位，
+// 由同一份表產生 JSON 與日誌內容（二進位）的編碼 / 解碼，新增欄位只需加一行。
+//
+//   constexpr auto POINT_FIELDS = MakeFieldTable(
+//       Field("x", &Point::x),
+//       Field("y", &Point::y));
+//
+//   POINT_FIELDS.WriteJson(writer, point);        // 依表中順序輸出鍵值
+//   POINT_FIELDS.ReadJson(reader, point);         // 讀到 Key 後呼叫，鍵不屬於此表時回傳 false
+//
+// 載入時以編譯期建立的完美雜湊表由鍵名找到欄位（雜湊只取樣鍵名的長度與三個字元，
+// 最後只比較一次字串），不逐一比較鍵名，也不需執行期反射。
+// 支援的值型別：bool、整數（包含 LONG / COLORREF 等別名）、std::wstring。
+
+namespace FieldCodec {
+
+template <typename T>
+void WriteJson(JsonWriter& writer, const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        writer.Bool(value);
+    } else if constexpr (std::is_same_v<T, std::wstring>) {
+        writer.String(value);
+    } else if constexpr (std::is_signed_v<T>) {
+        writer.Int(value);
+    } else {
+        writer.UInt(value);
+    }
+}
+
+// 值的型別不符時保留原值（呼叫前先填入預設值）
+template <typename T>
+void ReadJson(JsonReader& reader, T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        value = reader.GetBool(value);
+    } else if constexpr (std::is_same_v<T, std::wstring>) {
+        if (reader.GetToken() == JsonReader::Token::String) {
+            value = reader.GetWideString();
+        }
+    } else {
+        value = static_cast<T>(reader.GetInt(static_cast<int64_t>(value)));
+    }
+}
+
+// 日誌內容：整數固定 4 位元組（與 JournalPayloadWriter 相同）
+template <typename T>
+void WritePayload(JournalPayloadWriter& payload, const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        payload.PutBool(value);
+    } else if constexpr (std::is_same_v<T, std::wstring>) {
+        payload.PutString(value);
+    } else if constexpr (std::is_signed_v<T>) {
+        payload.PutInt(static_cast<int32_t>(value));
+    } else {
+        payload.PutUInt(static_cast<uint32_t>(value));
+    }
+}
+
+template <typename T>
+void ReadPayload(JournalPayloadReader& payload, T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        value = payload.GetBool();
+    } else if constexpr (std::is_same_v<T, std::wstring>) {
+        value = payload.GetString();
+    } else if constexpr (std::is_signed_v<T>) {
+        value = static_cast<T>(payload.GetInt());
+    } else {
+        value = static_cast<T>(payload.GetUInt());
+    }
+}
+
+// FNV-1a（加上種子），鍵名都很短
+// 最後把高位元混入低位元：槽位只取低位元，而 FNV 的低位元只受各字元的低位元影響
+constexpr uint32_t HashKey(std::string_view key, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (size_t i = 0; i < key.size(); ++i) {
+        hash ^= static_cast<uint8_t>(key[i]);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+// 只取長度與首、中、尾三個字元：不需走訪整個鍵名，多數欄位表都能找到無碰撞的種子
+constexpr uint32_t SampleKey(std::string_view key, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    hash = (hash ^ static_cast<uint32_t>(key.size())) * 16777619u;
+    if (!key.empty()) {
+        hash = (hash ^ static_cast<uint8_t>(key[0])) * 16777619u;
+        hash = (hash ^ static_cast<uint8_t>(key[key.size() / 2])) * 16777619u;
+        hash = (hash ^ static_cast<uint8_t>(key[key.size() - 1])) * 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+} // namespace FieldCodec
+
+// 直接成員：owner.*member
+template <typename Owner, typename T>
+struct FieldDescriptor {
+    using OwnerType = Owner;
+    using ValueType = T;
+
+    std::string_view name;
+    T Owner::*member;
+
+    T& Get(Owner& owner) const { return owner.*member; }
+    const T& Get(const Owner& owner) const { return owner.*member; }
+};
+
+// 巢狀成員：(owner.*outer).*member（例如 POINT position 的 x）
+template <typename Owner, typename Inner, typename T>
+struct NestedFieldDescriptor {
+    using OwnerType = Owner;
+    using ValueType = T;
+
+    std::string_view name;
+    Inner Owner::*outer;
+    T Inner::*member;
+
+    T& Get(Owner& owner) const { return (owner.*outer).*member; }
+    const T& Get(const Owner& owner) const { return (owner.*outer).*member; }
+};
+
+template <typename Owner, typename T>
+constexpr FieldDescriptor<Owner, T> Field(std::string_view name, T Owner::*member) {
+    return { name, member };
+}
+
+template <typename Owner, typename Inner, typename T>
+constexpr NestedFieldDescriptor<Owner, Inner, T> Field(std::string_view name, Inner Owner::*outer,
+                                                       T Inner::*member) {
+    return { name, outer, member };
+}
+
+template <typename... Fields>
+class FieldTable {
+public:
+    using Owner = typename std::tuple_element_t<0, std::tuple<Fields...>>::OwnerType;
+
+    static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+    static_assert(FIELD_COUNT > 0 && FIELD_COUNT < 255, "FieldTable supports 1-254 fields");
+    static_assert((std::is_same_v<typename Fields::OwnerType, Owner> && ...),
+                  "all fields must belong to the same type");
+
+    // 槽位數為 2 的次方且至少是欄位數的兩倍，容易找到無碰撞的種子
+    static constexpr size_t SLOT_COUNT = [] {
+        size_t count = 4;
+        while (count < FIELD_COUNT * 2) count *= 2;
+        return count;
+    }();
+
+    constexpr explicit FieldTable(Fields... fields)
+        : fields_(fields...)
+        , names_{ fields.name... }
+        , slots_{}
+        , seed_(0)
+        , sampled_(true) {
+        // 先找取樣雜湊的種子；鍵名只在未取樣的字元不同時改用完整雜湊
+        // （鍵名重複時找不到種子，編譯期求值會失敗）
+        while (!TrySeed(seed_)) {
+            if (++seed_ == SAMPLED_SEED_LIMIT && sampled_) {
+                sampled_ = false;
+                seed_ = 0;
+            }
+        }
+    }
+
+    // 依鍵名找到欄位索引；不屬於此表時回傳 -1
+    constexpr int Find(std::string_view key) const {
+        uint8_t index = slots_[Hash(key, seed_) & (SLOT_COUNT - 1)];
+        if (index == EMPTY_SLOT || names_[index] != key) {
+            return -1;
+        }
+        return index;
+    }
+
+    // 依表中順序輸出所有欄位（呼叫端負責 BeginObject / EndObject）
+    void WriteJson(JsonWriter& writer, const Owner& owner) const {
+        std::apply([&](const auto&... field) {
+            ((writer.Key(field.name), FieldCodec::WriteJson(writer, field.Get(owner))), ...);
+        }, fields_);
+    }
+
+    // 在讀到 Key 之後呼叫：鍵屬於此表時讀取其值並回傳 true，否則不前進並回傳 false
+    bool ReadJson(JsonReader& reader, Owner& owner) const {
+        int index = reader.HasEscapes() ? Find(reader.GetString()) : Find(reader.GetRawString());
+        if (index < 0) {
+            return false;
+        }
+        reader.Next();
+        ReadJsonAt(static_cast<size_t>(index), reader, owner, std::index_sequence_for<Fields...>());
+        return true;
+    }
+
+    // 在讀到 BeginObject 之後呼叫：讀完整個物件，未知欄位略過
+    bool ReadJsonObject(JsonReader& reader, Owner& owner) const {
+        while (reader.Next() == JsonReader::Token::Key) {
+            if (!ReadJson(reader, owner) && !reader.SkipValue()) {
+                return false;
+            }
+        }
+        return reader.GetToken() == JsonReader::Token::EndObject;
+    }
+
+    // 日誌內容：依表中順序逐欄寫入 / 讀出，沒有鍵名
+    void WritePayload(JournalPayloadWriter& payload, const Owner& owner) const {
+        std::apply([&](const auto&... field) {
+            (FieldCodec::WritePayload(payload, field.Get(owner)), ...);
+        }, fields_);
+    }
+
+    void ReadPayload(JournalPayloadReader& payload, Owner& owner) const {
+        std::apply([&](const auto&... field) {
+            (FieldCodec::ReadPayload(payload, field.Get(owner)), ...);
+        }, fields_);
+    }
+
+private:
+    static constexpr uint8_t EMPTY_SLOT = 0xFF;
+    static constexpr uint32_t SAMPLED_SEED_LIMIT = 4096;
+
+    constexpr uint32_t Hash(std::string_view key, uint32_t seed) const {
+        return sampled_ ? FieldCodec::SampleKey(key, seed) : FieldCodec::HashKey(key, seed);
+    }
+
+    constexpr bool TrySeed(uint32_t seed) {
+        for (size_t i = 0; i < SLOT_COUNT; ++i) {
+            slots_[i] = EMPTY_SLOT;
+        }
+        for (size_t i = 0; i < FIELD_COUNT; ++i) {
+            size_t slot = Hash(names_[i], seed) & (SLOT_COUNT - 1);
+            if (slots_[slot] != EMPTY_SLOT) {
+                return false;
+            }
+            slots_[slot] = static_cast<uint8_t>(i);
+        }
+        return true;
+    }
+
+    // 以函式指標表分派到各欄位專屬的解碼函式
+    template <size_t... I>
+    void ReadJsonAt(size_t index, JsonReader& reader, Owner& owner, std::index_sequence<I...>) const {
+        using Reader = void (*)(const FieldTable&, JsonReader&, Owner&);
+        static constexpr Reader readers[] = { &FieldTable::ReadJsonField<I>... };
+        readers[index](*this, reader, owner);
+    }
+
+    template <size_t I>
+    static void ReadJsonField(const FieldTable& table, JsonReader& reader, Owner& owner) {
+        FieldCodec::ReadJson(reader, std::get<I>(table.fields_).Get(owner));
+    }
+
+    std::tuple<Fields...> fields_;
+    std::array<std::string_view, FIELD_COUNT> names_;
+    std::array<uint8_t, SLOT_COUNT> slots_;
+    uint32_t seed_;
+    bool sampled_;
+};
+
+template <typename... Fields>
+constexpr FieldTable<Fields...> MakeFieldTable(Fields... fields) {
+    return FieldTable<Fields...>(fields...);
+}
@@ -0,0 +1,249 @@
+#include "FileWidgetStorage.h"
+
+namespace {
+
+enum StorageRecordType : uint16_t {
+    STORAGE_RECORD_TRANSACTION = 1
+};
+
+// 每個項目在紀錄中的額外開銷：是否刪除(1) + 鍵長度(4) + 值長度(4)
+const uint64_t ENTRY_OVERHEAD = 9;
+
+// 檔案超過此大小且大部分是失效資料時才壓縮
+const uint64_t COMPACT_MIN_FILE_SIZE = 256 * 1024;
+const uint64_t COMPACT_GARBAGE_RATIO = 4;
+
+// 壓縮時每筆紀錄的目標大小（遠低於單筆紀錄上限）
+const size_t COMPACT_CHUNK_SIZE = 256 * 1024;
+
+bool StartsWith(const std::string& key, std::string_view prefix) {
+    return key.size() >= prefix.size() && key.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace
+
+FileWidgetStorage::FileWidgetStorage()
+    : liveBytes_(0) {
+}
+
+FileWidgetStorage::~FileWidgetStorage() {
+    Close();
+}
+
+bool FileWidgetStorage::Open(const std::wstring& filePath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    entries_.clear();
+    liveBytes_ = 0;
+
+    if (!journal_.Open(filePath, 0, [this](const MutationJournal::Record& record) {
+            ApplyRecord(record);
+        })) {
+        return false;
+    }
+
+    if (NeedsCompaction()) {
+        CompactLocked();
+    }
+    return true;
+}
+
+void FileWidgetStorage::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    journal_.Close();
+}
+
+bool FileWidgetStorage::IsOpen() const {
+    return journal_.IsOpen();
+}
+
+bool FileWidgetStorage::Get(std::string_view key, std::string& value) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return false;
+    }
+    value = it->second;
+    return true;
+}
+
+bool FileWidgetStorage::Contains(std::string_view key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.find(key) != entries_.end();
+}
+
+void FileWidgetStorage::ForEach(std::string_view prefix, const Visitor& visit) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.lower_bound(prefix); it != entries_.end(); ++it) {
+        if (!StartsWith(it->first, prefix)) {
+            break;
+        }
+        visit(it->first, it->second);
+    }
+}
+
+bool FileWidgetStorage::Commit(const WidgetStorageBatch& batch) {
+    if (batch.IsEmpty()) {
+        return true;
+    }
+
+    // 交易內容：項目數，接著每個項目為 是否刪除、鍵、（寫入時）值
+    const auto& operations = batch.GetOperations();
+    JournalPayloadWriter payload;
+    payload.PutUInt(static_cast<uint32_t>(operations.size()));
+    for (const auto& op : operations) {
+        payload.PutBool(op.isRemove);
+        payload.PutBytes(op.key);
+        if (!op.isRemove) {
+            payload.PutBytes(op.value);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 先寫入檔案，成功後才更新快取
+    if (journal_.Append(STORAGE_RECORD_TRANSACTION, payload) == 0) {
+        return false;
+    }
+
+    for (const auto& op : operations) {
+        if (op.isRemove) {
+            ApplyRemove(op.key);
+        } else {
+            ApplyPut(op.key, op.value);
+        }
+    }
+
+    if (NeedsCompaction()) {
+        CompactLocked();
+    }
+    return true;
+}
+
+bool FileWidgetStorage::Put(std::string_view key, std::string_view value) {
+    WidgetStorageBatch batch;
+    batch.Put(key, value);
+    return Commit(batch);
+}
+
+bool FileWidgetStorage::Remove(std::string_view key) {
+    WidgetStorageBatch batch;
+    batch.Remove(key);
+    return Commit(batch);
+}
+
+bool FileWidgetStorage::RemovePrefix(std::string_view prefix) {
+    WidgetStorageBatch batch;
+    ForEach(prefix, [&batch](const std::string& key, const std::string&) {
+        batch.Remove(key);
+    });
+    return Commit(batch);
+}
+
+bool FileWidgetStorage::Compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return CompactLocked();
+}
+
+size_t FileWidgetStorage::GetEntryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t FileWidgetStorage::GetFileSize() const {
+    return journal_.GetFileSize();
+}
+
+void FileWidgetStorage::ApplyRecord(const MutationJournal::Record& record) {
+    if (record.type != STORAGE_RECORD_TRANSACTION) {
+        return;
+    }
+
+    // 先完整解碼，確認內容有效才套用（整筆交易全有或全無）
+    JournalPayloadReader reader(record.payload, record.payloadSize);
+    uint32_t count = reader.GetUInt();
+
+    WidgetStorageBatch batch;
+    for (uint32_t i = 0; i < count && reader.IsValid(); ++i) {
+        bool isRemove = reader.GetBool();
+        std::string key = reader.GetBytes();
+        if (isRemove) {
+            batch.Remove(key);
+        } else {
+            batch.Put(key, reader.GetBytes());
+        }
+    }
+    if (!reader.IsValid()) {
+        return;
+    }
+
+    for (const auto& op : batch.GetOperations()) {
+        if (op.isRemove) {
+            ApplyRemove(op.key);
+        } else {
+            ApplyPut(op.key, op.value);
+        }
+    }
+}
+
+void FileWidgetStorage::ApplyPut(const std::string& key, std::string value) {
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        liveBytes_ -= it->second.size();
+        liveBytes_ += value.size();
+        it->second = std::move(value);
+    } else {
+        liveBytes_ += key.size() + value.size() + ENTRY_OVERHEAD;
+        entries_.emplace(key, std::move(value));
+    }
+}
+
+void FileWidgetStorage::ApplyRemove(const std::string& key) {
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        liveBytes_ -= it->first.size() + it->second.size() + ENTRY_OVERHEAD;
+        entries_.erase(it);
+    }
+}
+
+bool FileWidgetStorage::NeedsCompaction() const {
+    uint64_t fileSize = journal_.GetFileSize();
+    return fileSize > COMPACT_MIN_FILE_SIZE && fileSize > liveBytes_ * COMPACT_GARBAGE_RATIO;
+}
+
+bool FileWidgetStorage::CompactLocked() {
+    if (!journal_.IsOpen()) {
+        return false;
+    }
+
+    // 把目前內容追加為新的交易，再捨棄之前的所有紀錄。
+    // 中途失敗時舊紀錄仍在，重新回放的結果相同。
+    uint64_t lastSequence = journal_.GetLastSequence();
+
+    auto it = entries_.begin();
+    while (it != entries_.end()) {
+        JournalPayloadWriter payload;
+        size_t chunkSize = 0;
+        uint32_t count = 0;
+        auto chunkEnd = it;
+        while (chunkEnd != entries_.end() &&
+               (count == 0 || chunkSize + chunkEnd->first.size() + chunkEnd->second.size() <= COMPACT_CHUNK_SIZE)) {
+            chunkSize += chunkEnd->first.size() + chunkEnd->second.size() + ENTRY_OVERHEAD;
+            ++count;
+            ++chunkEnd;
+        }
+
+        payload.PutUInt(count);
+        for (; it != chunkEnd; ++it) {
+            payload.PutBool(false);
+            payload.PutBytes(it->first);
+            payload.PutBytes(it->second);
+        }
+
+        if (journal_.Append(STORAGE_RECORD_TRANSACTION, payload) == 0) {
+            return false;
+        }
+    }
+
+    return journal_.DiscardThrough(lastSequence);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "IWidgetStorage.h"
+#include "MutationJournal.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// 以單一檔案保存的 IWidgetStorage 實作
+// 每筆交易是變更日誌中的一筆紀錄，開啟時一次讀入並回放到記憶體快取；
+// 之後只保留一個追加用的檔案句柄。失效資料過多時重寫為目前內容（壓縮）。
+class FileWidgetStorage : public IWidgetStorage {
+public:
+    FileWidgetStorage();
+    ~FileWidgetStorage() override;
+
+    FileWidgetStorage(const FileWidgetStorage&) = delete;
+    FileWidgetStorage& operator=(const FileWidgetStorage&) = delete;
+
+    // 開啟（不存在則建立）儲存檔並載入全部內容
+    bool Open(const std::wstring& filePath);
+    void Close();
+    bool IsOpen() const;
+
+    bool Get(std::string_view key, std::string& value) const override;
+    bool Contains(std::string_view key) const override;
+    void ForEach(std::string_view prefix, const Visitor& visit) const override;
+    bool Commit(const WidgetStorageBatch& batch) override;
+    bool Put(std::string_view key, std::string_view value) override;
+    bool Remove(std::string_view key) override;
+    bool RemovePrefix(std::string_view prefix) override;
+
+    // 立即重寫為只含目前內容的檔案
+    bool Compact();
+
+    // 目前項目數量與檔案大小
+    size_t GetEntryCount() const;
+    uint64_t GetFileSize() const;
+
+private:
+    void ApplyRecord(const MutationJournal::Record& record);
+    void ApplyPut(const std::string& key, std::string value);
+    void ApplyRemove(const std::string& key);
+    bool CompactLocked();
+    bool NeedsCompaction() const;
+
+    mutable std::mutex mutex_;
+    MutationJournal journal_;
+    std::map<std::string, std::string, std::less<>> entries_;
+    uint64_t liveBytes_;  // 目前所有鍵值的位元組總數
+};
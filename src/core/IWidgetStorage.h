@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 批次寫入：收集多筆變更，交給 IWidgetStorage::Commit 以單一交易寫入
+class WidgetStorageBatch {
+public:
+    struct Operation {
+        bool isRemove;
+        std::string key;
+        std::string value;
+    };
+
+    void Put(std::string_view key, std::string_view value) {
+        operations_.push_back({ false, std::string(key), std::string(value) });
+    }
+
+    void Remove(std::string_view key) {
+        operations_.push_back({ true, std::string(key), std::string() });
+    }
+
+    bool IsEmpty() const { return operations_.empty(); }
+    void Clear() { operations_.clear(); }
+
+    const std::vector<Operation>& GetOperations() const { return operations_; }
+
+private:
+    std::vector<Operation> operations_;
+};
+
+// Widget 共用的鍵值儲存服務
+// 由主程式開啟一次，透過 CreateWidgetEx 的參數（WidgetCreateParams）交給各插件。
+// 鍵為 UTF-8 字串，慣例以「Widget 名稱/」為前綴；值為任意位元組。
+// 讀取直接來自記憶體快取，寫入在 Commit 回傳前已寫入檔案。
+class IWidgetStorage {
+public:
+    using Visitor = std::function<void(const std::string& key, const std::string& value)>;
+
+    virtual ~IWidgetStorage() = default;
+
+    // 讀取單一鍵值；不存在時回傳 false
+    virtual bool Get(std::string_view key, std::string& value) const = 0;
+
+    virtual bool Contains(std::string_view key) const = 0;
+
+    // 依鍵的順序走訪所有以 prefix 開頭的項目
+    virtual void ForEach(std::string_view prefix, const Visitor& visit) const = 0;
+
+    // 以單一交易套用整批變更（全部成功或全部不生效）
+    virtual bool Commit(const WidgetStorageBatch& batch) = 0;
+
+    // 單筆寫入 / 刪除（各自為一筆交易）
+    virtual bool Put(std::string_view key, std::string_view value) = 0;
+    virtual bool Remove(std::string_view key) = 0;
+
+    // 刪除所有以 prefix 開頭的項目（單一交易）
+    virtual bool RemovePrefix(std::string_view prefix) = 0;
+};
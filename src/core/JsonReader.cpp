@@ -0,0 +1,446 @@
+#include "JsonReader.h"
+#include "StringCodec.h"
+#include <charconv>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define JSON_READER_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline bool IsWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+#ifdef JSON_READER_SSE2
+
+// 最低位元 1 的位置（mask 不可為 0）
+inline int LowestSetBit(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// 16 個位元組中空白字元的位元遮罩
+inline unsigned WhitespaceMask16(__m128i v) {
+    __m128i ws = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+    return static_cast<unsigned>(_mm_movemask_epi8(ws));
+}
+
+// 16 個位元組中引號或反斜線的位元遮罩
+inline unsigned QuoteOrEscapeMask16(__m128i v) {
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    return static_cast<unsigned>(_mm_movemask_epi8(special));
+}
+
+#endif
+
+} // namespace
+
+JsonReader::JsonReader(const char* data, size_t size)
+    : begin_(data)
+    , pos_(data)
+    , end_(data + size)
+    , token_(Token::None)
+    , hasEscapes_(false)
+    , numberIsInteger_(true)
+    , intValue_(0)
+    , depth_(0)
+    , containerBits_(0)
+    , expectKey_(false)
+    , needSeparator_(false) {
+    // 略過 UTF-8 BOM
+    if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF &&
+        static_cast<unsigned char>(data[1]) == 0xBB &&
+        static_cast<unsigned char>(data[2]) == 0xBF) {
+        pos_ += 3;
+    }
+}
+
+bool JsonReader::InObject() const {
+    return depth_ > 0 && ((containerBits_ >> (depth_ - 1)) & 1) != 0;
+}
+
+void JsonReader::SkipWhitespace() {
+    // 以區域變數掃描：經由 char 指標讀取時，編譯器無法假設成員 pos_ 未被改寫
+    const char* p = pos_;
+
+    // 多數 token 之間沒有或只有一個空白：先逐字檢查，遇到縮排（換行後的一串空白）才整段略過
+    for (int i = 0; i < 2; ++i) {
+        if (p >= end_ || !IsWhitespace(*p)) {
+            pos_ = p;
+            return;
+        }
+        ++p;
+    }
+
+#ifdef JSON_READER_SSE2
+    while (end_ - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned other = ~WhitespaceMask16(v) & 0xFFFF;
+        if (other != 0) {
+            pos_ = p + LowestSetBit(other);
+            return;
+        }
+        p += 16;
+    }
+#endif
+
+    while (p < end_ && IsWhitespace(*p)) {
+        ++p;
+    }
+    pos_ = p;
+}
+
+JsonReader::Token JsonReader::Fail() {
+    token_ = Token::Error;
+    pos_ = end_;
+    return token_;
+}
+
+JsonReader::Token JsonReader::Next() {
+    if (token_ == Token::Error || token_ == Token::End) {
+        return token_;
+    }
+
+    // 處理分隔符號：值之間必須恰好一個逗號，結束符號前不可有逗號，頂層只能有一個值
+    bool afterComma = false;
+    for (;;) {
+        SkipWhitespace();
+        if (pos_ >= end_) {
+            token_ = (depth_ == 0 && !afterComma) ? Token::End : Token::Error;
+            return token_;
+        }
+        if (*pos_ == ',') {
+            if (depth_ == 0 || !needSeparator_) {
+                return Fail();
+            }
+            ++pos_;
+            needSeparator_ = false;
+            afterComma = true;
+            expectKey_ = InObject();
+            continue;
+        }
+        break;
+    }
+
+    char c = *pos_;
+    bool closing = (c == '}' || c == ']');
+    if (closing ? afterComma : needSeparator_) {
+        return Fail();
+    }
+    if (!closing && expectKey_ && InObject() && c != '"') {
+        return Fail();
+    }
+
+    Token token = ReadToken(c);
+    needSeparator_ = (token != Token::BeginObject && token != Token::BeginArray && token != Token::Key);
+    return token;
+}
+
+JsonReader::Token JsonReader::ReadToken(char c) {
+    switch (c) {
+    case '{':
+        if (depth_ >= MAX_DEPTH) {
+            return Fail();
+        }
+        containerBits_ |= (uint64_t(1) << depth_);
+        ++depth_;
+        ++pos_;
+        expectKey_ = true;
+        token_ = Token::BeginObject;
+        return token_;
+
+    case '[':
+        if (depth_ >= MAX_DEPTH) {
+            return Fail();
+        }
+        containerBits_ &= ~(uint64_t(1) << depth_);
+        ++depth_;
+        ++pos_;
+        expectKey_ = false;
+        token_ = Token::BeginArray;
+        return token_;
+
+    case '}':
+        if (!InObject()) {
+            return Fail();
+        }
+        --depth_;
+        ++pos_;
+        expectKey_ = false;
+        token_ = Token::EndObject;
+        return token_;
+
+    case ']':
+        if (depth_ == 0 || InObject()) {
+            return Fail();
+        }
+        --depth_;
+        ++pos_;
+        expectKey_ = false;
+        token_ = Token::EndArray;
+        return token_;
+
+    case '"':
+        if (expectKey_ && InObject()) {
+            expectKey_ = false;
+            if (ReadString(Token::Key) == Token::Error) {
+                return token_;
+            }
+            // Key 之後必須是冒號
+            SkipWhitespace();
+            if (pos_ >= end_ || *pos_ != ':') {
+                return Fail();
+            }
+            ++pos_;
+            return token_;
+        }
+        return ReadString(Token::String);
+
+    case 't':
+        return ReadLiteral("true", 4, Token::True);
+    case 'f':
+        return ReadLiteral("false", 5, Token::False);
+    case 'n':
+        return ReadLiteral("null", 4, Token::Null);
+
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            return ReadNumber();
+        }
+        return Fail();
+    }
+}
+
+JsonReader::Token JsonReader::ReadString(Token kind) {
+    const char* start = pos_ + 1;  // 略過開頭的引號
+    const char* p = start;
+    const char* end = end_;
+    bool hasEscapes = false;
+
+    for (;;) {
+#ifdef JSON_READER_SSE2
+        // 一次檢查 16 個位元組，直接跳到下一個引號或反斜線
+        while (end - p >= 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned special = QuoteOrEscapeMask16(v);
+            if (special != 0) {
+                p += LowestSetBit(special);
+                break;
+            }
+            p += 16;
+        }
+#endif
+        if (p >= end) {
+            break;
+        }
+
+        char c = *p;
+        if (c == '"') {
+            text_ = std::string_view(start, static_cast<size_t>(p - start));
+            hasEscapes_ = hasEscapes;
+            pos_ = p + 1;
+            token_ = kind;
+            return token_;
+        }
+        if (c == '\\') {
+            hasEscapes = true;
+            p += 2;
+            continue;
+        }
+        ++p;
+    }
+
+    return Fail();
+}
+
+JsonReader::Token JsonReader::ReadNumber() {
+    const char* start = pos_;
+    const char* p = start;
+    bool negative = (*p == '-');
+    if (negative) {
+        ++p;
+    }
+
+    // 設定檔中的數值幾乎都是短整數：掃描的同時累加，不需再呼叫 from_chars
+    const char* digits = p;
+    uint64_t magnitude = 0;
+    while (p < end_ && *p >= '0' && *p <= '9') {
+        magnitude = magnitude * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    size_t digitCount = static_cast<size_t>(p - digits);
+
+    // 依 JSON 數值文法檢查：-? (0 | [1-9][0-9]*) (.[0-9]+)? ([eE][+-]?[0-9]+)?
+    if (digitCount == 0 || (digitCount > 1 && *digits == '0')) {
+        return Fail();
+    }
+
+    bool isInteger = true;
+    if (p < end_ && *p == '.') {
+        isInteger = false;
+        const char* fraction = ++p;
+        while (p < end_ && *p >= '0' && *p <= '9') {
+            ++p;
+        }
+        if (p == fraction) {
+            return Fail();
+        }
+    }
+    if (p < end_ && (*p == 'e' || *p == 'E')) {
+        isInteger = false;
+        ++p;
+        if (p < end_ && (*p == '+' || *p == '-')) {
+            ++p;
+        }
+        const char* exponent = p;
+        while (p < end_ && *p >= '0' && *p <= '9') {
+            ++p;
+        }
+        if (p == exponent) {
+            return Fail();
+        }
+    }
+    // 數值之後不能再接數值的字元（例如 1-2、1.2.3、1e5e5）
+    if (p < end_ && (*p == '.' || *p == '+' || *p == '-' || *p == 'e' || *p == 'E')) {
+        return Fail();
+    }
+
+    pos_ = p;
+    text_ = std::string_view(start, static_cast<size_t>(p - start));
+    hasEscapes_ = false;
+    numberIsInteger_ = isInteger;
+    token_ = Token::Number;
+
+    if (numberIsInteger_) {
+        if (digitCount <= 18) {
+            // 18 位以內不會溢位
+            intValue_ = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+        } else {
+            auto result = std::from_chars(start, p, intValue_);
+            if (result.ec != std::errc() || result.ptr != p) {
+                // 超出 int64 範圍，改以浮點數處理
+                numberIsInteger_ = false;
+            }
+        }
+    }
+    return token_;
+}
+
+JsonReader::Token JsonReader::ReadLiteral(const char* literal, size_t length, Token kind) {
+    if (static_cast<size_t>(end_ - pos_) < length || std::memcmp(pos_, literal, length) != 0) {
+        return Fail();
+    }
+    pos_ += length;
+    hasEscapes_ = false;
+    text_ = std::string_view();
+    token_ = kind;
+    return token_;
+}
+
+bool JsonReader::IsKey(std::string_view name) const {
+    if (token_ != Token::Key) {
+        return false;
+    }
+    if (!hasEscapes_) {
+        return text_ == name;
+    }
+    return GetString() == name;
+}
+
+std::string JsonReader::GetString() const {
+    if (token_ != Token::Key && token_ != Token::String) {
+        return std::string();
+    }
+    if (!hasEscapes_) {
+        return std::string(text_);
+    }
+
+    std::string out;
+    out.reserve(text_.size());
+    StringCodec::AppendUnescaped(out, text_);
+    return out;
+}
+
+std::wstring JsonReader::GetWideString() const {
+    if (token_ != Token::Key && token_ != Token::String) {
+        return std::wstring();
+    }
+    return DecodeWideString(text_, hasEscapes_);
+}
+
+std::wstring JsonReader::DecodeWideString(std::string_view text, bool unescape) {
+    std::wstring out;
+    StringCodec::AppendWide(out, text, unescape);
+    return out;
+}
+
+int64_t JsonReader::GetInt(int64_t defaultValue) const {
+    if (token_ != Token::Number) {
+        return defaultValue;
+    }
+    if (numberIsInteger_) {
+        return intValue_;
+    }
+    // 超出 int64 範圍（例如 1e300）的轉型是未定義行為，改回傳預設值
+    double value = GetDouble(static_cast<double>(defaultValue));
+    if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0)) {
+        return defaultValue;
+    }
+    return static_cast<int64_t>(value);
+}
+
+double JsonReader::GetDouble(double defaultValue) const {
+    if (token_ != Token::Number) {
+        return defaultValue;
+    }
+    if (numberIsInteger_) {
+        return static_cast<double>(intValue_);
+    }
+
+    double value = defaultValue;
+    auto result = std::from_chars(text_.data(), text_.data() + text_.size(), value);
+    if (result.ec != std::errc()) {
+        return defaultValue;
+    }
+    return value;
+}
+
+bool JsonReader::GetBool(bool defaultValue) const {
+    if (token_ == Token::True) return true;
+    if (token_ == Token::False) return false;
+    return defaultValue;
+}
+
+bool JsonReader::SkipValue() {
+    Token t = token_;
+    if (t == Token::Key) {
+        t = Next();
+    }
+
+    if (t == Token::BeginObject || t == Token::BeginArray) {
+        int targetDepth = depth_ - 1;
+        while (depth_ > targetDepth) {
+            Token n = Next();
+            if (n == Token::Error || n == Token::End) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return t != Token::Error && t != Token::End;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 單次掃描的串流式 JSON 讀取器（pull 模式）
+// 直接在 UTF-8 緩衝區上逐一取出 token，不建立 DOM、不產生中間子字串。
+// Key / String 的內容以 string_view 指向原始緩衝區，需要時才解碼。
+class JsonReader {
+public:
+    enum class Token {
+        None,
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        Key,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        End,
+        Error
+    };
+
+    // 緩衝區在讀取期間必須保持有效
+    JsonReader(const char* data, size_t size);
+
+    // 前進到下一個 token
+    Token Next();
+
+    // 目前的 token
+    Token GetToken() const { return token_; }
+
+    // 目前 Key / String 的原始內容（未還原轉義）
+    std::string_view GetRawString() const { return text_; }
+
+    // 目前 Key / String 是否包含轉義字元
+    bool HasEscapes() const { return hasEscapes_; }
+
+    // 目前 Key 是否等於指定名稱（Key 名稱不含轉義時零成本比較）
+    bool IsKey(std::string_view name) const;
+
+    // 取得還原轉義後的字串
+    std::string GetString() const;
+    std::wstring GetWideString() const;
+
+    // 將 UTF-8 字串內容轉為 wide string；unescape 為 false 時保留反斜線原樣
+    // （舊版設定檔寫入時未做轉義，路徑中的反斜線需原樣讀回）
+    static std::wstring DecodeWideString(std::string_view text, bool unescape = true);
+
+    // 取得數值（非 Number token 時回傳預設值）
+    int64_t GetInt(int64_t defaultValue = 0) const;
+    double GetDouble(double defaultValue = 0.0) const;
+
+    // 取得布林值（True/False token）
+    bool GetBool(bool defaultValue = false) const;
+
+    // 在讀到 Key 之後呼叫，略過其對應的整個值（含巢狀物件與陣列）
+    // 在讀到 BeginObject / BeginArray 之後呼叫，則略過該容器的剩餘內容
+    bool SkipValue();
+
+    // 目前巢狀深度
+    int GetDepth() const { return depth_; }
+
+    // 目前讀取位置（位元組偏移）
+    size_t GetOffset() const { return static_cast<size_t>(pos_ - begin_); }
+
+private:
+    void SkipWhitespace();
+    Token ReadToken(char c);
+    Token ReadString(Token kind);
+    Token ReadNumber();
+    Token ReadLiteral(const char* literal, size_t length, Token kind);
+    Token Fail();
+
+    // 巢狀容器類型堆疊（位元堆疊：1 = 物件，0 = 陣列）
+    static const int MAX_DEPTH = 64;
+    bool InObject() const;
+
+    const char* begin_;
+    const char* pos_;
+    const char* end_;
+    Token token_;
+    std::string_view text_;
+    bool hasEscapes_;
+    bool numberIsInteger_;
+    int64_t intValue_;
+    int depth_;
+    uint64_t containerBits_;
+    bool expectKey_;
+    bool needSeparator_;    // 上一個值之後必須先有逗號或結束符號
+};
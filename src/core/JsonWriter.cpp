@@ -0,0 +1,115 @@
+#include "JsonWriter.h"
+#include "StringCodec.h"
+#include <charconv>
+
+JsonWriter::JsonWriter(size_t reserveBytes)
+    : depth_(0)
+    , afterKey_(false) {
+    buffer_.reserve(reserveBytes > 0 ? reserveBytes : 256);
+    first_[0] = true;
+}
+
+void JsonWriter::Indent() {
+    buffer_.append(static_cast<size_t>(depth_) * 2, ' ');
+}
+
+void JsonWriter::BeginValue() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (depth_ == 0) {
+        return;
+    }
+    if (!first_[depth_]) {
+        buffer_ += ',';
+    }
+    first_[depth_] = false;
+    buffer_ += '\n';
+    Indent();
+}
+
+void JsonWriter::BeginObject() {
+    BeginValue();
+    buffer_ += '{';
+    if (depth_ < MAX_DEPTH) {
+        ++depth_;
+        first_[depth_] = true;
+    }
+}
+
+void JsonWriter::EndObject() {
+    bool empty = first_[depth_];
+    if (depth_ > 0) {
+        --depth_;
+    }
+    if (!empty) {
+        buffer_ += '\n';
+        Indent();
+    }
+    buffer_ += '}';
+    if (depth_ == 0) {
+        buffer_ += '\n';
+    }
+}
+
+void JsonWriter::BeginArray() {
+    BeginValue();
+    buffer_ += '[';
+    if (depth_ < MAX_DEPTH) {
+        ++depth_;
+        first_[depth_] = true;
+    }
+}
+
+void JsonWriter::EndArray() {
+    bool empty = first_[depth_];
+    if (depth_ > 0) {
+        --depth_;
+    }
+    if (!empty) {
+        buffer_ += '\n';
+        Indent();
+    }
+    buffer_ += ']';
+}
+
+void JsonWriter::Key(std::string_view name) {
+    BeginValue();
+    buffer_ += '"';
+    buffer_.append(name.data(), name.size());
+    buffer_ += "\": ";
+    afterKey_ = true;
+}
+
+void JsonWriter::String(std::wstring_view value) {
+    BeginValue();
+    buffer_ += '"';
+    StringCodec::AppendUtf8(buffer_, value, true);
+    buffer_ += '"';
+}
+
+void JsonWriter::Int(int64_t value) {
+    BeginValue();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, static_cast<size_t>(result.ptr - digits));
+}
+
+void JsonWriter::UInt(uint64_t value) {
+    BeginValue();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, static_cast<size_t>(result.ptr - digits));
+}
+
+void JsonWriter::Bool(bool value) {
+    BeginValue();
+    buffer_ += value ? "true" : "false";
+}
+
+std::string JsonWriter::Release() {
+    std::string result;
+    result.swap(buffer_);
+    return result;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 直接輸出 UTF-8 的 JSON 寫入器（縮排 2 格）
+// 寬字串在寫入時一併轉義並轉碼，不產生中間的 std::wstring。
+class JsonWriter {
+public:
+    // reserveBytes：預先配置的緩衝區大小（通常取上次輸出的大小）
+    explicit JsonWriter(size_t reserveBytes = 0);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    // 物件成員名稱（ASCII，不做轉義）
+    void Key(std::string_view name);
+
+    // 值
+    void String(std::wstring_view value);
+    void Int(int64_t value);
+    void UInt(uint64_t value);
+    void Bool(bool value);
+
+    // 取得輸出結果
+    const std::string& GetBuffer() const { return buffer_; }
+    std::string Release();
+
+private:
+    // 寫入值之前的逗號、換行與縮排
+    void BeginValue();
+    void Indent();
+
+    static const int MAX_DEPTH = 64;
+
+    std::string buffer_;
+    int depth_;
+    bool first_[MAX_DEPTH + 1];  // 各層是否尚未寫入任何元素
+    bool afterKey_;
+};
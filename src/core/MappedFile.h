@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// 唯讀的記憶體映射檔案
+// 開啟後內容直接對應到位址空間，讀取時才由作業系統載入頁面。
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射整個檔案（空檔案視為失敗）
+    bool Open(const std::wstring& filePath);
+
+    // 解除映射並關閉檔案
+    void Close();
+
+    bool IsOpen() const { return data_ != nullptr; }
+    const char* GetData() const { return data_; }
+    size_t GetSize() const { return size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* fileHandle_;
+    void* mappingHandle_;
+#endif
+};
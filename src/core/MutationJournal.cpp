@@ -0,0 +1,405 @@
+#include "MutationJournal.h"
+#include "PersistenceWorker.h"
+#include "StringCodec.h"
+#include <array>
+#include <cstring>
+
+#ifndef _WIN32
+#include <filesystem>
+#endif
+
+namespace {
+
+// 檔案標頭
+const char JOURNAL_MAGIC[8] = { 'I', 'K', 'J', 'R', 'N', 'L', '0', '1' };
+const size_t HEADER_SIZE = sizeof(JOURNAL_MAGIC);
+
+// 紀錄標頭：payloadSize(4) + crc(4) + sequence(8) + type(2)
+const size_t RECORD_HEADER_SIZE = 18;
+
+uint32_t Crc32(const char* data, size_t size) {
+    // 區域靜態變數的初始化是執行緒安全的（Append 與 DiscardThrough 可能在不同執行緒）
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t = {};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void PutRaw(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF);
+    }
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T GetRaw(const char* p) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+FILE* OpenFile(const std::wstring& filePath, const char* mode) {
+#ifdef _WIN32
+    std::wstring wideMode(mode, mode + std::strlen(mode));
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, filePath.c_str(), wideMode.c_str()) != 0) {
+        return nullptr;
+    }
+    return file;
+#else
+    return std::fopen(std::filesystem::path(filePath).c_str(), mode);
+#endif
+}
+
+bool ReadWholeFile(const std::wstring& filePath, std::string& content) {
+    FILE* file = OpenFile(filePath, "rb");
+    if (!file) {
+        return false;
+    }
+
+    content.clear();
+    char chunk[64 * 1024];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        content.append(chunk, count);
+    }
+    std::fclose(file);
+    return true;
+}
+
+// 逐筆檢查紀錄，回傳最後一筆有效紀錄結尾的位置
+template <typename Visitor>
+size_t ScanRecords(const std::string& content, Visitor&& visit) {
+    size_t pos = HEADER_SIZE;
+    const char* data = content.data();
+
+    while (content.size() - pos >= RECORD_HEADER_SIZE) {
+        uint32_t payloadSize = GetRaw<uint32_t>(data + pos);
+        uint32_t crc = GetRaw<uint32_t>(data + pos + 4);
+        if (payloadSize > MutationJournal::MAX_PAYLOAD_SIZE ||
+            content.size() - pos - RECORD_HEADER_SIZE < payloadSize) {
+            break;
+        }
+
+        // CRC 涵蓋序號、類型與內容
+        if (Crc32(data + pos + 8, RECORD_HEADER_SIZE - 8 + payloadSize) != crc) {
+            break;
+        }
+
+        MutationJournal::Record record;
+        record.sequence = GetRaw<uint64_t>(data + pos + 8);
+        record.type = GetRaw<uint16_t>(data + pos + 16);
+        record.payload = data + pos + RECORD_HEADER_SIZE;
+        record.payloadSize = payloadSize;
+        visit(record, pos);
+
+        pos += RECORD_HEADER_SIZE + payloadSize;
+    }
+
+    return pos;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// JournalPayloadWriter / JournalPayloadReader
+
+void JournalPayloadWriter::PutInt(int32_t value) {
+    PutRaw<uint32_t>(data_, static_cast<uint32_t>(value));
+}
+
+void JournalPayloadWriter::PutUInt(uint32_t value) {
+    PutRaw<uint32_t>(data_, value);
+}
+
+void JournalPayloadWriter::PutBool(bool value) {
+    data_ += value ? '\1' : '\0';
+}
+
+void JournalPayloadWriter::PutString(std::wstring_view value) {
+    // 長度前綴 + UTF-8 內容
+    size_t lengthPos = data_.size();
+    PutRaw<uint32_t>(data_, 0);
+    StringCodec::AppendUtf8(data_, value);
+
+    uint32_t length = static_cast<uint32_t>(data_.size() - lengthPos - 4);
+    for (size_t i = 0; i < 4; ++i) {
+        data_[lengthPos + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+}
+
+void JournalPayloadWriter::PutBytes(std::string_view value) {
+    PutRaw<uint32_t>(data_, static_cast<uint32_t>(value.size()));
+    data_.append(value.data(), value.size());
+}
+
+JournalPayloadReader::JournalPayloadReader(const char* data, size_t size)
+    : pos_(data)
+    , end_(data + size)
+    , valid_(true) {
+}
+
+bool JournalPayloadReader::Take(void* out, size_t size) {
+    if (!valid_ || static_cast<size_t>(end_ - pos_) < size) {
+        valid_ = false;
+        return false;
+    }
+    std::memcpy(out, pos_, size);
+    pos_ += size;
+    return true;
+}
+
+int32_t JournalPayloadReader::GetInt() {
+    return static_cast<int32_t>(GetUInt());
+}
+
+uint32_t JournalPayloadReader::GetUInt() {
+    char bytes[4];
+    if (!Take(bytes, sizeof(bytes))) {
+        return 0;
+    }
+    return GetRaw<uint32_t>(bytes);
+}
+
+bool JournalPayloadReader::GetBool() {
+    char value = 0;
+    Take(&value, 1);
+    return value != 0;
+}
+
+std::wstring JournalPayloadReader::GetString() {
+    uint32_t length = GetUInt();
+    if (!valid_ || static_cast<size_t>(end_ - pos_) < length) {
+        valid_ = false;
+        return std::wstring();
+    }
+
+    std::wstring result = StringCodec::ToWide(std::string_view(pos_, length));
+    pos_ += length;
+    return result;
+}
+
+std::string JournalPayloadReader::GetBytes() {
+    uint32_t length = GetUInt();
+    if (!valid_ || static_cast<size_t>(end_ - pos_) < length) {
+        valid_ = false;
+        return std::string();
+    }
+
+    std::string result(pos_, length);
+    pos_ += length;
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// MutationJournal
+
+MutationJournal::MutationJournal()
+    : file_(nullptr)
+    , lastSequence_(0)
+    , recordCount_(0)
+    , fileSize_(0) {
+}
+
+MutationJournal::~MutationJournal() {
+    Close();
+}
+
+bool MutationJournal::Open(const std::wstring& filePath, uint64_t afterSequence,
+                           const ReplayCallback& callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    filePath_ = filePath;
+    lastSequence_ = afterSequence;
+    recordCount_ = 0;
+    fileSize_ = HEADER_SIZE;
+
+    std::string content;
+    bool exists = ReadWholeFile(filePath, content);
+
+    if (!exists || content.size() < HEADER_SIZE ||
+        std::memcmp(content.data(), JOURNAL_MAGIC, HEADER_SIZE) != 0) {
+        // 不存在或不是日誌檔：建立新檔
+        if (!Rewrite(std::string(JOURNAL_MAGIC, HEADER_SIZE))) {
+            return false;
+        }
+        return OpenForAppend();
+    }
+
+    size_t validEnd = ScanRecords(content, [&](const Record& record, size_t) {
+        ++recordCount_;
+        if (record.sequence > lastSequence_) {
+            lastSequence_ = record.sequence;
+        }
+        if (record.sequence > afterSequence && callback) {
+            callback(record);
+        }
+    });
+    fileSize_ = validEnd;
+
+    // 截掉不完整的檔尾
+    if (validEnd < content.size()) {
+        content.resize(validEnd);
+        if (!Rewrite(content)) {
+            return false;
+        }
+    }
+
+    return OpenForAppend();
+}
+
+void MutationJournal::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    // 關閉後不再對應任何檔案：DiscardThrough 不會重新建立檔案，Append 一律失敗，直到再次 Open
+    filePath_.clear();
+    lastSequence_ = 0;
+    recordCount_ = 0;
+    fileSize_ = 0;
+}
+
+bool MutationJournal::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_ != nullptr;
+}
+
+uint64_t MutationJournal::Append(uint16_t type, const JournalPayloadWriter& payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        return 0;
+    }
+
+    const std::string& data = payload.GetData();
+    if (data.size() > MAX_PAYLOAD_SIZE) {
+        return 0;
+    }
+
+    uint64_t sequence = lastSequence_ + 1;
+
+    std::string record;
+    record.reserve(RECORD_HEADER_SIZE + data.size());
+    PutRaw<uint32_t>(record, static_cast<uint32_t>(data.size()));
+    PutRaw<uint32_t>(record, 0);  // CRC 稍後填入
+    PutRaw<uint64_t>(record, sequence);
+    PutRaw<uint16_t>(record, type);
+    record += data;
+
+    uint32_t crc = Crc32(record.data() + 8, record.size() - 8);
+    for (size_t i = 0; i < 4; ++i) {
+        record[4 + i] = static_cast<char>((crc >> (8 * i)) & 0xFF);
+    }
+
+    // 交給作業系統快取即可，不強制落盤
+    if (std::fwrite(record.data(), 1, record.size(), file_) != record.size() ||
+        std::fflush(file_) != 0) {
+        return 0;
+    }
+
+    lastSequence_ = sequence;
+    ++recordCount_;
+    fileSize_ += record.size();
+    return sequence;
+}
+
+bool MutationJournal::DiscardThrough(uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (filePath_.empty()) {
+        return false;
+    }
+
+    std::string content(JOURNAL_MAGIC, HEADER_SIZE);
+    uint64_t remaining = 0;
+
+    if (lastSequence_ > sequence) {
+        // 快照之後又有新紀錄：保留序號較大的部分
+        if (file_) {
+            std::fflush(file_);
+        }
+
+        std::string existing;
+        if (!ReadWholeFile(filePath_, existing)) {
+            return false;
+        }
+
+        size_t keepFrom = std::string::npos;
+        size_t validEnd = ScanRecords(existing, [&](const Record& record, size_t offset) {
+            if (record.sequence > sequence) {
+                if (keepFrom == std::string::npos) {
+                    keepFrom = offset;
+                }
+                ++remaining;
+            }
+        });
+
+        if (keepFrom != std::string::npos) {
+            content.append(existing, keepFrom, validEnd - keepFrom);
+        }
+    } else if (recordCount_ == 0) {
+        return true;
+    }
+
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    if (!Rewrite(content)) {
+        OpenForAppend();
+        return false;
+    }
+
+    recordCount_ = remaining;
+    fileSize_ = content.size();
+    return OpenForAppend();
+}
+
+uint64_t MutationJournal::GetLastSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastSequence_;
+}
+
+uint64_t MutationJournal::GetRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recordCount_;
+}
+
+uint64_t MutationJournal::GetFileSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fileSize_;
+}
+
+bool MutationJournal::Rewrite(const std::string& content) {
+    return PersistenceWorker::WriteFileAtomic(filePath_, content);
+}
+
+bool MutationJournal::OpenForAppend() {
+    file_ = OpenFile(filePath_, "ab");
+    return file_ != nullptr;
+}
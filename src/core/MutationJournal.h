@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// 單筆紀錄的內容編碼（小端序整數、UTF-8 字串）
+class JournalPayloadWriter {
+public:
+    void PutInt(int32_t value);
+    void PutUInt(uint32_t value);
+    void PutBool(bool value);
+    void PutString(std::wstring_view value);
+    void PutBytes(std::string_view value);
+
+    const std::string& GetData() const { return data_; }
+
+private:
+    std::string data_;
+};
+
+class JournalPayloadReader {
+public:
+    JournalPayloadReader(const char* data, size_t size);
+
+    int32_t GetInt();
+    uint32_t GetUInt();
+    bool GetBool();
+    std::wstring GetString();
+    std::string GetBytes();
+
+    // 讀取過程中是否沒有越界
+    bool IsValid() const { return valid_; }
+
+private:
+    bool Take(void* out, size_t size);
+
+    const char* pos_;
+    const char* end_;
+    bool valid_;
+};
+
+// 只追加的變更日誌
+// 每筆紀錄：長度、CRC32、序號、類型、內容。狀態變更只追加一筆小紀錄，
+// 完整快照寫入後再以 DiscardThrough 捨棄已包含在快照中的紀錄。
+// 檔尾不完整或校驗失敗的紀錄（例如寫入中途當機）會在開啟時截掉。
+class MutationJournal {
+public:
+    struct Record {
+        uint64_t sequence;
+        uint16_t type;
+        const char* payload;
+        size_t payloadSize;
+    };
+
+    using ReplayCallback = std::function<void(const Record&)>;
+
+    // 單筆紀錄內容上限（超過的紀錄無法寫入，也用於辨識損毀的長度欄位）
+    static const uint32_t MAX_PAYLOAD_SIZE = 1024 * 1024;
+
+    MutationJournal();
+    ~MutationJournal();
+
+    MutationJournal(const MutationJournal&) = delete;
+    MutationJournal& operator=(const MutationJournal&) = delete;
+
+    // 開啟（不存在則建立）日誌，並依序回放序號大於 afterSequence 的紀錄
+    bool Open(const std::wstring& filePath, uint64_t afterSequence, const ReplayCallback& callback);
+
+    // 關閉日誌檔並清除路徑與序號（之後需再次 Open 才能追加）
+    void Close();
+
+    bool IsOpen() const;
+
+    // 追加一筆紀錄，回傳其序號（失敗或內容過大回傳 0）
+    uint64_t Append(uint16_t type, const JournalPayloadWriter& payload);
+
+    // 捨棄序號小於等於 sequence 的紀錄（快照寫入完成後呼叫，可在背景執行緒）
+    bool DiscardThrough(uint64_t sequence);
+
+    // 最後一筆紀錄的序號（沒有紀錄時為快照的序號）
+    uint64_t GetLastSequence() const;
+
+    // 目前日誌中的紀錄數量與檔案大小
+    uint64_t GetRecordCount() const;
+    uint64_t GetFileSize() const;
+
+private:
+    bool Rewrite(const std::string& content);
+    bool OpenForAppend();
+
+    mutable std::mutex mutex_;
+    std::wstring filePath_;
+    FILE* file_;
+    uint64_t lastSequence_;
+    uint64_t recordCount_;
+    uint64_t fileSize_;
+};
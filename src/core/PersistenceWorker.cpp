@@ -0,0 +1,169 @@
+#include "PersistenceWorker.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdio>
+#include <filesystem>
+#endif
+
+PersistenceWorker::PersistenceWorker(unsigned int debounceMs)
+    : debounce_(debounceMs)
+    , stopping_(false)
+    , flushRequested_(false)
+    , writing_(false)
+    , lastWriteOk_(true)
+    , writeCount_(0) {
+}
+
+PersistenceWorker::~PersistenceWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+
+    // 背景執行緒結束前會寫完所有待寫內容
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void PersistenceWorker::Submit(const std::wstring& filePath, std::string data, WrittenCallback onWritten) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PendingWrite& pending = pending_[filePath];
+        pending.data = std::move(data);
+        pending.onWritten = std::move(onWritten);
+        lastSubmit_ = std::chrono::steady_clock::now();
+
+        // 第一次提交時才啟動背景執行緒
+        if (!thread_.joinable()) {
+            thread_ = std::thread(&PersistenceWorker::ThreadProc, this);
+        }
+    }
+    wakeCondition_.notify_all();
+}
+
+bool PersistenceWorker::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!thread_.joinable()) {
+        return lastWriteOk_;
+    }
+
+    flushRequested_ = true;
+    wakeCondition_.notify_all();
+    idleCondition_.wait(lock, [this] { return pending_.empty() && !writing_; });
+    flushRequested_ = false;
+    return lastWriteOk_;
+}
+
+void PersistenceWorker::Discard(const std::wstring& filePath) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.erase(filePath);
+
+    // 等待進行中的寫入完成，避免刪除檔案後又被寫回
+    idleCondition_.wait(lock, [this] { return !writing_; });
+}
+
+uint64_t PersistenceWorker::GetWriteCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writeCount_;
+}
+
+void PersistenceWorker::ThreadProc() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;) {
+        wakeCondition_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+
+        if (pending_.empty()) {
+            // stopping_ 且沒有待寫內容
+            break;
+        }
+
+        // 等待提交停止一段時間，把連續的變更合併成一次寫入
+        while (!stopping_ && !flushRequested_) {
+            auto deadline = lastSubmit_ + debounce_;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+            wakeCondition_.wait_until(lock, deadline);
+        }
+
+        std::map<std::wstring, PendingWrite> batch;
+        batch.swap(pending_);
+        writing_ = true;
+        lock.unlock();
+
+        bool ok = true;
+        for (const auto& item : batch) {
+            bool written = WriteFileAtomic(item.first, item.second.data);
+            if (!written) {
+                ok = false;
+            }
+            if (item.second.onWritten) {
+                item.second.onWritten(written);
+            }
+        }
+
+        lock.lock();
+        writing_ = false;
+        lastWriteOk_ = ok;
+        writeCount_ += batch.size();
+        idleCondition_.notify_all();
+    }
+
+    idleCondition_.notify_all();
+}
+
+bool PersistenceWorker::WriteFileAtomic(const std::wstring& filePath, const std::string& data) {
+    std::wstring tempPath = filePath + L".tmp";
+
+#ifdef _WIN32
+    HANDLE hFile = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr,
+                               CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    DWORD written = 0;
+    BOOL ok = WriteFile(hFile, data.data(), static_cast<DWORD>(data.size()), &written, nullptr);
+    ok = ok && written == data.size() && FlushFileBuffers(hFile);
+    CloseHandle(hFile);
+
+    if (!ok) {
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+
+    if (!MoveFileExW(tempPath.c_str(), filePath.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+    return true;
+#else
+    std::filesystem::path target(filePath);
+    std::filesystem::path temp(tempPath);
+
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = (std::fflush(file) == 0) && ok;
+    ok = (std::fclose(file) == 0) && ok;
+
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(temp, target, ec);
+    }
+    if (!ok || ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+#endif
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 背景寫入服務（write-behind）
+// Widget 在狀態變更時提交序列化好的內容，同一路徑在短時間內的多次提交
+// 只保留最新一份，由背景執行緒合併成一次寫入。寫入採「先寫暫存檔再改名」，
+// 確保設定檔不會因中途失敗而只寫了一半。
+class PersistenceWorker {
+public:
+    // debounceMs：最後一次提交後等待多久才寫入
+    explicit PersistenceWorker(unsigned int debounceMs = 300);
+    ~PersistenceWorker();
+
+    PersistenceWorker(const PersistenceWorker&) = delete;
+    PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+    // 寫入完成後的通知（在背景執行緒呼叫，參數為是否成功）
+    using WrittenCallback = std::function<void(bool)>;
+
+    // 提交要寫入的內容（取代同一路徑尚未寫入的舊內容，舊內容的通知一併捨棄）
+    void Submit(const std::wstring& filePath, std::string data, WrittenCallback onWritten = nullptr);
+
+    // 立即寫入所有待寫內容並等待完成；任一寫入失敗則回傳 false
+    bool Flush();
+
+    // 捨棄指定路徑尚未寫入的內容（例如設定檔即將被刪除）
+    void Discard(const std::wstring& filePath);
+
+    // 已完成的實際寫入次數
+    uint64_t GetWriteCount() const;
+
+    // 以「先寫暫存檔再改名」的方式寫入整個檔案
+    static bool WriteFileAtomic(const std::wstring& filePath, const std::string& data);
+
+private:
+    struct PendingWrite {
+        std::string data;
+        WrittenCallback onWritten;
+    };
+
+    void ThreadProc();
+
+    std::chrono::milliseconds debounce_;
+    mutable std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable idleCondition_;
+    std::map<std::wstring, PendingWrite> pending_;
+    std::chrono::steady_clock::time_point lastSubmit_;
+    std::thread thread_;
+    bool stopping_;
+    bool flushRequested_;
+    bool writing_;
+    bool lastWriteOk_;
+    uint64_t writeCount_;
+};
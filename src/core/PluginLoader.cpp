@@ -37,6 +37,7 @@ bool PluginLoader::LoadPlugin(const std::wstring& dllPath, PluginInfo& outInfo)
 
     // 取得必要的函式指標
     auto createFunc = (CreateWidgetFunc)GetProcAddress(hModule, "CreateWidget");
+    auto createExFunc = (CreateWidgetExFunc)GetProcAddress(hModule, "CreateWidgetEx");
     auto destroyFunc = (DestroyWidgetFunc)GetProcAddress(hModule, "DestroyWidget");
     auto getNameFunc = (const wchar_t*(*)())GetProcAddress(hModule, "GetWidgetName");
     auto getVersionFunc = (const wchar_t*(*)())GetProcAddress(hModule, "GetWidgetVersion");
@@ -54,6 +55,7 @@ bool PluginLoader::LoadPlugin(const std::wstring& dllPath, PluginInfo& outInfo)
     outInfo.version = getVersionFunc();
     outInfo.hModule = hModule;
     outInfo.createFunc = createFunc;
+    outInfo.createExFunc = createExFunc;  // 可能為 nullptr（舊版 Widget 不支持）
     outInfo.destroyFunc = destroyFunc;
     outInfo.executeCommandFunc = executeCommandFunc;  // 可能為 nullptr（舊版 Widget 不支持）
     outInfo.widgetInstance = nullptr;
@@ -74,13 +76,14 @@ void PluginLoader::UnloadPlugin(PluginInfo& plugin) {
     }
 }
 
-std::shared_ptr<IWidget> PluginLoader::CreateWidgetInstance(PluginInfo& plugin, void* params) {
+std::shared_ptr<IWidget> PluginLoader::CreateWidgetInstance(PluginInfo& plugin, const WidgetCreateParams& params) {
     if (!plugin.createFunc) {
         return nullptr;
     }
 
-    // 創建 Widget 實例
-    IWidget* widget = plugin.createFunc(params);
+    // 創建 Widget 實例（舊版插件把 CreateWidget 的參數當作 HINSTANCE* 讀取）
+    HINSTANCE hInstance = params.hInstance;
+    IWidget* widget = plugin.createExFunc ? plugin.createExFunc(&params) : plugin.createFunc(&hInstance);
     if (!widget) {
         return nullptr;
     }
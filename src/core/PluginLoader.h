@@ -12,6 +12,7 @@ struct PluginInfo {
     std::wstring version;
     HMODULE hModule;
     CreateWidgetFunc createFunc;
+    CreateWidgetExFunc createExFunc;    // 可能為 nullptr（舊版 Widget 不支持）
     DestroyWidgetFunc destroyFunc;
     ExecuteCommandFunc executeCommandFunc;
     std::shared_ptr<IWidget> widgetInstance;
@@ -28,8 +29,8 @@ public:
     // 卸載 DLL
     static void UnloadPlugin(PluginInfo& plugin);
 
-    // 創建 Widget 實例
-    static std::shared_ptr<IWidget> CreateWidgetInstance(PluginInfo& plugin, void* params = nullptr);
+    // 創建 Widget 實例（插件沒有 CreateWidgetEx 時只傳 hInstance 給 CreateWidget）
+    static std::shared_ptr<IWidget> CreateWidgetInstance(PluginInfo& plugin, const WidgetCreateParams& params);
 
     // 銷毀 Widget 實例
     static void DestroyWidgetInstance(PluginInfo& plugin);
@@ -0,0 +1,433 @@
+#include "StringCodec.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define STRING_CODEC_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+// 每個寬字元最多輸出的位元組數
+const size_t MAX_UTF8_PER_UNIT = sizeof(wchar_t) == 2 ? 3 : 4;
+const size_t MAX_ESCAPED_PER_UNIT = 6;  // \u00XX
+
+char* PutUtf8(char* out, uint32_t cp) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+void AppendUtf8CodePoint(std::string& out, uint32_t cp) {
+    char bytes[4];
+    out.append(bytes, static_cast<size_t>(PutUtf8(bytes, cp) - bytes));
+}
+
+wchar_t* PutWide(wchar_t* out, uint32_t cp) {
+    if (sizeof(wchar_t) == 2 && cp >= 0x10000) {
+        cp -= 0x10000;
+        *out++ = static_cast<wchar_t>(0xD800 + (cp >> 10));
+        *out++ = static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+    } else {
+        *out++ = static_cast<wchar_t>(cp);
+    }
+    return out;
+}
+
+// 編碼一個寬字元（含代理對與轉義），p 前進到下一個字元
+char* EncodeOne(char* out, const wchar_t*& p, const wchar_t* end, bool escapeJson) {
+    uint32_t c = static_cast<uint32_t>(*p++);
+
+    if (c < 0x80) {
+        if (escapeJson) {
+            if (c == '"' || c == '\\') {
+                *out++ = '\\';
+            } else if (c < 0x20) {
+                *out++ = '\\';
+                switch (c) {
+                case '\n': *out++ = 'n'; return out;
+                case '\r': *out++ = 'r'; return out;
+                case '\t': *out++ = 't'; return out;
+                default:
+                    *out++ = 'u';
+                    *out++ = '0';
+                    *out++ = '0';
+                    *out++ = HEX_DIGITS[c >> 4];
+                    *out++ = HEX_DIGITS[c & 0xF];
+                    return out;
+                }
+            }
+        }
+        *out++ = static_cast<char>(c);
+        return out;
+    }
+
+    // UTF-16 代理對（wchar_t 為 2 位元組時）
+    if (c >= 0xD800 && c <= 0xDBFF && p < end) {
+        uint32_t lo = static_cast<uint32_t>(*p);
+        if (lo >= 0xDC00 && lo <= 0xDFFF) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+            ++p;
+        }
+    }
+    if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+        c = 0xFFFD;  // 不成對的代理字元或超出範圍
+    }
+    return PutUtf8(out, c);
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 讀取 \uXXXX 的四位十六進位數字，失敗回傳 -1
+long ReadHex4(const char* p, const char* end) {
+    if (end - p < 4) return -1;
+    long value = 0;
+    for (int i = 0; i < 4; ++i) {
+        int h = HexValue(p[i]);
+        if (h < 0) return -1;
+        value = (value << 4) | h;
+    }
+    return value;
+}
+
+// 解碼一個 UTF-8 字元，p 前進到下一個字元；無效序列回傳 U+FFFD
+uint32_t DecodeUtf8(const char*& p, const char* end) {
+    unsigned char c = static_cast<unsigned char>(*p++);
+    if (c < 0x80) {
+        return c;
+    }
+
+    int extra = 0;
+    uint32_t cp = 0;
+    if ((c & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = c & 0x07;
+    } else {
+        return 0xFFFD;
+    }
+
+    if (end - p < extra) {
+        p = end;
+        return 0xFFFD;
+    }
+
+    for (int i = 0; i < extra; ++i) {
+        unsigned char cc = static_cast<unsigned char>(*p);
+        if ((cc & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (cc & 0x3F);
+        ++p;
+    }
+    return cp;
+}
+
+// 解析一個轉義序列（p 指向反斜線之後），回傳 code point；失敗回傳 U+FFFD
+uint32_t DecodeEscape(const char*& p, const char* end) {
+    if (p >= end) {
+        return 0xFFFD;
+    }
+
+    char c = *p++;
+    switch (c) {
+    case '"':  return '"';
+    case '\\': return '\\';
+    case '/':  return '/';
+    case 'b':  return '\b';
+    case 'f':  return '\f';
+    case 'n':  return '\n';
+    case 'r':  return '\r';
+    case 't':  return '\t';
+    case 'u': {
+        long hi = ReadHex4(p, end);
+        if (hi < 0) return 0xFFFD;
+        p += 4;
+
+        // 代理對（surrogate pair）
+        if (hi >= 0xD800 && hi <= 0xDBFF) {
+            if (end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                long lo = ReadHex4(p + 2, end);
+                if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                    p += 6;
+                    return 0x10000 + ((static_cast<uint32_t>(hi) - 0xD800) << 10) +
+                           (static_cast<uint32_t>(lo) - 0xDC00);
+                }
+            }
+            return 0xFFFD;
+        }
+        return static_cast<uint32_t>(hi);
+    }
+    default:
+        return 0xFFFD;
+    }
+}
+
+#ifdef STRING_CODEC_SSE2
+
+// 載入 8 個寬字元為 8 個 16 位元值
+// wchar_t 為 4 位元組時另以 outsideBmp 回報是否有超出 U+FFFF 的值（此時回傳值無意義）。
+// SSE2 只有有號飽和壓縮：先減去 0x8000 移到有號範圍再壓縮，之後翻轉最高位元還原，
+// 否則 U+8000 以上（含代理字元）會被飽和成 0x7FFF
+inline __m128i LoadWide8(const wchar_t* p, bool& outsideBmp) {
+    if (sizeof(wchar_t) == 2) {
+        outsideBmp = false;
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4));
+    __m128i upper = _mm_or_si128(_mm_srli_epi32(lo, 16), _mm_srli_epi32(hi, 16));
+    outsideBmp = _mm_movemask_epi8(_mm_cmpeq_epi32(upper, _mm_setzero_si128())) != 0xFFFF;
+
+    const __m128i bias = _mm_set1_epi32(0x8000);
+    __m128i packed = _mm_packs_epi32(_mm_sub_epi32(lo, bias), _mm_sub_epi32(hi, bias));
+    return _mm_xor_si128(packed, _mm_set1_epi16(static_cast<short>(0x8000)));
+}
+
+// 8 個字元是否都在 U+0800..U+FFFF 且不是代理字元（每個固定編碼為 3 個位元組，常見於中日韓文字）
+inline bool IsThreeByteWide8(__m128i v) {
+    __m128i top = _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800)));
+    __m128i bad = _mm_or_si128(_mm_cmpeq_epi16(top, _mm_setzero_si128()),
+                               _mm_cmpeq_epi16(top, _mm_set1_epi16(static_cast<short>(0xD800))));
+    return _mm_movemask_epi8(bad) == 0;
+}
+
+// 8 個字元是否都是可直接輸出的 ASCII（轉義時另需排除引號、反斜線與控制字元）
+inline bool IsPlainWide8(__m128i v, bool escapeJson) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80))), zero);
+    if (escapeJson) {
+        __m128i special = _mm_or_si128(
+            _mm_cmplt_epi16(v, _mm_set1_epi16(0x20)),
+            _mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16('"')),
+                         _mm_cmpeq_epi16(v, _mm_set1_epi16('\\'))));
+        ascii = _mm_andnot_si128(special, ascii);
+    }
+    return _mm_movemask_epi8(ascii) == 0xFFFF;
+}
+
+// 16 個位元組中需要逐字處理的位元組（非 ASCII；還原轉義時另含反斜線）
+inline unsigned SpecialBytesMask16(__m128i v, bool unescapeJson) {
+    int mask = _mm_movemask_epi8(v);  // 最高位元 = 非 ASCII
+    if (unescapeJson) {
+        mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    }
+    return static_cast<unsigned>(mask);
+}
+
+// 最低位元 1 的位置（mask 不可為 0）
+inline int LowestSetBit(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// 將 16 個 ASCII 位元組展開為寬字元
+inline void StoreWide16(wchar_t* out, __m128i v) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(v, zero);
+    __m128i hi = _mm_unpackhi_epi8(v, zero);
+    if (sizeof(wchar_t) == 2) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), hi);
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+}
+
+#endif
+
+} // namespace
+
+void StringCodec::AppendUtf8(std::string& out, std::wstring_view text, bool escapeJson) {
+    if (text.empty()) {
+        return;
+    }
+
+    // 直接以指標寫入；先依純 ASCII 的長度配置，空間不足時再加倍
+    // （一次配置最壞情況的 6 倍會讓 resize 的清零成本蓋過轉碼本身）
+    const size_t maxPerUnit = escapeJson ? MAX_ESCAPED_PER_UNIT : MAX_UTF8_PER_UNIT;
+    const size_t blockReserve = 8 * maxPerUnit + MAX_UTF8_PER_UNIT;  // 一段 8 字元（含跨段的代理對）
+
+    size_t start = out.size();
+    out.resize(start + text.size() + blockReserve);
+    char* dst = &out[start];
+    char* dstEnd = &out[0] + out.size();
+
+    const wchar_t* p = text.data();
+    const wchar_t* end = p + text.size();
+
+    auto ensure = [&]() {
+        if (static_cast<size_t>(dstEnd - dst) < blockReserve) {
+            size_t used = static_cast<size_t>(dst - out.data());
+            size_t remaining = static_cast<size_t>(end - p);
+            out.resize(used + (std::max)(used - start, remaining) + remaining + blockReserve);
+            dst = &out[0] + used;
+            dstEnd = &out[0] + out.size();
+        }
+    };
+
+#ifdef STRING_CODEC_SSE2
+    while (end - p >= 8) {
+        ensure();
+
+        bool outsideBmp;
+        __m128i v = LoadWide8(p, outsideBmp);
+        if (!outsideBmp) {
+            if (IsPlainWide8(v, escapeJson)) {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(v, v));
+                dst += 8;
+                p += 8;
+                continue;
+            }
+            if (IsThreeByteWide8(v)) {
+                for (int i = 0; i < 8; ++i) {
+                    uint32_t c = static_cast<uint32_t>(p[i]);
+                    dst[0] = static_cast<char>(0xE0 | (c >> 12));
+                    dst[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    dst[2] = static_cast<char>(0x80 | (c & 0x3F));
+                    dst += 3;
+                }
+                p += 8;
+                continue;
+            }
+        }
+
+        // 含特殊字元：逐字處理這一段（代理對可能跨出段尾，以指標為準）
+        const wchar_t* blockEnd = p + 8;
+        while (p < blockEnd) {
+            dst = EncodeOne(dst, p, end, escapeJson);
+        }
+    }
+#endif
+
+    while (p < end) {
+        ensure();
+        dst = EncodeOne(dst, p, end, escapeJson);
+    }
+
+    out.resize(static_cast<size_t>(dst - out.data()));
+}
+
+void StringCodec::AppendWide(std::wstring& out, std::string_view text, bool unescapeJson) {
+    if (text.empty()) {
+        return;
+    }
+
+    // 每個位元組最多產生一個寬字元
+    size_t start = out.size();
+    out.resize(start + text.size());
+    wchar_t* dst = &out[start];
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    auto decodeOne = [&]() {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '\\' && unescapeJson) {
+            ++p;
+            dst = PutWide(dst, DecodeEscape(p, end));
+        } else if (c < 0x80) {
+            *dst++ = static_cast<wchar_t>(c);
+            ++p;
+        } else {
+            dst = PutWide(dst, DecodeUtf8(p, end));
+        }
+    };
+
+#ifdef STRING_CODEC_SSE2
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned special = SpecialBytesMask16(v, unescapeJson);
+        if (special == 0) {
+            StoreWide16(dst, v);
+            dst += 16;
+            p += 16;
+            continue;
+        }
+
+        // 先整段展開第一個特殊位元組之前的 ASCII（多寫的部分會被後面覆寫，
+        // 剩餘輸入至少 16 個位元組，輸出空間足夠），再逐字處理該字元
+        int plain = LowestSetBit(special);
+        StoreWide16(dst, v);
+        dst += plain;
+        p += plain;
+        decodeOne();
+    }
+#endif
+
+    while (p < end) {
+        decodeOne();
+    }
+
+    out.resize(static_cast<size_t>(dst - out.data()));
+}
+
+void StringCodec::AppendUnescaped(std::string& out, std::string_view text) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        // 複製一段連續的非轉義內容
+        const char* run = p;
+        p = static_cast<const char*>(std::memchr(p, '\\', static_cast<size_t>(end - p)));
+        if (!p) {
+            p = end;
+        }
+        out.append(run, static_cast<size_t>(p - run));
+
+        if (p < end) {
+            ++p;  // 反斜線
+            AppendUtf8CodePoint(out, DecodeEscape(p, end));
+        }
+    }
+}
+
+std::string StringCodec::ToUtf8(std::wstring_view text) {
+    std::string out;
+    AppendUtf8(out, text);
+    return out;
+}
+
+std::wstring StringCodec::ToWide(std::string_view text) {
+    std::wstring out;
+    AppendWide(out, text);
+    return out;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// 字串編解碼：寬字串（UTF-16 / UTF-32）與 UTF-8 互轉，可在同一次掃描中做 JSON 轉義或還原
+// 以 SSE2 一次檢查 8 個寬字元（解碼時 16 個位元組），整段都是不需處理的 ASCII 時
+// 直接整段轉寫；只有含特殊字元或非 ASCII 的區段才逐字處理。
+// 所有設定檔寫入器（JSON、二進位佈局、變更日誌、共用儲存的鍵）都使用這裡的實作。
+class StringCodec {
+public:
+    // 轉為 UTF-8 附加到 out；escapeJson 為 true 時同時轉義引號、反斜線與控制字元（不含前後引號）
+    static void AppendUtf8(std::string& out, std::wstring_view text, bool escapeJson = false);
+
+    // 將 UTF-8 解碼後附加到 out；unescapeJson 為 true 時同時還原 JSON 轉義，
+    // 為 false 時反斜線原樣保留；無效序列解碼為 U+FFFD
+    static void AppendWide(std::wstring& out, std::string_view text, bool unescapeJson = false);
+
+    // 只還原 JSON 轉義，內容維持 UTF-8
+    static void AppendUnescaped(std::string& out, std::string_view text);
+
+    static std::string ToUtf8(std::wstring_view text);
+    static std::wstring ToWide(std::string_view text);
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <windows.h>
+#include <cstddef>
+
 // Widget DLL 導出宏
 #ifdef _WIN32
     #ifdef WIDGET_EXPORTS
@@ -13,7 +16,22 @@
 
 // Widget 工廠函式類型定義
 class IWidget;
+class IWidgetStorage;
+
+// CreateWidgetEx 的參數
+// 主程式填入 cbSize = sizeof(WidgetCreateParams)；插件只讀取 cbSize 涵蓋的欄位（見 HasField），
+// 之後新增的欄位一律加在最後。CreateWidget(void*) 維持舊的約定：params 是 HINSTANCE*。
+struct WidgetCreateParams {
+    DWORD cbSize;
+    HINSTANCE hInstance;
+    IWidgetStorage* storage;   // 主程式提供的共用儲存服務（可能為 nullptr）
+
+    // 主程式傳入的結構是否包含 [offset, offset + size) 的欄位
+    bool HasField(size_t offset, size_t size) const { return cbSize >= offset + size; }
+};
+
 typedef IWidget* (*CreateWidgetFunc)(void* params);
+typedef IWidget* (*CreateWidgetExFunc)(const WidgetCreateParams* params);
 typedef void (*DestroyWidgetFunc)(IWidget* widget);
 typedef void (*ExecuteCommandFunc)(IWidget* widget, int commandId);
 
@@ -21,9 +39,10 @@ typedef void (*ExecuteCommandFunc)(IWidget* widget, int commandId);
 #define WIDGET_CMD_CREATE_NEW       1001
 #define WIDGET_CMD_CLEAR_ALL_DATA   1002
 
-// 每個 Widget DLL 必須導出這些函式
+// 每個 Widget DLL 必須導出這些函式（CreateWidgetEx 可省略，主程式改呼叫 CreateWidget）
 extern "C" {
     WIDGET_API IWidget* CreateWidget(void* params);
+    WIDGET_API IWidget* CreateWidgetEx(const WidgetCreateParams* params);
     WIDGET_API void DestroyWidget(IWidget* widget);
     WIDGET_API const wchar_t* GetWidgetName();
     WIDGET_API const wchar_t* GetWidgetVersion();
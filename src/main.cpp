@@ -1,5 +1,7 @@
 #include "core/WidgetManager.h"
 #include "core/PluginLoader.h"
+#include "core/FileWidgetStorage.h"
+#include "core/StringCodec.h"
 #include <windows.h>
 #include <iostream>
 #include <memory>
@@ -21,66 +23,79 @@ const wchar_t* APP_NAME = L"DesktopWidgetManager";
 // Control window procedure
 LRESULT CALLBACK ControlWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
-// Widget 狀態儲存/載入
-std::wstring GetWidgetStateConfigPath() {
+// 共用儲存服務（所有 Widget 共用同一個檔案與句柄）
+FileWidgetStorage g_storage;
+
+// Widget 啟用狀態的鍵前綴
+const char* WIDGET_STATE_PREFIX = "DesktopWidgetManager/enabled/";
+
+std::wstring GetConfigDirectory() {
     wchar_t appDataPath[MAX_PATH];
     if (SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appDataPath))) {
         std::wstring configDir = std::wstring(appDataPath) + L"\\FencesWidget";
         CreateDirectoryW(configDir.c_str(), nullptr);
-        return configDir + L"\\widget_states.conf";
+        return configDir;
     }
     return L"";
 }
 
-void SaveWidgetStates(WidgetManager& manager) {
-    std::wstring configPath = GetWidgetStateConfigPath();
-    if (configPath.empty()) return;
-
-    std::wofstream file(configPath);
-    if (!file.is_open()) return;
+std::string GetWidgetStateKey(const std::wstring& widgetName) {
+    std::string key = WIDGET_STATE_PREFIX;
+    StringCodec::AppendUtf8(key, widgetName);
+    return key;
+}
 
+// Widget 狀態儲存/載入
+void SaveWidgetStates(WidgetManager& manager) {
+    WidgetStorageBatch batch;
     for (const auto& plugin : g_loadedPlugins) {
         bool isEnabled = manager.IsWidgetEnabled(plugin.name);
-        file << plugin.name << L"=" << (isEnabled ? L"1" : L"0") << L"\n";
+        batch.Put(GetWidgetStateKey(plugin.name), isEnabled ? "1" : "0");
     }
-    file.close();
+    g_storage.Commit(batch);
 }
 
-void LoadWidgetStates(WidgetManager& manager) {
-    std::wstring configPath = GetWidgetStateConfigPath();
-    if (configPath.empty()) return;
-
-    std::wifstream file(configPath);
+// 匯入舊版 widget_states.conf（每行 名稱=0/1），成功後刪除舊檔
+void ImportLegacyWidgetStates(const std::wstring& configDir) {
+    std::wstring legacyPath = configDir + L"\\widget_states.conf";
+    std::wifstream file(legacyPath);
     if (!file.is_open()) return;
 
+    WidgetStorageBatch batch;
     std::wstring line;
     while (std::getline(file, line)) {
         size_t pos = line.find(L'=');
         if (pos != std::wstring::npos) {
-            std::wstring widgetName = line.substr(0, pos);
-            std::wstring stateStr = line.substr(pos + 1);
+            batch.Put(GetWidgetStateKey(line.substr(0, pos)), line.substr(pos + 1) == L"1" ? "1" : "0");
+        }
+    }
+    file.close();
+
+    if (g_storage.Commit(batch)) {
+        DeleteFileW(legacyPath.c_str());
+    }
+}
 
-            bool shouldEnable = (stateStr == L"1");
+// 回傳是否有保存過的狀態
+bool LoadWidgetStates(WidgetManager& manager) {
+    bool hasSavedState = false;
 
-            // 檢查該 Widget 是否已載入
-            bool widgetExists = false;
-            for (const auto& plugin : g_loadedPlugins) {
-                if (plugin.name == widgetName) {
-                    widgetExists = true;
-                    break;
-                }
-            }
+    // 只查詢已載入的 Widget（快取內的有序表查詢）
+    for (const auto& plugin : g_loadedPlugins) {
+        std::string state;
+        if (!g_storage.Get(GetWidgetStateKey(plugin.name), state)) {
+            continue;
+        }
 
-            if (widgetExists) {
-                if (shouldEnable) {
-                    manager.EnableWidget(widgetName);
-                } else {
-                    manager.DisableWidget(widgetName);
-                }
-            }
+        hasSavedState = true;
+        if (state == "1") {
+            manager.EnableWidget(plugin.name);
+        } else {
+            manager.DisableWidget(plugin.name);
         }
     }
-    file.close();
+
+    return hasSavedState;
 }
 
 // Check if auto-start is enabled
@@ -408,30 +423,34 @@ int WINAPI wWinMain(
     GetModuleFileNameW(nullptr, exePath, MAX_PATH);
     std::filesystem::path exeDir = std::filesystem::path(exePath).parent_path();
 
+    // 開啟共用儲存（一次讀入所有 Widget 的設定）
+    std::wstring configDir = GetConfigDirectory();
+    if (!configDir.empty() && g_storage.Open(configDir + L"\\widgets.store")) {
+        ImportLegacyWidgetStates(configDir);
+    }
+
     g_loadedPlugins = PluginLoader::ScanPlugins(exeDir.wstring());
 
     // 為每個插件創建 Widget 實例並註冊
+    WidgetCreateParams createParams = {};
+    createParams.cbSize = sizeof(WidgetCreateParams);
+    createParams.hInstance = hInstance;
+    createParams.storage = g_storage.IsOpen() ? &g_storage : nullptr;
     for (auto& plugin : g_loadedPlugins) {
-        auto widgetInstance = PluginLoader::CreateWidgetInstance(plugin, &hInstance);
+        auto widgetInstance = PluginLoader::CreateWidgetInstance(plugin, createParams);
         if (widgetInstance) {
             manager.RegisterWidget(widgetInstance);
         }
     }
 
-    // 載入上次保存的 Widget 狀態（如果沒有配置則全部啟用）
-    LoadWidgetStates(manager);
-
-    // 如果是第一次運行（沒有配置檔案），預設啟用所有 Widget
-    std::wstring configPath = GetWidgetStateConfigPath();
-    std::wifstream testFile(configPath);
-    if (!testFile.is_open()) {
-        // 首次運行，啟用所有 Widget
+    // 載入上次保存的 Widget 狀態
+    if (!LoadWidgetStates(manager)) {
+        // 首次運行（沒有保存過的狀態），啟用所有 Widget
         for (auto& plugin : g_loadedPlugins) {
             manager.EnableWidget(plugin.name);
         }
         SaveWidgetStates(manager);
     }
-    testFile.close();
 
     // Message loop
     MSG msg;
@@ -0,0 +1,95 @@
+#include "TestSupport.h"
+#include "widgets/BackBufferPolicy.h"
+#include <cstdint>
+
+namespace {
+
+int64_t GetPixels(const BackBufferPolicy::Extent& extent) {
+    return (int64_t)extent.width * extent.height;
+}
+
+} // namespace
+
+TEST_CASE(CapacityAddsHeadroomAndAligns) {
+    BackBufferPolicy::Extent capacity = BackBufferPolicy::GetCapacity(100, 1000);
+    CHECK(capacity.width == 128);       // 100 + 25 = 125，對齊到 128
+    CHECK(capacity.height == 1280);     // 1000 + 250 = 1250，對齊到 1280
+
+    capacity = BackBufferPolicy::GetCapacity(1920, 1080);
+    CHECK(capacity.width == 2432);
+    CHECK(capacity.height == 1408);
+
+    for (int32_t size = 0; size < 3000; size += 7) {
+        capacity = BackBufferPolicy::GetCapacity(size, size);
+        CHECK(capacity.width % BackBufferPolicy::ALIGNMENT == 0);
+        CHECK(capacity.width >= size + size / 4);
+        CHECK(capacity.width > 0);      // 空的視窗也配置一格
+    }
+}
+
+TEST_CASE(GrowingBeyondCapacityReallocates) {
+    BackBufferPolicy::Extent capacity = BackBufferPolicy::GetCapacity(400, 300);
+    CHECK(!BackBufferPolicy::NeedsReallocation(capacity, 400, 300));
+    CHECK(!BackBufferPolicy::NeedsReallocation(capacity, capacity.width, capacity.height));
+    CHECK(BackBufferPolicy::NeedsReallocation(capacity, capacity.width + 1, 300));
+    CHECK(BackBufferPolicy::NeedsReallocation(capacity, 400, capacity.height + 1));
+}
+
+TEST_CASE(ResizeDragWithinCapacityDoesNotReallocate) {
+    // 拖曳調整大小：每次只差幾個像素，在預留空間內不重新配置
+    BackBufferPolicy::Extent capacity = BackBufferPolicy::GetCapacity(800, 600);
+    int reallocations = 0;
+    for (int32_t step = 0; step < 200; ++step) {
+        int32_t width = 800 + step;
+        int32_t height = 600 + step / 2;
+        if (BackBufferPolicy::NeedsReallocation(capacity, width, height)) {
+            capacity = BackBufferPolicy::GetCapacity(width, height);
+            ++reallocations;
+        }
+    }
+    CHECK(reallocations == 0);
+
+    // 縮小到容量以內也不重新配置
+    for (int32_t step = 0; step < 200; ++step) {
+        CHECK(!BackBufferPolicy::NeedsReallocation(capacity, 800 - step, 600 - step));
+    }
+}
+
+TEST_CASE(SmallBuffersNeverShrink) {
+    // 容量不超過 SHRINK_MIN_PIXELS 時，縮到多小都保留（收合 / 展開柵欄）
+    BackBufferPolicy::Extent capacity = { 512, 512 };
+    CHECK(!BackBufferPolicy::NeedsReallocation(capacity, 1, 1));
+    CHECK(!BackBufferPolicy::NeedsReallocation(capacity, 0, 0));
+
+    capacity = { 1024, 1024 };
+    CHECK(GetPixels(capacity) == BackBufferPolicy::SHRINK_MIN_PIXELS);
+    CHECK(!BackBufferPolicy::NeedsReallocation(capacity, 1, 1));
+}
+
+TEST_CASE(LargeBuffersShrinkOnlyWhenMoreThanFourTimesTooBig) {
+    BackBufferPolicy::Extent capacity = BackBufferPolicy::GetCapacity(1920, 1080);
+    CHECK(GetPixels(capacity) > BackBufferPolicy::SHRINK_MIN_PIXELS);
+
+    // 1200 × 600 重新配置後為 1536 × 768，4 倍仍大於目前容量：保留
+    CHECK(!BackBufferPolicy::NeedsReallocation(capacity, 1200, 600));
+    // 1000 × 500 重新配置後為 1280 × 640，4 倍小於目前容量：縮小
+    CHECK(BackBufferPolicy::NeedsReallocation(capacity, 1000, 500));
+    CHECK(BackBufferPolicy::NeedsReallocation(capacity, 1, 1));
+
+    // 縮小後的容量立刻又判定為合適
+    BackBufferPolicy::Extent shrunk = BackBufferPolicy::GetCapacity(1000, 500);
+    CHECK(!BackBufferPolicy::NeedsReallocation(shrunk, 1000, 500));
+}
+
+TEST_CASE(FreshCapacityIsNeverTooBig) {
+    for (int32_t width = 1; width < 4000; width += 97) {
+        for (int32_t height = 1; height < 4000; height += 131) {
+            BackBufferPolicy::Extent capacity = BackBufferPolicy::GetCapacity(width, height);
+            CHECK(!BackBufferPolicy::NeedsReallocation(capacity, width, height));
+        }
+    }
+}
+
+int main() {
+    return test::RunAll();
+}
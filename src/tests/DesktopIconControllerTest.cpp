@@ -0,0 +1,192 @@
+#include "TestSupport.h"
+#include "widgets/DesktopIconController.h"
+#include "widgets/SimulatedDesktopIconHost.h"
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const int ITEM_COUNT = 1000;
+
+// 柵欄保存的是完整路徑，桌面只顯示不含副檔名的名稱
+std::wstring PathOf(int index) {
+    wchar_t number[16];
+    swprintf(number, sizeof(number) / sizeof(number[0]), L"%05d", index);
+    return std::wstring(L"C:\\Users\\me\\Desktop\\item") + number + L".lnk";
+}
+
+std::vector<std::wstring> PathsOf(int first, int count) {
+    std::vector<std::wstring> paths;
+    for (int i = first; i < first + count; ++i) {
+        paths.push_back(PathOf(i));
+    }
+    return paths;
+}
+
+bool IsHidden(const SimulatedDesktopIconHost& host, int index) {
+    DesktopIconPoint position = host.GetItems()[index].position;
+    return position.x == DesktopIconController::HIDDEN_POSITION.x &&
+           position.y == DesktopIconController::HIDDEN_POSITION.y;
+}
+
+} // namespace
+
+TEST_CASE(HideReadsNamesOnceAndBatchesRedraw) {
+    SimulatedDesktopIconHost host;
+    host.Populate(ITEM_COUNT);
+    DesktopIconController controller(host);
+
+    // 第一批：讀一次名稱快照，之後每個圖示一次 SetItemPosition，重繪只暫停一次
+    CHECK(controller.Hide(PathsOf(0, 10)) == 10);
+    const auto& counts = host.GetCallCounts();
+    CHECK(counts.connect == 1);
+    CHECK(counts.itemCount == 1);
+    CHECK(counts.itemText == (uint64_t)ITEM_COUNT);
+    CHECK(counts.positionQueries == 0);
+    CHECK(counts.setPosition == 10);
+    CHECK(counts.beginUpdate == 1);
+    CHECK(counts.endUpdate == 1);
+    CHECK(counts.arrange == 0);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(IsHidden(host, i));
+    }
+    CHECK(!IsHidden(host, 10));
+
+    // 第二批沿用快照：往返次數與桌面項目數無關
+    host.ResetCallCounts();
+    std::vector<std::wstring> paths = PathsOf(10, 10);
+    paths.push_back(L"C:\\Users\\me\\Desktop\\missing.lnk");
+    CHECK(controller.Hide(paths) == 10);
+    CHECK(counts.itemText == 0);
+    CHECK(counts.itemCount == 1);
+    CHECK(counts.setPosition == 10);
+    CHECK(counts.GetRoundTrips() == 1 + 1 + 10 + 2);
+}
+
+TEST_CASE(ChangeStampInvalidatesSnapshot) {
+    SimulatedDesktopIconHost host;
+    host.Populate(ITEM_COUNT);
+    DesktopIconController controller(host);
+    CHECK(controller.Hide(PathsOf(0, 1)) == 1);
+
+    // 改名不改變項目數，只有變更戳記能讓快照失效
+    host.RenameItem(5, L"renamed");
+    host.ResetCallCounts();
+    CHECK(controller.Hide({ L"C:\\Users\\me\\Desktop\\renamed.txt" }) == 1);
+    CHECK(host.GetCallCounts().itemText == (uint64_t)ITEM_COUNT);
+    CHECK(IsHidden(host, 5));
+    CHECK(controller.FindIndex(PathOf(5)) == -1);
+}
+
+TEST_CASE(RestoreSetsEachIconOnceWithoutArrange) {
+    SimulatedDesktopIconHost host;
+    host.Populate(ITEM_COUNT);
+    host.SetScreenOffset({ 100, 50 });
+    DesktopIconController controller(host);
+
+    // 前 20 個有原始位置（螢幕座標），後 20 個沒有
+    std::vector<std::pair<std::wstring, DesktopIconPoint>> icons;
+    std::vector<DesktopIconPoint> original;
+    for (int i = 0; i < 40; ++i) {
+        DesktopIconPoint position = host.GetItems()[i].position;
+        original.push_back(position);
+        DesktopIconPoint saved = (i < 20) ? DesktopIconPoint{ position.x + 100, position.y + 50 }
+                                          : DesktopIconPoint{ -1, -1 };
+        icons.push_back({ PathOf(i), saved });
+    }
+    CHECK(controller.Hide(PathsOf(0, 40)) == 40);
+
+    host.ResetCallCounts();
+    CHECK(controller.Restore(icons) == 40);
+    const auto& counts = host.GetCallCounts();
+    CHECK(counts.connect == 1);
+    CHECK(counts.itemCount == 2);           // 快照確認 + 讀回全部位置
+    CHECK(counts.itemText == 0);
+    CHECK(counts.positionQueries == 1);
+    CHECK(counts.positionsRead == (uint64_t)ITEM_COUNT);
+    CHECK(counts.screenToList == 20);
+    CHECK(counts.grid == 1);
+    CHECK(counts.arrange == 0);
+    CHECK(counts.setPosition == 40);
+    CHECK(counts.beginUpdate == 1);
+    CHECK(counts.endUpdate == 1);
+
+    // 有原始位置的回到原處；其餘放到空格，且不與任何圖示重疊
+    for (int i = 0; i < 20; ++i) {
+        CHECK(host.GetItems()[i].position.x == original[i].x);
+        CHECK(host.GetItems()[i].position.y == original[i].y);
+    }
+    std::set<std::pair<int32_t, int32_t>> cells;
+    for (const auto& item : host.GetItems()) {
+        cells.insert({ item.position.x, item.position.y });
+    }
+    CHECK(cells.size() == (size_t)ITEM_COUNT);
+}
+
+TEST_CASE(ShowUsesSingleBatch) {
+    SimulatedDesktopIconHost host;
+    host.Populate(ITEM_COUNT);
+    DesktopIconController controller(host);
+    CHECK(controller.Hide(PathsOf(100, 30)) == 30);
+
+    host.ResetCallCounts();
+    CHECK(controller.Show(PathsOf(100, 30)) == 30);
+    const auto& counts = host.GetCallCounts();
+    CHECK(counts.arrange == 0);
+    CHECK(counts.screenToList == 0);
+    CHECK(counts.positionQueries == 1);
+    CHECK(counts.setPosition == 30);
+    CHECK(counts.beginUpdate == 1);
+    for (int i = 100; i < 130; ++i) {
+        CHECK(!IsHidden(host, i));
+    }
+}
+
+TEST_CASE(ReconcileMovesOnlyVisibleIcons) {
+    SimulatedDesktopIconHost host;
+    host.Populate(ITEM_COUNT);
+    DesktopIconController controller(host);
+    CHECK(controller.Hide(PathsOf(0, 5)) == 5);
+
+    // 應隱藏 10 個，其中 5 個已在隱藏位置：一次讀回這 10 個位置，只移動另外 5 個
+    host.ResetCallCounts();
+    CHECK(controller.Reconcile(PathsOf(0, 10)) == 5);
+    const auto& counts = host.GetCallCounts();
+    CHECK(counts.itemText == 0);
+    CHECK(counts.positionQueries == 1);
+    CHECK(counts.positionsRead == 10);
+    CHECK(counts.setPosition == 5);
+    CHECK(counts.beginUpdate == 1);
+    CHECK(counts.endUpdate == 1);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(IsHidden(host, i));
+    }
+
+    // 桌面已正確：只讀位置，不送出任何變更
+    host.ResetCallCounts();
+    CHECK(controller.Reconcile(PathsOf(0, 10)) == 0);
+    CHECK(counts.positionQueries == 1);
+    CHECK(counts.setPosition == 0);
+    CHECK(counts.beginUpdate == 0);
+    CHECK(counts.endUpdate == 0);
+    CHECK(counts.GetRoundTrips() == 1 + 1 + 1 + 10);
+}
+
+TEST_CASE(UnavailableDesktopStopsAfterConnect) {
+    SimulatedDesktopIconHost host;
+    host.Populate(ITEM_COUNT);
+    host.SetAvailable(false);
+    DesktopIconController controller(host);
+
+    CHECK(controller.Hide(PathsOf(0, 10)) == 0);
+    CHECK(controller.Restore({ { PathOf(0), DesktopIconPoint{ 0, 0 } } }) == 0);
+    CHECK(controller.Reconcile(PathsOf(0, 10)) == 0);
+    CHECK(host.GetCallCounts().connect == 3);
+    CHECK(host.GetCallCounts().GetRoundTrips() == 3);
+}
+
+int main() {
+    return test::RunAll();
+}
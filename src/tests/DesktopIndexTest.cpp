@@ -0,0 +1,162 @@
+#include "TestSupport.h"
+#include "widgets/DesktopIndex.h"
+#include "widgets/InotifyDesktopFolderWatcher.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void Touch(const fs::path& path) {
+    std::ofstream file(path);
+    file << "x";
+}
+
+std::wstring Join(const fs::path& folder, const char* name) {
+    return (folder / name).wstring();
+}
+
+// 把收到的變更全部換成一次溢位通知，模擬通知遺失
+class OverflowingWatcher : public InotifyDesktopFolderWatcher {
+public:
+    bool overflow = false;
+
+    void Poll(std::vector<DesktopFolderChange>& changes) override {
+        if (!overflow) {
+            InotifyDesktopFolderWatcher::Poll(changes);
+            return;
+        }
+        std::vector<DesktopFolderChange> dropped;
+        InotifyDesktopFolderWatcher::Poll(dropped);
+        changes.push_back({ 0, DesktopFolderChange::OVERFLOWED, {} });
+    }
+};
+
+} // namespace
+
+TEST_CASE(ScansExistingEntries) {
+    test::TempDirectory desktop;
+    Touch(desktop.GetPath() / "report.docx");
+    Touch(desktop.GetPath() / ".hidden");
+    fs::create_directory(desktop.GetPath() / "Projects");
+
+    InotifyDesktopFolderWatcher watcher;
+    DesktopIndex index(watcher);
+    REQUIRE(index.AddFolder(desktop.GetPath().wstring()));
+    CHECK(index.AddFolder(desktop.GetPath().wstring()));
+    CHECK(index.GetFolderCount() == 1);
+    CHECK(index.GetCount() == 3);
+
+    const DesktopIndex::Entry* report = index.Find(Join(desktop.GetPath(), "REPORT.DOCX"));
+    REQUIRE(report != nullptr);
+    CHECK(!report->isDirectory);
+    CHECK(!report->isHidden);
+    CHECK(report->folder == 0);
+
+    const DesktopIndex::Entry* projects = index.Find(Join(desktop.GetPath(), "Projects"));
+    REQUIRE(projects != nullptr);
+    CHECK(projects->isDirectory);
+
+    const DesktopIndex::Entry* hidden = index.Find(Join(desktop.GetPath(), ".hidden"));
+    REQUIRE(hidden != nullptr);
+    CHECK(hidden->isHidden);
+}
+
+TEST_CASE(AppliesCreateRenameAndDelete) {
+    test::TempDirectory desktop;
+    InotifyDesktopFolderWatcher watcher;
+    DesktopIndex index(watcher);
+    REQUIRE(index.AddFolder(desktop.GetPath().wstring()));
+    CHECK(index.GetCount() == 0);
+
+    // 沒有變更時不遞增世代
+    uint64_t generation = index.GetGeneration();
+    index.Update();
+    CHECK(index.GetGeneration() == generation);
+
+    Touch(desktop.GetPath() / "notes.txt");
+    fs::create_directory(desktop.GetPath() / "Archive");
+    index.Update();
+    CHECK(index.GetCount() == 2);
+    CHECK(index.Contains(Join(desktop.GetPath(), "notes.txt")));
+    REQUIRE(index.Find(Join(desktop.GetPath(), "Archive")) != nullptr);
+    CHECK(index.Find(Join(desktop.GetPath(), "Archive"))->isDirectory);
+    CHECK(index.GetGeneration() > generation);
+
+    // 改名：舊名移除、新名加入
+    generation = index.GetGeneration();
+    fs::rename(desktop.GetPath() / "notes.txt", desktop.GetPath() / "todo.txt");
+    index.Update();
+    CHECK(index.GetCount() == 2);
+    CHECK(!index.Contains(Join(desktop.GetPath(), "notes.txt")));
+    CHECK(index.Contains(Join(desktop.GetPath(), "todo.txt")));
+    CHECK(index.GetGeneration() > generation);
+
+    fs::remove(desktop.GetPath() / "todo.txt");
+    fs::remove(desktop.GetPath() / "Archive");
+    index.Update();
+    CHECK(index.GetCount() == 0);
+    CHECK(!index.Contains(Join(desktop.GetPath(), "todo.txt")));
+}
+
+TEST_CASE(TracksMultipleFolders) {
+    // 使用者桌面與公用桌面：項目記錄所屬資料夾，跨資料夾移動時跟著改變
+    test::TempDirectory user;
+    test::TempDirectory common;
+    Touch(common.GetPath() / "shared.lnk");
+
+    InotifyDesktopFolderWatcher watcher;
+    DesktopIndex index(watcher);
+    REQUIRE(index.AddFolder(user.GetPath().wstring()));
+    REQUIRE(index.AddFolder(common.GetPath().wstring()));
+    CHECK(index.GetFolderCount() == 2);
+    REQUIRE(index.Find(Join(common.GetPath(), "shared.lnk")) != nullptr);
+    CHECK(index.Find(Join(common.GetPath(), "shared.lnk"))->folder == 1);
+
+    fs::rename(common.GetPath() / "shared.lnk", user.GetPath() / "shared.lnk");
+    index.Update();
+    CHECK(!index.Contains(Join(common.GetPath(), "shared.lnk")));
+    REQUIRE(index.Find(Join(user.GetPath(), "shared.lnk")) != nullptr);
+    CHECK(index.Find(Join(user.GetPath(), "shared.lnk"))->folder == 0);
+
+    std::vector<std::wstring> paths;
+    index.ForEach([&](const DesktopIndex::Entry& entry) { paths.push_back(entry.path); });
+    CHECK(paths.size() == 1);
+
+    index.Clear();
+    CHECK(index.GetFolderCount() == 0);
+    CHECK(index.GetCount() == 0);
+}
+
+TEST_CASE(RescansAfterLostNotifications) {
+    test::TempDirectory desktop;
+    Touch(desktop.GetPath() / "a.txt");
+
+    OverflowingWatcher watcher;
+    DesktopIndex index(watcher);
+    REQUIRE(index.AddFolder(desktop.GetPath().wstring()));
+
+    watcher.overflow = true;
+    Touch(desktop.GetPath() / "b.txt");
+    fs::remove(desktop.GetPath() / "a.txt");
+    index.Update();
+    CHECK(index.GetCount() == 1);
+    CHECK(!index.Contains(Join(desktop.GetPath(), "a.txt")));
+    CHECK(index.Contains(Join(desktop.GetPath(), "b.txt")));
+}
+
+TEST_CASE(RejectsMissingFolder) {
+    test::TempDirectory desktop;
+    InotifyDesktopFolderWatcher watcher;
+    DesktopIndex index(watcher);
+    CHECK(!index.AddFolder(Join(desktop.GetPath(), "missing")));
+    CHECK(index.GetFolderCount() == 0);
+    CHECK(index.GetCount() == 0);
+}
+
+int main() {
+    return test::RunAll();
+}
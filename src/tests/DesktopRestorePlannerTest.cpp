@@ -0,0 +1,233 @@
+#include "TestSupport.h"
+#include "widgets/DesktopRestorePlanner.h"
+#include <random>
+#include <vector>
+
+namespace {
+
+const DesktopIconGrid GRID = { 75, 100, 4, 3 };  // 4 欄 × 3 列，格子依欄優先編號
+
+DesktopIconPoint CellPoint(int column, int row) {
+    return { column * GRID.cellWidth, row * GRID.cellHeight };
+}
+
+DesktopRestorePlanner::Request Saved(DesktopIconPoint point) {
+    return { point, true };
+}
+
+DesktopRestorePlanner::Request Unsaved() {
+    return { DesktopIconPoint{ 0, 0 }, false };
+}
+
+bool Same(DesktopIconPoint a, DesktopIconPoint b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+// 參考實作：逐格線性掃描（與規劃器相同的兩階段規則）
+std::vector<DesktopIconPoint> ReferencePlan(const DesktopIconGrid& grid,
+                                            const std::vector<DesktopIconPoint>& occupied,
+                                            const std::vector<DesktopRestorePlanner::Request>& requests) {
+    int64_t cellCount = (int64_t)grid.columns * grid.rows;
+    std::vector<bool> used((size_t)cellCount, false);
+    auto cellOf = [&](DesktopIconPoint p) -> int64_t {
+        if (p.x < 0 || p.y < 0 || p.x / grid.cellWidth >= grid.columns || p.y / grid.cellHeight >= grid.rows) {
+            return -1;
+        }
+        return (int64_t)(p.x / grid.cellWidth) * grid.rows + p.y / grid.cellHeight;
+    };
+    for (DesktopIconPoint p : occupied) {
+        int64_t cell = cellOf(p);
+        if (cell >= 0) {
+            used[(size_t)cell] = true;
+        }
+    }
+
+    std::vector<DesktopIconPoint> positions(requests.size(), DesktopIconPoint{ 0, 0 });
+    std::vector<size_t> deferred;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        int64_t cell = requests[i].hasSaved ? cellOf(requests[i].saved) : -1;
+        if (cell >= 0 && !used[(size_t)cell]) {
+            used[(size_t)cell] = true;
+            positions[i] = requests[i].saved;
+        } else {
+            deferred.push_back(i);
+        }
+    }
+    for (size_t i : deferred) {
+        int64_t start = requests[i].hasSaved ? cellOf(requests[i].saved) : 0;
+        start = (start >= 0) ? start : 0;
+        int64_t found = -1;
+        for (int64_t n = 0; n < cellCount && found < 0; ++n) {
+            int64_t cell = (start + n) % cellCount;
+            if (!used[(size_t)cell]) {
+                found = cell;
+            }
+        }
+        if (found >= 0) {
+            used[(size_t)found] = true;
+            positions[i] = { (int32_t)(found / grid.rows) * grid.cellWidth, (int32_t)(found % grid.rows) * grid.cellHeight };
+        } else if (requests[i].hasSaved) {
+            positions[i] = requests[i].saved;
+        }
+    }
+    return positions;
+}
+
+} // namespace
+
+TEST_CASE(KeepsFreeSavedPositions) {
+    DesktopRestorePlanner planner;
+    planner.Reset(GRID);
+    planner.MarkOccupied(CellPoint(0, 0));
+    planner.MarkOccupied({ -10000, -10000 });  // 已隱藏的圖示在格線外
+    CHECK(planner.GetOccupiedCount() == 1);
+
+    // 原始位置不必對齊格子，保留原值
+    std::vector<DesktopIconPoint> positions;
+    planner.Plan({ Saved({ 160, 130 }), Saved(CellPoint(3, 2)) }, positions);
+    REQUIRE(positions.size() == 2);
+    CHECK(Same(positions[0], { 160, 130 }));
+    CHECK(Same(positions[1], CellPoint(3, 2)));
+    CHECK(planner.GetOccupiedCount() == 3);
+}
+
+TEST_CASE(OccupiedSavedCellFallsToNextFreeCell) {
+    DesktopRestorePlanner planner;
+    planner.Reset(GRID);
+    planner.MarkOccupied(CellPoint(1, 1));
+    planner.MarkOccupied(CellPoint(1, 2));
+
+    // (1,1) 與其後的 (1,2) 都被佔用：往下一欄的頂端
+    std::vector<DesktopIconPoint> positions;
+    planner.Plan({ Saved(CellPoint(1, 1)) }, positions);
+    CHECK(Same(positions[0], CellPoint(2, 0)));
+
+    // 同一批中兩個圖示存了同一格：先到的保留，後到的往後找
+    planner.Reset(GRID);
+    planner.Plan({ Saved(CellPoint(0, 0)), Saved({ 10, 10 }) }, positions);
+    CHECK(Same(positions[0], CellPoint(0, 0)));
+    CHECK(Same(positions[1], CellPoint(0, 1)));
+}
+
+TEST_CASE(SavedCellsWinOverFallbackSearch) {
+    // 沒有原始位置的圖示排在前面，也不會搶走後面圖示的原始格子
+    DesktopRestorePlanner planner;
+    planner.Reset(GRID);
+    std::vector<DesktopIconPoint> positions;
+    planner.Plan({ Unsaved(), Saved(CellPoint(0, 0)), Unsaved() }, positions);
+    CHECK(Same(positions[1], CellPoint(0, 0)));
+    CHECK(Same(positions[0], CellPoint(0, 1)));
+    CHECK(Same(positions[2], CellPoint(0, 2)));
+}
+
+TEST_CASE(SearchWrapsToGridStart) {
+    DesktopRestorePlanner planner;
+    planner.Reset(GRID);
+    planner.MarkOccupied(CellPoint(3, 1));
+    planner.MarkOccupied(CellPoint(3, 2));
+    planner.MarkOccupied(CellPoint(0, 0));
+
+    std::vector<DesktopIconPoint> positions;
+    planner.Plan({ Saved(CellPoint(3, 1)), Saved({ 5000, 0 }) }, positions);
+    CHECK(Same(positions[0], CellPoint(0, 1)));
+    CHECK(Same(positions[1], CellPoint(0, 2)));  // 格線外的原始位置從頭找
+}
+
+TEST_CASE(GridOverflowKeepsSavedPositions) {
+    DesktopRestorePlanner planner;
+    planner.Reset(GRID);
+    for (int column = 0; column < GRID.columns; ++column) {
+        for (int row = 0; row < GRID.rows; ++row) {
+            if (column != 2 || row != 1) {
+                planner.MarkOccupied(CellPoint(column, row));
+            }
+        }
+    }
+
+    // 只剩一格：第一個拿到空格，其餘保留原始位置（沒有時為原點）
+    std::vector<DesktopIconPoint> positions;
+    planner.Plan({ Saved(CellPoint(0, 0)), Saved(CellPoint(1, 1)), Unsaved() }, positions);
+    CHECK(Same(positions[0], CellPoint(2, 1)));
+    CHECK(Same(positions[1], CellPoint(1, 1)));
+    CHECK(Same(positions[2], CellPoint(0, 0)));
+    CHECK(planner.GetOccupiedCount() == (size_t)(GRID.columns * GRID.rows));
+}
+
+TEST_CASE(InvalidGridLeavesSavedPositions) {
+    DesktopRestorePlanner planner;
+    planner.Reset({ 0, 0, 0, 0 });
+    planner.MarkOccupied({ 0, 0 });
+    CHECK(planner.GetOccupiedCount() == 0);
+
+    std::vector<DesktopIconPoint> positions;
+    planner.Plan({ Saved({ 40, 50 }), Unsaved() }, positions);
+    CHECK(Same(positions[0], { 40, 50 }));
+    CHECK(Same(positions[1], { 0, 0 }));
+}
+
+TEST_CASE(SkipsFullWordsOnLargeGrids) {
+    // 20000 格、前 10000 格已滿（跨越多個摘要字組），最後一個字組只用到一部分
+    DesktopIconGrid grid = { 75, 100, 200, 100 };
+    DesktopRestorePlanner planner;
+    planner.Reset(grid);
+    for (int cell = 0; cell < 10000; ++cell) {
+        planner.MarkOccupied({ (cell / grid.rows) * grid.cellWidth, (cell % grid.rows) * grid.cellHeight });
+    }
+
+    std::vector<DesktopIconPoint> positions;
+    planner.Plan({ Unsaved(), Saved({ 199 * 75, 99 * 100 }), Saved({ 199 * 75, 99 * 100 }) }, positions);
+    CHECK(Same(positions[0], { 100 * 75, 0 }));
+    CHECK(Same(positions[1], { 199 * 75, 99 * 100 }));
+    CHECK(Same(positions[2], { 100 * 75, 100 }));  // 最後一格被佔用後從頭找
+}
+
+TEST_CASE(MatchesLinearScanReference) {
+    std::mt19937 rng(2024);
+    for (int round = 0; round < 300; ++round) {
+        DesktopIconGrid grid = { 75, 100, 1 + (int32_t)(rng() % 90), 1 + (int32_t)(rng() % 70) };
+        int32_t width = grid.columns * grid.cellWidth;
+        int32_t height = grid.rows * grid.cellHeight;
+        int64_t cellCount = (int64_t)grid.columns * grid.rows;
+
+        // 佔用比例從幾乎空到超過格線容量
+        std::vector<DesktopIconPoint> occupied;
+        int64_t occupiedCount = (int64_t)(rng() % (cellCount + 1));
+        for (int64_t i = 0; i < occupiedCount; ++i) {
+            occupied.push_back({ (int32_t)(rng() % width), (int32_t)(rng() % height) });
+        }
+        std::vector<DesktopRestorePlanner::Request> requests;
+        size_t requestCount = rng() % 64;
+        for (size_t i = 0; i < requestCount; ++i) {
+            int kind = (int)(rng() % 4);
+            if (kind == 0) {
+                requests.push_back(Unsaved());
+            } else if (kind == 1) {
+                requests.push_back(Saved({ (int32_t)(rng() % (width + 400)), (int32_t)(rng() % (height + 400)) }));
+            } else {
+                requests.push_back(Saved({ (int32_t)(rng() % width), (int32_t)(rng() % height) }));
+            }
+        }
+
+        DesktopRestorePlanner planner;
+        planner.Reset(grid);
+        for (DesktopIconPoint p : occupied) {
+            planner.MarkOccupied(p);
+        }
+        std::vector<DesktopIconPoint> positions;
+        planner.Plan(requests, positions);
+
+        std::vector<DesktopIconPoint> expected = ReferencePlan(grid, occupied, requests);
+        bool same = positions.size() == expected.size();
+        for (size_t i = 0; same && i < positions.size(); ++i) {
+            same = Same(positions[i], expected[i]);
+        }
+        CHECK(same);
+        if (!same) {
+            return;
+        }
+    }
+}
+
+int main() {
+    return test::RunAll();
+}
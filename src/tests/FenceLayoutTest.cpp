@@ -0,0 +1,280 @@
+#include "TestSupport.h"
+#include "widgets/FenceLayout.h"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+FenceLayout MakeLayout() {
+    FenceLayout layout;
+    layout.journalSequence = 0x123456789ULL;
+
+    FenceLayoutFence tools;
+    tools.title = L"工具 \"常用\"";
+    tools.x = -1920;
+    tools.y = 40;
+    tools.width = 420;
+    tools.height = 300;
+    tools.isCollapsed = true;
+    tools.expandedHeight = 512;
+    tools.iconSize = 48;
+    tools.alpha = 180;
+    tools.backgroundColor = 0x00102030;
+    tools.borderColor = 0x00405060;
+    tools.titleColor = 0x00FFFFFF;
+    tools.borderWidth = 0;
+    tools.iconSpacing = 6;
+    tools.scrollOffset = 120;
+    tools.icons.push_back({ L"C:\\Users\\使用者\\Desktop\\編輯器.lnk", 10, 20, 0 });
+    tools.icons.push_back({ L"D:\\tab\there\\new\nline.txt", -5, 3000, 7 });
+    tools.icons.push_back({ L"\\\\server\\share\\報告.docx", 0, 0, -1 });
+    layout.fences.push_back(tools);
+
+    FenceLayoutFence empty;
+    empty.isPinned = true;
+    layout.fences.push_back(empty);
+
+    FenceLayoutFence docs;
+    docs.title = L"文件";
+    docs.width = 200;
+    docs.height = 150;
+    docs.icons.push_back({ L"C:\\a.pdf", 1, 2, 3 });
+    layout.fences.push_back(docs);
+    return layout;
+}
+
+bool SameLayout(const FenceLayout& a, const FenceLayout& b) {
+    if (a.journalSequence != b.journalSequence || a.fences.size() != b.fences.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.fences.size(); ++i) {
+        const FenceLayoutFence& x = a.fences[i];
+        const FenceLayoutFence& y = b.fences[i];
+        if (x.title != y.title || x.x != y.x || x.y != y.y || x.width != y.width || x.height != y.height ||
+            x.isCollapsed != y.isCollapsed || x.isPinned != y.isPinned || x.expandedHeight != y.expandedHeight ||
+            x.iconSize != y.iconSize || x.alpha != y.alpha || x.backgroundColor != y.backgroundColor ||
+            x.borderColor != y.borderColor || x.titleColor != y.titleColor || x.borderWidth != y.borderWidth ||
+            x.iconSpacing != y.iconSpacing || x.scrollOffset != y.scrollOffset ||
+            x.icons.size() != y.icons.size()) {
+            return false;
+        }
+        for (size_t j = 0; j < x.icons.size(); ++j) {
+            if (x.icons[j].filePath != y.icons[j].filePath || x.icons[j].originalX != y.icons[j].originalX ||
+                x.icons[j].originalY != y.icons[j].originalY ||
+                x.icons[j].originalIndex != y.icons[j].originalIndex) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 映射檔案的起點是頁面對齊的；測試用 uint64_t 陣列模擬
+struct AlignedBuffer {
+    explicit AlignedBuffer(const std::string& content)
+        : words((content.size() + 15) / 8), size(content.size()) {
+        std::memcpy(words.data(), content.data(), content.size());
+    }
+
+    const char* data() const { return reinterpret_cast<const char*>(words.data()); }
+    char* data() { return reinterpret_cast<char*>(words.data()); }
+
+    std::vector<uint64_t> words;
+    size_t size;
+};
+
+FenceLayoutFileHeader& HeaderOf(AlignedBuffer& buffer) {
+    return *reinterpret_cast<FenceLayoutFileHeader*>(buffer.data());
+}
+
+FenceLayoutFenceRecord& FenceOf(AlignedBuffer& buffer, uint32_t index) {
+    return reinterpret_cast<FenceLayoutFenceRecord*>(buffer.data() + HeaderOf(buffer).fenceTableOffset)[index];
+}
+
+FenceLayoutIconRecord& IconOf(AlignedBuffer& buffer, uint32_t index) {
+    return reinterpret_cast<FenceLayoutIconRecord*>(buffer.data() + HeaderOf(buffer).iconTableOffset)[index];
+}
+
+bool AttachCorrupted(const std::string& binary, const std::function<void(AlignedBuffer&)>& corrupt) {
+    AlignedBuffer buffer(binary);
+    corrupt(buffer);
+    FenceLayoutView view;
+    return view.Attach(buffer.data(), buffer.size);
+}
+
+} // namespace
+
+TEST_CASE(BinaryRoundTrip) {
+    FenceLayout source = MakeLayout();
+    AlignedBuffer buffer(FenceLayoutBinary::Write(source));
+
+    FenceLayoutView view;
+    REQUIRE(view.Attach(buffer.data(), buffer.size));
+    CHECK(view.GetJournalSequence() == source.journalSequence);
+    CHECK(view.GetFenceCount() == 3);
+    CHECK(view.GetIconCount() == 4);
+
+    FenceLayout restored;
+    view.ToLayout(restored);
+    CHECK(SameLayout(source, restored));
+
+    // 不解碼整份佈局也能取得單一柵欄設定
+    FenceLayoutFence docs;
+    view.GetFenceSettings(2, docs);
+    CHECK(docs.title == L"文件");
+    CHECK(docs.icons.empty());
+}
+
+TEST_CASE(JsonRoundTrip) {
+    FenceLayout source = MakeLayout();
+    std::string json = FenceLayoutJson::Write(source);
+
+    FenceLayout parsed;
+    REQUIRE(FenceLayoutJson::Parse(json.data(), json.size(), parsed));
+    CHECK(SameLayout(source, parsed));
+    CHECK(FenceLayoutJson::Write(parsed) == json);
+}
+
+TEST_CASE(JsonDropsIconsWithoutPath) {
+    // 與舊版載入相同：沒有路徑的圖示無法還原，略過
+    std::string json = "{\"version\": 2, \"fences\": [{\"title\": \"t\", \"icons\": ["
+                       "{\"filePath\": \"\", \"originalIndex\": 1}, {\"originalIndex\": 2},"
+                       " {\"filePath\": \"C:\\\\a.lnk\", \"originalIndex\": 3}]}]}";
+    FenceLayout layout;
+    REQUIRE(FenceLayoutJson::Parse(json.data(), json.size(), layout));
+    REQUIRE(layout.fences.size() == 1);
+    REQUIRE(layout.fences[0].icons.size() == 1);
+    CHECK(layout.fences[0].icons[0].originalIndex == 3);
+}
+
+TEST_CASE(JsonToBinaryToJson) {
+    // 匯入 config.json → 寫出 config.layout → 匯出 JSON，內容不變
+    std::string json = FenceLayoutJson::Write(MakeLayout());
+    FenceLayout imported;
+    REQUIRE(FenceLayoutJson::Parse(json.data(), json.size(), imported));
+
+    AlignedBuffer buffer(FenceLayoutBinary::Write(imported));
+    FenceLayoutView view;
+    REQUIRE(view.Attach(buffer.data(), buffer.size));
+    FenceLayout exported;
+    view.ToLayout(exported);
+    CHECK(FenceLayoutJson::Write(exported) == json);
+}
+
+TEST_CASE(EmptyLayoutRoundTrip) {
+    FenceLayout source;
+    AlignedBuffer buffer(FenceLayoutBinary::Write(source));
+    FenceLayoutView view;
+    REQUIRE(view.Attach(buffer.data(), buffer.size));
+    CHECK(view.GetFenceCount() == 0);
+
+    FenceLayout restored;
+    view.ToLayout(restored);
+    CHECK(SameLayout(source, restored));
+}
+
+TEST_CASE(ReadsVersion1Records) {
+    // 第 1 版：柵欄紀錄到 iconCount 為止，缺少的欄位使用預設值
+    FenceLayout source = MakeLayout();
+    std::string current = FenceLayoutBinary::Write(source);
+    FenceLayoutFileHeader header;
+    std::memcpy(&header, current.data(), sizeof(header));
+
+    std::string fences;
+    for (uint32_t i = 0; i < header.fenceCount; ++i) {
+        fences.append(current, header.fenceTableOffset + i * sizeof(FenceLayoutFenceRecord),
+                      FENCE_LAYOUT_V1_FENCE_RECORD_SIZE);
+    }
+    std::string icons = current.substr(header.iconTableOffset, header.stringPoolOffset - header.iconTableOffset);
+    std::string pool = current.substr(header.stringPoolOffset, header.stringPoolSize);
+
+    header.version = 1;
+    header.iconTableOffset = header.fenceTableOffset + static_cast<uint32_t>(fences.size());
+    header.stringPoolOffset = header.iconTableOffset + static_cast<uint32_t>(icons.size());
+    std::string v1(reinterpret_cast<const char*>(&header), sizeof(header));
+    v1 += fences + icons + pool;
+
+    AlignedBuffer buffer(v1);
+    FenceLayoutView view;
+    REQUIRE(view.Attach(buffer.data(), buffer.size));
+    FenceLayout restored;
+    view.ToLayout(restored);
+    REQUIRE(restored.fences.size() == source.fences.size());
+
+    FenceLayoutFence defaults;
+    CHECK(restored.fences[0].title == source.fences[0].title);
+    CHECK(restored.fences[0].borderWidth == defaults.borderWidth);
+    CHECK(restored.fences[0].iconSpacing == defaults.iconSpacing);
+    CHECK(restored.fences[0].scrollOffset == defaults.scrollOffset);
+    REQUIRE(restored.fences[0].icons.size() == 3);
+    CHECK(restored.fences[0].icons[1].filePath == source.fences[0].icons[1].filePath);
+}
+
+TEST_CASE(RejectsCorruptHeader) {
+    std::string binary = FenceLayoutBinary::Write(MakeLayout());
+    CHECK(AttachCorrupted(binary, [](AlignedBuffer&) {}));
+
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { b.data()[0] = 'X'; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).version = 0; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).version = FENCE_LAYOUT_VERSION + 1; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).headerSize = 16; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { b.size = sizeof(FenceLayoutFileHeader) - 1; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { b.size -= 1; }));
+}
+
+TEST_CASE(RejectsCorruptTables) {
+    std::string binary = FenceLayoutBinary::Write(MakeLayout());
+
+    // 表格未對齊
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).fenceTableOffset += 2; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).iconTableOffset += 1; }));
+
+    // 表格或字串池超出檔案
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).fenceCount += 1000; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).fenceCount = 0xFFFFFFFFu; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).iconCount = 0xFFFFFFFFu; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).iconTableOffset = 0xFFFFFFF0u; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).stringPoolSize += 1; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { HeaderOf(b).stringPoolOffset = 0xFFFFFFFFu; }));
+}
+
+TEST_CASE(RejectsCorruptRecords) {
+    std::string binary = FenceLayoutBinary::Write(MakeLayout());
+
+    // 字串範圍超出字串池（含加法溢位）
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { FenceOf(b, 0).titleLength = HeaderOf(b).stringPoolSize + 1; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) {
+        FenceOf(b, 2).titleOffset = 0xFFFFFFF0u;
+        FenceOf(b, 2).titleLength = 0x20;
+    }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { IconOf(b, 3).pathOffset = HeaderOf(b).stringPoolSize; }));
+
+    // 圖示範圍超出圖示表
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) { FenceOf(b, 2).iconCount = 2; }));
+    CHECK(!AttachCorrupted(binary, [](AlignedBuffer& b) {
+        FenceOf(b, 0).firstIcon = 0xFFFFFFFFu;
+        FenceOf(b, 0).iconCount = 2;
+    }));
+}
+
+TEST_CASE(RejectsMisalignedBuffer) {
+    std::string binary = FenceLayoutBinary::Write(MakeLayout());
+    AlignedBuffer shifted(std::string(1, '\0') + binary);
+    FenceLayoutView view;
+    CHECK(!view.Attach(shifted.data() + 1, binary.size()));
+}
+
+TEST_CASE(RecognizesBinaryLayout) {
+    std::string binary = FenceLayoutBinary::Write(MakeLayout());
+    std::string json = FenceLayoutJson::Write(MakeLayout());
+    CHECK(FenceLayoutView::IsBinaryLayout(binary.data(), binary.size()));
+    CHECK(!FenceLayoutView::IsBinaryLayout(json.data(), json.size()));
+    CHECK(!FenceLayoutView::IsBinaryLayout(binary.data(), 4));
+}
+
+int main() {
+    return test::RunAll();
+}
@@ -0,0 +1,116 @@
+#include "TestSupport.h"
+#include "core/FieldTable.h"
+#include "widgets/FenceLayout.h"
+#include <string>
+
+namespace {
+
+struct Sample {
+    int32_t count = 0;
+    uint32_t color = 0;
+    bool enabled = false;
+    std::wstring name;
+};
+
+constexpr auto SAMPLE_FIELDS = MakeFieldTable(
+    Field("count", &Sample::count),
+    Field("color", &Sample::color),
+    Field("enabled", &Sample::enabled),
+    Field("name", &Sample::name));
+
+// 長度與首、中、尾字元都相同：取樣雜湊必定碰撞，需改用完整雜湊
+struct Colliding {
+    int32_t first = 0;
+    int32_t second = 0;
+};
+
+constexpr auto COLLIDING_FIELDS = MakeFieldTable(
+    Field("a1m2z", &Colliding::first),
+    Field("a3m4z", &Colliding::second));
+
+} // namespace
+
+TEST_CASE(FindsEveryFieldByName) {
+    CHECK(SAMPLE_FIELDS.Find("count") == 0);
+    CHECK(SAMPLE_FIELDS.Find("color") == 1);
+    CHECK(SAMPLE_FIELDS.Find("enabled") == 2);
+    CHECK(SAMPLE_FIELDS.Find("name") == 3);
+    CHECK(SAMPLE_FIELDS.Find("") == -1);
+    CHECK(SAMPLE_FIELDS.Find("counts") == -1);
+    CHECK(SAMPLE_FIELDS.Find("cxunt") == -1);
+
+    const char* fenceKeys[] = {
+        "title", "x", "y", "width", "height", "isCollapsed", "isPinned", "expandedHeight", "iconSize",
+        "alpha", "backgroundColor", "borderColor", "titleColor", "borderWidth", "iconSpacing", "scrollOffset",
+    };
+    for (int i = 0; i < (int)(sizeof(fenceKeys) / sizeof(fenceKeys[0])); ++i) {
+        CHECK(FENCE_LAYOUT_FENCE_FIELDS.Find(fenceKeys[i]) == i);
+    }
+    CHECK(FENCE_LAYOUT_FENCE_FIELDS.Find("icons") == -1);
+}
+
+TEST_CASE(FallsBackToFullHashOnSampledCollision) {
+    static_assert(COLLIDING_FIELDS.Find("a1m2z") == 0, "compile-time lookup");
+    CHECK(COLLIDING_FIELDS.Find("a1m2z") == 0);
+    CHECK(COLLIDING_FIELDS.Find("a3m4z") == 1);
+    CHECK(COLLIDING_FIELDS.Find("a5m6z") == -1);
+}
+
+TEST_CASE(JsonRoundTripInAnyOrder) {
+    Sample source;
+    source.count = -7;
+    source.color = 0xFFEEDDCC;
+    source.enabled = true;
+    source.name = L"名稱 \"引號\"";
+
+    JsonWriter writer(0);
+    writer.BeginObject();
+    SAMPLE_FIELDS.WriteJson(writer, source);
+    writer.EndObject();
+    std::string json = writer.Release();
+
+    Sample parsed;
+    JsonReader reader(json.data(), json.size());
+    REQUIRE(reader.Next() == JsonReader::Token::BeginObject);
+    REQUIRE(SAMPLE_FIELDS.ReadJsonObject(reader, parsed));
+    CHECK(parsed.count == source.count);
+    CHECK(parsed.color == source.color);
+    CHECK(parsed.enabled == source.enabled);
+    CHECK(parsed.name == source.name);
+
+    // 順序不同、含未知欄位與型別不符的值（保留原值）
+    std::string shuffled = "{\"name\": \"n\", \"extra\": [1, {\"a\": 2}], \"count\": \"x\", \"color\": 5}";
+    Sample defaults;
+    defaults.count = 3;
+    JsonReader shuffledReader(shuffled.data(), shuffled.size());
+    REQUIRE(shuffledReader.Next() == JsonReader::Token::BeginObject);
+    REQUIRE(SAMPLE_FIELDS.ReadJsonObject(shuffledReader, defaults));
+    CHECK(defaults.name == L"n");
+    CHECK(defaults.count == 3);
+    CHECK(defaults.color == 5);
+}
+
+TEST_CASE(PayloadRoundTrip) {
+    FenceLayoutFence source;
+    source.title = L"柵欄";
+    source.x = -100;
+    source.isPinned = true;
+    source.titleColor = 0x00ABCDEF;
+    source.scrollOffset = 33;
+
+    JournalPayloadWriter writer;
+    FENCE_LAYOUT_FENCE_FIELDS.WritePayload(writer, source);
+    JournalPayloadReader reader(writer.GetData().data(), writer.GetData().size());
+    FenceLayoutFence decoded;
+    FENCE_LAYOUT_FENCE_FIELDS.ReadPayload(reader, decoded);
+    CHECK(reader.IsValid());
+    CHECK(decoded.title == source.title);
+    CHECK(decoded.x == source.x);
+    CHECK(decoded.isPinned);
+    CHECK(decoded.titleColor == source.titleColor);
+    CHECK(decoded.scrollOffset == source.scrollOffset);
+}
+
+int main() {
+    return test::RunAll();
+}
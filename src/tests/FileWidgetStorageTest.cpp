@@ -0,0 +1,283 @@
+#include "TestSupport.h"
+#include "core/FileWidgetStorage.h"
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace {
+
+std::map<std::string, std::string> ReadAll(const FileWidgetStorage& storage, std::string_view prefix = "") {
+    std::map<std::string, std::string> entries;
+    storage.ForEach(prefix, [&](const std::string& key, const std::string& value) {
+        entries[key] = value;
+    });
+    return entries;
+}
+
+// 模擬最後一筆交易寫到一半時當機
+void TearTail(const std::filesystem::path& file, uintmax_t bytes) {
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - bytes);
+}
+
+} // namespace
+
+TEST_CASE(PersistsCommittedBatches) {
+    test::TempDirectory dir;
+    std::wstring path = (dir.GetPath() / "widgets.db").wstring();
+
+    {
+        FileWidgetStorage storage;
+        REQUIRE(storage.Open(path));
+        WidgetStorageBatch batch;
+        batch.Put("Fences/a", "1");
+        batch.Put("Fences/b", std::string("\0\xFF", 2));
+        batch.Put("Notes/a", "便利貼");
+        REQUIRE(storage.Commit(batch));
+        REQUIRE(storage.Put("Fences/a", "2"));
+        REQUIRE(storage.Remove("Fences/b"));
+    }
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(path));
+    std::string value;
+    CHECK(storage.Get("Fences/a", value) && value == "2");
+    CHECK(!storage.Contains("Fences/b"));
+    CHECK(storage.Get("Notes/a", value) && value == "便利貼");
+    CHECK(storage.GetEntryCount() == 2);
+}
+
+TEST_CASE(TornTransactionIsDroppedAsAWhole) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "widgets.db";
+
+    {
+        FileWidgetStorage storage;
+        REQUIRE(storage.Open(file.wstring()));
+        REQUIRE(storage.Put("Fences/a", "old"));
+        REQUIRE(storage.Put("Fences/keep", "x"));
+
+        WidgetStorageBatch batch;
+        batch.Put("Fences/a", "new");
+        batch.Remove("Fences/keep");
+        batch.Put("Fences/c", "added");
+        REQUIRE(storage.Commit(batch));
+    }
+
+    // 交易的前幾個項目完整寫入，最後一個項目殘缺：整筆交易都不生效
+    TearTail(file, 2);
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(file.wstring()));
+    std::map<std::string, std::string> expected = { { "Fences/a", "old" }, { "Fences/keep", "x" } };
+    CHECK(ReadAll(storage) == expected);
+
+    // 截掉殘缺的交易後仍可繼續寫入
+    REQUIRE(storage.Put("Fences/d", "after"));
+    storage.Close();
+    REQUIRE(storage.Open(file.wstring()));
+    CHECK(storage.Contains("Fences/d"));
+    CHECK(storage.GetEntryCount() == 3);
+}
+
+TEST_CASE(RejectedBatchLeavesNothingApplied) {
+    test::TempDirectory dir;
+    std::wstring path = (dir.GetPath() / "widgets.db").wstring();
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(path));
+    REQUIRE(storage.Put("k", "v"));
+    uint64_t sizeBefore = storage.GetFileSize();
+
+    // 超過單筆紀錄上限的交易無法寫入，前面的項目也不能套用到快取
+    WidgetStorageBatch batch;
+    batch.Put("small", "1");
+    batch.Remove("k");
+    batch.Put("huge", std::string(MutationJournal::MAX_PAYLOAD_SIZE, 'x'));
+    CHECK(!storage.Commit(batch));
+    CHECK(!storage.Contains("small"));
+    CHECK(storage.Contains("k"));
+    CHECK(storage.GetFileSize() == sizeBefore);
+
+    storage.Close();
+    REQUIRE(storage.Open(path));
+    CHECK(storage.GetEntryCount() == 1);
+}
+
+TEST_CASE(RemovePrefixRemovesOnlyMatchingKeys) {
+    test::TempDirectory dir;
+    std::wstring path = (dir.GetPath() / "widgets.db").wstring();
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(path));
+    WidgetStorageBatch batch;
+    batch.Put("Fences", "root");
+    batch.Put("Fences/1", "a");
+    batch.Put("Fences/2", "b");
+    batch.Put("Fences/2/icons", "c");
+    batch.Put("FencesX/1", "d");
+    batch.Put("Notes/1", "e");
+    REQUIRE(storage.Commit(batch));
+
+    REQUIRE(storage.RemovePrefix("Fences/"));
+    std::map<std::string, std::string> expected = { { "Fences", "root" }, { "FencesX/1", "d" }, { "Notes/1", "e" } };
+    CHECK(ReadAll(storage) == expected);
+
+    // 沒有符合的項目時不寫入任何紀錄
+    uint64_t size = storage.GetFileSize();
+    CHECK(storage.RemovePrefix("Missing/"));
+    CHECK(storage.GetFileSize() == size);
+
+    storage.Close();
+    REQUIRE(storage.Open(path));
+    CHECK(ReadAll(storage) == expected);
+}
+
+TEST_CASE(TornRemovePrefixKeepsAllKeys) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "widgets.db";
+
+    std::map<std::string, std::string> before;
+    {
+        FileWidgetStorage storage;
+        REQUIRE(storage.Open(file.wstring()));
+        WidgetStorageBatch batch;
+        for (int i = 0; i < 50; ++i) {
+            batch.Put("Fences/" + std::to_string(i), std::string(i, 'v'));
+        }
+        batch.Put("Notes/1", "n");
+        REQUIRE(storage.Commit(batch));
+        before = ReadAll(storage);
+
+        uint64_t size = storage.GetFileSize();
+        REQUIRE(storage.RemovePrefix("Fences/"));
+        CHECK(storage.GetEntryCount() == 1);
+        // 整個前綴的刪除是一筆交易
+        CHECK(storage.GetFileSize() > size);
+    }
+
+    // 刪除交易寫到一半：不會只刪掉一部分
+    TearTail(file, 5);
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(file.wstring()));
+    CHECK(ReadAll(storage) == before);
+}
+
+TEST_CASE(AutomaticCompactionPreservesContent) {
+    test::TempDirectory dir;
+    std::wstring path = (dir.GetPath() / "widgets.db").wstring();
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(path));
+    REQUIRE(storage.Put("Notes/keep", "keep"));
+
+    // 反覆覆寫同一個鍵：失效資料累積到門檻後自動壓縮
+    std::string value(1000, 'a');
+    uint64_t largestSize = 0;
+    for (int i = 0; i < 2000; ++i) {
+        value[0] = static_cast<char>('a' + i % 26);
+        REQUIRE(storage.Put("Fences/state", value));
+        if (storage.GetFileSize() > largestSize) {
+            largestSize = storage.GetFileSize();
+        }
+    }
+    CHECK(largestSize < 2000u * 1000u);
+    CHECK(storage.GetFileSize() < 512 * 1024);
+
+    std::map<std::string, std::string> expected = ReadAll(storage);
+    storage.Close();
+    REQUIRE(storage.Open(path));
+    CHECK(ReadAll(storage) == expected);
+    CHECK(storage.GetEntryCount() == 2);
+}
+
+TEST_CASE(CompactSplitsLargeContentIntoChunks) {
+    test::TempDirectory dir;
+    std::wstring path = (dir.GetPath() / "widgets.db").wstring();
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(path));
+
+    // 總量超過單筆紀錄上限：壓縮必須分成多筆交易
+    for (int batchIndex = 0; batchIndex < 6; ++batchIndex) {
+        WidgetStorageBatch batch;
+        for (int i = 0; i < 100; ++i) {
+            batch.Put("Icons/" + std::to_string(batchIndex) + "/" + std::to_string(i), std::string(4000, char('A' + i % 26)));
+        }
+        REQUIRE(storage.Commit(batch));
+    }
+    REQUIRE(storage.RemovePrefix("Icons/0/"));
+    std::map<std::string, std::string> expected = ReadAll(storage);
+    uint64_t sizeBefore = storage.GetFileSize();
+
+    REQUIRE(storage.Compact());
+    CHECK(storage.GetFileSize() < sizeBefore);
+    CHECK(ReadAll(storage) == expected);
+
+    storage.Close();
+    REQUIRE(storage.Open(path));
+    CHECK(ReadAll(storage) == expected);
+    CHECK(storage.GetEntryCount() == 500);
+}
+
+TEST_CASE(InterruptedCompactionReplaysToSameContent) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "widgets.db";
+
+    std::map<std::string, std::string> expected;
+    {
+        FileWidgetStorage storage;
+        REQUIRE(storage.Open(file.wstring()));
+        REQUIRE(storage.Put("a", "1"));
+        REQUIRE(storage.Put("b", "2"));
+        REQUIRE(storage.Put("a", "3"));
+        REQUIRE(storage.Remove("b"));
+        REQUIRE(storage.Put("c", "4"));
+        expected = ReadAll(storage);
+    }
+
+    // 壓縮已追加目前內容，但在捨棄舊紀錄之前當機：
+    // 舊紀錄加上新追加的完整快照，回放結果相同
+    {
+        MutationJournal journal;
+        REQUIRE(journal.Open(file.wstring(), 0, nullptr));
+        JournalPayloadWriter payload;
+        payload.PutUInt(static_cast<uint32_t>(expected.size()));
+        for (const auto& entry : expected) {
+            payload.PutBool(false);
+            payload.PutBytes(entry.first);
+            payload.PutBytes(entry.second);
+        }
+        REQUIRE(journal.Append(1, payload) != 0);
+    }
+
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open(file.wstring()));
+    CHECK(ReadAll(storage) == expected);
+
+    // 快照那筆也只寫了一半
+    storage.Close();
+    TearTail(file, 1);
+    REQUIRE(storage.Open(file.wstring()));
+    CHECK(ReadAll(storage) == expected);
+}
+
+TEST_CASE(ForEachVisitsPrefixInKeyOrder) {
+    test::TempDirectory dir;
+    FileWidgetStorage storage;
+    REQUIRE(storage.Open((dir.GetPath() / "widgets.db").wstring()));
+    REQUIRE(storage.Put("b/2", ""));
+    REQUIRE(storage.Put("a/1", ""));
+    REQUIRE(storage.Put("b/1", ""));
+    REQUIRE(storage.Put("c", ""));
+
+    std::string visited;
+    storage.ForEach("b/", [&](const std::string& key, const std::string&) {
+        visited += key + ";";
+    });
+    CHECK(visited == "b/1;b/2;");
+}
+
+int main() {
+    return test::RunAll();
+}
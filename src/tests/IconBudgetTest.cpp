@@ -0,0 +1,162 @@
+#include "TestSupport.h"
+#include "widgets/IconBudget.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+const size_t ICON_BYTES = 1000;
+
+IconBudget MakeBudget(size_t maxBytes, size_t maxHandles) {
+    IconBudget budget;
+    IconBudget::Limits limits;
+    limits.maxBytes = maxBytes;
+    limits.maxHandles = maxHandles;
+    budget.SetLimits(limits);
+    return budget;
+}
+
+IconBudget::Candidate MakeCandidate(uint64_t id, IconBudget::Tier tier, uint64_t lastUse) {
+    IconBudget::Candidate candidate;
+    candidate.id = id;
+    candidate.tier = tier;
+    candidate.lastUse = lastUse;
+    candidate.usage.bytes = ICON_BYTES;
+    candidate.usage.handles = 2;
+    return candidate;
+}
+
+IconBudget::Usage SumUsage(const std::vector<IconBudget::Candidate>& candidates) {
+    IconBudget::Usage usage = { 0, 0 };
+    for (const auto& candidate : candidates) {
+        usage.bytes += candidate.usage.bytes;
+        usage.handles += candidate.usage.handles;
+    }
+    return usage;
+}
+
+bool Contains(const std::vector<uint64_t>& ids, uint64_t id) {
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+} // namespace
+
+TEST_CASE(UnderBudgetEvictsNothing) {
+    IconBudget budget = MakeBudget(10 * ICON_BYTES, 1000);
+    std::vector<IconBudget::Candidate> candidates;
+    for (uint64_t i = 0; i < 10; ++i) {
+        candidates.push_back(MakeCandidate(i, IconBudget::TIER_OFFSCREEN, i));
+    }
+    IconBudget::Usage usage = SumUsage(candidates);
+    CHECK(!budget.IsOverBudget(usage));
+
+    std::vector<uint64_t> victims;
+    IconBudget::Usage after = budget.SelectVictims(candidates, usage, victims);
+    CHECK(victims.empty());
+    CHECK(after.bytes == usage.bytes);
+}
+
+TEST_CASE(EvictsLowerTiersFirstThenLeastRecentlyUsed) {
+    IconBudget budget = MakeBudget(4 * ICON_BYTES, 1000);
+    // 層級與使用時間刻意交錯：較低層級的圖示即使最近才用過也先淘汰
+    std::vector<IconBudget::Candidate> candidates;
+    candidates.push_back(MakeCandidate(1, IconBudget::TIER_NEARBY, 1));
+    candidates.push_back(MakeCandidate(2, IconBudget::TIER_OFFSCREEN, 9));
+    candidates.push_back(MakeCandidate(3, IconBudget::TIER_OFFSCREEN, 5));
+    candidates.push_back(MakeCandidate(4, IconBudget::TIER_UNUSED_SIZE, 20));
+    candidates.push_back(MakeCandidate(5, IconBudget::TIER_COLLAPSED, 2));
+    candidates.push_back(MakeCandidate(6, IconBudget::TIER_NEARBY, 0));
+    candidates.push_back(MakeCandidate(7, IconBudget::TIER_VISIBLE, 3));
+    candidates.push_back(MakeCandidate(8, IconBudget::TIER_VISIBLE, 4));
+
+    // 8 個圖示、上限 4 個：淘汰到 3 個（75%）為止，共 5 個
+    std::vector<uint64_t> victims;
+    IconBudget::Usage after = budget.SelectVictims(candidates, SumUsage(candidates), victims);
+    REQUIRE(victims.size() == 5);
+    CHECK(victims[0] == 4);     // 不再繪製的尺寸
+    CHECK(victims[1] == 5);     // 收合
+    CHECK(victims[2] == 3);     // 捲動範圍外，較久未使用
+    CHECK(victims[3] == 2);
+    CHECK(victims[4] == 6);     // 上下一頁內，較久未使用
+    CHECK(after.bytes == 3 * ICON_BYTES);
+    CHECK(!Contains(victims, 1));
+}
+
+TEST_CASE(StopsAtLowWatermark) {
+    IconBudget budget = MakeBudget(100 * ICON_BYTES, 100000);
+    std::vector<IconBudget::Candidate> candidates;
+    for (uint64_t i = 0; i < 120; ++i) {
+        candidates.push_back(MakeCandidate(i, IconBudget::TIER_OFFSCREEN, i));
+    }
+    IconBudget::Usage usage = SumUsage(candidates);
+    CHECK(budget.IsOverBudget(usage));
+
+    std::vector<uint64_t> victims;
+    IconBudget::Usage after = budget.SelectVictims(candidates, usage, victims);
+    size_t target = budget.GetLimits().maxBytes / 100 * IconBudget::LOW_WATERMARK_PERCENT;
+    CHECK(after.bytes <= target);
+    CHECK(after.bytes + ICON_BYTES > target);   // 到目標就停止，不多淘汰
+    CHECK(victims.size() == 45);
+    for (uint64_t id = 0; id < 45; ++id) {
+        CHECK(Contains(victims, id));           // 最久未使用的先淘汰
+    }
+    CHECK(!budget.IsOverBudget(after));
+    CHECK(!budget.IsAboveLowWatermark(after));
+}
+
+TEST_CASE(HandleLimitAlsoTriggersEviction) {
+    IconBudget budget = MakeBudget(1000 * ICON_BYTES, 20);
+    std::vector<IconBudget::Candidate> candidates;
+    for (uint64_t i = 0; i < 12; ++i) {
+        candidates.push_back(MakeCandidate(i, IconBudget::TIER_COLLAPSED, i));
+    }
+
+    // 24 個控制代碼、上限 20：降到 15 個以下
+    std::vector<uint64_t> victims;
+    IconBudget::Usage after = budget.SelectVictims(candidates, SumUsage(candidates), victims);
+    CHECK(victims.size() == 5);
+    CHECK(after.handles == 14);
+}
+
+TEST_CASE(NeverEvictsVisibleIcons) {
+    IconBudget budget = MakeBudget(4 * ICON_BYTES, 1000);
+    std::vector<IconBudget::Candidate> candidates;
+    for (uint64_t i = 0; i < 10; ++i) {
+        candidates.push_back(MakeCandidate(i, IconBudget::TIER_VISIBLE, i));
+    }
+    candidates.push_back(MakeCandidate(100, IconBudget::TIER_NEARBY, 50));
+
+    // 只有可見的圖示也超出上限時，淘汰其餘的之後停止
+    std::vector<uint64_t> victims;
+    IconBudget::Usage after = budget.SelectVictims(candidates, SumUsage(candidates), victims);
+    REQUIRE(victims.size() == 1);
+    CHECK(victims[0] == 100);
+    CHECK(after.bytes == 10 * ICON_BYTES);
+    CHECK(budget.IsOverBudget(after));
+}
+
+TEST_CASE(LowWatermarkGatesPrefetch) {
+    IconBudget budget = MakeBudget(100 * ICON_BYTES, 100);
+    IconBudget::Usage usage = { 75 * ICON_BYTES, 10 };
+    CHECK(!budget.IsAboveLowWatermark(usage));
+    usage.bytes += 1;
+    CHECK(budget.IsAboveLowWatermark(usage));
+    CHECK(!budget.IsOverBudget(usage));
+
+    usage.bytes = 0;
+    usage.handles = 76;
+    CHECK(budget.IsAboveLowWatermark(usage));
+}
+
+TEST_CASE(IconUsageCountsColorAndMask) {
+    IconBudget::Usage usage = IconBudget::GetIconUsage(48);
+    CHECK(usage.handles == 2);
+    // 48 × 48 × 4 位元組的色彩點陣圖，遮罩每列 48 位元補齊為 6 位元組
+    CHECK(usage.bytes == 48 * 48 * 4 + 6 * 48);
+    CHECK(IconBudget::GetIconUsage(20).bytes == 20 * 20 * 4 + 4 * 20);
+}
+
+int main() {
+    return test::RunAll();
+}
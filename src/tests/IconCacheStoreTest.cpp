@@ -0,0 +1,316 @@
+#include "TestSupport.h"
+#include "widgets/IconCacheStore.h"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 映射的檔案以頁面對齊：測試以 uint64_t 陣列保存，確保標頭與紀錄表對齊
+class AlignedBuffer {
+public:
+    explicit AlignedBuffer(const std::string& data)
+        : words_((data.size() + 7) / 8 + 1, 0)
+        , size_(data.size()) {
+        std::memcpy(words_.data(), data.data(), data.size());
+    }
+
+    char* GetData() { return reinterpret_cast<char*>(words_.data()); }
+    size_t GetSize() const { return size_; }
+
+    IconCacheFileHeader& GetHeader() { return *reinterpret_cast<IconCacheFileHeader*>(GetData()); }
+    IconCacheRecord& GetRecord(uint32_t index) {
+        return reinterpret_cast<IconCacheRecord*>(GetData() + GetHeader().recordTableOffset)[index];
+    }
+
+private:
+    std::vector<uint64_t> words_;
+    size_t size_;
+};
+
+std::vector<uint32_t> MakePixels(uint32_t width, uint32_t height, uint32_t seed) {
+    std::vector<uint32_t> pixels(size_t(width) * height);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = 0xFF000000u | (uint32_t)(i * 2654435761u + seed);
+    }
+    return pixels;
+}
+
+IconCacheStamp MakeStamp(uint64_t lastWriteTime, uint64_t fileSize) {
+    IconCacheStamp stamp;
+    stamp.lastWriteTime = lastWriteTime;
+    stamp.fileSize = fileSize;
+    return stamp;
+}
+
+// 兩個路徑鍵、一個類型鍵；同一鍵有兩種尺寸
+std::string MakeCacheFile() {
+    IconCacheStore store;
+    std::vector<uint32_t> small = MakePixels(32, 32, 1);
+    std::vector<uint32_t> large = MakePixels(48, 48, 2);
+    std::vector<uint32_t> type = MakePixels(16, 24, 3);
+    store.Put(L"C:\\Users\\使用者\\Desktop\\報告.docx", 32, MakeStamp(100, 2000), 32, 32, small.data());
+    store.Put(L"C:\\Users\\使用者\\Desktop\\報告.docx", 48, MakeStamp(100, 2000), 48, 48, large.data());
+    store.Put(L".txt", 32, MakeStamp(0, 0), 16, 24, type.data());
+    return store.Serialize();
+}
+
+bool SamePixels(const IconCacheImage& image, const std::vector<uint32_t>& pixels) {
+    return image.pixels && size_t(image.width) * image.height == pixels.size() &&
+           std::memcmp(image.pixels, pixels.data(), pixels.size() * sizeof(uint32_t)) == 0;
+}
+
+bool Attaches(const std::function<void(AlignedBuffer&)>& corrupt) {
+    AlignedBuffer buffer(MakeCacheFile());
+    corrupt(buffer);
+    IconCacheStore store;
+    return store.Attach(buffer.GetData(), buffer.GetSize());
+}
+
+// 損壞所有紀錄的同一欄位後，Attach 仍成功，但紀錄查不到、序列化時也被捨棄
+void CheckRecordRejected(const std::function<void(IconCacheRecord&)>& corrupt) {
+    AlignedBuffer buffer(MakeCacheFile());
+    IconCacheStore store;
+    REQUIRE(store.Attach(buffer.GetData(), buffer.GetSize()));
+    for (uint32_t i = 0; i < buffer.GetHeader().recordCount; ++i) {
+        corrupt(buffer.GetRecord(i));
+    }
+
+    IconCacheImage image;
+    CHECK(!store.Find(L"C:\\Users\\使用者\\Desktop\\報告.docx", 32, image));
+    CHECK(!store.Find(L".txt", 32, image));
+    store.Serialize();
+    CHECK(store.GetAttachedCount() == 0);
+}
+
+} // namespace
+
+TEST_CASE(RoundTripsThroughFile) {
+    AlignedBuffer buffer(MakeCacheFile());
+    IconCacheStore store;
+    REQUIRE(store.Attach(buffer.GetData(), buffer.GetSize()));
+    CHECK(store.GetAttachedCount() == 3);
+    CHECK(!store.IsDirty());
+
+    IconCacheImage image;
+    CHECK(!store.Find(L"c:\\users\\使用者\\desktop\\報告.docx", 32, image));  // 鍵已由 IconCache::MakeKey 正規化，這裡區分大小寫
+    REQUIRE(store.Find(L"C:\\Users\\使用者\\Desktop\\報告.docx", 48, image));
+    CHECK(image.width == 48 && image.height == 48);
+    CHECK(image.stamp == MakeStamp(100, 2000));
+    CHECK(SamePixels(image, MakePixels(48, 48, 2)));
+    CHECK(reinterpret_cast<uintptr_t>(image.pixels) % 16 == 0);  // 直接指向映射的檔案
+
+    REQUIRE(store.Find(L".txt", 32, image));
+    CHECK(image.width == 16 && image.height == 24);
+    CHECK(SamePixels(image, MakePixels(16, 24, 3)));
+    CHECK(!store.Find(L".txt", 48, image));
+}
+
+TEST_CASE(ReportsStampsForStalenessChecks) {
+    AlignedBuffer buffer(MakeCacheFile());
+    IconCacheStore store;
+    REQUIRE(store.Attach(buffer.GetData(), buffer.GetSize()));
+
+    // 來源的修改時間或大小任一不同即視為過期
+    IconCacheImage image;
+    REQUIRE(store.Find(L"C:\\Users\\使用者\\Desktop\\報告.docx", 32, image));
+    CHECK(image.stamp == MakeStamp(100, 2000));
+    CHECK(image.stamp != MakeStamp(101, 2000));
+    CHECK(image.stamp != MakeStamp(100, 2001));
+
+    // 重新提取的圖示取代過期的紀錄：Put 的優先，序列化後只留下新的
+    std::vector<uint32_t> fresh = MakePixels(32, 32, 9);
+    store.Put(L"C:\\Users\\使用者\\Desktop\\報告.docx", 32, MakeStamp(200, 2100), 32, 32, fresh.data());
+    CHECK(store.IsDirty());
+    REQUIRE(store.Find(L"C:\\Users\\使用者\\Desktop\\報告.docx", 32, image));
+    CHECK(image.stamp == MakeStamp(200, 2100));
+
+    AlignedBuffer rewritten(store.Serialize());
+    CHECK(!store.IsDirty());
+    IconCacheStore reloaded;
+    REQUIRE(reloaded.Attach(rewritten.GetData(), rewritten.GetSize()));
+    CHECK(reloaded.GetAttachedCount() == 3);
+    REQUIRE(reloaded.Find(L"C:\\Users\\使用者\\Desktop\\報告.docx", 32, image));
+    CHECK(image.stamp == MakeStamp(200, 2100));
+    CHECK(SamePixels(image, fresh));
+    REQUIRE(reloaded.Find(L"C:\\Users\\使用者\\Desktop\\報告.docx", 48, image));
+    CHECK(image.stamp == MakeStamp(100, 2000));
+}
+
+TEST_CASE(SerializeDetachesOriginalBuffer) {
+    AlignedBuffer buffer(MakeCacheFile());
+    IconCacheStore store;
+    REQUIRE(store.Attach(buffer.GetData(), buffer.GetSize()));
+    store.Serialize();
+
+    // 原本的緩衝區可以被覆寫（例如關閉映射後取代檔案）
+    std::memset(buffer.GetData(), 0xCD, buffer.GetSize());
+    IconCacheImage image;
+    REQUIRE(store.Find(L".txt", 32, image));
+    CHECK(SamePixels(image, MakePixels(16, 24, 3)));
+}
+
+TEST_CASE(RejectsCorruptHeader) {
+    CHECK(Attaches([](AlignedBuffer&) {}));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().magic[0] = 'X'; }));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().version = ICON_CACHE_VERSION + 1; }));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().headerSize = 8; }));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().recordTableOffset += 4; }));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().recordCount = 0x10000000; }));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().stringPoolSize = 0xFFFFFFF0u; }));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().pixelDataOffset += 8; }));
+    CHECK(!Attaches([](AlignedBuffer& b) { b.GetHeader().pixelDataSize = ~uint64_t(0) - 4; }));
+
+    std::string data = MakeCacheFile();
+    IconCacheStore store;
+    AlignedBuffer truncated(data.substr(0, data.size() - 1));
+    CHECK(!store.Attach(truncated.GetData(), truncated.GetSize()));
+    AlignedBuffer header(data.substr(0, sizeof(IconCacheFileHeader) - 1));
+    CHECK(!store.Attach(header.GetData(), header.GetSize()));
+    CHECK(!store.IsAttached());
+
+    // 未對齊的緩衝區
+    std::vector<uint64_t> words(data.size() / 8 + 2);
+    char* misaligned = reinterpret_cast<char*>(words.data()) + 1;
+    std::memcpy(misaligned, data.data(), data.size());
+    CHECK(!store.Attach(misaligned, data.size()));
+}
+
+TEST_CASE(RejectsCorruptRecords) {
+    CheckRecordRejected([](IconCacheRecord& r) { r.keyOffset = 0xFFFFFF00u; });
+    CheckRecordRejected([](IconCacheRecord& r) { r.keyLength += 1000; });
+    CheckRecordRejected([](IconCacheRecord& r) { r.pixelOffset += 2; });
+    CheckRecordRejected([](IconCacheRecord& r) { r.pixelOffset = ~uint64_t(0) - 3; });
+    CheckRecordRejected([](IconCacheRecord& r) { r.height = ICON_CACHE_MAX_DIMENSION + 1; });
+    CheckRecordRejected([](IconCacheRecord& r) { r.width = 0; });
+
+    // 鍵與雜湊不符：查詢找不到，序列化時捨棄
+    AlignedBuffer buffer(MakeCacheFile());
+    for (uint32_t i = 0; i < buffer.GetHeader().recordCount; ++i) {
+        buffer.GetRecord(i).keyHash ^= 1;
+    }
+    IconCacheStore store;
+    REQUIRE(store.Attach(buffer.GetData(), buffer.GetSize()));
+    IconCacheImage image;
+    CHECK(!store.Find(L".txt", 32, image));
+    store.Serialize();
+    CHECK(store.GetAttachedCount() == 0);
+}
+
+TEST_CASE(EnforcesDimensionLimits) {
+    IconCacheStore store;
+    std::vector<uint32_t> pixels(size_t(ICON_CACHE_MAX_DIMENSION + 1) * 2, 0xFF112233u);
+
+    // 超過邊長上限或空的點陣圖不寫入
+    store.Put(L"wide", 256, IconCacheStamp(), ICON_CACHE_MAX_DIMENSION + 1, 1, pixels.data());
+    store.Put(L"tall", 256, IconCacheStamp(), 1, ICON_CACHE_MAX_DIMENSION + 1, pixels.data());
+    store.Put(L"empty", 256, IconCacheStamp(), 0, 16, pixels.data());
+    CHECK(!store.IsDirty());
+
+    store.Put(L"max", 256, IconCacheStamp(), ICON_CACHE_MAX_DIMENSION, 2, pixels.data());
+    CHECK(store.IsDirty());
+    AlignedBuffer buffer(store.Serialize());
+
+    IconCacheStore reloaded;
+    REQUIRE(reloaded.Attach(buffer.GetData(), buffer.GetSize()));
+    IconCacheImage image;
+    REQUIRE(reloaded.Find(L"max", 256, image));
+    CHECK(image.width == ICON_CACHE_MAX_DIMENSION && image.height == 2);
+
+    // 檔案中超過上限的紀錄視為損壞（即使像素範圍剛好在資料內）
+    buffer.GetRecord(0).width = ICON_CACHE_MAX_DIMENSION * 2;
+    buffer.GetRecord(0).height = 1;
+    CHECK(!reloaded.Find(L"max", 256, image));
+}
+
+TEST_CASE(ConvertsPremultipliedAlpha) {
+    uint32_t pixels[] = { 0xFF336699u, 0x80FF8000u, 0x00FFFFFFu, 0x40404040u };
+    IconCacheStore::Premultiply(pixels, 4);
+    CHECK(pixels[0] == 0xFF336699u);
+    CHECK(pixels[1] == 0x80804000u);
+    CHECK(pixels[2] == 0x00000000u);
+    CHECK(pixels[3] == 0x40101010u);
+
+    IconCacheStore::Unpremultiply(pixels, 4);
+    CHECK(pixels[0] == 0xFF336699u);
+    CHECK(pixels[1] == 0x80FF8000u);
+    CHECK(pixels[2] == 0x00000000u);
+    CHECK(pixels[3] == 0x40404040u);
+}
+
+TEST_CASE(SerializeDropsRecordsNotRetained) {
+    const std::wstring report = L"C:\\Users\\使用者\\Desktop\\報告.docx";
+    AlignedBuffer buffer(MakeCacheFile());
+    IconCacheStore store;
+    REQUIRE(store.Attach(buffer.GetData(), buffer.GetSize()));
+    std::vector<uint32_t> added = MakePixels(32, 32, 7);
+    CHECK(store.Put(L"C:\\Removed.lnk", 32, MakeStamp(1, 1), 32, 32, added.data()));
+
+    // 柵欄只剩報告（改用 48px）與 .txt：32px 的報告與已移除的捷徑都捨棄
+    IconCacheStore::RetainKeys retain = { { report, 48 }, { L".txt", 32 }, { L".pdf", 32 } };
+    CHECK(store.CountUnretained(retain) == 1);
+    CHECK(store.CountUnretained({ { report, 32 }, { report, 48 }, { L".txt", 32 } }) == 0);
+
+    AlignedBuffer rewritten(store.Serialize(&retain));
+    IconCacheStore reloaded;
+    REQUIRE(reloaded.Attach(rewritten.GetData(), rewritten.GetSize()));
+    CHECK(reloaded.GetAttachedCount() == 2);
+    IconCacheImage image;
+    CHECK(reloaded.Find(report, 48, image));
+    CHECK(reloaded.Find(L".txt", 32, image));
+    CHECK(!reloaded.Find(report, 32, image));
+    CHECK(!reloaded.Find(L"C:\\Removed.lnk", 32, image));
+    CHECK(reloaded.CountUnretained(retain) == 0);
+}
+
+TEST_CASE(SerializeKeepsSmallestRecordsUnderByteCap) {
+    IconCacheStore store;
+    std::vector<uint32_t> small = MakePixels(32, 32, 1);
+    std::vector<uint32_t> large = MakePixels(256, 256, 2);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(store.Put(L"icon" + std::to_wstring(i), 32, MakeStamp(1, 1), 32, 32, small.data()));
+        CHECK(store.Put(L"icon" + std::to_wstring(i), 256, MakeStamp(1, 1), 256, 256, large.data()));
+    }
+
+    // 上限容得下全部 32px 與一筆 256px
+    const uint64_t cap = 4 * 32 * 32 * 4 + 256 * 256 * 4;
+    AlignedBuffer rewritten(store.Serialize(nullptr, cap));
+    CHECK(rewritten.GetHeader().pixelDataSize <= cap);
+    IconCacheStore reloaded;
+    REQUIRE(reloaded.Attach(rewritten.GetData(), rewritten.GetSize()));
+    CHECK(reloaded.GetAttachedCount() == 5);
+    IconCacheImage image;
+    for (int i = 0; i < 4; ++i) {
+        CHECK(reloaded.Find(L"icon" + std::to_wstring(i), 32, image));
+        CHECK(SamePixels(image, small));
+    }
+}
+
+TEST_CASE(BoundsPendingBytes) {
+    IconCacheStore store;
+    const size_t iconBytes = 48 * 48 * 4;
+    store.SetPendingLimit(3 * iconBytes);
+    std::vector<uint32_t> pixels = MakePixels(48, 48, 5);
+    CHECK(store.Put(L"a", 48, MakeStamp(1, 1), 48, 48, pixels.data()));
+    CHECK(store.Put(L"b", 48, MakeStamp(1, 1), 48, 48, pixels.data()));
+    CHECK(store.Put(L"c", 48, MakeStamp(1, 1), 48, 48, pixels.data()));
+    CHECK(store.GetPendingBytes() == 3 * iconBytes);
+
+    // 超過上限的不暫存；取代既有的不增加用量
+    CHECK(!store.Put(L"d", 48, MakeStamp(1, 1), 48, 48, pixels.data()));
+    CHECK(store.Put(L"a", 48, MakeStamp(2, 2), 48, 48, pixels.data()));
+    CHECK(store.GetPendingBytes() == 3 * iconBytes);
+    IconCacheImage image;
+    CHECK(!store.Find(L"d", 48, image));
+
+    // 寫出後暫存歸零，可以再加入
+    store.Serialize();
+    CHECK(store.GetPendingBytes() == 0);
+    CHECK(store.Put(L"d", 48, MakeStamp(1, 1), 48, 48, pixels.data()));
+}
+
+int main() {
+    return test::RunAll();
+}
@@ -0,0 +1,137 @@
+#include "TestSupport.h"
+#include "widgets/IconCompositor.h"
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+const IconCompositor::Kernel SIMD_KERNELS[] = {
+    IconCompositor::KERNEL_SSE2,
+    IconCompositor::KERNEL_AVX2,
+    IconCompositor::KERNEL_NEON,
+};
+
+// 逐位元比較 kernel 與純量版本的結果
+bool MatchesScalar(IconCompositor::Kernel kernel, const std::vector<uint32_t>& dst, size_t dstStride,
+                   const uint32_t* src, size_t srcStride, uint32_t width, uint32_t height, size_t dstOffset = 0) {
+    std::vector<uint32_t> expected = dst;
+    std::vector<uint32_t> actual = dst;
+    IconCompositor::BlendOver(IconCompositor::KERNEL_SCALAR, expected.data() + dstOffset, dstStride, src, srcStride,
+                              width, height);
+    IconCompositor::BlendOver(kernel, actual.data() + dstOffset, dstStride, src, srcStride, width, height);
+    return expected == actual;
+}
+
+} // namespace
+
+TEST_CASE(ScalarMatchesFormula) {
+    // dst = src + dst * (255 - srcAlpha) / 255（四捨五入，超過 255 時飽和）
+    uint32_t dst[] = { 0xFF204060u, 0xFF204060u, 0xFF204060u, 0x80808080u, 0xFFFFFFFFu };
+    const uint32_t src[] = { 0xFF010203u, 0x00000000u, 0x80402010u, 0x00000000u, 0x40FF0000u };
+    IconCompositor::BlendOver(IconCompositor::KERNEL_SCALAR, dst, 5, src, 5, 5, 1);
+    CHECK(dst[0] == 0xFF010203u);   // 不透明：直接取代
+    CHECK(dst[1] == 0xFF204060u);   // 全透明：保留目的
+    CHECK(dst[2] == 0xFF504040u);   // 目的 0x20、0x40、0x60 乘以 127 / 255 後為 16、32、48
+    CHECK(dst[3] == 0x80808080u);
+    CHECK(dst[4] == 0xFFFFBFBFu);   // 未預乘的來源：通道飽和
+}
+
+TEST_CASE(KernelsMatchScalarExhaustively) {
+    // 所有 (來源 alpha, 來源通道, 目的通道) 的組合：每列 256 個目的值，共 256 × 256 列
+    const uint32_t width = 256;
+    const uint32_t height = 256 * 256;
+    std::vector<uint32_t> src(size_t(width) * height);
+    std::vector<uint32_t> dst(src.size());
+    for (uint32_t alpha = 0; alpha < 256; ++alpha) {
+        for (uint32_t channel = 0; channel < 256; ++channel) {
+            size_t row = (size_t(alpha) * 256 + channel) * width;
+            uint32_t pixel = (alpha << 24) | (channel << 16) | ((channel * alpha / 255) << 8) | (255 - channel);
+            for (uint32_t d = 0; d < width; ++d) {
+                src[row + d] = pixel;
+                dst[row + d] = (d << 24) | (d << 16) | ((255 - d) << 8) | (d ^ 0x5A);
+            }
+        }
+    }
+
+    for (IconCompositor::Kernel kernel : SIMD_KERNELS) {
+        if (!IconCompositor::IsSupported(kernel)) {
+            std::printf("  %s not supported here, skipped\n", IconCompositor::GetKernelName(kernel));
+            continue;
+        }
+        bool same = MatchesScalar(kernel, dst, width, src.data(), width, width, height);
+        CHECK(same);
+        if (!same) {
+            std::fprintf(stderr, "  %s differs from scalar\n", IconCompositor::GetKernelName(kernel));
+        }
+    }
+}
+
+TEST_CASE(KernelsMatchScalarOnRandomRects) {
+    // 各種寬度（含尾端不足一個向量的部分）、未對齊的起點與 stride，來源混合整片透明 / 不透明
+    std::mt19937 rng(99);
+    for (int round = 0; round < 400; ++round) {
+        uint32_t width = 1 + rng() % 70;
+        uint32_t height = 1 + rng() % 9;
+        size_t srcStride = width + rng() % 5;
+        size_t dstStride = width + rng() % 5;
+        size_t srcOffset = rng() % 4;
+        size_t dstOffset = rng() % 4;
+
+        std::vector<uint32_t> src(srcOffset + srcStride * height);
+        for (auto& pixel : src) {
+            uint32_t kind = rng() % 4;
+            pixel = (kind == 0) ? 0u : (kind == 1) ? (0xFF000000u | (rng() & 0xFFFFFF)) : (uint32_t)rng();
+        }
+        std::vector<uint32_t> dst(dstOffset + dstStride * height);
+        for (auto& pixel : dst) {
+            pixel = (uint32_t)rng();
+        }
+
+        for (IconCompositor::Kernel kernel : SIMD_KERNELS) {
+            if (!IconCompositor::IsSupported(kernel)) {
+                continue;
+            }
+            bool same = MatchesScalar(kernel, dst, dstStride, src.data() + srcOffset, srcStride, width, height,
+                                      dstOffset);
+            CHECK(same);
+            if (!same) {
+                return;
+            }
+        }
+    }
+}
+
+TEST_CASE(LeavesStridePaddingUntouched) {
+    const uint32_t width = 13;
+    const size_t stride = 16;
+    std::vector<uint32_t> src(stride * 4, 0x80402010u);
+    for (IconCompositor::Kernel kernel : { IconCompositor::KERNEL_SCALAR, IconCompositor::GetDefaultKernel() }) {
+        std::vector<uint32_t> dst(stride * 4, 0xDEADBEEFu);
+        IconCompositor::BlendOver(kernel, dst.data(), stride, src.data(), stride, width, 4);
+        for (size_t y = 0; y < 4; ++y) {
+            for (size_t x = width; x < stride; ++x) {
+                CHECK(dst[y * stride + x] == 0xDEADBEEFu);
+            }
+        }
+    }
+}
+
+TEST_CASE(UnsupportedKernelFallsBackToScalar) {
+    CHECK(IconCompositor::IsSupported(IconCompositor::KERNEL_SCALAR));
+    CHECK(IconCompositor::IsSupported(IconCompositor::GetDefaultKernel()));
+
+    std::vector<uint32_t> src(64, 0x7F3F1F0Fu);
+    std::vector<uint32_t> expected(64, 0xFF808080u);
+    IconCompositor::BlendOver(IconCompositor::KERNEL_SCALAR, expected.data(), 64, src.data(), 64, 64, 1);
+    for (IconCompositor::Kernel kernel : SIMD_KERNELS) {
+        std::vector<uint32_t> dst(64, 0xFF808080u);
+        IconCompositor::BlendOver(kernel, dst.data(), 64, src.data(), 64, 64, 1);
+        CHECK(dst == expected);
+    }
+}
+
+int main() {
+    return test::RunAll();
+}
@@ -0,0 +1,283 @@
+#include "TestSupport.h"
+#include "widgets/IconScaler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const IconCompositor::Kernel SIMD_KERNELS[] = {
+    IconCompositor::KERNEL_SSE2,
+    IconCompositor::KERNEL_AVX2,
+    IconCompositor::KERNEL_NEON,
+};
+
+const double PI = 3.14159265358979323846;
+
+double ReferenceLanczos(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    if (std::fabs(x) >= 3.0) {
+        return 0.0;
+    }
+    return 3.0 * std::sin(PI * x) * std::sin(PI * x / 3.0) / (PI * PI * x * x);
+}
+
+uint32_t ClampToAlpha(const double channels[4]) {
+    uint32_t value[4];
+    for (int c = 0; c < 4; ++c) {
+        double rounded = std::floor(channels[c] + 0.5);
+        value[c] = (uint32_t)(rounded < 0.0 ? 0.0 : rounded > 255.0 ? 255.0 : rounded);
+    }
+    uint32_t result = value[3] << 24;
+    for (int c = 0; c < 3; ++c) {
+        result |= (std::min)(value[c], value[3]) << (c * 8);
+    }
+    return result;
+}
+
+// 一個方向的 Lanczos-3（浮點權重、不定點化），邊緣重複最外側的像素
+std::vector<uint32_t> ReferencePass(const std::vector<uint32_t>& src, uint32_t srcSize, uint32_t lines,
+                                    uint32_t dstSize, bool horizontal) {
+    double scale = double(srcSize) / dstSize;
+    double filterScale = (std::max)(scale, 1.0);
+    double support = 3.0 * filterScale;
+    std::vector<uint32_t> dst(size_t(dstSize) * lines);
+    for (uint32_t line = 0; line < lines; ++line) {
+        for (uint32_t i = 0; i < dstSize; ++i) {
+            double center = (i + 0.5) * scale - 0.5;
+            int first = (int)std::floor(center - support) + 1;
+            int last = (int)std::floor(center + support);
+            double sums[4] = { 0, 0, 0, 0 };
+            double total = 0.0;
+            for (int k = first; k <= last; ++k) {
+                double weight = ReferenceLanczos((k - center) / filterScale);
+                int index = (std::min)((std::max)(k, 0), (int)srcSize - 1);
+                uint32_t pixel = horizontal ? src[size_t(line) * srcSize + index] : src[size_t(index) * lines + line];
+                for (int c = 0; c < 4; ++c) {
+                    sums[c] += weight * ((pixel >> (c * 8)) & 0xFF);
+                }
+                total += weight;
+            }
+            for (double& sum : sums) {
+                sum /= total;
+            }
+            uint32_t pixel = ClampToAlpha(sums);
+            if (horizontal) {
+                dst[size_t(line) * dstSize + i] = pixel;
+            } else {
+                dst[size_t(i) * lines + line] = pixel;
+            }
+        }
+    }
+    return dst;
+}
+
+std::vector<uint32_t> ReferenceResample(const std::vector<uint32_t>& src, uint32_t srcWidth, uint32_t srcHeight,
+                                        uint32_t dstWidth, uint32_t dstHeight) {
+    std::vector<uint32_t> rows = ReferencePass(src, srcWidth, srcHeight, dstWidth, true);
+    return ReferencePass(rows, srcHeight, dstWidth, dstHeight, false);
+}
+
+// 通道差異的最大值，以及差異超過 1 的通道數
+int MaxChannelDifference(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, size_t* over1 = nullptr) {
+    int worst = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            int diff = std::abs(int((a[i] >> shift) & 0xFF) - int((b[i] >> shift) & 0xFF));
+            worst = (std::max)(worst, diff);
+            count += (diff > 1) ? 1 : 0;
+        }
+    }
+    if (over1) {
+        *over1 = count;
+    }
+    return worst;
+}
+
+// 預乘 alpha 的測試圖示：漸層背景上有硬邊的不透明方塊與半透明圓形（負瓣會在硬邊造成振鈴）
+std::vector<uint32_t> MakeIcon(uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> pixels(size_t(width) * height);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t alpha = 40 + (x * 180) / width;
+            uint32_t r = (y * 255 / height) * alpha / 255;
+            uint32_t g = (x * 255 / width) * alpha / 255;
+            uint32_t b = (rng() & 0xFF) * alpha / 255;
+            if (x > width / 4 && x < width / 2 && y > height / 4 && y < height * 3 / 4) {
+                alpha = 255;
+                r = 255;
+                g = 0;
+                b = 0;
+            }
+            double dx = x - width * 0.7;
+            double dy = y - height * 0.4;
+            if (dx * dx + dy * dy < width * height * 0.02) {
+                alpha = 0;
+                r = g = b = 0;
+            }
+            pixels[size_t(y) * width + x] = (alpha << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+    return pixels;
+}
+
+bool IsPremultiplied(const std::vector<uint32_t>& pixels) {
+    for (uint32_t pixel : pixels) {
+        uint32_t alpha = pixel >> 24;
+        if ((pixel & 0xFF) > alpha || ((pixel >> 8) & 0xFF) > alpha || ((pixel >> 16) & 0xFF) > alpha) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(HalveAveragesWithRounding) {
+    // 2×2 區塊各通道取平均並四捨五入；奇數的最後一欄捨去
+    const uint32_t src[] = {
+        0x00000000u, 0x04040404u, 0xFFFFFFFFu,
+        0x01010101u, 0x01020304u, 0x80808080u,
+    };
+    uint32_t dst[1] = {};
+    IconScaler::Halve(IconCompositor::KERNEL_SCALAR, src, 3, 2, dst);
+    CHECK(dst[0] == 0x02020202u);   // (0 + 4 + 1 + 1 + 2) / 4 = 1.5 → 2、(0 + 4 + 1 + 4 + 2) / 4 = 2.25 → 2
+
+    std::vector<uint32_t> flat(64 * 64, 0xC0604020u);
+    std::vector<uint32_t> half(32 * 32);
+    IconScaler::Halve(IconCompositor::KERNEL_SCALAR, flat.data(), 64, 64, half.data());
+    CHECK(std::all_of(half.begin(), half.end(), [](uint32_t p) { return p == 0xC0604020u; }));
+}
+
+TEST_CASE(FlatColorStaysExact) {
+    // 定點權重總和精確為 1：平坦區域縮放後不變色
+    const uint32_t color = 0x80402010u;
+    const uint32_t sizes[][2] = { { 256, 96 }, { 256, 128 }, { 48, 256 }, { 100, 37 }, { 17, 17 }, { 32, 200 } };
+    for (const auto& size : sizes) {
+        std::vector<uint32_t> src(size_t(size[0]) * size[0], color);
+        std::vector<uint32_t> dst(size_t(size[1]) * size[1]);
+        IconScaler::Scale(IconCompositor::KERNEL_SCALAR, src.data(), size[0], size[0], dst.data(), size[1], size[1]);
+        CHECK(std::all_of(dst.begin(), dst.end(), [&](uint32_t p) { return p == color; }));
+    }
+}
+
+TEST_CASE(ResampleMatchesFloatingPointReference) {
+    // 與浮點的 Lanczos-3 參考實作比較：差異來自權重的定點化，通常不超過 1；
+    // 水平結果的捨入偶爾差 1，經過垂直濾波的主瓣後最多差 2（少於千分之一的通道）
+    const uint32_t sizes[][4] = {
+        { 256, 256, 96, 96 },
+        { 256, 256, 128, 128 },
+        { 128, 128, 96, 96 },
+        { 48, 48, 96, 96 },
+        { 32, 32, 256, 256 },
+        { 60, 40, 45, 70 },
+    };
+    for (const auto& size : sizes) {
+        std::vector<uint32_t> src = MakeIcon(size[0], size[1], size[0] * 31 + size[2]);
+        std::vector<uint32_t> dst(size_t(size[2]) * size[3]);
+        IconScaler::Resample(IconCompositor::KERNEL_SCALAR, src.data(), size[0], size[1], dst.data(), size[2], size[3]);
+        std::vector<uint32_t> expected = ReferenceResample(src, size[0], size[1], size[2], size[3]);
+
+        size_t over1 = 0;
+        int difference = MaxChannelDifference(dst, expected, &over1);
+        CHECK(difference <= 2);
+        CHECK(over1 * 1000 < dst.size() * 4);
+        if (difference > 2 || over1 * 1000 >= dst.size() * 4) {
+            std::fprintf(stderr, "  %ux%u -> %ux%u: max %d, %zu channels over 1\n",
+                         size[0], size[1], size[2], size[3], difference, over1);
+        }
+    }
+}
+
+TEST_CASE(OutputStaysPremultiplied) {
+    const uint32_t targets[] = { 16, 32, 48, 96, 128, 200, 256 };
+    std::vector<uint32_t> src = MakeIcon(256, 256, 5);
+    IconMipChain chain;
+    chain.Build(IconCompositor::KERNEL_SCALAR, src.data(), 256, 256);
+    for (uint32_t target : targets) {
+        std::vector<uint32_t> dst(size_t(target) * target);
+        chain.Scale(IconCompositor::KERNEL_SCALAR, dst.data(), target, target);
+        CHECK(IsPremultiplied(dst));
+    }
+}
+
+TEST_CASE(MipChainPicksNearestLevel) {
+    std::vector<uint32_t> src = MakeIcon(256, 256, 8);
+    IconMipChain chain;
+    chain.Build(IconCompositor::KERNEL_SCALAR, src.data(), 256, 256);
+    CHECK(chain.GetWidth() == 256 && chain.GetHeight() == 256);
+    CHECK(chain.GetLevelCount() == 9);  // 256 … 1
+
+    // 剛好落在某一層時直接複製該層，與單次縮放相同
+    std::vector<uint32_t> fromChain(128 * 128);
+    std::vector<uint32_t> halved(128 * 128);
+    chain.Scale(IconCompositor::KERNEL_SCALAR, fromChain.data(), 128, 128);
+    IconScaler::Halve(IconCompositor::KERNEL_SCALAR, src.data(), 256, 256, halved.data());
+    CHECK(fromChain == halved);
+
+    // 其餘尺寸從不小於目標的最小一層重新取樣，與單次縮放的結果相同
+    for (uint32_t target : { 96u, 48u, 20u, 300u }) {
+        std::vector<uint32_t> a(size_t(target) * target);
+        std::vector<uint32_t> b(a.size());
+        chain.Scale(IconCompositor::KERNEL_SCALAR, a.data(), target, target);
+        IconScaler::Scale(IconCompositor::KERNEL_SCALAR, src.data(), 256, 256, b.data(), target, target);
+        CHECK(a == b);
+    }
+}
+
+TEST_CASE(KernelsMatchScalar) {
+    // 各種尺寸（含奇數寬度與不足一個向量的尾端、非正方形、放大）逐位元相同
+    const uint32_t sizes[][4] = {
+        { 256, 256, 96, 96 }, { 256, 256, 128, 128 }, { 256, 256, 256, 256 }, { 256, 256, 48, 48 },
+        { 48, 48, 96, 96 }, { 32, 32, 256, 256 }, { 77, 31, 13, 45 }, { 15, 9, 7, 3 }, { 1, 1, 5, 5 },
+        { 200, 120, 99, 61 },
+    };
+    for (IconCompositor::Kernel kernel : SIMD_KERNELS) {
+        if (!IconCompositor::IsSupported(kernel)) {
+            std::printf("  %s not supported here, skipped\n", IconCompositor::GetKernelName(kernel));
+            continue;
+        }
+        for (const auto& size : sizes) {
+            std::vector<uint32_t> src = MakeIcon(size[0], size[1], size[2]);
+            std::vector<uint32_t> expected(size_t(size[2]) * size[3]);
+            std::vector<uint32_t> actual(expected.size());
+
+            IconScaler::Scale(IconCompositor::KERNEL_SCALAR, src.data(), size[0], size[1], expected.data(), size[2], size[3]);
+            IconScaler::Scale(kernel, src.data(), size[0], size[1], actual.data(), size[2], size[3]);
+            CHECK(actual == expected);
+
+            IconScaler::Resample(IconCompositor::KERNEL_SCALAR, src.data(), size[0], size[1], expected.data(), size[2], size[3]);
+            IconScaler::Resample(kernel, src.data(), size[0], size[1], actual.data(), size[2], size[3]);
+            CHECK(actual == expected);
+
+            std::vector<uint32_t> halfExpected(size_t(size[0] / 2) * (size[1] / 2));
+            std::vector<uint32_t> halfActual(halfExpected.size());
+            IconScaler::Halve(IconCompositor::KERNEL_SCALAR, src.data(), size[0], size[1], halfExpected.data());
+            IconScaler::Halve(kernel, src.data(), size[0], size[1], halfActual.data());
+            CHECK(halfActual == halfExpected);
+        }
+
+        // 任意位元組（不一定是合法的預乘值）
+        std::mt19937 rng(kernel);
+        std::vector<uint32_t> noise(size_t(130) * 70);
+        for (auto& pixel : noise) {
+            pixel = (uint32_t)rng();
+        }
+        std::vector<uint32_t> expected(size_t(57) * 101);
+        std::vector<uint32_t> actual(expected.size());
+        IconScaler::Resample(IconCompositor::KERNEL_SCALAR, noise.data(), 130, 70, expected.data(), 57, 101);
+        IconScaler::Resample(kernel, noise.data(), 130, 70, actual.data(), 57, 101);
+        CHECK(actual == expected);
+    }
+}
+
+int main() {
+    return test::RunAll();
+}
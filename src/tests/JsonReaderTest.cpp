@@ -0,0 +1,170 @@
+#include "TestSupport.h"
+#include "core/JsonReader.h"
+#include "widgets/FenceLayout.h"
+#include <string>
+#include <vector>
+
+using Token = JsonReader::Token;
+
+namespace {
+
+std::vector<Token> ReadAll(const std::string& json) {
+    JsonReader reader(json.data(), json.size());
+    std::vector<Token> tokens;
+    for (;;) {
+        Token token = reader.Next();
+        tokens.push_back(token);
+        if (token == Token::End || token == Token::Error) {
+            return tokens;
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE(TokenizesNestedDocument) {
+    std::string json = "{\"a\": [1, -2.5, true, false, null], \"b\": {\"c\": \"d\"}}";
+    std::vector<Token> expected = {
+        Token::BeginObject, Token::Key, Token::BeginArray, Token::Number, Token::Number,
+        Token::True, Token::False, Token::Null, Token::EndArray, Token::Key, Token::BeginObject,
+        Token::Key, Token::String, Token::EndObject, Token::EndObject, Token::End
+    };
+    CHECK(ReadAll(json) == expected);
+}
+
+TEST_CASE(ReadsValues) {
+    std::string json = "\xEF\xBB\xBF{\"n\": 123456789012, \"d\": 1.5, \"s\": \"x\\\"y\\u4e2d\"}";
+    JsonReader reader(json.data(), json.size());
+    REQUIRE(reader.Next() == Token::BeginObject);
+
+    REQUIRE(reader.Next() == Token::Key);
+    CHECK(reader.IsKey("n"));
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetInt() == 123456789012LL);
+
+    REQUIRE(reader.Next() == Token::Key);
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetDouble() == 1.5);
+
+    REQUIRE(reader.Next() == Token::Key);
+    REQUIRE(reader.Next() == Token::String);
+    CHECK(reader.HasEscapes());
+    CHECK(reader.GetRawString() == "x\\\"y\\u4e2d");
+    CHECK(reader.GetWideString() == L"x\"y\u4e2d");
+}
+
+TEST_CASE(SkipsValues) {
+    std::string json = "{\"skip\": {\"a\": [1, {\"b\": []}]}, \"keep\": 7}";
+    JsonReader reader(json.data(), json.size());
+    REQUIRE(reader.Next() == Token::BeginObject);
+    REQUIRE(reader.Next() == Token::Key);
+    CHECK(reader.SkipValue());
+    REQUIRE(reader.Next() == Token::Key);
+    CHECK(reader.IsKey("keep"));
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetInt() == 7);
+    CHECK(reader.Next() == Token::EndObject);
+    CHECK(reader.Next() == Token::End);
+}
+
+TEST_CASE(RejectsMalformedInput) {
+    const char* inputs[] = {
+        "{\"a\": 1,}",
+        "[1,]",
+        "[1 2]",
+        "{\"a\": 1 \"b\": 2}",
+        "{1: 2}",
+        "[,1]",
+        "{\"a\" 1}",
+        "[1, 2",
+        "{\"a\": \"unterminated}",
+        "{\"a\": tru}",
+        "{} {}",
+        "]",
+    };
+    for (const char* input : inputs) {
+        std::vector<Token> tokens = ReadAll(input);
+        CHECK(tokens.back() == Token::Error);
+    }
+}
+
+TEST_CASE(RejectsMalformedNumbers) {
+    const char* inputs[] = {
+        "[1-2]",
+        "[1.2.3]",
+        "[-]",
+        "[-x]",
+        "[01]",
+        "[-01]",
+        "[1.]",
+        "[.5]",
+        "[1e]",
+        "[1e+]",
+        "[1e5e5]",
+        "[+1]",
+        "[0x10]",
+        "{\"a\": 5-}",
+    };
+    for (const char* input : inputs) {
+        std::vector<Token> tokens = ReadAll(input);
+        CHECK(tokens.back() == Token::Error);
+    }
+
+    const char* valid[] = { "[0]", "[-0]", "[0.5]", "[-1.25e-3]", "[1E+9]", "[12e0]", "[9007199254740993]" };
+    for (const char* input : valid) {
+        std::vector<Token> tokens = ReadAll(input);
+        CHECK(tokens.back() == Token::End);
+    }
+}
+
+TEST_CASE(OutOfRangeNumbersReturnDefault) {
+    std::string json = "[1e300, -1e300, 99999999999999999999, 1.5e3, -2.9]";
+    JsonReader reader(json.data(), json.size());
+    REQUIRE(reader.Next() == Token::BeginArray);
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetInt(-1) == -1);
+    CHECK(reader.GetDouble() == 1e300);
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetInt(-1) == -1);
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetInt(-1) == -1);     // 超出 int64 的整數
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetInt() == 1500);
+    REQUIRE(reader.Next() == Token::Number);
+    CHECK(reader.GetInt() == -2);
+    CHECK(reader.Next() == Token::EndArray);
+}
+
+TEST_CASE(ParsesLayoutInAnyOrder) {
+    std::string json =
+        "{\"fences\": [{\"icons\": [{\"originalIndex\": 3, \"unknown\": [1], \"filePath\": \"C:\\\\a.lnk\"}],"
+        " \"y\": 20, \"title\": \"T\\\"1\", \"x\": 10, \"borderWidth\": 4}],"
+        " \"journalSequence\": 9, \"version\": 2}";
+    FenceLayout layout;
+    REQUIRE(FenceLayoutJson::Parse(json.data(), json.size(), layout));
+    CHECK(layout.journalSequence == 9);
+    REQUIRE(layout.fences.size() == 1);
+    const FenceLayoutFence& fence = layout.fences[0];
+    CHECK(fence.title == L"T\"1");
+    CHECK(fence.x == 10);
+    CHECK(fence.y == 20);
+    CHECK(fence.borderWidth == 4);
+    CHECK(fence.iconSize == 64);
+    REQUIRE(fence.icons.size() == 1);
+    CHECK(fence.icons[0].filePath == L"C:\\a.lnk");
+    CHECK(fence.icons[0].originalIndex == 3);
+}
+
+TEST_CASE(KeepsBackslashesInVersion1Files) {
+    // 第 1 版設定檔寫入時未做轉義
+    std::string json = "{\"fences\": [{\"title\": \"t\", \"icons\": [{\"filePath\": \"C:\\Users\\a.lnk\"}]}]}";
+    FenceLayout layout;
+    REQUIRE(FenceLayoutJson::Parse(json.data(), json.size(), layout));
+    REQUIRE(layout.fences.size() == 1);
+    REQUIRE(layout.fences[0].icons.size() == 1);
+    CHECK(layout.fences[0].icons[0].filePath == L"C:\\Users\\a.lnk");
+}
+
+int main() {
+    return test::RunAll();
+}
@@ -0,0 +1,304 @@
+#include "TestSupport.h"
+#include "core/MutationJournal.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Replayed {
+    uint64_t sequence;
+    uint16_t type;
+    int32_t value;
+    std::wstring text;
+};
+
+std::vector<Replayed> OpenAndReplay(MutationJournal& journal, const std::wstring& path, uint64_t afterSequence) {
+    std::vector<Replayed> records;
+    journal.Open(path, afterSequence, [&](const MutationJournal::Record& record) {
+        JournalPayloadReader payload(record.payload, record.payloadSize);
+        Replayed replayed;
+        replayed.sequence = record.sequence;
+        replayed.type = record.type;
+        replayed.value = payload.GetInt();
+        replayed.text = payload.GetString();
+        if (payload.IsValid()) {
+            records.push_back(replayed);
+        }
+    });
+    return records;
+}
+
+void AppendRecords(MutationJournal& journal, int count) {
+    for (int i = 0; i < count; ++i) {
+        JournalPayloadWriter payload;
+        payload.PutInt(i);
+        payload.PutString(L"柵欄 " + std::to_wstring(i));
+        journal.Append((uint16_t)(1 + i % 10), payload);
+    }
+}
+
+std::string ReadFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void WriteFile(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), (std::streamsize)content.size());
+}
+
+} // namespace
+
+TEST_CASE(ReplaysRecordsAfterSequence) {
+    test::TempDirectory dir;
+    std::wstring path = (dir.GetPath() / "config.journal").wstring();
+
+    MutationJournal journal;
+    REQUIRE(OpenAndReplay(journal, path, 0).empty());
+    AppendRecords(journal, 10);
+    CHECK(journal.GetLastSequence() == 10);
+    CHECK(journal.GetRecordCount() == 10);
+    journal.Close();
+
+    MutationJournal reopened;
+    std::vector<Replayed> records = OpenAndReplay(reopened, path, 6);
+    REQUIRE(records.size() == 4);
+    for (size_t i = 0; i < records.size(); ++i) {
+        CHECK(records[i].sequence == 7 + i);
+        CHECK(records[i].value == (int32_t)(6 + i));
+        CHECK(records[i].text == L"柵欄 " + std::to_wstring(6 + i));
+        CHECK(records[i].type == 1 + (6 + i) % 10);
+    }
+    CHECK(reopened.GetLastSequence() == 10);
+    CHECK(reopened.GetRecordCount() == 10);
+
+    // 追加的序號接續在最後一筆之後
+    JournalPayloadWriter payload;
+    payload.PutInt(99);
+    CHECK(reopened.Append(1, payload) == 11);
+}
+
+TEST_CASE(TruncatesTornTail) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+
+    {
+        MutationJournal journal;
+        OpenAndReplay(journal, file.wstring(), 0);
+        AppendRecords(journal, 5);
+    }
+
+    // 最後一筆寫到一半時當機
+    std::string content = ReadFile(file);
+    content.resize(content.size() - 3);
+    WriteFile(file, content);
+
+    MutationJournal journal;
+    std::vector<Replayed> records = OpenAndReplay(journal, file.wstring(), 0);
+    CHECK(records.size() == 4);
+    CHECK(journal.GetLastSequence() == 4);
+    CHECK(journal.GetRecordCount() == 4);
+    CHECK(journal.GetFileSize() == std::filesystem::file_size(file));
+    CHECK(std::filesystem::file_size(file) < content.size());
+
+    // 截掉殘缺部分後可以繼續追加，且重新開啟時完整讀回
+    JournalPayloadWriter payload;
+    payload.PutInt(42);
+    payload.PutString(L"after");
+    CHECK(journal.Append(3, payload) == 5);
+    journal.Close();
+
+    MutationJournal reopened;
+    records = OpenAndReplay(reopened, file.wstring(), 0);
+    REQUIRE(records.size() == 5);
+    CHECK(records[4].value == 42);
+    CHECK(records[4].text == L"after");
+}
+
+TEST_CASE(StopsAtCorruptRecord) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+
+    size_t sizeAfterThree = 0;
+    {
+        MutationJournal journal;
+        OpenAndReplay(journal, file.wstring(), 0);
+        AppendRecords(journal, 3);
+        sizeAfterThree = (size_t)journal.GetFileSize();
+        AppendRecords(journal, 3);
+    }
+
+    // 第 4 筆的內容損毀：CRC 不符，之後的紀錄都不可信
+    std::string content = ReadFile(file);
+    content[sizeAfterThree + 20] ^= 0x5A;
+    WriteFile(file, content);
+
+    MutationJournal journal;
+    std::vector<Replayed> records = OpenAndReplay(journal, file.wstring(), 0);
+    CHECK(records.size() == 3);
+    CHECK(journal.GetLastSequence() == 3);
+    CHECK(std::filesystem::file_size(file) == sizeAfterThree);
+}
+
+TEST_CASE(RejectsOversizedLengthField) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+
+    size_t sizeAfterTwo = 0;
+    {
+        MutationJournal journal;
+        OpenAndReplay(journal, file.wstring(), 0);
+        AppendRecords(journal, 2);
+        sizeAfterTwo = (size_t)journal.GetFileSize();
+    }
+
+    // 檔尾接上長度欄位損毀的紀錄
+    std::string content = ReadFile(file);
+    content += std::string("\xFF\xFF\xFF\x7F", 4) + std::string(40, '\0');
+    WriteFile(file, content);
+
+    MutationJournal journal;
+    CHECK(OpenAndReplay(journal, file.wstring(), 0).size() == 2);
+    CHECK(std::filesystem::file_size(file) == sizeAfterTwo);
+}
+
+TEST_CASE(ReplacesFileWithoutHeader) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+    WriteFile(file, "not a journal");
+
+    MutationJournal journal;
+    CHECK(OpenAndReplay(journal, file.wstring(), 7).empty());
+    CHECK(journal.IsOpen());
+    CHECK(journal.GetLastSequence() == 7);
+
+    JournalPayloadWriter payload;
+    payload.PutInt(1);
+    CHECK(journal.Append(1, payload) == 8);
+}
+
+TEST_CASE(DiscardThroughKeepsNewerRecords) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+
+    MutationJournal journal;
+    OpenAndReplay(journal, file.wstring(), 0);
+    AppendRecords(journal, 10);
+    uint64_t fullSize = journal.GetFileSize();
+
+    REQUIRE(journal.DiscardThrough(6));
+    CHECK(journal.GetRecordCount() == 4);
+    CHECK(journal.GetLastSequence() == 10);
+    CHECK(journal.GetFileSize() < fullSize);
+    CHECK(journal.GetFileSize() == std::filesystem::file_size(file));
+
+    // 捨棄之後仍可追加
+    AppendRecords(journal, 1);
+    CHECK(journal.GetLastSequence() == 11);
+    journal.Close();
+
+    MutationJournal reopened;
+    std::vector<Replayed> records = OpenAndReplay(reopened, file.wstring(), 0);
+    REQUIRE(records.size() == 5);
+    CHECK(records.front().sequence == 7);
+    CHECK(records.back().sequence == 11);
+}
+
+TEST_CASE(DiscardThroughLastSequenceEmptiesJournal) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+
+    MutationJournal journal;
+    OpenAndReplay(journal, file.wstring(), 0);
+    AppendRecords(journal, 5);
+
+    REQUIRE(journal.DiscardThrough(5));
+    CHECK(journal.GetRecordCount() == 0);
+    CHECK(journal.GetLastSequence() == 5);
+
+    // 快照涵蓋到 5：新紀錄從 6 開始，重新開啟時只回放新紀錄
+    AppendRecords(journal, 2);
+    journal.Close();
+
+    MutationJournal reopened;
+    std::vector<Replayed> records = OpenAndReplay(reopened, file.wstring(), 5);
+    REQUIRE(records.size() == 2);
+    CHECK(records[0].sequence == 6);
+    CHECK(records[1].sequence == 7);
+}
+
+TEST_CASE(DiscardThroughOlderSnapshotKeepsEverythingNewer) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+
+    // 快照排入背景寫入後又追加了紀錄：只捨棄快照涵蓋的部分
+    MutationJournal journal;
+    OpenAndReplay(journal, file.wstring(), 0);
+    AppendRecords(journal, 3);
+    uint64_t snapshotSequence = journal.GetLastSequence();
+    AppendRecords(journal, 4);
+
+    REQUIRE(journal.DiscardThrough(snapshotSequence));
+    CHECK(journal.GetRecordCount() == 4);
+    journal.Close();
+
+    MutationJournal reopened;
+    CHECK(OpenAndReplay(reopened, file.wstring(), snapshotSequence).size() == 4);
+}
+
+TEST_CASE(CloseForgetsFile) {
+    test::TempDirectory dir;
+    std::filesystem::path file = dir.GetPath() / "config.journal";
+
+    MutationJournal journal;
+    OpenAndReplay(journal, file.wstring(), 0);
+    AppendRecords(journal, 3);
+    journal.Close();
+    std::filesystem::remove(file);
+
+    // 關閉後不再追加，也不會被 DiscardThrough 重新建立
+    JournalPayloadWriter payload;
+    payload.PutInt(1);
+    CHECK(!journal.IsOpen());
+    CHECK(journal.Append(1, payload) == 0);
+    CHECK(!journal.DiscardThrough(3));
+    CHECK(journal.GetLastSequence() == 0);
+    CHECK(journal.GetRecordCount() == 0);
+    CHECK(!std::filesystem::exists(file));
+
+    // 再次開啟後從空的日誌開始
+    CHECK(OpenAndReplay(journal, file.wstring(), 0).empty());
+    CHECK(journal.Append(1, payload) == 1);
+}
+
+TEST_CASE(PayloadReaderDetectsOverrun) {
+    JournalPayloadWriter writer;
+    writer.PutInt(-5);
+    writer.PutBool(true);
+    writer.PutString(L"路徑");
+    writer.PutBytes("raw");
+
+    const std::string& data = writer.GetData();
+    JournalPayloadReader reader(data.data(), data.size());
+    CHECK(reader.GetInt() == -5);
+    CHECK(reader.GetBool());
+    CHECK(reader.GetString() == L"路徑");
+    CHECK(reader.GetBytes() == "raw");
+    CHECK(reader.IsValid());
+    reader.GetInt();
+    CHECK(!reader.IsValid());
+
+    // 字串長度超出內容
+    JournalPayloadReader truncated(data.data(), 9);
+    truncated.GetInt();
+    truncated.GetBool();
+    CHECK(truncated.GetString().empty());
+    CHECK(!truncated.IsValid());
+}
+
+int main() {
+    return test::RunAll();
+}
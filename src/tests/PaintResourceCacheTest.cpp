@@ -0,0 +1,278 @@
+#include "TestSupport.h"
+#include "widgets/CountingPaintResourceFactory.h"
+#include "widgets/FencePaintStyles.h"
+#include "widgets/PaintResourceCache.h"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+uint32_t Rgb(uint32_t r, uint32_t g, uint32_t b) {
+    return r | (g << 8) | (b << 16);
+}
+
+// PaintFence 依柵欄狀態決定要畫的部分；樣式本身都來自 GetFencePaintStyles
+struct FenceState {
+    FencePaintState paint;
+    std::wstring title;
+    bool overflows;                 // 內容超過可見高度（繪製捲軸）
+    std::vector<bool> visibleIcons; // 畫面內的圖示與其選取狀態
+};
+
+FenceState MakeFence(uint32_t backgroundColor) {
+    FenceState fence;
+    fence.paint.backgroundColor = backgroundColor;
+    fence.paint.borderColor = Rgb(100, 100, 100);
+    fence.paint.borderWidth = 2;
+    fence.paint.isPinned = false;
+    fence.paint.isCollapsed = false;
+    fence.title = L"Fence";
+    fence.overflows = true;
+    fence.visibleIcons.assign(40, false);
+    fence.visibleIcons[3] = true;
+    return fence;
+}
+
+// DrawIconLabel 的樣式
+void ReplayIconLabel(PaintResourceCache& cache, const FencePaintStyles& styles, bool selected) {
+    if (selected) {
+        ScopedPaintResource selBrush(cache, styles.labelSelection);
+        CHECK(selBrush.Get() != nullptr);
+    }
+    ScopedPaintResource labelFont(cache, styles.labelFont);
+    CHECK(labelFont.Get() != nullptr);
+}
+
+// 依 PaintFence 的順序與作用範圍取得、釋放樣式
+void ReplayPaintFence(PaintResourceCache& cache, const FenceState& fence) {
+    const FencePaintStyles styles = GetFencePaintStyles(fence.paint);
+    ScopedPaintResource bgBrush(cache, styles.background);
+
+    if (!fence.title.empty()) {
+        ScopedPaintResource titleBrush(cache, styles.titleBar);
+        ScopedPaintResource titleFont(cache, styles.titleFont);
+        ScopedPaintResource pinBrush(cache, styles.pinButton);
+        ScopedPaintResource pinPen(cache, styles.pinButtonBorder);
+        ScopedPaintResource glyphPen(cache, styles.buttonGlyph);
+        ScopedPaintResource collapseBrush(cache, styles.collapseButton);
+        ScopedPaintResource collapsePen(cache, styles.collapseButtonBorder);
+    }
+
+    ScopedPaintResource borderPen(cache, styles.border);
+
+    if (!fence.paint.isCollapsed) {
+        if (fence.visibleIcons.empty()) {
+            ScopedPaintResource hintFont(cache, styles.hintFont);
+        } else {
+            for (bool selected : fence.visibleIcons) {
+                ReplayIconLabel(cache, styles, selected);
+            }
+        }
+        if (fence.overflows) {
+            ScopedPaintResource trackBrush(cache, styles.scrollTrack);
+            ScopedPaintResource thumbBrush(cache, styles.scrollThumb);
+        }
+        ScopedPaintResource resizeIndicatorBrush(cache, styles.resizeIndicator);
+    }
+}
+
+void ReplayFrame(PaintResourceCache& cache, const std::vector<FenceState>& fences) {
+    for (const FenceState& fence : fences) {
+        ReplayPaintFence(cache, fence);
+    }
+}
+
+// 一幀內用到的不同樣式（與 ReplayPaintFence 相同的條件）
+size_t CountFrameStyles(const std::vector<FenceState>& fences) {
+    std::unordered_set<PaintStyle, PaintStyleHash> used;
+    for (const FenceState& fence : fences) {
+        const FencePaintStyles styles = GetFencePaintStyles(fence.paint);
+        used.insert(styles.background);
+        if (!fence.title.empty()) {
+            used.insert({ styles.titleBar, styles.titleFont, styles.pinButton, styles.pinButtonBorder,
+                          styles.buttonGlyph, styles.collapseButton, styles.collapseButtonBorder });
+        }
+        used.insert(styles.border);
+        if (!fence.paint.isCollapsed) {
+            if (fence.visibleIcons.empty()) {
+                used.insert(styles.hintFont);
+            }
+            for (bool selected : fence.visibleIcons) {
+                if (selected) {
+                    used.insert(styles.labelSelection);
+                }
+                used.insert(styles.labelFont);
+            }
+            if (fence.overflows) {
+                used.insert({ styles.scrollTrack, styles.scrollThumb });
+            }
+            used.insert(styles.resizeIndicator);
+        }
+    }
+    return used.size();
+}
+
+std::vector<FenceState> MakeFences() {
+    std::vector<FenceState> fences;
+    fences.push_back(MakeFence(Rgb(40, 40, 40)));
+    fences.push_back(MakeFence(Rgb(30, 60, 90)));
+    fences.push_back(MakeFence(Rgb(10, 10, 10)));
+    fences[1].paint.isPinned = true;
+    fences[1].visibleIcons.clear();
+    fences[2].paint.isCollapsed = true;
+    return fences;
+}
+
+} // namespace
+
+TEST_CASE(SteadyFramesCreateNothing) {
+    CountingPaintResourceFactory factory;
+    PaintResourceCache cache(factory);
+    std::vector<FenceState> fences = MakeFences();
+
+    ReplayFrame(cache, fences);
+    CountingPaintResourceFactory::Counts first = factory.GetCounts();
+    CHECK(first.GetCreated() > 0);
+    CHECK(first.fonts == 3);    // 標題、提示、名稱各一個，柵欄之間共用
+    CHECK(first.GetCreated() == CountFrameStyles(fences));  // 每個不同的樣式只建立一次
+    CHECK(first.destroyed == 0);
+    PaintResourceCache::Stats stats = cache.GetStats();
+    CHECK(stats.live == first.GetCreated());
+    CHECK(stats.idle == stats.live);    // 幀結束後沒有引用
+
+    for (int frame = 0; frame < 200; ++frame) {
+        ReplayFrame(cache, fences);
+    }
+    const CountingPaintResourceFactory::Counts& counts = factory.GetCounts();
+    CHECK(counts.brushes == first.brushes);
+    CHECK(counts.pens == first.pens);
+    CHECK(counts.fonts == first.fonts);
+    CHECK(counts.destroyed == 0);
+    CHECK(factory.GetLiveCount() == first.GetCreated());
+    CHECK(cache.GetStats().hits > 200 * first.GetCreated());
+}
+
+TEST_CASE(ToggledStatesStayFlatOnceSeen) {
+    CountingPaintResourceFactory factory;
+    PaintResourceCache cache(factory);
+    std::vector<FenceState> fences = MakeFences();
+
+    // 釘住、收合與選取各切換一次，兩種狀態的樣式都建立過
+    for (int pass = 0; pass < 2; ++pass) {
+        for (FenceState& fence : fences) {
+            fence.paint.isPinned = !fence.paint.isPinned;
+            fence.paint.isCollapsed = !fence.paint.isCollapsed;
+            fence.visibleIcons.assign(fence.visibleIcons.size(), pass == 0);
+            ReplayFrame(cache, fences);
+        }
+    }
+    uint64_t created = factory.GetCounts().GetCreated();
+
+    for (int frame = 0; frame < 100; ++frame) {
+        FenceState& fence = fences[frame % fences.size()];
+        fence.paint.isPinned = !fence.paint.isPinned;
+        fence.paint.isCollapsed = !fence.paint.isCollapsed;
+        if (!fence.visibleIcons.empty()) {
+            fence.visibleIcons[frame % fence.visibleIcons.size()] = (frame & 1) != 0;
+        }
+        ReplayFrame(cache, fences);
+    }
+    CHECK(factory.GetCounts().GetCreated() == created);
+    CHECK(factory.GetCounts().destroyed == 0);
+}
+
+TEST_CASE(ColorChangeCreatesOnlyNewStyles) {
+    CountingPaintResourceFactory factory;
+    PaintResourceCache cache(factory);
+    std::vector<FenceState> fences = MakeFences();
+    ReplayFrame(cache, fences);
+    uint64_t brushes = factory.GetCounts().brushes;
+    uint64_t pens = factory.GetCounts().pens;
+
+    // 背景色改變：背景與標題列各一個新筆刷，之後穩定
+    fences[0].paint.backgroundColor = Rgb(200, 100, 50);
+    ReplayFrame(cache, fences);
+    CHECK(factory.GetCounts().brushes == brushes + 2);
+    CHECK(factory.GetCounts().pens == pens);
+    for (int frame = 0; frame < 10; ++frame) {
+        ReplayFrame(cache, fences);
+    }
+    CHECK(factory.GetCounts().brushes == brushes + 2);
+
+    // 改回原本的顏色：閒置的筆刷直接取回
+    fences[0].paint.backgroundColor = Rgb(40, 40, 40);
+    ReplayFrame(cache, fences);
+    CHECK(factory.GetCounts().brushes == brushes + 2);
+    CHECK(factory.GetCounts().destroyed == 0);
+}
+
+TEST_CASE(IdleLimitBoundsRetiredStyles) {
+    CountingPaintResourceFactory factory;
+    const size_t idleLimit = 16;
+    PaintResourceCache cache(factory, idleLimit);
+    std::vector<FenceState> fences = MakeFences();
+
+    // 拖動色彩選擇器：每幀新的背景色，閒置的舊筆刷不超過上限
+    for (uint32_t step = 0; step < 100; ++step) {
+        fences[0].paint.backgroundColor = Rgb(step, 255 - step, 128);
+        ReplayFrame(cache, fences);
+        CHECK(cache.GetStats().idle <= idleLimit);
+    }
+    CHECK(factory.GetLiveCount() == cache.GetStats().live);
+    CHECK(factory.GetCounts().destroyed > 0);
+    CHECK(factory.GetInvalidDestroyCount() == 0);
+}
+
+TEST_CASE(ClearDestroysEveryResource) {
+    CountingPaintResourceFactory factory;
+    {
+        PaintResourceCache cache(factory);
+        std::vector<FenceState> fences = MakeFences();
+        ReplayFrame(cache, fences);
+        cache.Clear();
+        CHECK(factory.GetLiveCount() == 0);
+        CHECK(cache.GetStats().live == 0);
+
+        // 清除後（例如 DPI 改變）第一幀重新建立同樣數量，之後再次穩定
+        uint64_t created = factory.GetCounts().GetCreated();
+        ReplayFrame(cache, fences);
+        CHECK(factory.GetCounts().GetCreated() == created * 2);
+        ReplayFrame(cache, fences);
+        CHECK(factory.GetCounts().GetCreated() == created * 2);
+    }
+    CHECK(factory.GetLiveCount() == 0);
+    CHECK(factory.GetCounts().destroyed == factory.GetCounts().GetCreated());
+    CHECK(factory.GetInvalidDestroyCount() == 0);
+}
+
+TEST_CASE(StylesFollowFenceSettings) {
+    FencePaintState state = MakeFence(Rgb(30, 10, 200)).paint;
+    FencePaintStyles styles = GetFencePaintStyles(state);
+    CHECK(styles.background == PaintStyle::Brush(Rgb(30, 10, 200)));
+    CHECK(styles.titleBar == PaintStyle::Brush(Rgb(10, 0, 180)));   // 各通道減 20，不小於 0
+    CHECK(styles.border == PaintStyle::Pen(Rgb(100, 100, 100), 2));
+    CHECK(styles.titleFont.kind == PaintStyle::KIND_FONT);
+    CHECK(styles.hintFont.italic);
+    CHECK(!(styles.labelFont == styles.titleFont));
+
+    // 釘住與收合只改變對應按鈕的樣式，字型與圖形的畫筆不變
+    state.isPinned = true;
+    FencePaintStyles pinned = GetFencePaintStyles(state);
+    CHECK(!(pinned.pinButton == styles.pinButton));
+    CHECK(!(pinned.pinButtonBorder == styles.pinButtonBorder));
+    CHECK(pinned.collapseButton == styles.collapseButton);
+    CHECK(&pinned.titleFont == &styles.titleFont);
+    CHECK(&pinned.buttonGlyph == &styles.buttonGlyph);
+
+    state.isCollapsed = true;
+    FencePaintStyles collapsed = GetFencePaintStyles(state);
+    CHECK(!(collapsed.collapseButton == pinned.collapseButton));
+    CHECK(!(collapsed.collapseButtonBorder == pinned.collapseButtonBorder));
+    CHECK(collapsed.pinButton == pinned.pinButton);
+}
+
+int main() {
+    return test::RunAll();
+}
@@ -0,0 +1,203 @@
+#include "TestSupport.h"
+#include "core/StringCodec.h"
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace {
+
+void PutReferenceUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// 逐字元的參考實作（不經過 SIMD 快速路徑）
+std::string ReferenceUtf8(const std::wstring& text, bool escapeJson) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    for (size_t i = 0; i < text.size(); ++i) {
+        uint32_t c = static_cast<uint32_t>(text[i]);
+        if (escapeJson && c < 0x80) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+                continue;
+            }
+            if (c == '\n') { out += "\\n"; continue; }
+            if (c == '\r') { out += "\\r"; continue; }
+            if (c == '\t') { out += "\\t"; continue; }
+            if (c < 0x20) {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
+                continue;
+            }
+        }
+        if (c >= 0xD800 && c <= 0xDBFF && i + 1 < text.size()) {
+            uint32_t lo = static_cast<uint32_t>(text[i + 1]);
+            if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+                ++i;
+            }
+        }
+        if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+            c = 0xFFFD;
+        }
+        PutReferenceUtf8(out, c);
+    }
+    return out;
+}
+
+// 刻意涵蓋 SIMD 分類的各個邊界
+const uint32_t INTERESTING[] = {
+    'a', 'Z', ' ', '"', '\\', '\n', '\r', '\t', 0x01, 0x1F, 0x7F,
+    0x80, 0x7FF, 0x800, 0x4E2D, 0x7FFF, 0x8000, 0x9AD8, 0xD7FF,
+    0xD800, 0xDBFF, 0xDC00, 0xDFFF, 0xE000, 0xFFFD, 0xFFFF,
+};
+
+std::wstring RandomText(std::mt19937& rng, size_t length) {
+    std::wstring text;
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(INTERESTING) / sizeof(INTERESTING[0]) - 1);
+    for (size_t i = 0; i < length; ++i) {
+        int k = kind(rng);
+        if (k < 4) {
+            text += static_cast<wchar_t>('a' + rng() % 26);  // 讓部分區段走純 ASCII 快速路徑
+        } else if (k < 6) {
+            text += static_cast<wchar_t>(0x4E00 + rng() % 0x5000);  // 中日韓文字
+        } else if (k < 7) {
+            // 代理對（wchar_t 為 4 位元組時則是超出 BMP 的字元）
+            uint32_t cp = 0x10000 + rng() % 0x100000;
+            if (sizeof(wchar_t) == 2) {
+                text += static_cast<wchar_t>(0xD800 + ((cp - 0x10000) >> 10));
+                text += static_cast<wchar_t>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+            } else {
+                text += static_cast<wchar_t>(cp);
+            }
+        } else {
+            text += static_cast<wchar_t>(INTERESTING[pick(rng)]);
+        }
+    }
+    return text;
+}
+
+std::string Repeat(const char* bytes, int count) {
+    std::string out;
+    for (int i = 0; i < count; ++i) {
+        out += bytes;
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE(LoneSurrogatesBecomeReplacementCharacters) {
+    // 整段 8 個字元都是代理字元：曾因飽和壓縮被誤判為一般的 3 位元組字元
+    std::wstring highs(8, static_cast<wchar_t>(0xD800));
+    std::wstring lows(8, static_cast<wchar_t>(0xDFFF));
+    CHECK(StringCodec::ToUtf8(highs) == Repeat("\xEF\xBF\xBD", 8));
+    CHECK(StringCodec::ToUtf8(lows) == Repeat("\xEF\xBF\xBD", 8));
+    CHECK(StringCodec::ToUtf8(highs) == ReferenceUtf8(highs, false));
+}
+
+TEST_CASE(UpperBmpBlocksUseFastPathCorrectly) {
+    // U+8000 以上的中日韓文字整段走 3 位元組快速路徑
+    std::wstring text;
+    for (wchar_t c = 0x8000; c < 0x8010; ++c) {
+        text += c;
+    }
+    text += std::wstring(8, static_cast<wchar_t>(0xFFFF));
+    CHECK(StringCodec::ToUtf8(text) == ReferenceUtf8(text, false));
+}
+
+TEST_CASE(OutOfRangeWideCharacters) {
+    if (sizeof(wchar_t) != 4) {
+        return;
+    }
+    std::wstring text(8, static_cast<wchar_t>(0x110000));
+    text += std::wstring(8, static_cast<wchar_t>(0x1F600));
+    CHECK(StringCodec::ToUtf8(text) == ReferenceUtf8(text, false));
+}
+
+TEST_CASE(MatchesScalarReference) {
+    std::mt19937 rng(12345);
+    for (int round = 0; round < 5000; ++round) {
+        std::wstring text = RandomText(rng, rng() % 48);
+        for (bool escapeJson : { false, true }) {
+            std::string expected = ReferenceUtf8(text, escapeJson);
+            std::string actual = StringCodec::ToUtf8(text);
+            if (escapeJson) {
+                actual.clear();
+                StringCodec::AppendUtf8(actual, text, true);
+            }
+            CHECK(actual == expected);
+            if (actual != expected) {
+                return;
+            }
+        }
+    }
+}
+
+TEST_CASE(AppendsAfterExistingContent) {
+    std::string out = "prefix:";
+    std::wstring text = L"\"引號\" and \\ back\nslash 中文字串 repeated 中文字串";
+    StringCodec::AppendUtf8(out, text, true);
+    CHECK(out == "prefix:" + ReferenceUtf8(text, true));
+}
+
+TEST_CASE(RoundTripsValidText) {
+    std::mt19937 rng(777);
+    for (int round = 0; round < 2000; ++round) {
+        std::wstring text = RandomText(rng, rng() % 64);
+        // 無效的代理字元在編碼時已被取代、無法還原：以編碼後再解碼的內容作為有效文字
+        std::string utf8 = ReferenceUtf8(text, false);
+        std::wstring valid = StringCodec::ToWide(utf8);
+        CHECK(StringCodec::ToUtf8(valid) == utf8);
+
+        std::string escaped;
+        StringCodec::AppendUtf8(escaped, valid, true);
+        std::wstring unescaped;
+        StringCodec::AppendWide(unescaped, escaped, true);
+        CHECK(unescaped == valid);
+
+        std::string unescapedUtf8;
+        StringCodec::AppendUnescaped(unescapedUtf8, escaped);
+        CHECK(unescapedUtf8 == utf8);
+    }
+}
+
+TEST_CASE(DecodesEscapesAndInvalidSequences) {
+    std::wstring out;
+    StringCodec::AppendWide(out, "a\\u4e2d\\ud83d\\ude00\\n\\\"", true);
+    std::wstring expected = L"a\u4e2d";
+    if (sizeof(wchar_t) == 2) {
+        expected += static_cast<wchar_t>(0xD83D);
+        expected += static_cast<wchar_t>(0xDE00);
+    } else {
+        expected += static_cast<wchar_t>(0x1F600);
+    }
+    expected += L"\n\"";
+    CHECK(out == expected);
+
+    // 未開啟轉義時反斜線原樣保留；無效位元組解碼為 U+FFFD
+    CHECK(StringCodec::ToWide("C:\\Users\\a") == L"C:\\Users\\a");
+    CHECK(StringCodec::ToWide("\xFF" "abcdefghijklmnopq") == L"\xFFFD" L"abcdefghijklmnopq");
+    CHECK(StringCodec::ToWide("\xE4\xB8") == L"\xFFFD");
+}
+
+int main() {
+    return test::RunAll();
+}
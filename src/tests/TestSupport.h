@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// 最小的測試輔助（不依賴測試框架）
+// 每個測試檔以 TEST_CASE 定義案例，main 呼叫 test::RunAll()；任何 CHECK 失敗時程序以 1 結束。
+namespace test {
+
+struct Case {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<Case>& GetCases() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline int& GetFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*run)()) {
+        GetCases().push_back({ name, run });
+    }
+};
+
+inline void ReportFailure(const char* file, int line, const char* expression) {
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    ++GetFailureCount();
+}
+
+inline int RunAll() {
+    for (const auto& testCase : GetCases()) {
+        int before = GetFailureCount();
+        testCase.run();
+        std::printf("%s %s\n", GetFailureCount() == before ? "[  OK  ]" : "[ FAIL ]", testCase.name);
+    }
+    return GetFailureCount() == 0 ? 0 : 1;
+}
+
+// 測試用的暫存目錄（解構時連同內容刪除）
+class TempDirectory {
+public:
+    TempDirectory() {
+        static std::atomic<unsigned> counter{ 0 };
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        path_ = std::filesystem::temp_directory_path() /
+                ("ikwidget-test-" + std::to_string(stamp) + "-" + std::to_string(counter++));
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    const std::filesystem::path& GetPath() const { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
+} // namespace test
+
+#define TEST_CASE(name)                                            \
+    static void name();                                            \
+    static test::Registrar name##Registrar(#name, &name);          \
+    static void name()
+
+#define CHECK(condition)                                           \
+    do {                                                           \
+        if (!(condition)) {                                        \
+            test::ReportFailure(__FILE__, __LINE__, #condition);   \
+        }                                                          \
+    } while (0)
+
+// 失敗時不再執行同一案例的後續檢查（後面的檢查依賴這個結果）
+#define REQUIRE(condition)                                         \
+    do {                                                           \
+        if (!(condition)) {                                        \
+            test::ReportFailure(__FILE__, __LINE__, #condition);   \
+            return;                                                \
+        }                                                          \
+    } while (0)
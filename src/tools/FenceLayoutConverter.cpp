@@ -0,0 +1,68 @@
+// 柵欄佈局轉換工具：config.json <-> config.layout
+// 依輸入檔內容判斷格式；輸出副檔名為 .json 時寫 JSON，其餘寫二進位佈局。
+// 不依賴 Windows，可在 Linux 上建置，用於檢查與往返驗證設定檔。
+
+#include "widgets/FenceLayout.h"
+#include "core/MappedFile.h"
+#include "core/PersistenceWorker.h"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace {
+
+bool EndsWithJson(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    for (auto& c : extension) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return extension == ".json";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <input> <output>\n", argv[0]);
+        std::fprintf(stderr, "  output ending in .json is written as JSON, otherwise as binary layout\n");
+        return 2;
+    }
+
+    std::filesystem::path inputPath(argv[1]);
+    std::filesystem::path outputPath(argv[2]);
+
+    MappedFile input;
+    if (!input.Open(inputPath.wstring())) {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    FenceLayout layout;
+    if (FenceLayoutView::IsBinaryLayout(input.GetData(), input.GetSize())) {
+        FenceLayoutView view;
+        if (!view.Attach(input.GetData(), input.GetSize())) {
+            std::fprintf(stderr, "%s: invalid binary layout\n", argv[1]);
+            return 1;
+        }
+        view.ToLayout(layout);
+    } else if (!FenceLayoutJson::Parse(input.GetData(), input.GetSize(), layout)) {
+        std::fprintf(stderr, "%s: invalid JSON layout\n", argv[1]);
+        return 1;
+    }
+    input.Close();
+
+    std::string output = EndsWithJson(outputPath) ? FenceLayoutJson::Write(layout)
+                                                  : FenceLayoutBinary::Write(layout);
+    if (!PersistenceWorker::WriteFileAtomic(outputPath.wstring(), output)) {
+        std::fprintf(stderr, "cannot write %s\n", argv[2]);
+        return 1;
+    }
+
+    size_t iconCount = 0;
+    for (const auto& fence : layout.fences) {
+        iconCount += fence.icons.size();
+    }
+    std::printf("%zu fences, %zu icons -> %s (%zu bytes)\n",
+                layout.fences.size(), iconCount, argv[2], output.size());
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "BackBufferPolicy.h"
+#include <algorithm>
+
+namespace {
+
+int32_t GrowDimension(int32_t size) {
+    int32_t grown = (std::max)(size, (int32_t)1) + (std::max)(size, (int32_t)0) / 4;
+    return (grown + BackBufferPolicy::ALIGNMENT - 1) / BackBufferPolicy::ALIGNMENT * BackBufferPolicy::ALIGNMENT;
+}
+
+} // namespace
+
+bool BackBufferPolicy::NeedsReallocation(const Extent& capacity, int32_t width, int32_t height) {
+    if (width > capacity.width || height > capacity.height) {
+        return true;
+    }
+
+    int64_t capacityPixels = (int64_t)capacity.width * capacity.height;
+    if (capacityPixels <= SHRINK_MIN_PIXELS) {
+        return false;
+    }
+
+    // 與重新配置後的容量比較，剛配置好的緩衝區不會被判定為過大
+    Extent fitted = GetCapacity(width, height);
+    return capacityPixels > (int64_t)fitted.width * fitted.height * SHRINK_FACTOR;
+}
+
+BackBufferPolicy::Extent BackBufferPolicy::GetCapacity(int32_t width, int32_t height) {
+    Extent capacity;
+    capacity.width = GrowDimension(width);
+    capacity.height = GrowDimension(height);
+    return capacity;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// 保留式背景緩衝區的容量策略（不依賴 Windows）
+// 容量只在要求的大小超出時擴大，並預留 1/4、對齊 ALIGNMENT 像素，拖曳調整大小時不必每次重新配置；
+// 容量遠大於目前需要（面積超過 4 倍）且本身夠大時縮小，避免暫時放大後一直佔用記憶體；
+// 小的緩衝區不縮小，收合 / 展開柵欄時不必重新配置。
+class BackBufferPolicy {
+public:
+    struct Extent {
+        int32_t width;
+        int32_t height;
+    };
+
+    static const int32_t ALIGNMENT = 64;
+    static const int32_t SHRINK_FACTOR = 4;
+    static const int64_t SHRINK_MIN_PIXELS = 1024 * 1024;    // 容量小於此像素數時不縮小（4 MB）
+
+    // 容量為 capacity 的緩衝區是否需要重新配置才適合 width × height
+    static bool NeedsReallocation(const Extent& capacity, int32_t width, int32_t height);
+
+    // 為 width × height 配置時使用的容量
+    static Extent GetCapacity(int32_t width, int32_t height);
+};
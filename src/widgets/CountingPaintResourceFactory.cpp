@@ -0,0 +1,33 @@
+#include "CountingPaintResourceFactory.h"
+
+CountingPaintResourceFactory::CountingPaintResourceFactory()
+    : nextHandle_(0x1000)
+    , invalidDestroys_(0) {
+}
+
+PaintResource CountingPaintResourceFactory::Create(const PaintStyle& style) {
+    switch (style.kind) {
+    case PaintStyle::KIND_BRUSH:
+        ++counts_.brushes;
+        break;
+    case PaintStyle::KIND_PEN:
+        ++counts_.pens;
+        break;
+    case PaintStyle::KIND_FONT:
+        ++counts_.fonts;
+        break;
+    }
+
+    PaintResource resource = reinterpret_cast<PaintResource>(nextHandle_);
+    nextHandle_ += 4;
+    live_.insert(resource);
+    return resource;
+}
+
+void CountingPaintResourceFactory::Destroy(PaintResource resource) {
+    if (live_.erase(resource) == 0) {
+        ++invalidDestroys_;
+        return;
+    }
+    ++counts_.destroyed;
+}
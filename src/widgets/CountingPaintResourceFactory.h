@@ -0,0 +1,37 @@
+#pragma once
+
+#include "PaintResourceFactory.h"
+#include <cstdint>
+#include <unordered_set>
+
+// 只計數的繪製資源工廠（不依賴 Windows）
+// 每次 Create 回傳新的假控制代碼，記錄建立 / 刪除次數與目前存活的資源，
+// 用於在 Linux 上驗證繪製穩定後每一幀不再配置資源，以及所有資源最後都被刪除。
+class CountingPaintResourceFactory : public IPaintResourceFactory {
+public:
+    struct Counts {
+        uint64_t brushes = 0;
+        uint64_t pens = 0;
+        uint64_t fonts = 0;
+        uint64_t destroyed = 0;
+
+        uint64_t GetCreated() const { return brushes + pens + fonts; }
+    };
+
+    CountingPaintResourceFactory();
+
+    PaintResource Create(const PaintStyle& style) override;
+    void Destroy(PaintResource resource) override;
+
+    const Counts& GetCounts() const { return counts_; }
+    size_t GetLiveCount() const { return live_.size(); }
+
+    // 刪除了不存在（或已刪除）的資源的次數
+    uint64_t GetInvalidDestroyCount() const { return invalidDestroys_; }
+
+private:
+    Counts counts_;
+    uintptr_t nextHandle_;
+    std::unordered_set<PaintResource> live_;
+    uint64_t invalidDestroys_;
+};
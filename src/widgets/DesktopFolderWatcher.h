@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// 資料夾中的一個項目
+struct DesktopFolderEntry {
+    std::wstring name;
+    bool isDirectory;
+    bool isHidden;
+};
+
+// 監看到的資料夾變更（改名以「移除舊名 + 新增新名」表示）
+struct DesktopFolderChange {
+    enum Action {
+        ADDED,
+        REMOVED,
+        OVERFLOWED      // 通知遺失（緩衝區溢位等），該資料夾需重新掃描
+    };
+
+    int watchId;
+    Action action;
+    DesktopFolderEntry entry;   // OVERFLOWED 時不使用
+};
+
+// 資料夾列舉與變更通知的抽象（不依賴 Windows）
+// Win32 實作使用 FindFirstFileExW 與 ReadDirectoryChangesW，Linux 上以 inotify 代替，
+// 兩者都不阻塞：變更在背景由系統累積，呼叫 Poll 時才取出。
+class IDesktopFolderWatcher {
+public:
+    virtual ~IDesktopFolderWatcher() = default;
+
+    // 列出資料夾內容（不含 . 與 ..）；無法開啟時回傳 false
+    virtual bool Scan(const std::wstring& folder, std::vector<DesktopFolderEntry>& entries) = 0;
+
+    // 開始監看資料夾（不含子資料夾）；回傳監看代碼，失敗時回傳 -1
+    virtual int Watch(const std::wstring& folder) = 0;
+    virtual void Unwatch(int watchId) = 0;
+
+    // 取出目前已累積的變更，附加到 changes（不阻塞）
+    virtual void Poll(std::vector<DesktopFolderChange>& changes) = 0;
+
+    // 組合資料夾與項目名稱
+    virtual std::wstring JoinPath(const std::wstring& folder, const std::wstring& name) const = 0;
+};
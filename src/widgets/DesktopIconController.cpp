@@ -0,0 +1,216 @@
+#include "DesktopIconController.h"
+
+const DesktopIconPoint DesktopIconController::HIDDEN_POSITION = { -10000, -10000 };
+
+DesktopIconController::DesktopIconController(IDesktopIconHost& host)
+    : host_(host) {
+}
+
+bool DesktopIconController::Prepare() {
+    return host_.Connect() && snapshot_.Update(host_);
+}
+
+int DesktopIconController::FindIndex(const std::wstring& filePath) {
+    // 名稱快照失效或項目數改變時才重新讀取整個清單
+    if (!Prepare()) {
+        return -1;
+    }
+    return snapshot_.Find(filePath);
+}
+
+std::vector<DesktopIconPoint> DesktopIconController::GetPositions(const std::vector<int>& indices) {
+    std::vector<DesktopIconPoint> positions(indices.size(), DesktopIconPoint{ -1, -1 });
+    if (indices.empty() || !host_.Connect() ||
+        !host_.GetItemPositions(indices.data(), indices.size(), positions.data())) {
+        return std::vector<DesktopIconPoint>(indices.size(), DesktopIconPoint{ -1, -1 });
+    }
+    return positions;
+}
+
+bool DesktopIconController::ReadAllPositions(std::vector<DesktopIconPoint>& positions) {
+    std::vector<int> indices(host_.GetItemCount());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = (int)i;
+    }
+
+    positions.resize(indices.size());
+    return indices.empty() || host_.GetItemPositions(indices.data(), indices.size(), positions.data());
+}
+
+std::vector<DesktopIconPoint> DesktopIconController::GetAllPositions() {
+    std::vector<DesktopIconPoint> positions;
+    if (!host_.Connect() || !ReadAllPositions(positions)) {
+        return {};
+    }
+    return positions;
+}
+
+size_t DesktopIconController::Hide(const std::vector<std::wstring>& filePaths) {
+    if (filePaths.empty() || !Prepare()) {
+        return 0;
+    }
+
+    // 移到畫面外（不實際刪除項目）
+    size_t hidden = 0;
+    host_.BeginUpdate();
+    for (const auto& filePath : filePaths) {
+        int index = snapshot_.Find(filePath);
+        if (index >= 0) {
+            host_.SetItemPosition(index, HIDDEN_POSITION);
+            ++hidden;
+        }
+    }
+    host_.EndUpdate();
+    return hidden;
+}
+
+size_t DesktopIconController::Show(const std::vector<std::wstring>& filePaths) {
+    std::vector<std::pair<std::wstring, DesktopIconPoint>> icons;
+    icons.reserve(filePaths.size());
+    for (const auto& filePath : filePaths) {
+        icons.push_back({ filePath, DesktopIconPoint{ -1, -1 } });
+    }
+    return Restore(icons);
+}
+
+bool DesktopIconController::PlanPositions(const std::vector<DesktopIconPoint>& current,
+                                          const std::vector<int>& indices,
+                                          const std::vector<DesktopRestorePlanner::Request>& requests,
+                                          std::vector<DesktopIconPoint>& positions) {
+    DesktopIconGrid grid;
+    if (!host_.GetGrid(grid)) {
+        return false;
+    }
+
+    // 標記其他可見圖示佔用的格子（已隱藏的在格線外，自然略過）
+    int itemCount = (int)current.size();
+    std::vector<bool> restoring(itemCount, false);
+    for (int index : indices) {
+        if (index < itemCount) {
+            restoring[index] = true;
+        }
+    }
+
+    planner_.Reset(grid);
+    for (int i = 0; i < itemCount; ++i) {
+        if (!restoring[i]) {
+            planner_.MarkOccupied(current[i]);
+        }
+    }
+    planner_.Plan(requests, positions);
+    return true;
+}
+
+size_t DesktopIconController::Restore(const std::vector<std::pair<std::wstring, DesktopIconPoint>>& icons) {
+    if (icons.empty() || !Prepare()) {
+        return 0;
+    }
+
+    std::vector<int> indices;
+    std::vector<DesktopRestorePlanner::Request> requests;
+    indices.reserve(icons.size());
+    requests.reserve(icons.size());
+    for (const auto& icon : icons) {
+        int index = snapshot_.Find(icon.first);
+        if (index < 0) {
+            continue;
+        }
+
+        DesktopRestorePlanner::Request request;
+        request.hasSaved = icon.second.x >= 0 && icon.second.y >= 0;
+        request.saved = request.hasSaved ? host_.ScreenToList(icon.second) : DesktopIconPoint{ 0, 0 };
+        indices.push_back(index);
+        requests.push_back(request);
+    }
+    if (indices.empty()) {
+        return 0;
+    }
+
+    // 一次讀回所有項目的位置作為佔用情形
+    std::vector<DesktopIconPoint> current;
+    std::vector<DesktopIconPoint> positions;
+    bool planned = ReadAllPositions(current) && PlanPositions(current, indices, requests, positions);
+
+    host_.BeginUpdate();
+    if (planned) {
+        for (size_t i = 0; i < indices.size(); ++i) {
+            host_.SetItemPosition(indices[i], positions[i]);
+        }
+    } else {
+        // 無法取得格線：沒有原始位置的圖示讓系統自動排列（整批只排列一次，
+        // 且在設定位置之前，避免覆蓋已恢復的圖示）
+        bool needsArrange = false;
+        for (const auto& request : requests) {
+            needsArrange = needsArrange || !request.hasSaved;
+        }
+        if (needsArrange) {
+            host_.Arrange();
+        }
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (requests[i].hasSaved) {
+                host_.SetItemPosition(indices[i], requests[i].saved);
+            }
+        }
+    }
+    host_.EndUpdate();
+    return indices.size();
+}
+
+size_t DesktopIconController::Reconcile(const std::vector<std::wstring>& hiddenPaths) {
+    if (hiddenPaths.empty() || !Prepare()) {
+        return 0;
+    }
+
+    std::vector<int> indices;
+    indices.reserve(hiddenPaths.size());
+    for (const auto& filePath : hiddenPaths) {
+        int index = snapshot_.Find(filePath);
+        if (index >= 0) {
+            indices.push_back(index);
+        }
+    }
+    if (indices.empty()) {
+        return 0;
+    }
+
+    // 一次讀回這些項目目前的位置，只處理不在隱藏位置的
+    std::vector<DesktopIconPoint> current(indices.size());
+    if (!host_.GetItemPositions(indices.data(), indices.size(), current.data())) {
+        return Hide(hiddenPaths);
+    }
+
+    std::vector<int> toHide;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (current[i].x != HIDDEN_POSITION.x || current[i].y != HIDDEN_POSITION.y) {
+            toHide.push_back(indices[i]);
+        }
+    }
+
+    // 桌面已是正確狀態：不送出任何變更（包括暫停重繪與重新繪製）
+    if (toHide.empty()) {
+        return 0;
+    }
+
+    host_.BeginUpdate();
+    for (int index : toHide) {
+        host_.SetItemPosition(index, HIDDEN_POSITION);
+    }
+    host_.EndUpdate();
+    return toHide.size();
+}
+
+bool DesktopIconController::ShowAt(const std::wstring& filePath, DesktopIconPoint screenPosition) {
+    if (!Prepare()) {
+        return false;
+    }
+
+    int index = snapshot_.Find(filePath);
+    if (index < 0) {
+        return false;
+    }
+
+    host_.BeginUpdate();
+    host_.SetItemPosition(index, host_.ScreenToList(screenPosition));
+    host_.EndUpdate();
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "DesktopIconHost.h"
+#include "DesktopListSnapshot.h"
+#include "DesktopRestorePlanner.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// 桌面圖示的隱藏 / 顯示 / 恢復演算法（不依賴 Windows，透過 IDesktopIconHost 操作桌面）
+// 每批操作只確認一次名稱快照，之後的查詢都在本機完成；
+// 位置讀取一律走批次介面，變更期間暫停重繪。
+class DesktopIconController {
+public:
+    // 隱藏圖示時移到的位置（清單座標）
+    static const DesktopIconPoint HIDDEN_POSITION;
+
+    explicit DesktopIconController(IDesktopIconHost& host);
+
+    DesktopIconController(const DesktopIconController&) = delete;
+    DesktopIconController& operator=(const DesktopIconController&) = delete;
+
+    // 使名稱快照失效（下次操作前重新讀取）
+    void Invalidate() { snapshot_.Invalidate(); }
+
+    // 依檔案路徑找桌面項目索引；找不到回傳 -1
+    int FindIndex(const std::wstring& filePath);
+
+    // 批次讀取位置（清單座標）；失敗的項目為 { -1, -1 }
+    std::vector<DesktopIconPoint> GetPositions(const std::vector<int>& indices);
+
+    // 讀取全部項目位置（positions[i] 對應索引 i）；無法連線時回傳空陣列
+    std::vector<DesktopIconPoint> GetAllPositions();
+
+    // 以下回傳實際處理的圖示數量
+    size_t Hide(const std::vector<std::wstring>& filePaths);
+
+    // 顯示到第一個空格（與沒有原始位置的 Restore 相同）
+    size_t Show(const std::vector<std::wstring>& filePaths);
+
+    // 恢復到原始位置（螢幕座標）；沒有原始位置（x 或 y 為負）或原始位置已被佔用的圖示
+    // 放到空格。位置在本機整批規劃，每個圖示一次 SetItemPosition，不自動排列。
+    size_t Restore(const std::vector<std::pair<std::wstring, DesktopIconPoint>>& icons);
+
+    // 讓桌面與應隱藏的集合一致：一次讀回這些項目的位置，只移動還不在隱藏位置的。
+    // 回傳移動的項目數（桌面已正確時為 0，且不送出任何變更）
+    size_t Reconcile(const std::vector<std::wstring>& hiddenPaths);
+
+    // 將單一圖示顯示在指定位置（螢幕座標）
+    bool ShowAt(const std::wstring& filePath, DesktopIconPoint screenPosition);
+
+private:
+    // 連線並確認名稱快照可用
+    bool Prepare();
+
+    // 依序讀取所有項目的位置（positions[i] 對應索引 i）
+    bool ReadAllPositions(std::vector<DesktopIconPoint>& positions);
+
+    // 以 current（所有項目目前的位置）的格線佔用情形規劃 indices 的位置；無法取得格線時回傳 false
+    bool PlanPositions(const std::vector<DesktopIconPoint>& current,
+                       const std::vector<int>& indices,
+                       const std::vector<DesktopRestorePlanner::Request>& requests,
+                       std::vector<DesktopIconPoint>& positions);
+
+    IDesktopIconHost& host_;
+    DesktopListSnapshot snapshot_;
+    DesktopRestorePlanner planner_;
+};
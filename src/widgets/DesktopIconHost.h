@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 桌面圖示容器的座標（與 Win32 POINT 相同的 32 位元整數）
+struct DesktopIconPoint {
+    int32_t x;
+    int32_t y;
+};
+
+// 桌面圖示的格線（清單座標）：cellWidth × cellHeight 的格子共 columns 欄、rows 列
+struct DesktopIconGrid {
+    int32_t cellWidth;
+    int32_t cellHeight;
+    int32_t columns;
+    int32_t rows;
+};
+
+// 桌面圖示容器的抽象（不依賴 Windows）
+// Win32 實作操作 explorer 內的 SysListView32（每次呼叫都是跨程序往返），
+// SimulatedDesktopIconHost 則是記憶體內的模擬，用於在 Linux 上量測與驗證批次演算法。
+class IDesktopIconHost {
+public:
+    virtual ~IDesktopIconHost() = default;
+
+    // 確認桌面可用（每批操作開始時呼叫）；無法連線時回傳 false
+    virtual bool Connect() = 0;
+
+    // 項目集合或名稱可能已改變時遞增（殼層變更通知、重新連線到不同清單）
+    virtual uint64_t GetChangeStamp() const = 0;
+
+    virtual int GetItemCount() = 0;
+
+    // 讀取項目名稱（失敗或沒有名稱時回傳 false）
+    virtual bool GetItemText(int index, std::wstring& text) = 0;
+
+    // 批次讀取項目位置（清單座標）；索引無效或讀取失敗的項目為 { -1, -1 }
+    virtual bool GetItemPositions(const int* indices, size_t count, DesktopIconPoint* positions) = 0;
+
+    // 設定項目位置（清單座標）
+    virtual void SetItemPosition(int index, DesktopIconPoint position) = 0;
+
+    // 讀取目前的格線（圖示間距與可見範圍）；無法取得時回傳 false
+    virtual bool GetGrid(DesktopIconGrid& grid) = 0;
+
+    // 自動排列所有項目
+    virtual void Arrange() = 0;
+
+    // 螢幕座標轉為清單座標
+    virtual DesktopIconPoint ScreenToList(DesktopIconPoint point) = 0;
+
+    // 批次變更期間暫停重繪，結束時一次刷新
+    virtual void BeginUpdate() = 0;
+    virtual void EndUpdate() = 0;
+};
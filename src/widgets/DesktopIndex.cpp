@@ -0,0 +1,146 @@
+#include "DesktopIndex.h"
+#include <cwctype>
+
+DesktopIndex::DesktopIndex(IDesktopFolderWatcher& watcher)
+    : watcher_(watcher)
+    , generation_(0) {
+}
+
+DesktopIndex::~DesktopIndex() {
+    Clear();
+}
+
+std::wstring DesktopIndex::MakeKey(const std::wstring& path) {
+    // 與 _wcsicmp 相同的比較規則
+    std::wstring key = path;
+    for (auto& ch : key) {
+        ch = static_cast<wchar_t>(std::towlower(ch));
+    }
+    return key;
+}
+
+bool DesktopIndex::AddFolder(const std::wstring& folder) {
+    std::wstring key = MakeKey(folder);
+    for (const auto& existing : folders_) {
+        if (MakeKey(existing.path) == key) {
+            return true;
+        }
+    }
+
+    // 先開始監看再掃描：掃描期間的變更會在下次 Update 套用（重複的新增 / 移除無害）
+    Folder entry;
+    entry.path = folder;
+    entry.watchId = watcher_.Watch(folder);
+    entry.dirty = false;
+    folders_.push_back(entry);
+
+    if (!Rescan((int)folders_.size() - 1)) {
+        if (folders_.back().watchId >= 0) {
+            watcher_.Unwatch(folders_.back().watchId);
+        }
+        folders_.pop_back();
+        return false;
+    }
+    return true;
+}
+
+void DesktopIndex::Clear() {
+    for (const auto& folder : folders_) {
+        if (folder.watchId >= 0) {
+            watcher_.Unwatch(folder.watchId);
+        }
+    }
+    folders_.clear();
+    if (!entries_.empty()) {
+        entries_.clear();
+        ++generation_;
+    }
+}
+
+bool DesktopIndex::Rescan(int folder) {
+    std::vector<DesktopFolderEntry> scanned;
+    if (!watcher_.Scan(folders_[folder].path, scanned)) {
+        return false;
+    }
+
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.folder == folder) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& entry : scanned) {
+        Insert(folder, entry);
+    }
+
+    folders_[folder].dirty = false;
+    ++generation_;
+    return true;
+}
+
+void DesktopIndex::Insert(int folder, const DesktopFolderEntry& entry) {
+    Entry item;
+    item.path = watcher_.JoinPath(folders_[folder].path, entry.name);
+    item.folder = folder;
+    item.isDirectory = entry.isDirectory;
+    item.isHidden = entry.isHidden;
+
+    std::wstring key = MakeKey(item.path);
+    entries_[key] = std::move(item);
+}
+
+void DesktopIndex::Erase(int folder, const std::wstring& name) {
+    entries_.erase(MakeKey(watcher_.JoinPath(folders_[folder].path, name)));
+}
+
+int DesktopIndex::FindFolder(int watchId) const {
+    for (size_t i = 0; i < folders_.size(); ++i) {
+        if (folders_[i].watchId == watchId) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void DesktopIndex::Update() {
+    pending_.clear();
+    watcher_.Poll(pending_);
+
+    bool changed = false;
+    for (const auto& change : pending_) {
+        int folder = FindFolder(change.watchId);
+        if (folder < 0 || folders_[folder].dirty) {
+            continue;
+        }
+
+        switch (change.action) {
+        case DesktopFolderChange::ADDED:
+            Insert(folder, change.entry);
+            changed = true;
+            break;
+        case DesktopFolderChange::REMOVED:
+            Erase(folder, change.entry.name);
+            changed = true;
+            break;
+        case DesktopFolderChange::OVERFLOWED:
+            folders_[folder].dirty = true;
+            break;
+        }
+    }
+    if (changed) {
+        ++generation_;
+    }
+
+    // 通知遺失或無法監看的資料夾只能整個重新掃描
+    for (size_t i = 0; i < folders_.size(); ++i) {
+        if (folders_[i].dirty || folders_[i].watchId < 0) {
+            Rescan((int)i);
+        }
+    }
+}
+
+const DesktopIndex::Entry* DesktopIndex::Find(const std::wstring& path) const {
+    auto it = entries_.find(MakeKey(path));
+    return (it != entries_.end()) ? &it->second : nullptr;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "DesktopFolderWatcher.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 桌面資料夾索引（不依賴 Windows）
+// 加入資料夾時掃描一次，之後只套用變更通知；查詢（自動分類、檔案是否仍存在等）
+// 不需再存取檔案系統。通知遺失或無法監看的資料夾在下次 Update 時重新掃描。
+class DesktopIndex {
+public:
+    struct Entry {
+        std::wstring path;
+        int folder;         // 所屬資料夾（AddFolder 的順序）
+        bool isDirectory;
+        bool isHidden;
+    };
+
+    explicit DesktopIndex(IDesktopFolderWatcher& watcher);
+    ~DesktopIndex();
+
+    DesktopIndex(const DesktopIndex&) = delete;
+    DesktopIndex& operator=(const DesktopIndex&) = delete;
+
+    // 掃描並開始監看資料夾；重複加入同一資料夾時直接回傳 true，無法掃描時回傳 false
+    bool AddFolder(const std::wstring& folder);
+
+    // 停止監看並清空索引
+    void Clear();
+
+    // 套用累積的變更通知
+    void Update();
+
+    size_t GetFolderCount() const { return folders_.size(); }
+    size_t GetCount() const { return entries_.size(); }
+
+    // 內容改變時遞增
+    uint64_t GetGeneration() const { return generation_; }
+
+    // 依完整路徑查詢（不分大小寫）；找不到回傳 nullptr
+    const Entry* Find(const std::wstring& path) const;
+    bool Contains(const std::wstring& path) const { return Find(path) != nullptr; }
+
+    // 依路徑排序走訪所有項目
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (const auto& pair : entries_) {
+            fn(pair.second);
+        }
+    }
+
+private:
+    struct Folder {
+        std::wstring path;
+        int watchId;        // -1 表示無法監看，每次 Update 重新掃描
+        bool dirty;
+    };
+
+    bool Rescan(int folder);
+    void Insert(int folder, const DesktopFolderEntry& entry);
+    void Erase(int folder, const std::wstring& name);
+    int FindFolder(int watchId) const;
+    static std::wstring MakeKey(const std::wstring& path);
+
+    IDesktopFolderWatcher& watcher_;
+    std::vector<Folder> folders_;
+    std::map<std::wstring, Entry> entries_;     // 鍵為小寫完整路徑
+    std::vector<DesktopFolderChange> pending_;  // 重複使用的變更暫存區
+    uint64_t generation_;
+};
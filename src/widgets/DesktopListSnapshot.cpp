@@ -0,0 +1,78 @@
+#include "DesktopListSnapshot.h"
+#include "DesktopIconHost.h"
+#include <cwctype>
+
+DesktopListSnapshot::DesktopListSnapshot()
+    : itemCount_(0)
+    , changeStamp_(0)
+    , valid_(false) {
+}
+
+bool DesktopListSnapshot::Update(IDesktopIconHost& host) {
+    // 只需一次 GetItemCount（Win32 上不涉及跨程序記憶體）即可確認快照仍可用
+    if (valid_ && host.GetChangeStamp() == changeStamp_ && host.GetItemCount() == itemCount_) {
+        return true;
+    }
+
+    return Read(host);
+}
+
+bool DesktopListSnapshot::Read(IDesktopIconHost& host) {
+    valid_ = false;
+    indexByName_.clear();
+
+    // 先記下戳記：讀取途中發生的變更會讓下次 Update 重新讀取
+    uint64_t changeStamp = host.GetChangeStamp();
+    int itemCount = host.GetItemCount();
+    indexByName_.reserve(itemCount);
+
+    std::wstring name;
+    for (int i = 0; i < itemCount; i++) {
+        if (!host.GetItemText(i, name)) {
+            continue;
+        }
+        NormalizeName(name);
+        indexByName_.emplace(name, i);  // 同名時保留第一個（與逐一比對的結果相同）
+    }
+
+    itemCount_ = itemCount;
+    changeStamp_ = changeStamp;
+    valid_ = true;
+    return true;
+}
+
+void DesktopListSnapshot::NormalizeName(std::wstring& name) {
+    // 與 _wcsicmp 相同的比較規則
+    for (auto& ch : name) {
+        ch = static_cast<wchar_t>(std::towlower(ch));
+    }
+}
+
+int DesktopListSnapshot::FindName(std::wstring name) const {
+    NormalizeName(name);
+    auto it = indexByName_.find(name);
+    return (it != indexByName_.end()) ? it->second : -1;
+}
+
+int DesktopListSnapshot::Find(const std::wstring& filePath) const {
+    if (!valid_) {
+        return -1;
+    }
+
+    // 取出檔名
+    size_t lastSlash = filePath.find_last_of(L"\\/");
+    std::wstring fileName = (lastSlash != std::wstring::npos)
+        ? filePath.substr(lastSlash + 1)
+        : filePath;
+
+    // 桌面通常不顯示副檔名（例如捷徑），也嘗試不帶副檔名的版本
+    int index = FindName(fileName);
+    size_t lastDot = fileName.find_last_of(L'.');
+    if (lastDot != std::wstring::npos && lastDot > 0) {
+        int withoutExt = FindName(fileName.substr(0, lastDot));
+        if (withoutExt >= 0 && (index < 0 || withoutExt < index)) {
+            index = withoutExt;
+        }
+    }
+    return index;
+}
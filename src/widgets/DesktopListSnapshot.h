@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class IDesktopIconHost;
+
+// 桌面項目名稱快照
+// 一次讀出所有項目名稱，建立不分大小寫的「名稱 → 索引」表，之後的查詢都不需再詢問桌面。
+// 項目數或宿主的變更戳記（殼層通知、重新連線）改變時失效，下次使用前重新讀取。
+class DesktopListSnapshot {
+public:
+    DesktopListSnapshot();
+
+    // 確保快照對應宿主目前的清單：已失效或項目數改變時重新讀取
+    bool Update(IDesktopIconHost& host);
+
+    void Invalidate() { valid_ = false; }
+
+    // 依檔案路徑找項目索引（比對完整檔名或不含副檔名的名稱，不分大小寫）；找不到回傳 -1
+    int Find(const std::wstring& filePath) const;
+
+private:
+    bool Read(IDesktopIconHost& host);
+    int FindName(std::wstring name) const;
+    static void NormalizeName(std::wstring& name);
+
+    int itemCount_;
+    uint64_t changeStamp_;
+    bool valid_;
+    std::unordered_map<std::wstring, int> indexByName_;  // 鍵為小寫名稱，同名時保留最小索引
+};
@@ -0,0 +1,159 @@
+#include "DesktopRestorePlanner.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// 最低位元 1 的位置（value 不可為 0）
+inline int LowestSetBit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (int)index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// 低於 bit 的位元全為 1 的遮罩
+inline uint64_t MaskBelow(int bit) {
+    return (bit == 0) ? 0 : (~uint64_t(0) >> (64 - bit));
+}
+
+} // namespace
+
+DesktopRestorePlanner::DesktopRestorePlanner()
+    : grid_{ 0, 0, 0, 0 }
+    , cellCount_(0)
+    , occupied_(0) {
+}
+
+void DesktopRestorePlanner::Reset(const DesktopIconGrid& grid) {
+    grid_ = grid;
+    bool valid = grid.cellWidth > 0 && grid.cellHeight > 0 && grid.columns > 0 && grid.rows > 0;
+    cellCount_ = valid ? (int64_t)grid.columns * grid.rows : 0;
+    occupied_ = 0;
+
+    size_t words = (size_t)((cellCount_ + 63) / 64);
+    cells_.assign(words, 0);
+    full_.assign((words + 63) / 64, 0);
+
+    // 最後一個字組超出格線的位元視為已佔用，搜尋時不需另外檢查邊界
+    if (cellCount_ % 64 != 0) {
+        cells_.back() = ~MaskBelow((int)(cellCount_ % 64));
+    }
+}
+
+int64_t DesktopRestorePlanner::CellOf(DesktopIconPoint position) const {
+    if (cellCount_ == 0 || position.x < 0 || position.y < 0) {
+        return -1;
+    }
+    int64_t column = position.x / grid_.cellWidth;
+    int64_t row = position.y / grid_.cellHeight;
+    if (column >= grid_.columns || row >= grid_.rows) {
+        return -1;
+    }
+    return column * grid_.rows + row;
+}
+
+DesktopIconPoint DesktopRestorePlanner::OriginOf(int64_t cell) const {
+    int32_t column = (int32_t)(cell / grid_.rows);
+    int32_t row = (int32_t)(cell % grid_.rows);
+    return { column * grid_.cellWidth, row * grid_.cellHeight };
+}
+
+bool DesktopRestorePlanner::IsOccupied(int64_t cell) const {
+    return (cells_[cell >> 6] >> (cell & 63)) & 1;
+}
+
+void DesktopRestorePlanner::Occupy(int64_t cell) {
+    uint64_t& word = cells_[cell >> 6];
+    uint64_t bit = uint64_t(1) << (cell & 63);
+    if (word & bit) {
+        return;
+    }
+    word |= bit;
+    ++occupied_;
+    if (word == ~uint64_t(0)) {
+        size_t index = (size_t)(cell >> 6);
+        full_[index >> 6] |= uint64_t(1) << (index & 63);
+    }
+}
+
+void DesktopRestorePlanner::MarkOccupied(DesktopIconPoint position) {
+    int64_t cell = CellOf(position);
+    if (cell >= 0) {
+        Occupy(cell);
+    }
+}
+
+int64_t DesktopRestorePlanner::FindFreeInRange(int64_t start, int64_t end) const {
+    if (start >= end) {
+        return -1;
+    }
+
+    // 起始字組中 start 之後的空格
+    size_t word = (size_t)(start >> 6);
+    uint64_t freeBits = ~cells_[word] & ~MaskBelow((int)(start & 63));
+    if (freeBits) {
+        int64_t cell = (int64_t)word * 64 + LowestSetBit(freeBits);
+        return (cell < end) ? cell : -1;
+    }
+
+    // 以摘要位元圖跳過全滿的字組（每個摘要字組涵蓋 4096 格）
+    size_t next = word + 1;
+    size_t wordCount = cells_.size();
+    while (next < wordCount) {
+        uint64_t notFull = ~full_[next >> 6] & ~MaskBelow((int)(next & 63));
+        if (notFull) {
+            size_t candidate = (next & ~size_t(63)) + LowestSetBit(notFull);
+            if (candidate >= wordCount) {
+                break;
+            }
+            int64_t cell = (int64_t)candidate * 64 + LowestSetBit(~cells_[candidate]);
+            return (cell < end) ? cell : -1;
+        }
+        next = (next & ~size_t(63)) + 64;
+    }
+    return -1;
+}
+
+int64_t DesktopRestorePlanner::FindFree(int64_t start) const {
+    if (occupied_ >= (size_t)cellCount_) {
+        return -1;
+    }
+    int64_t cell = FindFreeInRange(start, cellCount_);
+    return (cell >= 0) ? cell : FindFreeInRange(0, start);
+}
+
+void DesktopRestorePlanner::Plan(const std::vector<Request>& requests, std::vector<DesktopIconPoint>& positions) {
+    positions.assign(requests.size(), DesktopIconPoint{ 0, 0 });
+
+    // 先放原始格子仍空著的圖示，避免被其他需要找空格的圖示搶走
+    std::vector<size_t> deferred;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const Request& request = requests[i];
+        int64_t cell = request.hasSaved ? CellOf(request.saved) : -1;
+        if (cell >= 0 && !IsOccupied(cell)) {
+            Occupy(cell);
+            positions[i] = request.saved;
+        } else {
+            deferred.push_back(i);
+        }
+    }
+
+    // 其餘的從原始格子（沒有時從頭）往後找空格
+    for (size_t i : deferred) {
+        const Request& request = requests[i];
+        int64_t start = request.hasSaved ? CellOf(request.saved) : 0;
+        int64_t cell = FindFree(start >= 0 ? start : 0);
+        if (cell >= 0) {
+            Occupy(cell);
+            positions[i] = OriginOf(cell);
+        } else if (request.hasSaved) {
+            positions[i] = request.saved;
+        }
+    }
+}
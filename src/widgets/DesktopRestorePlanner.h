@@ -0,0 +1,52 @@
+#pragma once
+
+#include "DesktopIconHost.h"
+#include <cstdint>
+#include <vector>
+
+// 恢復圖示的位置規劃（不依賴 Windows）
+// 以「格子佔用位元圖」模擬桌面：先標記其他可見圖示佔用的格子，再在本機一次算出整批圖示的
+// 最終位置，每個圖示只需一次 SetItemPosition，不必讓桌面自動排列。
+// 格子依桌面預設的排列順序編號（由上而下、再由左而右），空格搜尋以兩層位元圖加上位元掃描完成。
+class DesktopRestorePlanner {
+public:
+    // 要規劃的圖示：saved 為原始位置（清單座標），hasSaved 為 false 時放到第一個空格
+    struct Request {
+        DesktopIconPoint saved;
+        bool hasSaved;
+    };
+
+    DesktopRestorePlanner();
+
+    // 重設為空的格線
+    void Reset(const DesktopIconGrid& grid);
+
+    // 標記某個位置所在的格子已被佔用（格線外的位置忽略，例如已隱藏的圖示）
+    void MarkOccupied(DesktopIconPoint position);
+
+    // 規劃整批圖示的位置（positions[i] 對應 requests[i]）：
+    // 原始位置的格子仍空著時保留原始位置；被佔用或沒有原始位置時改放到其後的第一個空格。
+    // 格線已滿時保留原始位置（沒有時為格線原點）。
+    void Plan(const std::vector<Request>& requests, std::vector<DesktopIconPoint>& positions);
+
+    const DesktopIconGrid& GetGrid() const { return grid_; }
+    size_t GetOccupiedCount() const { return occupied_; }
+
+private:
+    // 位置所在格子的編號；不在格線內時回傳 -1
+    int64_t CellOf(DesktopIconPoint position) const;
+    DesktopIconPoint OriginOf(int64_t cell) const;
+
+    bool IsOccupied(int64_t cell) const;
+    void Occupy(int64_t cell);
+
+    // 從 start 開始（到結尾後從頭）找第一個空格；格線已滿時回傳 -1
+    int64_t FindFree(int64_t start) const;
+    int64_t FindFreeInRange(int64_t start, int64_t end) const;
+
+    DesktopIconGrid grid_;
+    int64_t cellCount_;
+    size_t occupied_;
+    std::vector<uint64_t> cells_;   // 第 i 位元表示格子 i 已佔用
+    std::vector<uint64_t> full_;    // 第 i 位元表示 cells_[i] 已全滿
+};
@@ -0,0 +1,93 @@
+#include "FenceBackBuffer.h"
+#include <utility>
+
+FenceBackBuffer::FenceBackBuffer()
+    : dc_(nullptr)
+    , bitmap_(nullptr)
+    , oldBitmap_(nullptr)
+    , bits_(nullptr)
+    , capacity_{ 0, 0 } {
+}
+
+FenceBackBuffer::~FenceBackBuffer() {
+    Release();
+}
+
+FenceBackBuffer::FenceBackBuffer(FenceBackBuffer&& other) noexcept
+    : dc_(other.dc_)
+    , bitmap_(other.bitmap_)
+    , oldBitmap_(other.oldBitmap_)
+    , bits_(other.bits_)
+    , capacity_(other.capacity_) {
+    other.dc_ = nullptr;
+    other.bitmap_ = nullptr;
+    other.oldBitmap_ = nullptr;
+    other.bits_ = nullptr;
+    other.capacity_ = { 0, 0 };
+}
+
+FenceBackBuffer& FenceBackBuffer::operator=(FenceBackBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        std::swap(dc_, other.dc_);
+        std::swap(bitmap_, other.bitmap_);
+        std::swap(oldBitmap_, other.oldBitmap_);
+        std::swap(bits_, other.bits_);
+        std::swap(capacity_, other.capacity_);
+    }
+    return *this;
+}
+
+bool FenceBackBuffer::Prepare(HDC reference, int width, int height) {
+    if (bitmap_ && !BackBufferPolicy::NeedsReallocation(capacity_, width, height)) {
+        return true;
+    }
+
+    BackBufferPolicy::Extent capacity = BackBufferPolicy::GetCapacity(width, height);
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = capacity.width;
+    info.bmiHeader.biHeight = -capacity.height;
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = nullptr;
+    HBITMAP bitmap = CreateDIBSection(reference, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!bitmap) {
+        // 縮小失敗時原本的緩衝區仍可使用
+        return bitmap_ && width <= capacity_.width && height <= capacity_.height;
+    }
+
+    if (!dc_) {
+        dc_ = CreateCompatibleDC(reference);
+        if (!dc_) {
+            DeleteObject(bitmap);
+            return false;
+        }
+        oldBitmap_ = (HBITMAP)SelectObject(dc_, bitmap);
+    } else {
+        SelectObject(dc_, bitmap);
+        DeleteObject(bitmap_);
+    }
+
+    bitmap_ = bitmap;
+    bits_ = static_cast<uint32_t*>(bits);
+    capacity_ = capacity;
+    return true;
+}
+
+void FenceBackBuffer::Release() {
+    if (dc_) {
+        SelectObject(dc_, oldBitmap_);
+        DeleteDC(dc_);
+        dc_ = nullptr;
+    }
+    if (bitmap_) {
+        DeleteObject(bitmap_);
+        bitmap_ = nullptr;
+    }
+    oldBitmap_ = nullptr;
+    bits_ = nullptr;
+    capacity_ = { 0, 0 };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "BackBufferPolicy.h"
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+
+// 柵欄視窗保留的背景緩衝區：由上而下的 32bpp DIB section，常駐選入自己的記憶體 DC
+// 容量依 BackBufferPolicy 決定，只在客戶區超出容量（或遠小於容量）時重新配置。
+// 每次繪製後 DC 的選取物件與裁切都須還原，下次繪製才會從乾淨的狀態開始。
+class FenceBackBuffer {
+public:
+    FenceBackBuffer();
+    ~FenceBackBuffer();
+
+    FenceBackBuffer(FenceBackBuffer&& other) noexcept;
+    FenceBackBuffer& operator=(FenceBackBuffer&& other) noexcept;
+
+    FenceBackBuffer(const FenceBackBuffer&) = delete;
+    FenceBackBuffer& operator=(const FenceBackBuffer&) = delete;
+
+    // 確保緩衝區至少有 width × height（與 reference 相容）；失敗時回傳 false
+    bool Prepare(HDC reference, int width, int height);
+
+    // 刪除 DC 與點陣圖
+    void Release();
+
+    HDC GetMemoryDC() const { return dc_; }
+    uint32_t* GetBits() const { return bits_; }
+
+    // 每列的像素數（即容量寬度，可能大於客戶區）
+    size_t GetStride() const { return (size_t)capacity_.width; }
+
+    const BackBufferPolicy::Extent& GetCapacity() const { return capacity_; }
+
+private:
+    HDC dc_;
+    HBITMAP bitmap_;
+    HBITMAP oldBitmap_;
+    uint32_t* bits_;
+    BackBufferPolicy::Extent capacity_;
+};
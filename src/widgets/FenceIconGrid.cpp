@@ -0,0 +1,50 @@
+#include "FenceIconGrid.h"
+#include <algorithm>
+
+// (std::max) 以參考取用，需要類別外的定義
+const int32_t FenceIconGrid::LABEL_HEIGHT;
+const int32_t FenceIconGrid::MIN_TEXT_WIDTH;
+
+int32_t FenceIconGrid::GetCellWidth(int32_t iconSize, int32_t iconSpacing) {
+    // 名稱至少需要 70px，較大的圖示再加兩側留白
+    int32_t textWidth = (std::max)(MIN_TEXT_WIDTH, iconSize + 20);
+    return (std::max)(iconSize, textWidth) + iconSpacing;
+}
+
+int32_t FenceIconGrid::GetCellHeight(int32_t iconSize, int32_t iconSpacing) {
+    return iconSize + LABEL_HEIGHT + iconSpacing;
+}
+
+int32_t FenceIconGrid::Arrange(FenceIconPoint* positions, size_t count, int32_t iconSize, int32_t iconSpacing,
+                               int32_t left, int32_t top, int32_t availableWidth) {
+    const int32_t cellWidth = GetCellWidth(iconSize, iconSpacing);
+    const int32_t cellHeight = GetCellHeight(iconSize, iconSpacing);
+    const int32_t iconsPerRow = (std::max)(1, availableWidth / cellWidth);
+    const int32_t offsetX = left + (cellWidth - iconSize) / 2;
+
+    int32_t column = 0;
+    int32_t y = top;
+    for (size_t i = 0; i < count; ++i) {
+        positions[i].x = offsetX + column * cellWidth;
+        positions[i].y = y;
+        if (++column >= iconsPerRow) {
+            column = 0;
+            y += cellHeight;
+        }
+    }
+    return iconsPerRow;
+}
+
+int FenceIconGrid::HitTest(const FenceIconPoint* positions, size_t count, int32_t iconSize, int32_t scrollOffset,
+                           int32_t x, int32_t y) {
+    // 範圍包含名稱與左右留白，與繪製選取底色的範圍相近；換算成未捲動的座標只需做一次
+    const int32_t contentY = y + scrollOffset;
+    for (size_t i = 0; i < count; ++i) {
+        const FenceIconPoint& position = positions[i];
+        if (x >= position.x - 5 && x <= position.x + iconSize + 15 &&
+            contentY >= position.y - 5 && contentY <= position.y + iconSize + LABEL_HEIGHT) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
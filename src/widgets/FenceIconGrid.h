@@ -0,0 +1,25 @@
+#pragma once
+
+#include "FenceIconList.h"
+#include <cstddef>
+#include <cstdint>
+
+// 柵欄圖示格子的排列與點擊測試（不依賴 Windows）
+// 只讀寫 FenceIconList 的位置陣列，不接觸圖示的冷資料。
+class FenceIconGrid {
+public:
+    static const int32_t LABEL_HEIGHT = 35;     // 圖示下方名稱的高度
+    static const int32_t MIN_TEXT_WIDTH = 70;   // 名稱至少需要的寬度
+
+    static int32_t GetCellWidth(int32_t iconSize, int32_t iconSpacing);
+    static int32_t GetCellHeight(int32_t iconSize, int32_t iconSpacing);
+
+    // 由左至右、由上而下排列 count 個圖示（每格內水平置中），(left, top) 為第一格的左上角；
+    // 回傳每列的圖示數
+    static int32_t Arrange(FenceIconPoint* positions, size_t count, int32_t iconSize, int32_t iconSpacing,
+                           int32_t left, int32_t top, int32_t availableWidth);
+
+    // (x, y)（柵欄座標，已含捲動）落在哪個圖示的範圍內；沒有時回傳 -1
+    static int HitTest(const FenceIconPoint* positions, size_t count, int32_t iconSize, int32_t scrollOffset,
+                       int32_t x, int32_t y);
+};
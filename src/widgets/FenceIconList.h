@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 柵欄內圖示的位置（柵欄座標，未扣除捲動位移）
+struct FenceIconPoint {
+    int32_t x;
+    int32_t y;
+};
+
+// 柵欄的圖示集合（結構陣列，不依賴 Windows）
+//
+// 每一幀都會走訪的欄位（位置、選取狀態）各自緊密排列在獨立的陣列內，
+// 排列、繪製裁切與點擊測試只讀取這些陣列；路徑、名稱、圖示控制代碼等冷資料放在 Record 內，
+// 只在實際繪製或操作某個圖示時才讀取。三個陣列以同一索引對應，增刪時一起移動，
+// 索引與 std::vector<Record> 相同（刪除後其後的索引減一）。範圍 for 走訪的是 Record。
+template <typename Record>
+class FenceIconList {
+public:
+    using iterator = typename std::vector<Record>::iterator;
+    using const_iterator = typename std::vector<Record>::const_iterator;
+
+    size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+
+    void reserve(size_t count) {
+        records_.reserve(count);
+        positions_.reserve(count);
+        flags_.reserve(count);
+    }
+
+    void clear() {
+        records_.clear();
+        positions_.clear();
+        flags_.clear();
+    }
+
+    iterator begin() { return records_.begin(); }
+    iterator end() { return records_.end(); }
+    const_iterator begin() const { return records_.begin(); }
+    const_iterator end() const { return records_.end(); }
+
+    Record& operator[](size_t index) { return records_[index]; }
+    const Record& operator[](size_t index) const { return records_[index]; }
+
+    // 加到最後（未選取），回傳索引
+    size_t Add(Record record, FenceIconPoint position = FenceIconPoint{ 0, 0 }) {
+        records_.push_back(std::move(record));
+        positions_.push_back(position);
+        flags_.push_back(0);
+        return records_.size() - 1;
+    }
+
+    void Erase(size_t index) {
+        records_.erase(records_.begin() + index);
+        positions_.erase(positions_.begin() + index);
+        flags_.erase(flags_.begin() + index);
+    }
+
+    const FenceIconPoint& GetPosition(size_t index) const { return positions_[index]; }
+    void SetPosition(size_t index, FenceIconPoint position) { positions_[index] = position; }
+
+    // 所有圖示的位置（size() 個，依索引排列）
+    FenceIconPoint* GetPositions() { return positions_.data(); }
+    const FenceIconPoint* GetPositions() const { return positions_.data(); }
+
+    bool IsSelected(size_t index) const { return (flags_[index] & FLAG_SELECTED) != 0; }
+    void SetSelected(size_t index, bool selected) {
+        flags_[index] = selected ? uint8_t(flags_[index] | FLAG_SELECTED) : uint8_t(flags_[index] & ~FLAG_SELECTED);
+    }
+
+private:
+    enum : uint8_t {
+        FLAG_SELECTED = 1
+    };
+
+    std::vector<Record> records_;           // 冷資料
+    std::vector<FenceIconPoint> positions_; // 熱資料：位置
+    std::vector<uint8_t> flags_;            // 熱資料：選取等旗標
+};
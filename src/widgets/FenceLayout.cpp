@@ -0,0 +1,360 @@
+#include "FenceLayout.h"
+#include "core/JsonReader.h"
+#include "core/JsonWriter.h"
+#include "core/StringCodec.h"
+#include <cstring>
+
+namespace {
+
+// 檢查 [offset, offset + length) 是否落在 [0, limit) 之內
+bool InRange(uint64_t offset, uint64_t length, uint64_t limit) {
+    return offset <= limit && length <= limit - offset;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// FenceLayoutView
+
+FenceLayoutView::FenceLayoutView()
+    : header_(nullptr)
+    , fences_(nullptr)
+    , fenceRecordSize_(0)
+    , icons_(nullptr)
+    , stringPool_(nullptr) {
+}
+
+bool FenceLayoutView::IsBinaryLayout(const char* data, size_t size) {
+    return size >= sizeof(FENCE_LAYOUT_MAGIC) &&
+           std::memcmp(data, FENCE_LAYOUT_MAGIC, sizeof(FENCE_LAYOUT_MAGIC)) == 0;
+}
+
+bool FenceLayoutView::Attach(const char* data, size_t size) {
+    header_ = nullptr;
+
+    if (!IsBinaryLayout(data, size) || size < sizeof(FenceLayoutFileHeader) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(FenceLayoutFileHeader) != 0) {
+        return false;
+    }
+
+    const FenceLayoutFileHeader* header = reinterpret_cast<const FenceLayoutFileHeader*>(data);
+    if (header->version < 1 || header->version > FENCE_LAYOUT_VERSION ||
+        header->headerSize < sizeof(FenceLayoutFileHeader)) {
+        return false;
+    }
+    uint32_t fenceRecordSize = (header->version == 1) ? FENCE_LAYOUT_V1_FENCE_RECORD_SIZE
+                                                      : static_cast<uint32_t>(sizeof(FenceLayoutFenceRecord));
+
+    // 表格範圍與對齊
+    if (header->fenceTableOffset % 4 != 0 || header->iconTableOffset % 4 != 0 ||
+        !InRange(header->fenceTableOffset, uint64_t(header->fenceCount) * fenceRecordSize, size) ||
+        !InRange(header->iconTableOffset, uint64_t(header->iconCount) * sizeof(FenceLayoutIconRecord), size) ||
+        !InRange(header->stringPoolOffset, header->stringPoolSize, size)) {
+        return false;
+    }
+
+    const FenceLayoutIconRecord* icons =
+        reinterpret_cast<const FenceLayoutIconRecord*>(data + header->iconTableOffset);
+
+    // 只做整數範圍檢查，不解碼任何字串
+    for (uint32_t i = 0; i < header->fenceCount; ++i) {
+        FenceLayoutFenceRecord fence;
+        std::memcpy(&fence, data + header->fenceTableOffset + uint64_t(i) * fenceRecordSize,
+                    FENCE_LAYOUT_V1_FENCE_RECORD_SIZE);
+        if (!InRange(fence.titleOffset, fence.titleLength, header->stringPoolSize) ||
+            !InRange(fence.firstIcon, fence.iconCount, header->iconCount)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->iconCount; ++i) {
+        if (!InRange(icons[i].pathOffset, icons[i].pathLength, header->stringPoolSize)) {
+            return false;
+        }
+    }
+
+    header_ = header;
+    fences_ = data + header->fenceTableOffset;
+    fenceRecordSize_ = fenceRecordSize;
+    icons_ = icons;
+    stringPool_ = data + header->stringPoolOffset;
+    return true;
+}
+
+FenceLayoutFenceRecord FenceLayoutView::GetFence(uint32_t index) const {
+    // 舊版紀錄較短：先填入預設值，再複製檔案中實際存在的部分
+    FenceLayoutFence defaults;
+    FenceLayoutFenceRecord record = {};
+    record.borderWidth = defaults.borderWidth;
+    record.iconSpacing = defaults.iconSpacing;
+    record.scrollOffset = defaults.scrollOffset;
+    std::memcpy(&record, fences_ + uint64_t(index) * fenceRecordSize_, fenceRecordSize_);
+    return record;
+}
+
+std::string_view FenceLayoutView::GetString(uint32_t offset, uint32_t length) const {
+    return std::string_view(stringPool_ + offset, length);
+}
+
+std::wstring FenceLayoutView::DecodeString(uint32_t offset, uint32_t length) const {
+    return StringCodec::ToWide(GetString(offset, length));
+}
+
+void FenceLayoutView::GetFenceSettings(uint32_t index, FenceLayoutFence& fence) const {
+    FenceLayoutFenceRecord record = GetFence(index);
+
+    fence.title = DecodeString(record.titleOffset, record.titleLength);
+    fence.x = record.x;
+    fence.y = record.y;
+    fence.width = record.width;
+    fence.height = record.height;
+    fence.isCollapsed = (record.flags & FENCE_LAYOUT_FLAG_COLLAPSED) != 0;
+    fence.isPinned = (record.flags & FENCE_LAYOUT_FLAG_PINNED) != 0;
+    fence.expandedHeight = record.expandedHeight;
+    fence.iconSize = record.iconSize;
+    fence.alpha = record.alpha;
+    fence.backgroundColor = record.backgroundColor;
+    fence.borderColor = record.borderColor;
+    fence.titleColor = record.titleColor;
+    fence.borderWidth = record.borderWidth;
+    fence.iconSpacing = record.iconSpacing;
+    fence.scrollOffset = record.scrollOffset;
+    fence.icons.clear();
+}
+
+void FenceLayoutView::ToLayout(FenceLayout& layout) const {
+    layout.journalSequence = header_->journalSequence;
+    layout.fences.clear();
+    layout.fences.resize(header_->fenceCount);
+
+    for (uint32_t i = 0; i < header_->fenceCount; ++i) {
+        FenceLayoutFenceRecord record = GetFence(i);
+        FenceLayoutFence& fence = layout.fences[i];
+        GetFenceSettings(i, fence);
+
+        fence.icons.reserve(record.iconCount);
+        for (uint32_t j = 0; j < record.iconCount; ++j) {
+            const FenceLayoutIconRecord& iconRecord = icons_[record.firstIcon + j];
+            FenceLayoutIcon icon;
+            icon.filePath = DecodeString(iconRecord.pathOffset, iconRecord.pathLength);
+            icon.originalX = iconRecord.originalX;
+            icon.originalY = iconRecord.originalY;
+            icon.originalIndex = iconRecord.originalIndex;
+            fence.icons.push_back(std::move(icon));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// FenceLayoutBinary
+
+std::string FenceLayoutBinary::Write(const FenceLayout& layout) {
+    std::vector<FenceLayoutFenceRecord> fenceTable;
+    std::vector<FenceLayoutIconRecord> iconTable;
+    std::string stringPool;
+
+    fenceTable.reserve(layout.fences.size());
+    for (const auto& fence : layout.fences) {
+        FenceLayoutFenceRecord record = {};
+        record.x = fence.x;
+        record.y = fence.y;
+        record.width = fence.width;
+        record.height = fence.height;
+        record.expandedHeight = fence.expandedHeight;
+        record.iconSize = fence.iconSize;
+        record.alpha = fence.alpha;
+        record.backgroundColor = fence.backgroundColor;
+        record.borderColor = fence.borderColor;
+        record.titleColor = fence.titleColor;
+        record.borderWidth = fence.borderWidth;
+        record.iconSpacing = fence.iconSpacing;
+        record.scrollOffset = fence.scrollOffset;
+        record.flags = (fence.isCollapsed ? FENCE_LAYOUT_FLAG_COLLAPSED : 0) |
+                       (fence.isPinned ? FENCE_LAYOUT_FLAG_PINNED : 0);
+
+        record.titleOffset = static_cast<uint32_t>(stringPool.size());
+        StringCodec::AppendUtf8(stringPool, fence.title);
+        record.titleLength = static_cast<uint32_t>(stringPool.size()) - record.titleOffset;
+
+        record.firstIcon = static_cast<uint32_t>(iconTable.size());
+        record.iconCount = static_cast<uint32_t>(fence.icons.size());
+        for (const auto& icon : fence.icons) {
+            FenceLayoutIconRecord iconRecord = {};
+            iconRecord.originalX = icon.originalX;
+            iconRecord.originalY = icon.originalY;
+            iconRecord.originalIndex = icon.originalIndex;
+            iconRecord.pathOffset = static_cast<uint32_t>(stringPool.size());
+            StringCodec::AppendUtf8(stringPool, icon.filePath);
+            iconRecord.pathLength = static_cast<uint32_t>(stringPool.size()) - iconRecord.pathOffset;
+            iconTable.push_back(iconRecord);
+        }
+
+        fenceTable.push_back(record);
+    }
+
+    FenceLayoutFileHeader header = {};
+    std::memcpy(header.magic, FENCE_LAYOUT_MAGIC, sizeof(header.magic));
+    header.version = FENCE_LAYOUT_VERSION;
+    header.headerSize = sizeof(FenceLayoutFileHeader);
+    header.fenceCount = static_cast<uint32_t>(fenceTable.size());
+    header.iconCount = static_cast<uint32_t>(iconTable.size());
+    header.fenceTableOffset = sizeof(FenceLayoutFileHeader);
+    header.iconTableOffset = header.fenceTableOffset +
+                             header.fenceCount * static_cast<uint32_t>(sizeof(FenceLayoutFenceRecord));
+    header.stringPoolOffset = header.iconTableOffset +
+                              header.iconCount * static_cast<uint32_t>(sizeof(FenceLayoutIconRecord));
+    header.stringPoolSize = static_cast<uint32_t>(stringPool.size());
+    header.journalSequence = layout.journalSequence;
+
+    std::string output;
+    output.reserve(header.stringPoolOffset + stringPool.size());
+    output.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.append(reinterpret_cast<const char*>(fenceTable.data()),
+                  fenceTable.size() * sizeof(FenceLayoutFenceRecord));
+    output.append(reinterpret_cast<const char*>(iconTable.data()),
+                  iconTable.size() * sizeof(FenceLayoutIconRecord));
+    output += stringPool;
+    return output;
+}
+
+// ---------------------------------------------------------------------------
+// FenceLayoutJson
+
+bool FenceLayoutJson::Parse(const char* data, size_t size, FenceLayout& layout) {
+    // 解析時字串先以 string_view 指向原始緩衝區，版本確定後才解碼
+    struct RawStrings {
+        std::string_view title;
+        std::vector<std::string_view> paths;
+    };
+
+    JsonReader reader(data, size);
+    if (reader.Next() != JsonReader::Token::BeginObject) {
+        return false;
+    }
+
+    FenceLayout parsed;
+    std::vector<RawStrings> rawStrings;
+    bool hasFences = false;
+    int version = 1;
+
+    while (reader.Next() == JsonReader::Token::Key) {
+        if (reader.IsKey("version")) {
+            reader.Next();
+            version = (int)reader.GetInt(1);
+        } else if (reader.IsKey("journalSequence")) {
+            reader.Next();
+            parsed.journalSequence = (uint64_t)reader.GetInt(0);
+        } else if (reader.IsKey("fences")) {
+            if (reader.Next() != JsonReader::Token::BeginArray) {
+                return false;
+            }
+            hasFences = true;
+
+            while (reader.Next() == JsonReader::Token::BeginObject) {
+                FenceLayoutFence fence;
+                RawStrings raw;
+
+                while (reader.Next() == JsonReader::Token::Key) {
+                    if (reader.IsKey("icons")) {
+                        if (reader.Next() != JsonReader::Token::BeginArray) {
+                            return false;
+                        }
+
+                        while (reader.Next() == JsonReader::Token::BeginObject) {
+                            FenceLayoutIcon icon;
+                            std::string_view rawPath;
+                            while (reader.Next() == JsonReader::Token::Key) {
+                                if (reader.IsKey("filePath")) {
+                                    reader.Next();
+                                    rawPath = reader.GetRawString();
+                                } else if (!FENCE_LAYOUT_ICON_FIELDS.ReadJson(reader, icon) &&
+                                           !reader.SkipValue()) {
+                                    return false;
+                                }
+                            }
+                            if (reader.GetToken() != JsonReader::Token::EndObject) {
+                                return false;
+                            }
+                            if (!rawPath.empty()) {
+                                fence.icons.push_back(std::move(icon));
+                                raw.paths.push_back(rawPath);
+                            }
+                        }
+                        if (reader.GetToken() != JsonReader::Token::EndArray) {
+                            return false;
+                        }
+                        continue;
+                    }
+
+                    // 標題與路徑需等版本確定後才解碼，先於欄位表處理
+                    if (reader.IsKey("title")) {
+                        reader.Next();
+                        raw.title = reader.GetRawString();
+                    } else if (!FENCE_LAYOUT_FENCE_FIELDS.ReadJson(reader, fence) && !reader.SkipValue()) {
+                        return false;
+                    }
+                }
+                if (reader.GetToken() != JsonReader::Token::EndObject) {
+                    return false;
+                }
+
+                parsed.fences.push_back(std::move(fence));
+                rawStrings.push_back(std::move(raw));
+            }
+            if (reader.GetToken() != JsonReader::Token::EndArray) {
+                return false;
+            }
+        } else if (!reader.SkipValue()) {
+            return false;
+        }
+    }
+
+    // 檢查是否有柵欄數據
+    if (reader.GetToken() != JsonReader::Token::EndObject || !hasFences) {
+        return false;
+    }
+
+    // 第 1 版設定檔寫入時未做轉義，字串需原樣讀回
+    bool unescape = (version >= 2);
+    for (size_t i = 0; i < parsed.fences.size(); ++i) {
+        FenceLayoutFence& fence = parsed.fences[i];
+        fence.title = JsonReader::DecodeWideString(rawStrings[i].title, unescape);
+        for (size_t j = 0; j < fence.icons.size(); ++j) {
+            fence.icons[j].filePath = JsonReader::DecodeWideString(rawStrings[i].paths[j], unescape);
+        }
+    }
+
+    layout = std::move(parsed);
+    return true;
+}
+
+std::string FenceLayoutJson::Write(const FenceLayout& layout, size_t reserveBytes) {
+    JsonWriter writer(reserveBytes);
+
+    writer.BeginObject();
+    writer.Key("version");
+    writer.Int(2);
+    writer.Key("journalSequence");
+    writer.UInt(layout.journalSequence);
+    writer.Key("fences");
+    writer.BeginArray();
+
+    for (const auto& fence : layout.fences) {
+        writer.BeginObject();
+        FENCE_LAYOUT_FENCE_FIELDS.WriteJson(writer, fence);
+
+        writer.Key("icons");
+        writer.BeginArray();
+        for (const auto& icon : fence.icons) {
+            writer.BeginObject();
+            FENCE_LAYOUT_ICON_FIELDS.WriteJson(writer, icon);
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+    return writer.Release();
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "core/FieldTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 柵欄佈局資料模型與檔案格式（不依賴 Windows，可供轉換工具在 Linux 上使用）
+//
+// 兩種格式：
+// - JSON（config.json）：匯入 / 匯出用，人可閱讀
+// - 二進位（config.layout）：固定標頭 + 柵欄表 + 圖示表 + 字串池，
+//   可直接映射檔案後就地讀取，不需解析
+
+struct FenceLayoutIcon {
+    std::wstring filePath;
+    int32_t originalX = 0;
+    int32_t originalY = 0;
+    int32_t originalIndex = -1;
+};
+
+struct FenceLayoutFence {
+    std::wstring title;
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    bool isCollapsed = false;
+    bool isPinned = false;
+    int32_t expandedHeight = -1;           // -1 表示未設定，沿用 height
+    int32_t iconSize = 64;                 // 預設值
+    int32_t alpha = 230;                   // 預設透明度
+    uint32_t backgroundColor = 0x00F0F0F0; // RGB(240, 240, 240)
+    uint32_t borderColor = 0x00646464;     // RGB(100, 100, 100)
+    uint32_t titleColor = 0x00323232;      // RGB(50, 50, 50)
+    int32_t borderWidth = 2;
+    int32_t iconSpacing = 10;
+    int32_t scrollOffset = 0;
+    std::vector<FenceLayoutIcon> icons;
+};
+
+// 欄位表（JSON 鍵名與輸出順序、日誌內容順序）；新增欄位時在此加一行，
+// 二進位佈局另需在 FenceLayoutFenceRecord 末端追加並提高版本號
+inline constexpr auto FENCE_LAYOUT_ICON_FIELDS = MakeFieldTable(
+    Field("filePath", &FenceLayoutIcon::filePath),
+    Field("originalX", &FenceLayoutIcon::originalX),
+    Field("originalY", &FenceLayoutIcon::originalY),
+    Field("originalIndex", &FenceLayoutIcon::originalIndex));
+
+inline constexpr auto FENCE_LAYOUT_FENCE_FIELDS = MakeFieldTable(
+    Field("title", &FenceLayoutFence::title),
+    Field("x", &FenceLayoutFence::x),
+    Field("y", &FenceLayoutFence::y),
+    Field("width", &FenceLayoutFence::width),
+    Field("height", &FenceLayoutFence::height),
+    Field("isCollapsed", &FenceLayoutFence::isCollapsed),
+    Field("isPinned", &FenceLayoutFence::isPinned),
+    Field("expandedHeight", &FenceLayoutFence::expandedHeight),
+    Field("iconSize", &FenceLayoutFence::iconSize),
+    Field("alpha", &FenceLayoutFence::alpha),
+    Field("backgroundColor", &FenceLayoutFence::backgroundColor),
+    Field("borderColor", &FenceLayoutFence::borderColor),
+    Field("titleColor", &FenceLayoutFence::titleColor),
+    Field("borderWidth", &FenceLayoutFence::borderWidth),
+    Field("iconSpacing", &FenceLayoutFence::iconSpacing),
+    Field("scrollOffset", &FenceLayoutFence::scrollOffset));
+
+struct FenceLayout {
+    uint64_t journalSequence = 0;  // 快照涵蓋到的變更日誌序號
+    std::vector<FenceLayoutFence> fences;
+};
+
+// ---------------------------------------------------------------------------
+// 二進位格式（小端序；所有偏移量皆相對於檔案開頭）
+
+const char FENCE_LAYOUT_MAGIC[8] = { 'I', 'K', 'F', 'L', 'A', 'Y', 'O', 'T' };
+const uint32_t FENCE_LAYOUT_VERSION = 2;
+
+// 第 1 版的柵欄紀錄沒有 borderWidth 之後的欄位（其餘佈局相同，仍可讀取）
+const uint32_t FENCE_LAYOUT_V1_FENCE_RECORD_SIZE = 60;
+
+const uint32_t FENCE_LAYOUT_FLAG_COLLAPSED = 0x1;
+const uint32_t FENCE_LAYOUT_FLAG_PINNED = 0x2;
+
+struct FenceLayoutFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t fenceCount;
+    uint32_t iconCount;
+    uint32_t fenceTableOffset;
+    uint32_t iconTableOffset;
+    uint32_t stringPoolOffset;
+    uint32_t stringPoolSize;
+    uint64_t journalSequence;
+};
+
+struct FenceLayoutFenceRecord {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    int32_t expandedHeight;
+    int32_t iconSize;
+    int32_t alpha;
+    uint32_t backgroundColor;
+    uint32_t borderColor;
+    uint32_t titleColor;
+    uint32_t flags;
+    uint32_t titleOffset;   // 字串池內的偏移（UTF-8）
+    uint32_t titleLength;
+    uint32_t firstIcon;     // 圖示表內的起始索引
+    uint32_t iconCount;
+    int32_t borderWidth;    // 第 2 版起
+    int32_t iconSpacing;
+    int32_t scrollOffset;
+};
+
+struct FenceLayoutIconRecord {
+    int32_t originalX;
+    int32_t originalY;
+    int32_t originalIndex;
+    uint32_t pathOffset;    // 字串池內的偏移（UTF-8）
+    uint32_t pathLength;
+};
+
+static_assert(sizeof(FenceLayoutFileHeader) == 48, "FenceLayoutFileHeader layout changed");
+static_assert(sizeof(FenceLayoutFenceRecord) == 72, "FenceLayoutFenceRecord layout changed");
+static_assert(sizeof(FenceLayoutIconRecord) == 20, "FenceLayoutIconRecord layout changed");
+
+// 就地讀取映射後的二進位佈局（不複製資料，字串需要時才解碼）
+class FenceLayoutView {
+public:
+    FenceLayoutView();
+
+    // 驗證標頭與所有表格、字串範圍；緩衝區在使用期間必須保持有效
+    bool Attach(const char* data, size_t size);
+
+    static bool IsBinaryLayout(const char* data, size_t size);
+
+    uint64_t GetJournalSequence() const { return header_->journalSequence; }
+    uint32_t GetFenceCount() const { return header_->fenceCount; }
+    uint32_t GetIconCount() const { return header_->iconCount; }
+
+    // 依檔案版本補齊缺少的欄位後回傳
+    FenceLayoutFenceRecord GetFence(uint32_t index) const;
+    const FenceLayoutIconRecord& GetIcon(uint32_t index) const { return icons_[index]; }
+
+    // 字串池內容（UTF-8）
+    std::string_view GetString(uint32_t offset, uint32_t length) const;
+    std::wstring DecodeString(uint32_t offset, uint32_t length) const;
+
+    // 取得柵欄設定（解碼標題，不含圖示）
+    void GetFenceSettings(uint32_t index, FenceLayoutFence& fence) const;
+
+    // 轉為可修改的資料模型（回放變更日誌或匯出時使用）
+    void ToLayout(FenceLayout& layout) const;
+
+private:
+    const FenceLayoutFileHeader* header_;
+    const char* fences_;
+    uint32_t fenceRecordSize_;
+    const FenceLayoutIconRecord* icons_;
+    const char* stringPool_;
+};
+
+class FenceLayoutBinary {
+public:
+    // 序列化為二進位佈局
+    static std::string Write(const FenceLayout& layout);
+};
+
+class FenceLayoutJson {
+public:
+    // 單次掃描解析 JSON（欄位順序不限，未知欄位略過）
+    static bool Parse(const char* data, size_t size, FenceLayout& layout);
+
+    // 輸出 JSON；reserveBytes 為預先配置的緩衝區大小
+    static std::string Write(const FenceLayout& layout, size_t reserveBytes = 0);
+};
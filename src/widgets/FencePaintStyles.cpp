@@ -0,0 +1,43 @@
+#include "FencePaintStyles.h"
+
+namespace {
+
+uint32_t Rgb(uint32_t r, uint32_t g, uint32_t b) {
+    return r | (g << 8) | (b << 16);
+}
+
+uint32_t Darken(uint32_t channel) {
+    return channel > 20 ? channel - 20 : 0;
+}
+
+// 字重：FW_NORMAL = 400、FW_BOLD = 700
+const PaintStyle TITLE_FONT_STYLE = PaintStyle::Font(L"Segoe UI", 16, 700);
+const PaintStyle HINT_FONT_STYLE = PaintStyle::Font(L"微軟正黑體", 14, 400, true);
+const PaintStyle LABEL_FONT_STYLE = PaintStyle::Font(L"微軟正黑體", 16, 400);
+const PaintStyle GLYPH_PEN_STYLE = PaintStyle::Pen(Rgb(255, 255, 255), 2);
+
+} // namespace
+
+FencePaintStyles GetFencePaintStyles(const FencePaintState& state) {
+    uint32_t r = state.backgroundColor & 0xFF;
+    uint32_t g = (state.backgroundColor >> 8) & 0xFF;
+    uint32_t b = (state.backgroundColor >> 16) & 0xFF;
+
+    return {
+        PaintStyle::Brush(state.backgroundColor),
+        PaintStyle::Brush(Rgb(Darken(r), Darken(g), Darken(b))),
+        TITLE_FONT_STYLE,
+        PaintStyle::Brush(state.isPinned ? Rgb(100, 150, 255) : Rgb(180, 180, 180)),
+        PaintStyle::Pen(state.isPinned ? Rgb(70, 120, 200) : Rgb(150, 150, 150), 1),
+        PaintStyle::Brush(state.isCollapsed ? Rgb(255, 150, 100) : Rgb(180, 180, 180)),
+        PaintStyle::Pen(state.isCollapsed ? Rgb(200, 120, 70) : Rgb(150, 150, 150), 1),
+        GLYPH_PEN_STYLE,
+        PaintStyle::Pen(state.borderColor, state.borderWidth),
+        HINT_FONT_STYLE,
+        PaintStyle::Brush(Rgb(200, 200, 200)),
+        PaintStyle::Brush(Rgb(120, 120, 120)),
+        PaintStyle::Brush(Rgb(120, 120, 120)),
+        LABEL_FONT_STYLE,
+        PaintStyle::Brush(Rgb(173, 216, 230)),
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "PaintResourceFactory.h"
+#include <cstdint>
+
+// 柵欄繪製時依柵欄設定選用的樣式（不依賴 Windows）
+// PaintFence、DrawIconLabel 與 PaintResourceCacheTest 都從 GetFencePaintStyles 取得樣式，
+// 測試重播的就是實際繪製用到的樣式。色彩為 COLORREF 的排列（0x00BBGGRR）。
+struct FencePaintState {
+    uint32_t backgroundColor;
+    uint32_t borderColor;
+    int32_t borderWidth;
+    bool isPinned;
+    bool isCollapsed;
+};
+
+// 字型與按鈕圖形不隨柵欄設定改變，以參考指向共用的常數，每幀取得時不複製字型名稱
+struct FencePaintStyles {
+    PaintStyle background;
+    PaintStyle titleBar;                // 背景色各通道減 20
+    const PaintStyle& titleFont;
+    PaintStyle pinButton;
+    PaintStyle pinButtonBorder;
+    PaintStyle collapseButton;
+    PaintStyle collapseButtonBorder;
+    const PaintStyle& buttonGlyph;      // 圖釘與箭頭
+    PaintStyle border;
+    const PaintStyle& hintFont;         // 沒有圖示時的提示文字
+    PaintStyle scrollTrack;
+    PaintStyle scrollThumb;
+    PaintStyle resizeIndicator;
+    const PaintStyle& labelFont;        // 圖示名稱
+    PaintStyle labelSelection;          // 選取的圖示名稱底色
+};
+
+FencePaintStyles GetFencePaintStyles(const FencePaintState& state);
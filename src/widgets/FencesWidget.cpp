@@ -1,5 +1,11 @@
 #include "FencesWidget.h"
+#include "FenceIconGrid.h"
+#include "FenceLayout.h"
+#include "IconBitmap.h"
+#include "IconScaler.h"
 #include "core/WidgetExport.h"
+#include "core/MutationJournal.h"
+#include "core/MappedFile.h"
 #include <windows.h>
 #include <shellapi.h>
 #include <commctrl.h>
@@ -9,7 +15,10 @@
 #include <dwmapi.h>
 #include <richedit.h>
 #include <algorithm>
+#include <cstring>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "gdi32.lib")
@@ -39,10 +48,16 @@
 #define IDM_REMOVE_ICON       1009
 #define IDM_CHANGE_TITLE_COLOR 1010
 #define IDM_AUTO_CATEGORIZE   1011
+#define IDM_ICON_SIZE_96      1012
+#define IDM_ICON_SIZE_128     1013
+#define IDM_ICON_SIZE_256     1014
 
 // Title bar height
 const int TITLE_BAR_HEIGHT = 35;
 
+// Icon sizes with a cache slot in DesktopIcon (see GetIconSlot)
+static const int ICON_SLOT_SIZES[] = { 32, 48, 64, 96, 128, 256 };
+
 // Icon spacing and padding
 const int ICON_PADDING_LEFT = 15;
 const int ICON_PADDING_RIGHT = 15;
@@ -62,6 +77,157 @@ static const COLORREF COLOR_PRESETS[] = {
 };
 const int COLOR_PRESETS_COUNT = sizeof(COLOR_PRESETS) / sizeof(COLOR_PRESETS[0]);
 
+// 變更日誌紀錄類型（數值會寫入檔案，不可更改）
+enum FenceJournalRecord : uint16_t {
+    JOURNAL_FENCE_CREATED = 1,     // x, y, width, height, title
+    JOURNAL_FENCE_REMOVED = 2,     // fenceIndex
+    JOURNAL_FENCE_BOUNDS = 3,      // fenceIndex, x, y, width, height
+    JOURNAL_FENCE_COLLAPSED = 4,   // fenceIndex, isCollapsed, expandedHeight
+    JOURNAL_FENCE_PINNED = 5,      // fenceIndex, isPinned
+    JOURNAL_FENCE_TITLE = 6,       // fenceIndex, title
+    JOURNAL_FENCE_STYLE = 7,       // fenceIndex, backgroundColor, borderColor, titleColor, alpha
+    JOURNAL_FENCE_ICON_SIZE = 8,   // fenceIndex, iconSize
+    JOURNAL_ICON_ADDED = 9,        // fenceIndex, FENCE_LAYOUT_ICON_FIELDS
+    JOURNAL_ICON_REMOVED = 10      // fenceIndex, iconIndex
+};
+
+// 背景提取的圖示已完成（送給柵欄視窗）
+const UINT WM_FENCE_ICONS_READY = WM_APP + 1;
+
+// 距離上次快照累積多少筆紀錄後，寫入新快照並壓縮日誌
+const uint64_t JOURNAL_COMPACT_RECORDS = 256;
+
+namespace {
+
+// 日誌檔與快照放在同一目錄（config.journal）
+std::wstring GetJournalFilePath(const std::wstring& configPath) {
+    std::wstring base = configPath;
+    size_t dot = base.find_last_of(L'.');
+    size_t slash = base.find_last_of(L"\\/");
+    if (dot != std::wstring::npos && (slash == std::wstring::npos || dot > slash)) {
+        base.erase(dot);
+    }
+    return base + L".journal";
+}
+
+// 將一筆日誌紀錄套用到佈局資料模型
+void ApplyJournalRecord(std::vector<FenceLayoutFence>& fences, const MutationJournal::Record& record) {
+    JournalPayloadReader payload(record.payload, record.payloadSize);
+
+    if (record.type == JOURNAL_FENCE_CREATED) {
+        // 與 CreateFence 的預設值一致
+        FenceLayoutFence fence;
+        fence.x = payload.GetInt();
+        fence.y = payload.GetInt();
+        fence.width = payload.GetInt();
+        fence.height = payload.GetInt();
+        fence.title = payload.GetString();
+        fence.alpha = 220;
+        if (payload.IsValid()) {
+            fences.push_back(std::move(fence));
+        }
+        return;
+    }
+
+    int fenceIndex = payload.GetInt();
+    if (fenceIndex < 0 || fenceIndex >= (int)fences.size()) {
+        return;
+    }
+    FenceLayoutFence& fence = fences[fenceIndex];
+
+    switch (record.type) {
+    case JOURNAL_FENCE_REMOVED:
+        fences.erase(fences.begin() + fenceIndex);
+        break;
+
+    case JOURNAL_FENCE_BOUNDS: {
+        int x = payload.GetInt();
+        int y = payload.GetInt();
+        int width = payload.GetInt();
+        int height = payload.GetInt();
+        if (payload.IsValid()) {
+            fence.x = x;
+            fence.y = y;
+            fence.width = width;
+            fence.height = height;
+        }
+        break;
+    }
+
+    case JOURNAL_FENCE_COLLAPSED: {
+        bool isCollapsed = payload.GetBool();
+        int expandedHeight = payload.GetInt();
+        if (payload.IsValid()) {
+            fence.isCollapsed = isCollapsed;
+            fence.expandedHeight = expandedHeight;
+            fence.height = isCollapsed ? TITLE_BAR_HEIGHT : expandedHeight;
+        }
+        break;
+    }
+
+    case JOURNAL_FENCE_PINNED: {
+        bool isPinned = payload.GetBool();
+        if (payload.IsValid()) {
+            fence.isPinned = isPinned;
+        }
+        break;
+    }
+
+    case JOURNAL_FENCE_TITLE: {
+        std::wstring title = payload.GetString();
+        if (payload.IsValid()) {
+            fence.title = title;
+        }
+        break;
+    }
+
+    case JOURNAL_FENCE_STYLE: {
+        COLORREF backgroundColor = payload.GetUInt();
+        COLORREF borderColor = payload.GetUInt();
+        COLORREF titleColor = payload.GetUInt();
+        int alpha = payload.GetInt();
+        if (payload.IsValid()) {
+            fence.backgroundColor = backgroundColor;
+            fence.borderColor = borderColor;
+            fence.titleColor = titleColor;
+            fence.alpha = alpha;
+        }
+        break;
+    }
+
+    case JOURNAL_FENCE_ICON_SIZE: {
+        int iconSize = payload.GetInt();
+        if (payload.IsValid()) {
+            fence.iconSize = iconSize;
+        }
+        break;
+    }
+
+    case JOURNAL_ICON_ADDED: {
+        FenceLayoutIcon icon;
+        FENCE_LAYOUT_ICON_FIELDS.ReadPayload(payload, icon);
+        if (payload.IsValid() && !icon.filePath.empty()) {
+            fence.icons.push_back(std::move(icon));
+        }
+        break;
+    }
+
+    case JOURNAL_ICON_REMOVED: {
+        int iconIndex = payload.GetInt();
+        if (payload.IsValid() && iconIndex >= 0 && iconIndex < (int)fence.icons.size()) {
+            fence.icons.erase(fence.icons.begin() + iconIndex);
+        }
+        break;
+    }
+
+    default:
+        // 未知類型（較新版本寫入）：略過
+        break;
+    }
+}
+
+} // namespace
+
 FencesWidget::FencesWidget()
     : running_(false)
     , shutdownCalled_(false)
@@ -69,9 +235,14 @@ FencesWidget::FencesWidget()
     , windowClassName_(L"DesktopFenceWidget")
     , classRegistered_(false)
     , desktopWindow_(nullptr)
-    , desktopListView_(nullptr)
+    , desktopIcons_(desktopHost_)
+    , desktopIndex_(desktopFolderWatcher_)
+    , iconPool_(&FencesWidget::ExtractFileIcon, WM_FENCE_ICONS_READY)
+    , paintResources_(paintFactory_)
     , selectedIconIndex_(-1)
-    , selectedFence_(nullptr) {
+    , selectedFence_(nullptr)
+    , lastConfigSize_(0)
+    , lastSnapshotSequence_(0) {
 }
 
 FencesWidget::~FencesWidget() {
@@ -92,13 +263,23 @@ bool FencesWidget::Start() {
         return true;
     }
 
+    // 桌面項目有新增、刪除或改名時使名稱快照失效
+    desktopHost_.StartWatching(hInstance_);
+
+    // 上次保存的圖示點陣圖：第一次繪製即可顯示真正的圖示
+    LoadPersistentIcons();
+
     // 如果 fences_ 為空，才載入配置（首次啟動或清空後）
     if (fences_.empty()) {
-        wchar_t appData[MAX_PATH];
         bool configLoaded = false;
-        if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appData) == S_OK) {
-            std::wstring configPath = std::wstring(appData) + L"\\FencesWidget\\config.json";
-            configLoaded = LoadConfiguration(configPath);
+        std::wstring layoutPath = GetConfigFilePath(L"config.layout");
+        if (!layoutPath.empty()) {
+            // 優先讀取二進位快照，沒有時匯入 config.json（舊版或手動編輯的設定）
+            if (GetFileAttributesW(layoutPath.c_str()) != INVALID_FILE_ATTRIBUTES) {
+                configLoaded = LoadConfiguration(layoutPath);
+            } else {
+                configLoaded = LoadConfiguration(GetConfigFilePath(L"config.json"));
+            }
         }
 
         // 如果沒有配置檔，建立示範柵欄
@@ -106,6 +287,9 @@ bool FencesWidget::Start() {
             if (!CreateFence(100, 100, 300, 400, L"桌面柵欄 1")) {
                 return false;
             }
+
+            // 寫入初始快照，之後的變更日誌才有對應的柵欄
+            MarkConfigDirty();
         }
     }
 
@@ -116,16 +300,14 @@ bool FencesWidget::Start() {
         }
     }
 
-    // 重新隱藏應該在柵欄中的桌面圖示
-    for (auto& fence : fences_) {
-        if (!fence.icons.empty()) {
-            std::vector<std::wstring> iconPaths;
-            for (const auto& icon : fence.icons) {
-                iconPaths.push_back(icon.filePath);
-            }
-            HideDesktopIconsBatch(iconPaths);
+    // 讓桌面與柵欄一致：只移動位置不符的圖示（上次已隱藏的不再處理）
+    std::vector<std::wstring> iconPaths;
+    for (const auto& fence : fences_) {
+        for (const auto& icon : fence.icons) {
+            iconPaths.push_back(icon.filePath);
         }
     }
+    desktopIcons_.Reconcile(iconPaths);
 
     running_ = true;
     return true;
@@ -133,17 +315,17 @@ bool FencesWidget::Start() {
 
 void FencesWidget::RestoreAllDesktopIcons() {
     // 收集所有需要恢復的圖示資料
-    std::vector<std::pair<std::wstring, POINT>> iconData;
+    std::vector<std::pair<std::wstring, DesktopIconPoint>> iconData;
 
     for (auto& fence : fences_) {
         for (const auto& icon : fence.icons) {
-            iconData.push_back({icon.filePath, icon.originalDesktopPos});
+            iconData.push_back({ icon.filePath, ToDesktopIconPoint(icon.originalDesktopPos) });
         }
     }
 
     // 批次恢復所有圖示（一次性完成，避免多次重繪）
     if (!iconData.empty()) {
-        RestoreDesktopIconsBatch(iconData);
+        desktopIcons_.Restore(iconData);
     }
 }
 
@@ -160,10 +342,8 @@ std::wstring FencesWidget::GetFileExtension(const std::wstring& filePath) {
 }
 
 // 根據檔案類型取得分類名稱
-std::wstring FencesWidget::GetFileCategory(const std::wstring& filePath) {
-    // 檢查是否為資料夾
-    DWORD attrs = GetFileAttributesW(filePath.c_str());
-    if (attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+std::wstring FencesWidget::GetFileCategory(const std::wstring& filePath, bool isDirectory) {
+    if (isDirectory) {
         return L"資料夾";
     }
 
@@ -218,58 +398,65 @@ std::wstring FencesWidget::GetFileCategory(const std::wstring& filePath) {
     return L"其他";
 }
 
-// 自動分類桌面圖示
-void FencesWidget::AutoCategorizeDesktopIcons() {
-    // 取得桌面資料夾路徑
-    wchar_t desktopPath[MAX_PATH];
-    if (SHGetFolderPathW(nullptr, CSIDL_DESKTOP, nullptr, 0, desktopPath) != S_OK) {
-        MessageBoxW(nullptr, L"無法取得桌面路徑", L"錯誤", MB_OK | MB_ICONERROR);
-        return;
+bool FencesWidget::UpdateDesktopIndex() {
+    if (desktopIndex_.GetFolderCount() == 0) {
+        // 使用者桌面（啟用 OneDrive 備份時已重新導向）與公用桌面
+        const int folderIds[] = { CSIDL_DESKTOPDIRECTORY, CSIDL_COMMON_DESKTOPDIRECTORY };
+        for (int folderId : folderIds) {
+            wchar_t folderPath[MAX_PATH];
+            if (SHGetFolderPathW(nullptr, folderId, nullptr, 0, folderPath) == S_OK) {
+                desktopIndex_.AddFolder(folderPath);
+            }
+        }
+
+        // 未重新導向時，OneDrive 仍可能同步一份桌面資料夾
+        wchar_t oneDrive[MAX_PATH];
+        DWORD length = GetEnvironmentVariableW(L"OneDrive", oneDrive, MAX_PATH);
+        if (length > 0 && length < MAX_PATH) {
+            std::wstring oneDriveDesktop = std::wstring(oneDrive) + L"\\Desktop";
+            DWORD attrs = GetFileAttributesW(oneDriveDesktop.c_str());
+            if (attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+                desktopIndex_.AddFolder(oneDriveDesktop);
+            }
+        }
     }
 
-    // 掃描桌面上的所有檔案和資料夾
-    std::wstring searchPath = std::wstring(desktopPath) + L"\\*";
-    WIN32_FIND_DATAW findData;
-    HANDLE hFind = FindFirstFileW(searchPath.c_str(), &findData);
+    desktopIndex_.Update();
+    return desktopIndex_.GetFolderCount() > 0;
+}
 
-    if (hFind == INVALID_HANDLE_VALUE) {
+// 自動分類桌面圖示
+void FencesWidget::AutoCategorizeDesktopIcons() {
+    // 桌面項目來自索引（首次使用時掃描，之後只套用變更通知）
+    if (!UpdateDesktopIndex()) {
         MessageBoxW(nullptr, L"無法掃描桌面檔案", L"錯誤", MB_OK | MB_ICONERROR);
         return;
     }
 
-    // 建立分類對應表
-    std::map<std::wstring, std::vector<std::wstring>> categoryMap;
-
-    do {
-        // 跳過 . 和 ..
-        if (wcscmp(findData.cFileName, L".") == 0 || wcscmp(findData.cFileName, L"..") == 0) {
-            continue;
+    std::unordered_set<std::wstring> iconsInFences;
+    for (const auto& fence : fences_) {
+        for (const auto& icon : fence.icons) {
+            iconsInFences.insert(icon.filePath);
         }
+    }
 
-        // 建立完整路徑
-        std::wstring fullPath = std::wstring(desktopPath) + L"\\" + findData.cFileName;
+    // 建立分類對應表
+    std::map<std::wstring, std::vector<std::wstring>> categoryMap;
 
-        // 檢查是否已經在某個柵欄中
-        bool alreadyInFence = false;
-        for (const auto& fence : fences_) {
-            for (const auto& icon : fence.icons) {
-                if (icon.filePath == fullPath) {
-                    alreadyInFence = true;
-                    break;
-                }
-            }
-            if (alreadyInFence) break;
+    desktopIndex_.ForEach([&](const DesktopIndex::Entry& entry) {
+        // 隱藏項目（desktop.ini 等）不會顯示在桌面上
+        if (entry.isHidden) {
+            return;
         }
 
         // 如果不在柵欄中，加入分類
-        if (!alreadyInFence) {
-            std::wstring category = GetFileCategory(fullPath);
-            categoryMap[category].push_back(fullPath);
+        if (iconsInFences.find(entry.path) == iconsInFences.end()) {
+            categoryMap[GetFileCategory(entry.path, entry.isDirectory)].push_back(entry.path);
         }
+    });
 
-    } while (FindNextFileW(hFind, &findData));
-
-    FindClose(hFind);
+    // 一次讀回所有桌面圖示的位置，各分類共用
+    std::vector<DesktopIconPoint> desktopPositions = desktopIcons_.GetAllPositions();
 
     // 為每個分類建立柵欄（如果該分類有檔案）
     int xOffset = 100;
@@ -303,16 +490,17 @@ void FencesWidget::AutoCategorizeDesktopIcons() {
 
         // 將檔案加入到柵欄
         if (targetFence) {
+            size_t firstAdded = targetFence->icons.size();
+            AddIconsToFence(targetFence, files, &desktopPositions);
+
             std::vector<std::wstring> filesToHide;
-            for (const auto& filePath : files) {
-                if (AddIconToFence(targetFence, filePath)) {
-                    filesToHide.push_back(filePath);
-                }
+            for (size_t i = firstAdded; i < targetFence->icons.size(); ++i) {
+                filesToHide.push_back(targetFence->icons[i].filePath);
             }
 
             // 批次隱藏桌面圖示
             if (!filesToHide.empty()) {
-                HideDesktopIconsBatch(filesToHide);
+                desktopIcons_.Hide(filesToHide);
             }
 
             ArrangeIcons(targetFence);
@@ -320,14 +508,8 @@ void FencesWidget::AutoCategorizeDesktopIcons() {
         }
     }
 
-    // 儲存配置
-    wchar_t appData[MAX_PATH];
-    if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appData) == S_OK) {
-        std::wstring configPath = std::wstring(appData) + L"\\FencesWidget\\config.json";
-        std::wstring dirPath = std::wstring(appData) + L"\\FencesWidget";
-        CreateDirectoryW(dirPath.c_str(), nullptr);
-        SaveConfiguration(configPath);
-    }
+    // 儲存配置（背景寫入）
+    MarkConfigDirty();
 
     MessageBoxW(nullptr, L"桌面圖示自動分類完成！", L"完成", MB_OK | MB_ICONINFORMATION);
 }
@@ -348,6 +530,9 @@ void FencesWidget::ClearAllData() {
 
     // 刪除所有柵欄窗口
     for (auto& fence : fences_) {
+        for (auto& icon : fence.icons) {
+            ReleaseIcons(icon);
+        }
         if (fence.hwnd) {
             DestroyWindow(fence.hwnd);
         }
@@ -361,12 +546,21 @@ void FencesWidget::ClearAllData() {
     if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appData) == S_OK) {
         std::wstring configDir = std::wstring(appData) + L"\\FencesWidget";
         std::wstring configPath = configDir + L"\\config.json";
+        std::wstring layoutPath = configDir + L"\\config.layout";
+
+        // 捨棄尚未寫入的內容，避免刪除後又被寫回
+        persistence_.Discard(configPath);
+        persistence_.Discard(layoutPath);
 
-        // 刪除 config.json
+        // 刪除 config.json、二進位快照與變更日誌
         DeleteFileW(configPath.c_str());
+        DeleteFileW(layoutPath.c_str());
+        journal_.Close();
+        DeleteFileW(GetJournalFilePath(configPath).c_str());
 
-        // 嘗試刪除目錄（如果為空）
-        RemoveDirectoryW(configDir.c_str());
+        // 重新開啟空的日誌，之後建立的柵欄與變更照常記錄（序號從頭開始）
+        journal_.Open(GetJournalFilePath(configPath), 0, nullptr);
+        lastSnapshotSequence_ = 0;
     }
 
     MessageBoxW(nullptr, L"已清除所有柵欄和配置記錄！", L"完成", MB_OK | MB_ICONINFORMATION);
@@ -379,6 +573,10 @@ void FencesWidget::Stop() {
 
     // 關閉前恢復所有桌面圖示
     RestoreAllDesktopIcons();
+    desktopHost_.StopWatching();
+    desktopHost_.Disconnect();
+    desktopIndex_.Clear();
+    SavePersistentIcons();
 
     // Hide all fence windows
     for (auto& fence : fences_) {
@@ -390,285 +588,301 @@ void FencesWidget::Stop() {
     running_ = false;
 }
 
-bool FencesWidget::SaveConfiguration(const std::wstring& filePath) {
-    // 打開檔案寫入
-    HANDLE hFile = CreateFileW(filePath.c_str(), GENERIC_WRITE, 0, nullptr,
-                               CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
-    if (hFile == INVALID_HANDLE_VALUE) {
-        return false;
+std::wstring FencesWidget::GetConfigFilePath(const wchar_t* fileName) const {
+    wchar_t appData[MAX_PATH];
+    if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appData) != S_OK) {
+        return std::wstring();
     }
 
-    std::wstring config = L"{\n  \"fences\": [\n";
+    // 創建目錄
+    std::wstring dirPath = std::wstring(appData) + L"\\FencesWidget";
+    CreateDirectoryW(dirPath.c_str(), nullptr);
 
-    for (size_t i = 0; i < fences_.size(); ++i) {
-        const auto& fence = fences_[i];
-
-        config += L"    {\n";
-        config += L"      \"title\": \"" + fence.title + L"\",\n";
-        config += L"      \"x\": " + std::to_wstring(fence.rect.left) + L",\n";
-        config += L"      \"y\": " + std::to_wstring(fence.rect.top) + L",\n";
-        config += L"      \"width\": " + std::to_wstring(fence.rect.right - fence.rect.left) + L",\n";
-        config += L"      \"height\": " + std::to_wstring(fence.rect.bottom - fence.rect.top) + L",\n";
-        config += L"      \"isCollapsed\": " + std::wstring(fence.isCollapsed ? L"true" : L"false") + L",\n";
-        config += L"      \"isPinned\": " + std::wstring(fence.isPinned ? L"true" : L"false") + L",\n";
-        config += L"      \"expandedHeight\": " + std::to_wstring(fence.expandedHeight) + L",\n";
-        config += L"      \"iconSize\": " + std::to_wstring(fence.iconSize) + L",\n";
-        config += L"      \"alpha\": " + std::to_wstring(fence.alpha) + L",\n";
-        config += L"      \"backgroundColor\": " + std::to_wstring(fence.backgroundColor) + L",\n";
-        config += L"      \"borderColor\": " + std::to_wstring(fence.borderColor) + L",\n";
-        config += L"      \"titleColor\": " + std::to_wstring(fence.titleColor) + L",\n";
-        config += L"      \"icons\": [\n";
-
-        for (size_t j = 0; j < fence.icons.size(); ++j) {
-            const auto& icon = fence.icons[j];
-            config += L"        {\n";
-            config += L"          \"filePath\": \"" + icon.filePath + L"\",\n";
-            config += L"          \"originalX\": " + std::to_wstring(icon.originalDesktopPos.x) + L",\n";
-            config += L"          \"originalY\": " + std::to_wstring(icon.originalDesktopPos.y) + L",\n";
-            config += L"          \"originalIndex\": " + std::to_wstring(icon.originalDesktopIndex) + L"\n";
-            config += L"        }";
-            if (j < fence.icons.size() - 1) config += L",";
-            config += L"\n";
-        }
-
-        config += L"      ]\n";
-        config += L"    }";
-        if (i < fences_.size() - 1) config += L",";
-        config += L"\n";
-    }
-
-    config += L"  ]\n}\n";
-
-    // 轉換為 UTF-8 並寫入
-    int size = WideCharToMultiByte(CP_UTF8, 0, config.c_str(), -1, nullptr, 0, nullptr, nullptr);
-    char* utf8 = new char[size];
-    WideCharToMultiByte(CP_UTF8, 0, config.c_str(), -1, utf8, size, nullptr, nullptr);
-
-    DWORD written;
-    WriteFile(hFile, utf8, size - 1, &written, nullptr);
-
-    delete[] utf8;
-    CloseHandle(hFile);
-    return true;
+    return dirPath + L"\\" + fileName;
 }
 
-bool FencesWidget::LoadConfiguration(const std::wstring& filePath) {
-    // 讀取檔案
-    HANDLE hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
-                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-    if (hFile == INVALID_HANDLE_VALUE) {
-        return false;
+void FencesWidget::MarkConfigDirty() {
+    std::wstring layoutPath = GetConfigFilePath(L"config.layout");
+    if (!layoutPath.empty()) {
+        SaveSnapshot(layoutPath);
     }
+}
 
-    DWORD fileSize = GetFileSize(hFile, nullptr);
-    if (fileSize == 0 || fileSize == INVALID_FILE_SIZE) {
-        CloseHandle(hFile);
-        return false;
+void FencesWidget::BuildLayout(FenceLayout& layout) const {
+    layout.fences.clear();
+    layout.fences.reserve(fences_.size());
+
+    for (const auto& fence : fences_) {
+        FenceLayoutFence entry;
+        entry.title = fence.title;
+        entry.x = fence.rect.left;
+        entry.y = fence.rect.top;
+        entry.width = fence.rect.right - fence.rect.left;
+        entry.height = fence.rect.bottom - fence.rect.top;
+        entry.isCollapsed = fence.isCollapsed;
+        entry.isPinned = fence.isPinned;
+        entry.expandedHeight = fence.expandedHeight;
+        entry.iconSize = fence.iconSize;
+        entry.alpha = fence.alpha;
+        entry.backgroundColor = fence.backgroundColor;
+        entry.borderColor = fence.borderColor;
+        entry.titleColor = fence.titleColor;
+        entry.borderWidth = fence.borderWidth;
+        entry.iconSpacing = fence.iconSpacing;
+        entry.scrollOffset = fence.scrollOffset;
+
+        entry.icons.reserve(fence.icons.size());
+        for (const auto& icon : fence.icons) {
+            FenceLayoutIcon iconEntry;
+            iconEntry.filePath = icon.filePath;
+            iconEntry.originalX = icon.originalDesktopPos.x;
+            iconEntry.originalY = icon.originalDesktopPos.y;
+            iconEntry.originalIndex = icon.originalDesktopIndex;
+            entry.icons.push_back(std::move(iconEntry));
+        }
+
+        layout.fences.push_back(std::move(entry));
     }
+}
 
-    char* buffer = new char[fileSize + 1];
-    DWORD bytesRead;
-    ReadFile(hFile, buffer, fileSize, &bytesRead, nullptr);
-    buffer[bytesRead] = '\0';
-    CloseHandle(hFile);
+bool FencesWidget::SaveConfiguration(const std::wstring& filePath) {
+    // 匯出 JSON（以上次輸出大小預先配置緩衝區，直接輸出 UTF-8）
+    FenceLayout layout;
+    BuildLayout(layout);
+    layout.journalSequence = journal_.GetLastSequence();
 
-    // 轉換為 wide string
-    int wsize = MultiByteToWideChar(CP_UTF8, 0, buffer, -1, nullptr, 0);
-    if (wsize == 0) {
-        delete[] buffer;
-        return false;
-    }
+    std::string json = FenceLayoutJson::Write(layout, lastConfigSize_ + lastConfigSize_ / 4);
+    lastConfigSize_ = json.size();
 
-    wchar_t* wbuffer = new wchar_t[wsize];
-    MultiByteToWideChar(CP_UTF8, 0, buffer, -1, wbuffer, wsize);
-    std::wstring json(wbuffer);
+    // 交給背景執行緒寫入（短時間內的多次儲存會合併成一次）
+    persistence_.Submit(filePath, std::move(json));
+    return true;
+}
 
-    delete[] buffer;
-    delete[] wbuffer;
+bool FencesWidget::SaveSnapshot(const std::wstring& filePath) {
+    // 快照包含到目前為止的所有日誌紀錄
+    FenceLayout layout;
+    BuildLayout(layout);
+    layout.journalSequence = journal_.GetLastSequence();
+    lastSnapshotSequence_ = layout.journalSequence;
 
-    // 檢查是否有柵欄數據
-    if (json.find(L"\"fences\":") == std::wstring::npos) {
-        return false;
-    }
+    // 寫入成功後，快照已涵蓋的日誌紀錄即可捨棄
+    uint64_t journalSequence = layout.journalSequence;
+    persistence_.Submit(filePath, FenceLayoutBinary::Write(layout), [this, journalSequence](bool written) {
+        if (written) {
+            journal_.DiscardThrough(journalSequence);
+        }
+    });
+    return true;
+}
 
-    // 簡單的 JSON 解析（手動解析，避免外部依賴）
-    size_t pos = 0;
-    int fenceCount = 0;
-    while ((pos = json.find(L"\"title\":", pos)) != std::wstring::npos) {
-        // 解析柵欄標題
-        size_t titleStart = json.find(L'"', pos + 8) + 1;
-        size_t titleEnd = json.find(L'"', titleStart);
-        std::wstring title = json.substr(titleStart, titleEnd - titleStart);
+int FencesWidget::GetFenceIndex(const Fence* fence) const {
+    for (size_t i = 0; i < fences_.size(); ++i) {
+        if (&fences_[i] == fence) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
 
-        // 解析位置和大小
-        size_t xPos = json.find(L"\"x\":", titleEnd);
-        size_t yPos = json.find(L"\"y\":", xPos);
-        size_t wPos = json.find(L"\"width\":", yPos);
-        size_t hPos = json.find(L"\"height\":", wPos);
+void FencesWidget::AppendJournal(uint16_t type, const JournalPayloadWriter& payload) {
+    // 日誌未開啟或寫入失敗時改寫完整快照
+    if (!journal_.IsOpen() || journal_.Append(type, payload) == 0) {
+        MarkConfigDirty();
+        return;
+    }
 
-        int x = std::stoi(json.substr(json.find(L':', xPos) + 1, 10));
-        int y = std::stoi(json.substr(json.find(L':', yPos) + 1, 10));
-        int width = std::stoi(json.substr(json.find(L':', wPos) + 1, 10));
-        int height = std::stoi(json.substr(json.find(L':', hPos) + 1, 10));
+    // 累積一定數量的紀錄後寫入新快照（壓縮日誌）
+    if (journal_.GetLastSequence() - lastSnapshotSequence_ >= JOURNAL_COMPACT_RECORDS) {
+        MarkConfigDirty();
+    }
+}
 
-        // 解析收合狀態、固定狀態、展開高度、圖示大小、透明度和顏色
-        size_t collapsedPos = json.find(L"\"isCollapsed\":", hPos);
-        size_t pinnedPos = json.find(L"\"isPinned\":", hPos);
-        size_t expandedHeightPos = json.find(L"\"expandedHeight\":", hPos);
-        size_t iconSizePos = json.find(L"\"iconSize\":", hPos);
-        size_t alphaPos = json.find(L"\"alpha\":", hPos);
-        size_t bgColorPos = json.find(L"\"backgroundColor\":", hPos);
-        size_t borderColorPos = json.find(L"\"borderColor\":", hPos);
-        size_t titleColorPos = json.find(L"\"titleColor\":", hPos);
+void FencesWidget::JournalFenceStyle(Fence* fence) {
+    JournalPayloadWriter payload;
+    payload.PutInt(GetFenceIndex(fence));
+    payload.PutUInt(fence->backgroundColor);
+    payload.PutUInt(fence->borderColor);
+    payload.PutUInt(fence->titleColor);
+    payload.PutInt(fence->alpha);
+    AppendJournal(JOURNAL_FENCE_STYLE, payload);
+}
 
-        bool isCollapsed = false;
-        bool isPinned = false;
-        int expandedHeight = height;
-        int iconSize = 64; // 預設值
-        int alpha = 230; // 預設透明度
-        COLORREF backgroundColor = RGB(240, 240, 240); // 預設背景色
-        COLORREF borderColor = RGB(100, 100, 100); // 預設邊框色
-        COLORREF titleColor = RGB(50, 50, 50); // 預設標題色
+void FencesWidget::JournalFenceIconSize(Fence* fence) {
+    JournalPayloadWriter payload;
+    payload.PutInt(GetFenceIndex(fence));
+    payload.PutInt(fence->iconSize);
+    AppendJournal(JOURNAL_FENCE_ICON_SIZE, payload);
+}
 
-        if (collapsedPos != std::wstring::npos) {
-            size_t valueStart = json.find(L':', collapsedPos) + 1;
-            std::wstring value = json.substr(valueStart, 10);
-            isCollapsed = (value.find(L"true") != std::wstring::npos);
+bool FencesWidget::LoadConfiguration(const std::wstring& filePath) {
+    // 映射快照檔案：二進位佈局就地讀取，JSON 則直接在映射內容上解析
+    MappedFile file;
+    FenceLayoutView view;
+    FenceLayout layout;
+    bool isBinary = false;
+    bool snapshotLoaded = false;
+
+    if (file.Open(filePath)) {
+        if (view.Attach(file.GetData(), file.GetSize())) {
+            isBinary = true;
+            snapshotLoaded = true;
+            layout.journalSequence = view.GetJournalSequence();
+        } else {
+            snapshotLoaded = FenceLayoutJson::Parse(file.GetData(), file.GetSize(), layout);
         }
+    }
 
-        if (pinnedPos != std::wstring::npos) {
-            size_t valueStart = json.find(L':', pinnedPos) + 1;
-            std::wstring value = json.substr(valueStart, 10);
-            isPinned = (value.find(L"true") != std::wstring::npos);
-        }
+    // 回放快照之後的變更紀錄，並保持日誌開啟以便追加
+    // 二進位佈局只有在確實有紀錄要回放時才轉為可修改的資料模型
+    bool converted = false;
+    journal_.Open(GetJournalFilePath(filePath), layout.journalSequence,
+        [&](const MutationJournal::Record& record) {
+            if (isBinary && !converted) {
+                view.ToLayout(layout);
+                converted = true;
+            }
+            ApplyJournalRecord(layout.fences, record);
+        });
+    lastSnapshotSequence_ = layout.journalSequence;
 
-        if (expandedHeightPos != std::wstring::npos) {
-            expandedHeight = std::stoi(json.substr(json.find(L':', expandedHeightPos) + 1, 10));
-        }
+    int fenceCount = 0;
 
-        if (iconSizePos != std::wstring::npos) {
-            iconSize = std::stoi(json.substr(json.find(L':', iconSizePos) + 1, 10));
-        }
+    if (isBinary && !converted) {
+        // 直接從映射內容建立柵欄，路徑只在建立圖示時解碼一次
+        FenceLayoutFence settings;
+        for (uint32_t i = 0; i < view.GetFenceCount(); ++i) {
+            FenceLayoutFenceRecord record = view.GetFence(i);
+            view.GetFenceSettings(i, settings);
 
-        if (alphaPos != std::wstring::npos) {
-            alpha = std::stoi(json.substr(json.find(L':', alphaPos) + 1, 10));
-        }
+            Fence* fence = RestoreFence(settings);
+            if (!fence) {
+                continue;
+            }
+
+            fence->icons.reserve(record.iconCount);
+            for (uint32_t j = 0; j < record.iconCount; ++j) {
+                const FenceLayoutIconRecord& icon = view.GetIcon(record.firstIcon + j);
+                AddLoadedIcon(fence, view.DecodeString(icon.pathOffset, icon.pathLength),
+                              icon.originalX, icon.originalY, icon.originalIndex);
+            }
 
-        if (bgColorPos != std::wstring::npos) {
-            backgroundColor = (COLORREF)std::stoul(json.substr(json.find(L':', bgColorPos) + 1, 15));
+            FinishLoadedFence(fence);
+            fenceCount++;
         }
+        return fenceCount > 0;
+    }
+
+    if (!snapshotLoaded && layout.fences.empty()) {
+        return false;
+    }
 
-        if (borderColorPos != std::wstring::npos) {
-            borderColor = (COLORREF)std::stoul(json.substr(json.find(L':', borderColorPos) + 1, 15));
+    for (auto& entry : layout.fences) {
+        Fence* fence = RestoreFence(entry);
+        if (!fence) {
+            continue;
         }
 
-        if (titleColorPos != std::wstring::npos) {
-            titleColor = (COLORREF)std::stoul(json.substr(json.find(L':', titleColorPos) + 1, 15));
+        fence->icons.reserve(entry.icons.size());
+        for (auto& icon : entry.icons) {
+            AddLoadedIcon(fence, std::move(icon.filePath),
+                          icon.originalX, icon.originalY, icon.originalIndex);
         }
 
-        // 創建柵欄
-        if (CreateFence(x, y, width, height, title)) {
-            Fence* fence = &fences_.back();
+        FinishLoadedFence(fence);
+        fenceCount++;
+    }
 
-            // 設定收合狀態、固定狀態、展開高度、圖示大小、透明度和顏色
-            fence->isCollapsed = isCollapsed;
-            fence->isPinned = isPinned;
-            fence->expandedHeight = expandedHeight;
-            fence->iconSize = iconSize;
-            fence->alpha = alpha;
-            fence->backgroundColor = backgroundColor;
-            fence->borderColor = borderColor;
-            fence->titleColor = titleColor;
+    return fenceCount > 0;
+}
 
-            // 更新窗口透明度
-            SetLayeredWindowAttributes(fence->hwnd, 0, (BYTE)fence->alpha, LWA_ALPHA);
+Fence* FencesWidget::RestoreFence(const FenceLayoutFence& settings) {
+    // 創建柵欄（已在快照或日誌內，不再記錄）
+    if (!CreateFenceWindow(settings.x, settings.y, settings.width, settings.height, settings.title)) {
+        return nullptr;
+    }
 
-            // 重繪以套用新顏色
-            InvalidateRect(fence->hwnd, nullptr, TRUE);
+    Fence* fence = &fences_.back();
 
-            // 解析圖示
-            size_t iconsStart = json.find(L"\"icons\":", hPos);
-            size_t iconsEnd = json.find(L"]", iconsStart);
-            size_t iconPos = iconsStart;
-
-            // 收集所有圖示路徑以便批次隱藏
-            std::vector<std::wstring> iconPathsToHide;
-
-            while ((iconPos = json.find(L"\"filePath\":", iconPos)) != std::wstring::npos && iconPos < iconsEnd) {
-                size_t pathStart = json.find(L'"', iconPos + 11) + 1;
-                size_t pathEnd = json.find(L'"', pathStart);
-                std::wstring iconPath = json.substr(pathStart, pathEnd - pathStart);
-
-                // 解析原始位置
-                size_t oxPos = json.find(L"\"originalX\":", pathEnd);
-                size_t oyPos = json.find(L"\"originalY\":", oxPos);
-                size_t oiPos = json.find(L"\"originalIndex\":", oyPos);
-
-                int origX = std::stoi(json.substr(json.find(L':', oxPos) + 1, 10));
-                int origY = std::stoi(json.substr(json.find(L':', oyPos) + 1, 10));
-                int origIndex = std::stoi(json.substr(json.find(L':', oiPos) + 1, 10));
-
-                // 添加圖示到柵欄（不會自動記錄位置，因為已有配置）
-                DesktopIcon newIcon;
-                newIcon.filePath = iconPath;
-
-                // 只載入當前需要的大小（延遲載入優化）
-                newIcon.hIcon32 = nullptr;
-                newIcon.hIcon48 = nullptr;
-                newIcon.hIcon64 = nullptr;
-                newIcon.hIcon = nullptr;
-                newIcon.cachedIconSize = 0;
-
-                // 立即載入當前柵欄使用的圖示大小
-                if (fence->iconSize == 32) {
-                    newIcon.hIcon32 = GetFileIcon(iconPath, 32);
-                } else if (fence->iconSize == 48) {
-                    newIcon.hIcon48 = GetFileIcon(iconPath, 48);
-                } else if (fence->iconSize == 64) {
-                    newIcon.hIcon64 = GetFileIcon(iconPath, 64);
-                }
+    // 設定收合狀態、固定狀態、展開高度、圖示大小、透明度、顏色、邊框與捲動位置
+    fence->isCollapsed = settings.isCollapsed;
+    fence->isPinned = settings.isPinned;
+    fence->expandedHeight = (settings.expandedHeight >= 0) ? settings.expandedHeight : settings.height;
+    fence->iconSize = settings.iconSize;
+    fence->alpha = settings.alpha;
+    fence->backgroundColor = settings.backgroundColor;
+    fence->borderColor = settings.borderColor;
+    fence->titleColor = settings.titleColor;
+    fence->borderWidth = settings.borderWidth;
+    fence->iconSpacing = settings.iconSpacing;
+    fence->scrollOffset = settings.scrollOffset;
 
-                newIcon.selected = false;
-                newIcon.position = { 0, 0 };
-                newIcon.originalDesktopPos = { origX, origY };
-                newIcon.originalDesktopIndex = origIndex;
+    // 更新窗口透明度
+    SetLayeredWindowAttributes(fence->hwnd, 0, (BYTE)fence->alpha, LWA_ALPHA);
 
-                // 提取顯示名稱
-                size_t lastSlash = iconPath.find_last_of(L"\\/");
-                if (lastSlash != std::wstring::npos) {
-                    newIcon.displayName = iconPath.substr(lastSlash + 1);
-                } else {
-                    newIcon.displayName = iconPath;
-                }
+    // 重繪以套用新顏色
+    InvalidateRect(fence->hwnd, nullptr, TRUE);
+    return fence;
+}
 
-                size_t lastDot = newIcon.displayName.find_last_of(L'.');
-                if (lastDot != std::wstring::npos && lastDot > 0) {
-                    newIcon.displayName = newIcon.displayName.substr(0, lastDot);
-                }
+void FencesWidget::AddLoadedIcon(Fence* fence, std::wstring filePath, int originalX, int originalY,
+                                 int originalIndex) {
+    // 添加圖示到柵欄（不會自動記錄位置，因為已有配置）
+    // 只保存路徑與桌面資料；顯示名稱與圖示在第一次繪製時才建立，
+    // 收合或捲出可視範圍的圖示在啟動時幾乎沒有成本
+    DesktopIcon newIcon;
+    newIcon.filePath = std::move(filePath);
+    newIcon.materialized = false;
+    newIcon.hIcon32 = nullptr;
+    newIcon.hIcon48 = nullptr;
+    newIcon.hIcon64 = nullptr;
+    newIcon.hIcon96 = nullptr;
+    newIcon.hIcon128 = nullptr;
+    newIcon.hIcon256 = nullptr;
+    newIcon.cachedIconSize = 0;
+    newIcon.originalDesktopPos = { originalX, originalY };
+    newIcon.originalDesktopIndex = originalIndex;
 
-                fence->icons.push_back(newIcon);
+    fence->icons.Add(std::move(newIcon));
+}
 
-                // 記錄需要隱藏的圖示路徑
-                iconPathsToHide.push_back(iconPath);
+void FencesWidget::MaterializeIcon(DesktopIcon& icon) {
+    // 提取顯示名稱（去掉目錄與副檔名）
+    const std::wstring& iconPath = icon.filePath;
+    size_t nameStart = iconPath.find_last_of(L"\\/");
+    nameStart = (nameStart != std::wstring::npos) ? nameStart + 1 : 0;
 
-                iconPos = pathEnd;
-            }
+    size_t nameEnd = iconPath.find_last_of(L'.');
+    if (nameEnd == std::wstring::npos || nameEnd <= nameStart) {
+        nameEnd = iconPath.size();
+    }
 
-            // 批次隱藏所有桌面圖示（一次性完成，避免多次重繪）
-            if (!iconPathsToHide.empty()) {
-                HideDesktopIconsBatch(iconPathsToHide);
-            }
+    icon.displayName.assign(iconPath, nameStart, nameEnd - nameStart);
+    icon.iconKey = IconCache::MakeKey(iconPath);
+    icon.materialized = true;
+}
 
-            // 排列圖示
-            ArrangeIcons(fence);
-            InvalidateRect(fence->hwnd, nullptr, TRUE);
-            fenceCount++;
+void FencesWidget::FinishLoadedFence(Fence* fence) {
+    // 批次隱藏所有桌面圖示（一次性完成，避免多次重繪）
+    if (!fence->icons.empty()) {
+        std::vector<std::wstring> iconPathsToHide;
+        iconPathsToHide.reserve(fence->icons.size());
+        for (const auto& icon : fence->icons) {
+            iconPathsToHide.push_back(icon.filePath);
         }
-
-        pos = titleEnd;
+        desktopIcons_.Hide(iconPathsToHide);
     }
 
-    return fenceCount > 0;
+    // 排列圖示
+    ArrangeIcons(fence);
+
+    // 保存的捲動位置可能超出目前內容（例如圖示已被移除）
+    RECT clientRect;
+    GetClientRect(fence->hwnd, &clientRect);
+    int maxScroll = (std::max)(0, fence->contentHeight - (int)(clientRect.bottom - TITLE_BAR_HEIGHT));
+    fence->scrollOffset = (std::max)(0, (std::min)(fence->scrollOffset, maxScroll));
+
+    InvalidateRect(fence->hwnd, nullptr, TRUE);
 }
 
 void FencesWidget::Shutdown() {
@@ -678,28 +892,21 @@ void FencesWidget::Shutdown() {
     }
     shutdownCalled_ = true;
 
-    // 保存配置（在清空之前）
-    wchar_t appData[MAX_PATH];
-    if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appData) == S_OK) {
-        std::wstring configPath = std::wstring(appData) + L"\\FencesWidget\\config.json";
-
-        // 創建目錄
-        std::wstring dirPath = std::wstring(appData) + L"\\FencesWidget";
-        CreateDirectoryW(dirPath.c_str(), nullptr);
-
-        SaveConfiguration(configPath);
-    }
+    // 保存快照（在清空之前）與新提取的圖示，並等待背景寫入完成
+    MarkConfigDirty();
+    SavePersistentIcons();
+    persistence_.Flush();
 
     // WidgetManager 已經調用過 Stop()，這裡不需要再調用
 
+    // 停止背景提取（之後不會再有完成通知）
+    iconPool_.Stop();
+
     // Clean up all fence windows and icons
     for (auto& fence : fences_) {
         // Clean up all icon handles
         for (auto& icon : fence.icons) {
-            if (icon.hIcon) {
-                DestroyIcon(icon.hIcon);
-                icon.hIcon = nullptr;
-            }
+            ReleaseIcons(icon);
         }
 
         if (fence.hwnd) {
@@ -709,6 +916,9 @@ void FencesWidget::Shutdown() {
     }
 
     fences_.clear();
+
+    // 視窗都已銷毀，沒有 DC 還選著快取的 GDI 物件
+    paintResources_.Clear();
     UnregisterWindowClass();
 }
 
@@ -729,6 +939,24 @@ std::wstring FencesWidget::GetWidgetVersion() const {
 }
 
 bool FencesWidget::CreateFence(int x, int y, int width, int height, const std::wstring& title) {
+    if (!CreateFenceWindow(x, y, width, height, title)) {
+        return false;
+    }
+
+    // 所有建立柵欄的途徑（選單、命令、自動分類、示範柵欄）都記錄，
+    // 之後這個柵欄的紀錄回放時才有對應的索引
+    const Fence& created = fences_.back();
+    JournalPayloadWriter payload;
+    payload.PutInt(created.rect.left);
+    payload.PutInt(created.rect.top);
+    payload.PutInt(created.rect.right - created.rect.left);
+    payload.PutInt(created.rect.bottom - created.rect.top);
+    payload.PutString(created.title);
+    AppendJournal(JOURNAL_FENCE_CREATED, payload);
+    return true;
+}
+
+bool FencesWidget::CreateFenceWindow(int x, int y, int width, int height, const std::wstring& title) {
     if (!classRegistered_) {
         return false;
     }
@@ -791,7 +1019,7 @@ bool FencesWidget::CreateFence(int x, int y, int width, int height, const std::w
     fence.scrollbarDragStartY = 0;
     fence.scrollOffsetAtDragStart = 0;
 
-    fences_.push_back(fence);
+    fences_.push_back(std::move(fence));
 
     ShowWindow(hwnd, SW_SHOW);
     UpdateWindow(hwnd);
@@ -805,30 +1033,19 @@ bool FencesWidget::RemoveFence(size_t index) {
     }
 
     // 收集此柵欄內所有需要恢復的圖示資料
-    std::vector<std::pair<std::wstring, POINT>> iconData;
+    std::vector<std::pair<std::wstring, DesktopIconPoint>> iconData;
     for (const auto& icon : fences_[index].icons) {
-        iconData.push_back({icon.filePath, icon.originalDesktopPos});
+        iconData.push_back({ icon.filePath, ToDesktopIconPoint(icon.originalDesktopPos) });
     }
 
     // 批次恢復所有圖示到桌面（一次性完成，避免多次重繪）
     if (!iconData.empty()) {
-        RestoreDesktopIconsBatch(iconData);
+        desktopIcons_.Restore(iconData);
     }
 
     // Clean up icon handles
     for (auto& icon : fences_[index].icons) {
-        if (icon.hIcon) {
-            DestroyIcon(icon.hIcon);
-        }
-        if (icon.hIcon32) {
-            DestroyIcon(icon.hIcon32);
-        }
-        if (icon.hIcon48) {
-            DestroyIcon(icon.hIcon48);
-        }
-        if (icon.hIcon64) {
-            DestroyIcon(icon.hIcon64);
-        }
+        ReleaseIcons(icon);
     }
 
     if (fences_[index].hwnd) {
@@ -837,12 +1054,10 @@ bool FencesWidget::RemoveFence(size_t index) {
 
     fences_.erase(fences_.begin() + index);
 
-    // 保存配置以確保刪除操作同步到 JSON 文件
-    wchar_t appData[MAX_PATH];
-    if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appData) == S_OK) {
-        std::wstring configPath = std::wstring(appData) + L"\\FencesWidget\\config.json";
-        SaveConfiguration(configPath);
-    }
+    // 記錄刪除操作
+    JournalPayloadWriter payload;
+    payload.PutInt((int)index);
+    AppendJournal(JOURNAL_FENCE_REMOVED, payload);
 
     return true;
 }
@@ -861,6 +1076,11 @@ bool FencesWidget::UpdateFenceTitle(size_t index, const std::wstring& newTitle)
         SetWindowTextW(fences_[index].hwnd, newTitle.c_str());
         InvalidateRect(fences_[index].hwnd, nullptr, TRUE);
     }
+
+    JournalPayloadWriter payload;
+    payload.PutInt((int)index);
+    payload.PutString(newTitle);
+    AppendJournal(JOURNAL_FENCE_TITLE, payload);
     return true;
 }
 
@@ -877,6 +1097,8 @@ bool FencesWidget::UpdateFenceStyle(size_t index, COLORREF bgColor, COLORREF bor
         SetLayeredWindowAttributes(fences_[index].hwnd, 0, static_cast<BYTE>(alpha), LWA_ALPHA);
         InvalidateRect(fences_[index].hwnd, nullptr, TRUE);
     }
+
+    JournalFenceStyle(&fences_[index]);
     return true;
 }
 
@@ -932,7 +1154,7 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
     case WM_PAINT: {
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
-        PaintFence(hwnd, hdc);
+        PaintFence(hwnd, hdc, ps.rcPaint);
         EndPaint(hwnd, &ps);
         return 0;
     }
@@ -1340,6 +1562,11 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                         fence->title = newTitle;
                         SetWindowTextW(hwnd, newTitle);
                         InvalidateRect(hwnd, nullptr, TRUE);
+
+                        JournalPayloadWriter payload;
+                        payload.PutInt(GetFenceIndex(fence));
+                        payload.PutString(fence->title);
+                        AppendJournal(JOURNAL_FENCE_TITLE, payload);
                     }
                 }
                 break;
@@ -1359,6 +1586,7 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                 if (ChooseColorW(&cc)) {
                     fence->backgroundColor = cc.rgbResult;
                     InvalidateRect(hwnd, nullptr, TRUE);
+                    JournalFenceStyle(fence);
                 }
                 break;
             }
@@ -1377,6 +1605,7 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                 if (ChooseColorW(&cc)) {
                     fence->titleColor = cc.rgbResult;
                     InvalidateRect(hwnd, nullptr, TRUE);
+                    JournalFenceStyle(fence);
                 }
                 break;
             }
@@ -1690,6 +1919,7 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                     if (dialogResult) {
                         fence->alpha = currentAlpha;
                         InvalidateRect(hwnd, nullptr, TRUE);
+                        JournalFenceStyle(fence);
                     }
                 }
                 break;
@@ -1700,9 +1930,9 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                 RECT rect;
                 GetWindowRect(hwnd, &rect);
                 CreateFence(rect.left + 50, rect.top + 50,
-                          rect.right - rect.left,
-                          rect.bottom - rect.top,
-                          L"新柵欄");
+                            rect.right - rect.left,
+                            rect.bottom - rect.top,
+                            L"新柵欄");
                 break;
             }
 
@@ -1725,18 +1955,42 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                 fence->iconSize = 32;
                 ArrangeIcons(fence);
                 InvalidateRect(hwnd, nullptr, TRUE);
+                JournalFenceIconSize(fence);
                 break;
 
             case IDM_ICON_SIZE_48:
                 fence->iconSize = 48;
                 ArrangeIcons(fence);
                 InvalidateRect(hwnd, nullptr, TRUE);
+                JournalFenceIconSize(fence);
                 break;
 
             case IDM_ICON_SIZE_64:
                 fence->iconSize = 64;
                 ArrangeIcons(fence);
                 InvalidateRect(hwnd, nullptr, TRUE);
+                JournalFenceIconSize(fence);
+                break;
+
+            case IDM_ICON_SIZE_96:
+                fence->iconSize = 96;
+                ArrangeIcons(fence);
+                InvalidateRect(hwnd, nullptr, TRUE);
+                JournalFenceIconSize(fence);
+                break;
+
+            case IDM_ICON_SIZE_128:
+                fence->iconSize = 128;
+                ArrangeIcons(fence);
+                InvalidateRect(hwnd, nullptr, TRUE);
+                JournalFenceIconSize(fence);
+                break;
+
+            case IDM_ICON_SIZE_256:
+                fence->iconSize = 256;
+                ArrangeIcons(fence);
+                InvalidateRect(hwnd, nullptr, TRUE);
+                JournalFenceIconSize(fence);
                 break;
 
             case IDM_REMOVE_ICON:
@@ -1763,6 +2017,7 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                 int scrollAmount = -delta / 3;  // Scroll speed adjustment
 
                 // Update scroll offset
+                int previousOffset = fence->scrollOffset;
                 fence->scrollOffset += scrollAmount;
 
                 // Clamp scroll offset
@@ -1774,21 +2029,33 @@ LRESULT FencesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM l
                     fence->scrollOffset = maxScroll;
                 }
 
-                // Redraw fence
-                InvalidateRect(hwnd, nullptr, TRUE);
+                // Redraw the area below the title bar (title bar does not change while scrolling)
+                if (fence->scrollOffset != previousOffset) {
+                    RECT contentRect = { 0, TITLE_BAR_HEIGHT, clientRect.right, clientRect.bottom };
+                    InvalidateRect(hwnd, &contentRect, FALSE);
+                }
             }
         }
         return 0;
     }
 
+    case WM_FENCE_ICONS_READY: {
+        std::vector<IconExtractionPool::Result> results;
+        iconPool_.TakeCompleted(hwnd, results);
+        ApplyExtractedIcons(results);
+        return 0;
+    }
+
     case WM_DESTROY:
+        // 捨棄送往此視窗的提取請求與結果
+        iconPool_.Cancel(hwnd);
         return 0;
     }
 
     return DefWindowProc(hwnd, msg, wParam, lParam);
 }
 
-void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
+void FencesWidget::PaintFence(HWND hwnd, HDC hdc, const RECT& dirtyRect) {
     Fence* fence = FindFence(hwnd);
     if (!fence) {
         return;
@@ -1797,36 +2064,48 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
     RECT clientRect;
     GetClientRect(hwnd, &clientRect);
 
-    // Create memory DC for double buffering
-    HDC memDC = CreateCompatibleDC(hdc);
-    HBITMAP memBitmap = CreateCompatibleBitmap(hdc,
-        clientRect.right - clientRect.left,
-        clientRect.bottom - clientRect.top);
-    HBITMAP oldBitmap = (HBITMAP)SelectObject(memDC, memBitmap);
+    // 只重繪無效區域（BeginPaint 的 rcPaint）；範圍外的畫面不會被更新，不必畫
+    RECT paintRect;
+    if (!IntersectRect(&paintRect, &clientRect, &dirtyRect)) {
+        return;
+    }
+
+    // Double buffering
+    // 背景緩衝區（由上而下的 32bpp DIB section）由柵欄保留，客戶區超出容量時才重新配置，
+    // 圖示直接從圖集合成到像素上
+    int bufferWidth = clientRect.right - clientRect.left;
+    int bufferHeight = clientRect.bottom - clientRect.top;
+    if (!fence->backBuffer.Prepare(hdc, bufferWidth, bufferHeight)) {
+        return;
+    }
+    HDC memDC = fence->backBuffer.GetMemoryDC();
+    uint32_t* bufferBits = fence->backBuffer.GetBits();
+    size_t bufferStride = fence->backBuffer.GetStride();
+
+    // 之後取得或繪製的圖示在這次繪製結束時不淘汰；用量已接近預算時不預取畫面外的圖示
+    uint64_t paintStart = iconCache_.GetClock();
+    bool prefetch = !iconBudget_.IsAboveLowWatermark(GetIconMemoryUsage());
+
+    // 緩衝區 DC 跨繪製保留，結束時還原裁切與文字設定
+    int savedBufferDC = SaveDC(memDC);
+    IntersectClipRect(memDC, paintRect.left, paintRect.top, paintRect.right, paintRect.bottom);
+
+    // 筆刷、畫筆與字型都來自 paintResources_（依樣式共用），穩定狀態下繪製不建立任何 GDI 物件
+    const FencePaintStyles styles = GetFencePaintStyles({ fence->backgroundColor, fence->borderColor,
+                                                          fence->borderWidth, fence->isPinned, fence->isCollapsed });
 
     // Fill background
-    HBRUSH bgBrush = CreateSolidBrush(fence->backgroundColor);
-    FillRect(memDC, &clientRect, bgBrush);
-    DeleteObject(bgBrush);
+    ScopedPaintResource bgBrush(paintResources_, styles.background);
+    FillRect(memDC, &clientRect, ToBrush(bgBrush.Get()));
 
     // Draw title bar with darker background
     if (!fence->title.empty()) {
         RECT titleBarRect = clientRect;
         titleBarRect.bottom = TITLE_BAR_HEIGHT;
 
-        // Darken the background color for title bar
-        int r = GetRValue(fence->backgroundColor);
-        int g = GetGValue(fence->backgroundColor);
-        int b = GetBValue(fence->backgroundColor);
-        COLORREF titleBarColor = RGB(
-            max(0, r - 20),
-            max(0, g - 20),
-            max(0, b - 20)
-        );
-
-        HBRUSH titleBrush = CreateSolidBrush(titleBarColor);
-        FillRect(memDC, &titleBarRect, titleBrush);
-        DeleteObject(titleBrush);
+        // Title bar uses a darker background (see GetFencePaintStyles)
+        ScopedPaintResource titleBrush(paintResources_, styles.titleBar);
+        FillRect(memDC, &titleBarRect, ToBrush(titleBrush.Get()));
 
         // Draw title text
         RECT titleTextRect = titleBarRect;
@@ -1836,16 +2115,11 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
         SetBkMode(memDC, TRANSPARENT);
         SetTextColor(memDC, fence->titleColor);
 
-        HFONT hFont = CreateFontW(
-            16, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE,
-            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-            CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-
-        HFONT oldFont = (HFONT)SelectObject(memDC, hFont);
+        ScopedPaintResource titleFont(paintResources_, styles.titleFont);
+        HFONT oldFont = (HFONT)SelectObject(memDC, ToFont(titleFont.Get()));
         DrawTextW(memDC, fence->title.c_str(), -1, &titleTextRect,
             DT_LEFT | DT_VCENTER | DT_SINGLELINE);
         SelectObject(memDC, oldFont);
-        DeleteObject(hFont);
 
         // 繪製右上角圖示：收合和釘住
         const int iconSize = 20;
@@ -1856,24 +2130,21 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
         RECT pinRect = { rightX - iconSize, (TITLE_BAR_HEIGHT - iconSize) / 2,
                          rightX, (TITLE_BAR_HEIGHT - iconSize) / 2 + iconSize };
 
-        // 繪製圓角矩形背景
-        HBRUSH pinBrush = CreateSolidBrush(fence->isPinned ? RGB(100, 150, 255) : RGB(180, 180, 180));
-        HPEN pinPen = CreatePen(PS_SOLID, 1, fence->isPinned ? RGB(70, 120, 200) : RGB(150, 150, 150));
-        SelectObject(memDC, pinBrush);
-        SelectObject(memDC, pinPen);
+        // 繪製圓角矩形背景（選入的物件在區塊結束前換回原本的，快取的資源才不會留在 DC 內）
+        ScopedPaintResource pinBrush(paintResources_, styles.pinButton);
+        ScopedPaintResource pinPen(paintResources_, styles.pinButtonBorder);
+        HBRUSH oldButtonBrush = (HBRUSH)SelectObject(memDC, ToBrush(pinBrush.Get()));
+        HPEN oldButtonPen = (HPEN)SelectObject(memDC, ToPen(pinPen.Get()));
         RoundRect(memDC, pinRect.left, pinRect.top, pinRect.right, pinRect.bottom, 4, 4);
-        DeleteObject(pinBrush);
-        DeleteObject(pinPen);
 
         // 繪製釘子圖示（簡化的圖釘）
-        HPEN iconPen = CreatePen(PS_SOLID, 2, RGB(255, 255, 255));
-        SelectObject(memDC, iconPen);
+        ScopedPaintResource glyphPen(paintResources_, styles.buttonGlyph);
+        SelectObject(memDC, ToPen(glyphPen.Get()));
         int pinCenterX = (pinRect.left + pinRect.right) / 2;
         int pinCenterY = (pinRect.top + pinRect.bottom) / 2;
         Ellipse(memDC, pinCenterX - 3, pinCenterY - 4, pinCenterX + 3, pinCenterY + 2);
         MoveToEx(memDC, pinCenterX, pinCenterY + 2, nullptr);
         LineTo(memDC, pinCenterX, pinCenterY + 7);
-        DeleteObject(iconPen);
 
         rightX -= (iconSize + iconMargin);
 
@@ -1881,17 +2152,14 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
         RECT collapseRect = { rightX - iconSize, (TITLE_BAR_HEIGHT - iconSize) / 2,
                               rightX, (TITLE_BAR_HEIGHT - iconSize) / 2 + iconSize };
 
-        HBRUSH collapseBrush = CreateSolidBrush(fence->isCollapsed ? RGB(255, 150, 100) : RGB(180, 180, 180));
-        HPEN collapsePen = CreatePen(PS_SOLID, 1, fence->isCollapsed ? RGB(200, 120, 70) : RGB(150, 150, 150));
-        SelectObject(memDC, collapseBrush);
-        SelectObject(memDC, collapsePen);
+        ScopedPaintResource collapseBrush(paintResources_, styles.collapseButton);
+        ScopedPaintResource collapsePen(paintResources_, styles.collapseButtonBorder);
+        SelectObject(memDC, ToBrush(collapseBrush.Get()));
+        SelectObject(memDC, ToPen(collapsePen.Get()));
         RoundRect(memDC, collapseRect.left, collapseRect.top, collapseRect.right, collapseRect.bottom, 4, 4);
-        DeleteObject(collapseBrush);
-        DeleteObject(collapsePen);
 
         // 繪製箭頭（向下=展開，向上=收合）
-        HPEN arrowPen = CreatePen(PS_SOLID, 2, RGB(255, 255, 255));
-        SelectObject(memDC, arrowPen);
+        SelectObject(memDC, ToPen(glyphPen.Get()));
         int arrowCenterX = (collapseRect.left + collapseRect.right) / 2;
         int arrowCenterY = (collapseRect.top + collapseRect.bottom) / 2;
         if (fence->isCollapsed) {
@@ -1905,12 +2173,13 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
             LineTo(memDC, arrowCenterX, arrowCenterY - 3);
             LineTo(memDC, arrowCenterX + 5, arrowCenterY + 2);
         }
-        DeleteObject(arrowPen);
+        SelectObject(memDC, oldButtonBrush);
+        SelectObject(memDC, oldButtonPen);
     }
 
     // Draw border
-    HPEN borderPen = CreatePen(PS_SOLID, fence->borderWidth, fence->borderColor);
-    HPEN oldPen = (HPEN)SelectObject(memDC, borderPen);
+    ScopedPaintResource borderPen(paintResources_, styles.border);
+    HPEN oldPen = (HPEN)SelectObject(memDC, ToPen(borderPen.Get()));
     HBRUSH oldBrush = (HBRUSH)SelectObject(memDC, GetStockObject(NULL_BRUSH));
 
     Rectangle(memDC,
@@ -1921,7 +2190,6 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
 
     SelectObject(memDC, oldBrush);
     SelectObject(memDC, oldPen);
-    DeleteObject(borderPen);
 
     // 繪製圖示或提示文字（僅在未收合時）
     if (!fence->isCollapsed) {
@@ -1933,37 +2201,91 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
             SetBkMode(memDC, TRANSPARENT);
             SetTextColor(memDC, RGB(150, 150, 150));
 
-            HFONT hFont = CreateFontW(
-                14, 0, 0, 0, FW_NORMAL, TRUE, FALSE, FALSE,
-                DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"微軟正黑體");
-
-            HFONT oldFont = (HFONT)SelectObject(memDC, hFont);
+            ScopedPaintResource hintFont(paintResources_, styles.hintFont);
+            HFONT oldFont = (HFONT)SelectObject(memDC, ToFont(hintFont.Get()));
             DrawTextW(memDC, L"拖曳檔案到這裡...", -1, &hintRect,
                 DT_CENTER | DT_TOP | DT_SINGLELINE);
             SelectObject(memDC, oldFont);
-            DeleteObject(hFont);
         } else {
-            // Set clipping region to icon area (below title bar)
-            RECT iconArea = clientRect;
-            iconArea.top = TITLE_BAR_HEIGHT;
-            HRGN hClipRgn = CreateRectRgnIndirect(&iconArea);
-            SelectClipRgn(memDC, hClipRgn);
+            // Set clipping to icon area (below title bar)（IntersectClipRect 不需建立區域物件）
+            int savedDC = SaveDC(memDC);
+            IntersectClipRect(memDC, clientRect.left, TITLE_BAR_HEIGHT, clientRect.right, clientRect.bottom);
+
+            // 圖集過多不再使用的格子（圖示已移除）時整個重建
+            if (fence->atlas.GetCellCount() > fence->icons.size() * 2 + 16) {
+                fence->atlas.Reset((uint32_t)fence->iconSize);
+            }
 
             // Draw all icons with scroll offset applied
-            for (auto& icon : fence->icons) {
-                int adjustedY = icon.position.y - fence->scrollOffset;
+            // 選取底色與名稱以 GDI 繪製，圖示記下圖集格子後在下方一次合成
+            struct AtlasPlacement {
+                int cell;
+                int x;
+                int y;
+            };
+            std::vector<AtlasPlacement> placements;
+
+            // 裁切只讀取緊密排列的位置陣列，範圍內的圖示才讀取路徑與控制代碼
+            // 名稱文字比 LABEL_HEIGHT 多 5px，選取底色往上多 2px（見 DrawIconLabel）
+            int visibleHeight = clientRect.bottom - TITLE_BAR_HEIGHT;
+            const int labelOverhangTop = 2;
+            const int labelOverhangBottom = 5;
+            const FenceIconPoint* positions = fence->icons.GetPositions();
+            for (size_t i = 0; i < fence->icons.size(); ++i) {
+                int iconX = positions[i].x;
+                int adjustedY = positions[i].y - fence->scrollOffset;
 
                 // Only draw icons within visible area (with some margin for partial visibility)
-                if (adjustedY + fence->iconSize + 35 >= TITLE_BAR_HEIGHT &&
+                if (adjustedY + fence->iconSize + FenceIconGrid::LABEL_HEIGHT >= TITLE_BAR_HEIGHT &&
                     adjustedY < clientRect.bottom) {
-                    DrawIcon(memDC, icon, icon.position.x, adjustedY, fence->iconSize);
+                    // 可見但不在無效區域內的圖示保留緩衝區上的內容
+                    if (adjustedY + fence->iconSize + FenceIconGrid::LABEL_HEIGHT + labelOverhangBottom <= paintRect.top ||
+                        adjustedY - labelOverhangTop >= paintRect.bottom) {
+                        continue;
+                    }
+
+                    DesktopIcon& icon = fence->icons[i];
+                    HICON hIcon = DrawIconLabel(memDC, hwnd, icon, iconX, adjustedY, fence->iconSize,
+                                                fence->icons.IsSelected(i), styles);
+                    int cell = GetAtlasCell(fence, icon, hIcon);
+                    if (cell >= 0) {
+                        placements.push_back({ cell, iconX, adjustedY });
+                    } else if (hIcon) {
+                        // 無法讀出點陣圖的圖示（例如單色圖示）
+                        DrawIconEx(memDC, iconX, adjustedY, hIcon, fence->iconSize, fence->iconSize,
+                                   0, nullptr, DI_NORMAL);
+                    }
+                } else if (prefetch &&
+                           adjustedY + fence->iconSize + FenceIconGrid::LABEL_HEIGHT >= TITLE_BAR_HEIGHT - visibleHeight &&
+                           adjustedY < clientRect.bottom + visibleHeight) {
+                    // 上下各一頁內的圖示先在背景提取，捲動時不必等待
+                    DesktopIcon& icon = fence->icons[i];
+                    HICON* slot = GetIconSlot(icon, fence->iconSize);
+                    if (slot && !*slot) {
+                        if (!icon.materialized) {
+                            MaterializeIcon(icon);
+                        }
+                        *slot = AcquireIcon(hwnd, icon, fence->iconSize, IconExtractionPool::PRIORITY_PREFETCH);
+                    }
+                }
+            }
+
+            // 先讓 GDI 完成排入的繪製，再直接寫入像素（裁切到圖示區域內的無效區域）
+            GdiFlush();
+            IconAtlasRect clip = {
+                (int32_t)paintRect.left,
+                (std::max)((int32_t)paintRect.top, (int32_t)TITLE_BAR_HEIGHT),
+                (int32_t)paintRect.right,
+                (int32_t)paintRect.bottom
+            };
+            if (clip.top < clip.bottom) {
+                for (const auto& placement : placements) {
+                    fence->atlas.Draw(placement.cell, bufferBits, bufferStride, clip, placement.x, placement.y);
                 }
             }
 
             // Remove clipping region
-            SelectClipRgn(memDC, nullptr);
-            DeleteObject(hClipRgn);
+            RestoreDC(memDC, savedDC);
         }
     }
 
@@ -1982,9 +2304,8 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
                 scrollbarX + scrollbarWidth,
                 clientRect.bottom - scrollbarMargin
             };
-            HBRUSH trackBrush = CreateSolidBrush(RGB(200, 200, 200));
-            FillRect(memDC, &trackRect, trackBrush);
-            DeleteObject(trackBrush);
+            ScopedPaintResource trackBrush(paintResources_, styles.scrollTrack);
+            FillRect(memDC, &trackRect, ToBrush(trackBrush.Get()));
 
             // Calculate scrollbar thumb size and position
             int trackHeight = trackRect.bottom - trackRect.top;
@@ -1999,15 +2320,14 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
                 scrollbarX + scrollbarWidth,
                 thumbY + thumbHeight
             };
-            HBRUSH thumbBrush = CreateSolidBrush(RGB(120, 120, 120));
-            FillRect(memDC, &thumbRect, thumbBrush);
-            DeleteObject(thumbBrush);
+            ScopedPaintResource thumbBrush(paintResources_, styles.scrollThumb);
+            FillRect(memDC, &thumbRect, ToBrush(thumbBrush.Get()));
         }
     }
 
     // Draw resize indicator (僅在未收合時)
     if (!fence->isCollapsed) {
-        HBRUSH resizeIndicatorBrush = CreateSolidBrush(RGB(120, 120, 120));
+        ScopedPaintResource resizeIndicatorBrush(paintResources_, styles.resizeIndicator);
         for (int i = 0; i < 3; ++i) {
             for (int j = 0; j < 3; ++j) {
                 if (i + j >= 2) {
@@ -2017,22 +2337,25 @@ void FencesWidget::PaintFence(HWND hwnd, HDC hdc) {
                         clientRect.right - 10 + (i * 4),
                         clientRect.bottom - 10 + (j * 4)
                     };
-                    FillRect(memDC, &dotRect, resizeIndicatorBrush);
+                    FillRect(memDC, &dotRect, ToBrush(resizeIndicatorBrush.Get()));
                 }
             }
         }
-        DeleteObject(resizeIndicatorBrush);
     }
 
-    // Copy to screen
-    BitBlt(hdc, 0, 0,
-        clientRect.right - clientRect.left,
-        clientRect.bottom - clientRect.top,
-        memDC, 0, 0, SRCCOPY);
+    // Copy the repainted area to screen
+    BitBlt(hdc, paintRect.left, paintRect.top,
+        paintRect.right - paintRect.left,
+        paintRect.bottom - paintRect.top,
+        memDC, paintRect.left, paintRect.top, SRCCOPY);
+
+    RestoreDC(memDC, savedBufferDC);
 
-    SelectObject(memDC, oldBitmap);
-    DeleteObject(memBitmap);
-    DeleteDC(memDC);
+    // 繪製時從持久快取建立的圖示可能讓用量超出預算（繪製完成後才淘汰，不影響這次合成）；
+    // 這次繪製用到的圖示不淘汰，否則下一次繪製又要重新建立
+    if (iconBudget_.IsOverBudget(GetIconMemoryUsage())) {
+        EnforceIconBudget(paintStart);
+    }
 }
 
 Fence* FencesWidget::FindFence(HWND hwnd) {
@@ -2060,6 +2383,11 @@ void FencesWidget::OnLButtonDown(Fence* fence, int x, int y) {
         if (x >= pinRect.left && x <= pinRect.right && y >= pinRect.top && y <= pinRect.bottom) {
             fence->isPinned = !fence->isPinned;
             InvalidateRect(fence->hwnd, nullptr, FALSE);
+
+            JournalPayloadWriter payload;
+            payload.PutInt(GetFenceIndex(fence));
+            payload.PutBool(fence->isPinned);
+            AppendJournal(JOURNAL_FENCE_PINNED, payload);
             return;
         }
 
@@ -2089,6 +2417,12 @@ void FencesWidget::OnLButtonDown(Fence* fence, int x, int y) {
             }
 
             InvalidateRect(fence->hwnd, nullptr, FALSE);
+
+            JournalPayloadWriter payload;
+            payload.PutInt(GetFenceIndex(fence));
+            payload.PutBool(fence->isCollapsed);
+            payload.PutInt(fence->expandedHeight);
+            AppendJournal(JOURNAL_FENCE_COLLAPSED, payload);
             return;
         }
     }
@@ -2113,17 +2447,9 @@ void FencesWidget::OnLButtonDown(Fence* fence, int x, int y) {
         fence->iconDragStart.y = y;
         SetCapture(fence->hwnd);
 
-        // 創建拖拉圖示的影像列表（使用快取的圖示）
-        HICON hIcon = nullptr;
-        if (fence->iconSize == 32 && fence->icons[iconIndex].hIcon32) {
-            hIcon = fence->icons[iconIndex].hIcon32;
-        } else if (fence->iconSize == 48 && fence->icons[iconIndex].hIcon48) {
-            hIcon = fence->icons[iconIndex].hIcon48;
-        } else if (fence->iconSize == 64 && fence->icons[iconIndex].hIcon64) {
-            hIcon = fence->icons[iconIndex].hIcon64;
-        } else if (fence->icons[iconIndex].hIcon) {
-            hIcon = fence->icons[iconIndex].hIcon;
-        }
+        // 創建拖拉圖示的影像列表（使用快取的圖示，尚未提取時用預設圖示）
+        HICON* slot = GetIconSlot(fence->icons[iconIndex], fence->iconSize);
+        HICON hIcon = (slot && *slot) ? *slot : GetPlaceholderIcon(fence->iconSize);
 
         if (hIcon) {
             // 創建 ImageList
@@ -2180,8 +2506,11 @@ void FencesWidget::OnMouseMove(Fence* fence, int x, int y) {
             newScrollOffset = maxScroll;
         }
 
-        fence->scrollOffset = newScrollOffset;
-        InvalidateRect(fence->hwnd, nullptr, TRUE);
+        if (newScrollOffset != fence->scrollOffset) {
+            fence->scrollOffset = newScrollOffset;
+            RECT contentRect = { 0, TITLE_BAR_HEIGHT, clientRect.right, clientRect.bottom };
+            InvalidateRect(fence->hwnd, &contentRect, FALSE);
+        }
     } else if (fence->isDraggingIcon) {
         // 更新拖拉圖示位置
         POINT ptCursor;
@@ -2242,6 +2571,9 @@ void FencesWidget::OnMouseMove(Fence* fence, int x, int y) {
 }
 
 void FencesWidget::OnLButtonUp(Fence* fence) {
+    // 移動或調整大小結束時才記錄
+    bool boundsChanged = fence->isDragging || fence->isResizing;
+
     if (fence->isDraggingScrollbar) {
         fence->isDraggingScrollbar = false;
         ReleaseCapture();
@@ -2270,14 +2602,17 @@ void FencesWidget::OnLButtonUp(Fence* fence) {
             POINT ptScreen;
             GetCursorPos(&ptScreen);
 
-            // 先從柵欄移除（這會呼叫ShowDesktopIcon）
-            if (fence->icons[fence->draggingIconIndex].hIcon) {
-                DestroyIcon(fence->icons[fence->draggingIconIndex].hIcon);
-            }
-            fence->icons.erase(fence->icons.begin() + fence->draggingIconIndex);
+            // 先從柵欄移除
+            ReleaseIcons(fence->icons[fence->draggingIconIndex]);
+            fence->icons.Erase(fence->draggingIconIndex);
+
+            JournalPayloadWriter payload;
+            payload.PutInt(GetFenceIndex(fence));
+            payload.PutInt(fence->draggingIconIndex);
+            AppendJournal(JOURNAL_ICON_REMOVED, payload);
 
             // 在指定位置顯示桌面圖示
-            ShowDesktopIconAtPosition(filePath, ptScreen.x, ptScreen.y);
+            desktopIcons_.ShowAt(filePath, ToDesktopIconPoint(ptScreen));
 
             // 重新排列柵欄內的圖示
             ArrangeIcons(fence);
@@ -2291,6 +2626,16 @@ void FencesWidget::OnLButtonUp(Fence* fence) {
     fence->isResizing = false;
     fence->isDragging = false;
     ReleaseCapture();
+
+    if (boundsChanged) {
+        JournalPayloadWriter payload;
+        payload.PutInt(GetFenceIndex(fence));
+        payload.PutInt(fence->rect.left);
+        payload.PutInt(fence->rect.top);
+        payload.PutInt(fence->rect.right - fence->rect.left);
+        payload.PutInt(fence->rect.bottom - fence->rect.top);
+        AppendJournal(JOURNAL_FENCE_BOUNDS, payload);
+    }
 }
 
 void FencesWidget::OnRButtonDown(Fence* fence, int x, int y) {
@@ -2313,17 +2658,39 @@ void FencesWidget::OnRButtonDown(Fence* fence, int x, int y) {
 void FencesWidget::OnDropFiles(Fence* fence, HDROP hDrop) {
     UINT fileCount = DragQueryFileW(hDrop, 0xFFFFFFFF, nullptr, 0);
 
+    std::vector<std::wstring> filePaths;
+    filePaths.reserve(fileCount);
     for (UINT i = 0; i < fileCount; ++i) {
         wchar_t filePath[MAX_PATH];
         if (DragQueryFileW(hDrop, i, filePath, MAX_PATH)) {
-            // Add icon to fence
-            if (AddIconToFence(fence, filePath)) {
-                // Hide the desktop icon in real-time
-                HideDesktopIcon(filePath);
-            }
+            filePaths.push_back(filePath);
         }
     }
 
+    // Add icons to fence (original desktop positions are read in one batch)
+    size_t firstAdded = fence->icons.size();
+    AddIconsToFence(fence, filePaths);
+
+    std::vector<std::wstring> filesToHide;
+    for (size_t i = firstAdded; i < fence->icons.size(); ++i) {
+        const DesktopIcon& added = fence->icons[i];
+        filesToHide.push_back(added.filePath);
+
+        FenceLayoutIcon entry;
+        entry.filePath = added.filePath;
+        entry.originalX = added.originalDesktopPos.x;
+        entry.originalY = added.originalDesktopPos.y;
+        entry.originalIndex = added.originalDesktopIndex;
+
+        JournalPayloadWriter payload;
+        payload.PutInt(GetFenceIndex(fence));
+        FENCE_LAYOUT_ICON_FIELDS.WritePayload(payload, entry);
+        AppendJournal(JOURNAL_ICON_ADDED, payload);
+    }
+
+    // Hide the desktop icons in one redraw
+    desktopIcons_.Hide(filesToHide);
+
     ArrangeIcons(fence);
     InvalidateRect(fence->hwnd, nullptr, TRUE);
 }
@@ -2384,65 +2751,64 @@ bool FencesWidget::IsInScrollbarArea(Fence* fence, int x, int y, RECT* outThumbR
             y >= thumbRect.top && y <= thumbRect.bottom);
 }
 
-bool FencesWidget::AddIconToFence(Fence* fence, const std::wstring& filePath) {
+size_t FencesWidget::AddIconsToFence(Fence* fence, const std::vector<std::wstring>& filePaths,
+                                     const std::vector<DesktopIconPoint>* desktopPositions) {
     if (!fence) {
-        return false;
+        return 0;
     }
 
-    // Check if icon already exists
-    for (const auto& icon : fence->icons) {
-        if (icon.filePath == filePath) {
-            return false; // Already exists
-        }
-    }
+    size_t firstAdded = fence->icons.size();
+    std::vector<int> desktopIndices;
 
-    DesktopIcon newIcon;
-    newIcon.filePath = filePath;
+    for (const auto& filePath : filePaths) {
+        // Check if icon already exists
+        bool exists = false;
+        for (const auto& icon : fence->icons) {
+            if (icon.filePath == filePath) {
+                exists = true;
+                break;
+            }
+        }
+        if (exists) {
+            continue;
+        }
 
-    // 只載入當前需要的大小（延遲載入優化）
-    newIcon.hIcon32 = nullptr;
-    newIcon.hIcon48 = nullptr;
-    newIcon.hIcon64 = nullptr;
-    newIcon.hIcon = nullptr;
-    newIcon.cachedIconSize = 0;
+        DesktopIcon newIcon;
+        newIcon.filePath = filePath;
+        newIcon.materialized = false;  // 顯示名稱與圖示在繪製時建立
 
-    // 立即載入當前柵欄使用的圖示大小
-    if (fence->iconSize == 32) {
-        newIcon.hIcon32 = GetFileIcon(filePath, 32);
-    } else if (fence->iconSize == 48) {
-        newIcon.hIcon48 = GetFileIcon(filePath, 48);
-    } else if (fence->iconSize == 64) {
-        newIcon.hIcon64 = GetFileIcon(filePath, 64);
-    }
+        newIcon.hIcon32 = nullptr;
+        newIcon.hIcon48 = nullptr;
+        newIcon.hIcon64 = nullptr;
+        newIcon.hIcon96 = nullptr;
+        newIcon.hIcon128 = nullptr;
+        newIcon.hIcon256 = nullptr;
+        newIcon.cachedIconSize = 0;
 
-    newIcon.selected = false;
-    newIcon.position = { 0, 0 }; // Will be set by ArrangeIcons
+        // 記錄原始桌面索引（名稱快照查詢，不需跨程序呼叫）
+        newIcon.originalDesktopIndex = desktopIcons_.FindIndex(filePath);
+        newIcon.originalDesktopPos = { -1, -1 };  // 無效位置，稍後批次填入
+        desktopIndices.push_back(newIcon.originalDesktopIndex);
 
-    // 記錄原始桌面位置和索引
-    int desktopIndex = FindDesktopIconIndex(filePath);
-    newIcon.originalDesktopIndex = desktopIndex;
-    if (desktopIndex >= 0) {
-        newIcon.originalDesktopPos = GetDesktopIconPosition(desktopIndex);
-    } else {
-        newIcon.originalDesktopPos = { -1, -1 };  // 無效位置
+        fence->icons.Add(std::move(newIcon));  // 位置由 ArrangeIcons 設定
     }
 
-    // Extract display name
-    size_t lastSlash = filePath.find_last_of(L"\\/");
-    if (lastSlash != std::wstring::npos) {
-        newIcon.displayName = filePath.substr(lastSlash + 1);
+    // 所有新圖示的原始桌面位置一次讀回（已有全部位置時直接取用）
+    if (desktopPositions) {
+        for (size_t i = 0; i < desktopIndices.size(); ++i) {
+            int index = desktopIndices[i];
+            if (index >= 0 && index < (int)desktopPositions->size()) {
+                fence->icons[firstAdded + i].originalDesktopPos = ToPoint((*desktopPositions)[index]);
+            }
+        }
     } else {
-        newIcon.displayName = filePath;
-    }
-
-    // Remove file extension for display
-    size_t lastDot = newIcon.displayName.find_last_of(L'.');
-    if (lastDot != std::wstring::npos && lastDot > 0) {
-        newIcon.displayName = newIcon.displayName.substr(0, lastDot);
+        std::vector<DesktopIconPoint> positions = desktopIcons_.GetPositions(desktopIndices);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            fence->icons[firstAdded + i].originalDesktopPos = ToPoint(positions[i]);
+        }
     }
 
-    fence->icons.push_back(newIcon);
-    return true;
+    return fence->icons.size() - firstAdded;
 }
 
 bool FencesWidget::RemoveIconFromFence(Fence* fence, size_t iconIndex) {
@@ -2452,27 +2818,21 @@ bool FencesWidget::RemoveIconFromFence(Fence* fence, size_t iconIndex) {
 
     // 恢復圖示到原始桌面位置（使用批次函數以避免重繪問題）
     const auto& icon = fence->icons[iconIndex];
-    std::vector<std::pair<std::wstring, POINT>> iconData;
-    iconData.push_back({icon.filePath, icon.originalDesktopPos});
-    RestoreDesktopIconsBatch(iconData);
+    std::vector<std::pair<std::wstring, DesktopIconPoint>> iconData;
+    iconData.push_back({ icon.filePath, ToDesktopIconPoint(icon.originalDesktopPos) });
+    desktopIcons_.Restore(iconData);
 
-    // 清理所有快取的圖示
-    if (fence->icons[iconIndex].hIcon) {
-        DestroyIcon(fence->icons[iconIndex].hIcon);
-    }
-    if (fence->icons[iconIndex].hIcon32) {
-        DestroyIcon(fence->icons[iconIndex].hIcon32);
-    }
-    if (fence->icons[iconIndex].hIcon48) {
-        DestroyIcon(fence->icons[iconIndex].hIcon48);
-    }
-    if (fence->icons[iconIndex].hIcon64) {
-        DestroyIcon(fence->icons[iconIndex].hIcon64);
-    }
+    // 釋放圖示的快取引用
+    ReleaseIcons(fence->icons[iconIndex]);
 
-    fence->icons.erase(fence->icons.begin() + iconIndex);
+    fence->icons.Erase(iconIndex);
     ArrangeIcons(fence);
     InvalidateRect(fence->hwnd, nullptr, TRUE);
+
+    JournalPayloadWriter payload;
+    payload.PutInt(GetFenceIndex(fence));
+    payload.PutInt((int)iconIndex);
+    AppendJournal(JOURNAL_ICON_REMOVED, payload);
     return true;
 }
 
@@ -2485,35 +2845,13 @@ void FencesWidget::ArrangeIcons(Fence* fence) {
     RECT clientRect;
     GetClientRect(fence->hwnd, &clientRect);
 
-    // Calculate icon cell size (icon + text area + spacing)
-    // Text needs at least 70px width for typical filenames
-    const int textWidth = max(70, fence->iconSize + 20);
-    const int iconCellWidth = max(fence->iconSize, textWidth) + fence->iconSpacing;
-    const int iconCellHeight = fence->iconSize + 35 + fence->iconSpacing; // Icon + text + spacing
-
-    const int startX = ICON_PADDING_LEFT;
     const int startY = TITLE_BAR_HEIGHT + ICON_PADDING_TOP;
     const int availableWidth = clientRect.right - ICON_PADDING_LEFT - ICON_PADDING_RIGHT;
+    const int iconCellHeight = FenceIconGrid::GetCellHeight(fence->iconSize, fence->iconSpacing);
 
-    int iconsPerRow = max(1, availableWidth / iconCellWidth);
-    int currentX = startX;
-    int currentY = startY;
-    int currentCol = 0;
-
-    for (auto& icon : fence->icons) {
-        // Center icon horizontally in its cell
-        icon.position.x = currentX + (iconCellWidth - fence->iconSize) / 2;
-        icon.position.y = currentY;
-
-        currentCol++;
-        if (currentCol >= iconsPerRow) {
-            currentCol = 0;
-            currentX = startX;
-            currentY += iconCellHeight;
-        } else {
-            currentX += iconCellWidth;
-        }
-    }
+    // 只寫入位置陣列
+    int iconsPerRow = FenceIconGrid::Arrange(fence->icons.GetPositions(), fence->icons.size(), fence->iconSize,
+                                             fence->iconSpacing, ICON_PADDING_LEFT, startY, availableWidth);
 
     // Calculate total content height
     int rows = (int)fence->icons.size() / iconsPerRow;
@@ -2553,58 +2891,21 @@ HICON FencesWidget::GetFileIcon(const std::wstring& filePath, int size) {
     } else if (size <= 32) {
         flags |= SHGFI_LARGEICON;
     } else {
-        // 對於 64px，使用 SHIL_EXTRALARGE (48px) 並放大
+        // 大於 48px 時使用 SHIL_JUMBO (256px)，否則使用 SHIL_EXTRALARGE (48px)，再以 IconScaler 縮放到精確尺寸
         flags = SHGFI_SYSICONINDEX;
         result = SHGetFileInfoW(filePath.c_str(), 0, &sfi, sizeof(sfi), flags);
 
         if (result) {
             IImageList* imageList = nullptr;
-            // 使用 EXTRALARGE 獲得較好的 48px 圖示
-            HRESULT hr = SHGetImageList(SHIL_EXTRALARGE, IID_PPV_ARGS(&imageList));
+            HRESULT hr = SHGetImageList(size > 48 ? SHIL_JUMBO : SHIL_EXTRALARGE, IID_PPV_ARGS(&imageList));
 
             if (SUCCEEDED(hr) && imageList) {
-                HICON hIcon48 = nullptr;
-                hr = imageList->GetIcon(sfi.iIcon, ILD_TRANSPARENT, &hIcon48);
+                HICON hSourceIcon = nullptr;
+                hr = imageList->GetIcon(sfi.iIcon, ILD_TRANSPARENT, &hSourceIcon);
                 imageList->Release();
 
-                if (SUCCEEDED(hr) && hIcon48) {
-                    // 使用高品質方式將 48px 放大到 64px
-                    HDC hdcScreen = GetDC(nullptr);
-                    HDC hdcSrc = CreateCompatibleDC(hdcScreen);
-                    HDC hdcDst = CreateCompatibleDC(hdcScreen);
-
-                    HBITMAP hbmDst = CreateCompatibleBitmap(hdcScreen, size, size);
-                    HBITMAP hbmOldDst = (HBITMAP)SelectObject(hdcDst, hbmDst);
-
-                    // 設置高品質縮放模式
-                    SetStretchBltMode(hdcDst, HALFTONE);
-                    SetBrushOrgEx(hdcDst, 0, 0, nullptr);
-
-                    // 繪製透明背景
-                    BLENDFUNCTION blend = { 0 };
-                    blend.BlendOp = AC_SRC_OVER;
-                    blend.SourceConstantAlpha = 255;
-                    blend.AlphaFormat = AC_SRC_ALPHA;
-
-                    // 直接用 DrawIconEx 高品質繪製
-                    DrawIconEx(hdcDst, 0, 0, hIcon48, size, size, 0, nullptr, DI_NORMAL);
-
-                    // 創建新圖示
-                    ICONINFO iconInfo = {0};
-                    iconInfo.fIcon = TRUE;
-                    iconInfo.hbmColor = hbmDst;
-                    iconInfo.hbmMask = CreateBitmap(size, size, 1, 1, nullptr);
-
-                    HICON hResizedIcon = CreateIconIndirect(&iconInfo);
-
-                    DeleteObject(iconInfo.hbmMask);
-                    SelectObject(hdcDst, hbmOldDst);
-                    DeleteObject(hbmDst);
-                    DeleteDC(hdcDst);
-                    DeleteDC(hdcSrc);
-                    ReleaseDC(nullptr, hdcScreen);
-                    DestroyIcon(hIcon48);
-
+                if (SUCCEEDED(hr) && hSourceIcon) {
+                    HICON hResizedIcon = ScaleIcon(hSourceIcon, size);
                     if (hResizedIcon) {
                         return hResizedIcon;
                     }
@@ -2628,423 +2929,535 @@ HICON FencesWidget::GetFileIcon(const std::wstring& filePath, int size) {
         return sfi.hIcon;
     }
 
-    return LoadIcon(nullptr, IDI_APPLICATION);
+    // 複製共用的系統圖示，讓每個結果都有自己的控制代碼（快取以控制代碼計算引用）
+    return CopyIcon(LoadIcon(nullptr, IDI_APPLICATION));
 }
 
-void FencesWidget::DrawIcon(HDC hdc, DesktopIcon& icon, int x, int y, int iconSize) {
-    // Calculate text area width - ensure enough space to avoid overlap
-    const int textWidth = max(70, iconSize + 20);
-    const int textLeft = x - (textWidth - iconSize) / 2;
-    const int textRight = textLeft + textWidth;
-
-    // Draw selection background if selected
-    if (icon.selected) {
-        RECT selRect = { textLeft - 2, y - 2, textRight + 2, y + iconSize + 35 };
-        HBRUSH selBrush = CreateSolidBrush(RGB(173, 216, 230));
-        FillRect(hdc, &selRect, selBrush);
-        DeleteObject(selBrush);
+HICON FencesWidget::ScaleIcon(HICON hSourceIcon, int size) {
+    std::vector<uint32_t> pixels;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (!CaptureIconPixels(hSourceIcon, pixels, width, height)) {
+        DestroyIcon(hSourceIcon);
+        return nullptr;
     }
-
-    // 延遲載入：如果需要的大小尚未載入，則現在載入
-    HICON* hIconCache = nullptr;
-    if (iconSize == 32) {
-        hIconCache = &icon.hIcon32;
-    } else if (iconSize == 48) {
-        hIconCache = &icon.hIcon48;
-    } else if (iconSize == 64) {
-        hIconCache = &icon.hIcon64;
+    if (width == (uint32_t)size && height == (uint32_t)size) {
+        return hSourceIcon;
     }
+    DestroyIcon(hSourceIcon);
 
-    if (hIconCache && !*hIconCache) {
-        *hIconCache = GetFileIcon(icon.filePath, iconSize);
+    // 沒有大圖示的檔案在 SHIL_JUMBO 中只佔左上角 48×48，裁切後再縮放，避免圖示縮成一角
+    const uint32_t extraLarge = 48;
+    if (width > extraLarge && height > extraLarge) {
+        bool onlyTopLeft = true;
+        for (uint32_t y = 0; y < height && onlyTopLeft; ++y) {
+            const uint32_t* row = pixels.data() + size_t(y) * width;
+            for (uint32_t x = (y < extraLarge) ? extraLarge : 0; x < width; ++x) {
+                if (row[x] != 0) {
+                    onlyTopLeft = false;
+                    break;
+                }
+            }
+        }
+        if (onlyTopLeft) {
+            for (uint32_t y = 1; y < extraLarge; ++y) {
+                std::memmove(pixels.data() + size_t(y) * extraLarge, pixels.data() + size_t(y) * width,
+                             extraLarge * sizeof(uint32_t));
+            }
+            width = extraLarge;
+            height = extraLarge;
+        }
     }
 
-    // 使用快取的圖示
-    HICON hIconToUse = nullptr;
-    if (iconSize == 32 && icon.hIcon32) {
-        hIconToUse = icon.hIcon32;
-    } else if (iconSize == 48 && icon.hIcon48) {
-        hIconToUse = icon.hIcon48;
-    } else if (iconSize == 64 && icon.hIcon64) {
-        hIconToUse = icon.hIcon64;
-    } else if (icon.hIcon) {
-        hIconToUse = icon.hIcon;
-    }
+    std::vector<uint32_t> scaled(size_t(size) * size);
+    IconScaler::Scale(pixels.data(), width, height, scaled.data(), (uint32_t)size, (uint32_t)size);
+    return CreateIconFromPixels(scaled.data(), (uint32_t)size, (uint32_t)size);
+}
 
-    // Draw icon (centered)
-    if (hIconToUse) {
-        DrawIconEx(hdc, x, y, hIconToUse, iconSize, iconSize, 0, nullptr, DI_NORMAL);
+bool FencesWidget::ExtractFileIcon(const std::wstring& filePath, int size, const IconCacheStamp* unchanged,
+                                   IconExtractionPool::Result& result) {
+    // 來源檔案的戳記（修改時間與大小）；讀不到時為 0，下次啟動仍會重新檢查
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (GetFileAttributesExW(filePath.c_str(), GetFileExInfoStandard, &attributes)) {
+        result.stamp.lastWriteTime = (uint64_t(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                                     attributes.ftLastWriteTime.dwLowDateTime;
+        result.stamp.fileSize = (uint64_t(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    }
+    if (unchanged && result.stamp == *unchanged && result.stamp.lastWriteTime != 0) {
+        return false;
     }
 
-    // Draw display name with proper width
-    RECT textRect = { textLeft, y + iconSize + 2, textRight, y + iconSize + 40 };
-    SetBkMode(hdc, TRANSPARENT);
-
-    HFONT hFont = CreateFontW(
-        16, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-        DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-        CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"微軟正黑體");
-
-    HFONT oldFont = (HFONT)SelectObject(hdc, hFont);
-
-    // Draw text with shadow for better visibility
-    SetTextColor(hdc, RGB(255, 255, 255));
-    RECT shadowRect = textRect;
-    OffsetRect(&shadowRect, 1, 1);
-    DrawTextW(hdc, icon.displayName.c_str(), -1, &shadowRect,
-        DT_CENTER | DT_TOP | DT_WORDBREAK | DT_END_ELLIPSIS);
-
-    SetTextColor(hdc, RGB(0, 0, 0));
-    DrawTextW(hdc, icon.displayName.c_str(), -1, &textRect,
-        DT_CENTER | DT_TOP | DT_WORDBREAK | DT_END_ELLIPSIS);
-
-    SelectObject(hdc, oldFont);
-    DeleteObject(hFont);
+    result.icon = GetFileIcon(filePath, size);
+    if (!result.icon) {
+        return false;
+    }
+    if (!CaptureIconPixels(result.icon, result.pixels, result.width, result.height)) {
+        result.width = 0;
+        result.height = 0;
+    }
+    return true;
 }
 
-void FencesWidget::ShowFenceContextMenu(Fence* fence, int x, int y) {
-    // 設定滑鼠游標為箭頭
-    SetCursor(LoadCursor(nullptr, IDC_ARROW));
-
-    HMENU hMenu = CreatePopupMenu();
-    if (!hMenu) {
-        return;
+HICON* FencesWidget::GetIconSlot(DesktopIcon& icon, int size) {
+    if (size == 32) {
+        return &icon.hIcon32;
+    } else if (size == 48) {
+        return &icon.hIcon48;
+    } else if (size == 64) {
+        return &icon.hIcon64;
+    } else if (size == 96) {
+        return &icon.hIcon96;
+    } else if (size == 128) {
+        return &icon.hIcon128;
+    } else if (size == 256) {
+        return &icon.hIcon256;
     }
-
-    AppendMenuW(hMenu, MF_STRING, IDM_RENAME_FENCE, L"重新命名柵欄");
-    AppendMenuW(hMenu, MF_STRING, IDM_CHANGE_COLOR, L"變更背景顏色...");
-    AppendMenuW(hMenu, MF_STRING, IDM_CHANGE_TITLE_COLOR, L"變更標題顏色...");
-    AppendMenuW(hMenu, MF_STRING, IDM_CHANGE_TRANSPARENCY, L"調整透明度");
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, nullptr);
-
-    // 圖示大小子選單
-    HMENU hSizeMenu = CreatePopupMenu();
-    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 32 ? MF_CHECKED : 0), IDM_ICON_SIZE_32, L"小 (32px)");
-    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 48 ? MF_CHECKED : 0), IDM_ICON_SIZE_48, L"中 (48px)");
-    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 64 ? MF_CHECKED : 0), IDM_ICON_SIZE_64, L"大 (64px)");
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hSizeMenu, L"圖示大小");
-
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, nullptr);
-    AppendMenuW(hMenu, MF_STRING, IDM_AUTO_CATEGORIZE, L"自動分類桌面圖示");
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, nullptr);
-    AppendMenuW(hMenu, MF_STRING, IDM_CREATE_FENCE, L"建立新柵欄");
-    AppendMenuW(hMenu, MF_STRING, IDM_DELETE_FENCE, L"刪除柵欄");
-
-    TrackPopupMenu(hMenu, TPM_RIGHTBUTTON, x, y, 0, fence->hwnd, nullptr);
-    DestroyMenu(hMenu);
+    return nullptr;
 }
 
-HWND FencesWidget::GetDesktopListView() {
-    if (desktopListView_) {
-        return desktopListView_;
+HICON FencesWidget::GetPlaceholderIcon(int size) {
+    HICON& placeholder = placeholderIcons_[size];
+    if (!placeholder) {
+        // 系統共用圖示，不涉及殼層也不需要釋放
+        placeholder = (HICON)LoadImageW(nullptr, IDI_APPLICATION, IMAGE_ICON, size, size, LR_SHARED);
     }
+    return placeholder;
+}
 
-    // Find the desktop window
-    HWND hProgman = FindWindowW(L"Progman", nullptr);
-    if (!hProgman) {
-        return nullptr;
+HICON FencesWidget::AcquireIcon(HWND hwnd, DesktopIcon& icon, int size, IconExtractionPool::Priority priority) {
+    HICON hIcon = iconCache_.Acquire(icon.iconKey, size);
+    if (hIcon) {
+        return hIcon;
     }
 
-    // Find the SHELLDLL_DefView window
-    HWND hShellViewWin = FindWindowExW(hProgman, nullptr, L"SHELLDLL_DefView", nullptr);
-    if (!hShellViewWin) {
-        // Try WorkerW windows (for Windows 10+)
-        HWND hWorkerW = nullptr;
-        while ((hWorkerW = FindWindowExW(nullptr, hWorkerW, L"WorkerW", nullptr)) != nullptr) {
-            hShellViewWin = FindWindowExW(hWorkerW, nullptr, L"SHELLDLL_DefView", nullptr);
-            if (hShellViewWin) {
-                break;
+    // 上次保存的點陣圖：直接建立圖示，不呼叫殼層。之後在背景重新檢查：
+    // 路徑鍵比對來源檔案的戳記，類型鍵（取決於檔案關聯）則重新提取一次
+    IconCacheImage image;
+    if (persistentIcons_.Find(icon.iconKey, (uint32_t)size, image)) {
+        hIcon = CreateIconFromPixels(image.pixels, image.width, image.height);
+        if (hIcon) {
+            hIcon = iconCache_.Insert(icon.iconKey, size, hIcon);
+            // 每次執行只檢查一次：淘汰後重新建立時不再提取
+            if (refreshedIcons_.emplace(icon.iconKey, size).second) {
+                iconPool_.Request(hwnd, icon.iconKey, icon.filePath, size, IconExtractionPool::PRIORITY_REFRESH,
+                                  IconCache::IsTypeKey(icon.iconKey) ? nullptr : &image.stamp);
             }
+            return hIcon;
         }
     }
 
-    if (!hShellViewWin) {
-        return nullptr;
-    }
-
-    // Find the SysListView32 window (the actual desktop icon container)
-    desktopListView_ = FindWindowExW(hShellViewWin, nullptr, L"SysListView32", nullptr);
-    return desktopListView_;
+    iconPool_.Request(hwnd, icon.iconKey, icon.filePath, size, priority);
+    return nullptr;
 }
 
-POINT FencesWidget::GetDesktopIconPosition(int iconIndex) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView || iconIndex < 0) {
-        return { -1, -1 };
+void FencesWidget::ApplyExtractedIcons(std::vector<IconExtractionPool::Result>& results) {
+    // 提取失敗：繼續顯示預設圖示，提取服務在重試間隔內不再重新提取
+    results.erase(std::remove_if(results.begin(), results.end(),
+                                 [](const IconExtractionPool::Result& result) { return result.failed; }),
+                  results.end());
+
+    for (auto& result : results) {
+        // 重新提取的類型圖示多半與保存的相同：不必取代，也不必重寫快取檔案
+        IconCacheImage image;
+        if (result.refresh && !result.pixels.empty() &&
+            persistentIcons_.Find(result.key, (uint32_t)result.size, image) &&
+            image.width == result.width && image.height == result.height &&
+            std::memcmp(image.pixels, result.pixels.data(), result.pixels.size() * sizeof(uint32_t)) == 0) {
+            DestroyIcon(result.icon);
+            result.icon = nullptr;
+            continue;
+        }
+
+        // 新的點陣圖留待停止時寫入持久快取（暫存超過上限時略過，下次執行重新提取）
+        if (!result.pixels.empty()) {
+            persistentIcons_.Put(result.key, (uint32_t)result.size, result.stamp,
+                                 result.width, result.height, result.pixels.data());
+        }
+        if (result.refresh) {
+            ApplyRefreshedIcon(result);
+        }
     }
 
-    // Get the process ID of the desktop window
-    DWORD processId = 0;
-    GetWindowThreadProcessId(hListView, &processId);
+    // 每個結果套用到所有等待它的柵欄；同一快取鍵的圖示（例如各柵欄內所有 .txt）共用同一個結果
+    for (auto& fence : fences_) {
+        if (!fence.hwnd) {
+            continue;
+        }
+        std::vector<IconExtractionPool::Result*> waiting;
+        for (auto& result : results) {
+            if (std::find(result.targets.begin(), result.targets.end(), fence.hwnd) != result.targets.end()) {
+                waiting.push_back(&result);
+            }
+        }
+        if (waiting.empty()) {
+            continue;
+        }
 
-    // Open the process with read/write access
-    HANDLE hProcess = OpenProcess(PROCESS_VM_OPERATION | PROCESS_VM_READ | PROCESS_VM_WRITE,
-                                   FALSE, processId);
-    if (!hProcess) {
-        return { -1, -1 };
+        std::unordered_map<std::wstring, std::vector<DesktopIcon*>> iconsByKey;
+        for (auto& icon : fence.icons) {
+            if (icon.materialized) {
+                iconsByKey[icon.iconKey].push_back(&icon);
+            }
+        }
+
+        for (IconExtractionPool::Result* result : waiting) {
+            auto it = iconsByKey.find(result->key);
+            if (it == iconsByKey.end()) {
+                continue;
+            }
+            for (DesktopIcon* icon : it->second) {
+                HICON* slot = GetIconSlot(*icon, result->size);
+                if (!slot || *slot) {
+                    continue;
+                }
+                if (result->icon) {
+                    *slot = iconCache_.Insert(result->key, result->size, result->icon);
+                    result->icon = nullptr;
+                } else {
+                    *slot = iconCache_.Acquire(result->key, result->size);
+                }
+            }
+        }
+        InvalidateRect(fence.hwnd, nullptr, FALSE);
     }
 
-    // Allocate memory for the POINT structure in remote process
-    POINT* pRemotePos = (POINT*)VirtualAllocEx(hProcess, nullptr, sizeof(POINT),
-                                                MEM_COMMIT, PAGE_READWRITE);
-    if (!pRemotePos) {
-        CloseHandle(hProcess);
-        return { -1, -1 };
+    // 沒有圖示需要（已從柵欄移除，或已從快取取得）
+    for (auto& result : results) {
+        if (result.icon) {
+            DestroyIcon(result.icon);
+        }
     }
 
-    // Get icon position
-    SendMessageW(hListView, LVM_GETITEMPOSITION, iconIndex, (LPARAM)pRemotePos);
+    if (iconBudget_.IsOverBudget(GetIconMemoryUsage())) {
+        EnforceIconBudget();
+    }
+}
 
-    // Read back the position
-    POINT localPos = { -1, -1 };
-    ReadProcessMemory(hProcess, pRemotePos, &localPos, sizeof(POINT), nullptr);
+void FencesWidget::ApplyRefreshedIcon(IconExtractionPool::Result& result) {
+    HICON icon = result.icon;
+    result.icon = nullptr;
 
-    VirtualFreeEx(hProcess, pRemotePos, 0, MEM_RELEASE);
-    CloseHandle(hProcess);
+    // 已沒有柵欄使用這個圖示時 Replace 直接釋放新的圖示
+    HICON stale = iconCache_.Replace(result.key, result.size, icon);
+    if (!stale) {
+        return;
+    }
 
-    return localPos;
+    for (auto& fence : fences_) {
+        bool changed = false;
+        for (auto& desktopIcon : fence.icons) {
+            HICON* slot = GetIconSlot(desktopIcon, result.size);
+            if (slot && *slot == stale) {
+                *slot = icon;
+                changed = true;
+            }
+        }
+        if (changed && fence.hwnd) {
+            InvalidateRect(fence.hwnd, nullptr, FALSE);
+        }
+    }
+    DestroyIcon(stale);
 }
 
-int FencesWidget::FindDesktopIconIndex(const std::wstring& filePath) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView) {
-        return -1;
+void FencesWidget::LoadPersistentIcons() {
+    // 每個程序只載入一次（停止時序列化的內容已保存在 persistentIcons_ 內）
+    if (persistentIcons_.IsAttached()) {
+        return;
     }
 
-    // Get the number of items in the list view
-    int itemCount = (int)SendMessageW(hListView, LVM_GETITEMCOUNT, 0, 0);
-
-    // Extract filename from full path
-    size_t lastSlash = filePath.find_last_of(L"\\/");
-    std::wstring fileName = (lastSlash != std::wstring::npos)
-        ? filePath.substr(lastSlash + 1)
-        : filePath;
-
-    // 對於捷徑檔案，也嘗試不帶副檔名的版本
-    std::wstring fileNameWithoutExt = fileName;
-    size_t lastDot = fileNameWithoutExt.find_last_of(L'.');
-    if (lastDot != std::wstring::npos && lastDot > 0) {
-        fileNameWithoutExt = fileNameWithoutExt.substr(0, lastDot);
+    // 格式不符（舊版或損壞）時視為沒有快取，停止時重新寫入
+    std::wstring cachePath = GetConfigFilePath(L"icons.cache");
+    if (!cachePath.empty() && iconCacheFile_.Open(cachePath) &&
+        !persistentIcons_.Attach(iconCacheFile_.GetData(), iconCacheFile_.GetSize())) {
+        iconCacheFile_.Close();
     }
+}
 
-    // Get the process ID of the desktop window
-    DWORD processId = 0;
-    GetWindowThreadProcessId(hListView, &processId);
-
-    // Open the process with read/write access
-    HANDLE hProcess = OpenProcess(PROCESS_VM_OPERATION | PROCESS_VM_READ | PROCESS_VM_WRITE,
-                                   FALSE, processId);
-    if (!hProcess) {
-        return -1;
+void FencesWidget::SavePersistentIcons() {
+    // 只保留柵欄內圖示目前尺寸的點陣圖：已移除的圖示、刪除的檔案與不再使用的尺寸在這裡捨棄
+    IconCacheStore::RetainKeys retain;
+    for (const auto& fence : fences_) {
+        for (const auto& icon : fence.icons) {
+            retain.emplace(icon.materialized ? icon.iconKey : IconCache::MakeKey(icon.filePath),
+                           (uint32_t)fence.iconSize);
+        }
     }
-
-    // Allocate memory in the remote process for the item text
-    wchar_t* pRemoteBuffer = (wchar_t*)VirtualAllocEx(hProcess, nullptr, MAX_PATH * sizeof(wchar_t),
-                                                       MEM_COMMIT, PAGE_READWRITE);
-    if (!pRemoteBuffer) {
-        CloseHandle(hProcess);
-        return -1;
+    if (!persistentIcons_.IsDirty() && persistentIcons_.CountUnretained(retain) == 0) {
+        return;
     }
 
-    LVITEMW lvi = { 0 };
-    lvi.mask = LVIF_TEXT;
-    lvi.pszText = pRemoteBuffer;
-    lvi.cchTextMax = MAX_PATH;
-
-    // Allocate memory for the LVITEM structure
-    LVITEMW* pRemoteLvi = (LVITEMW*)VirtualAllocEx(hProcess, nullptr, sizeof(LVITEMW),
-                                                    MEM_COMMIT, PAGE_READWRITE);
-    if (!pRemoteLvi) {
-        VirtualFreeEx(hProcess, pRemoteBuffer, 0, MEM_RELEASE);
-        CloseHandle(hProcess);
-        return -1;
+    std::wstring cachePath = GetConfigFilePath(L"icons.cache");
+    if (cachePath.empty()) {
+        return;
     }
 
-    wchar_t localBuffer[MAX_PATH] = { 0 };
-
-    // Iterate through all items and compare names
-    for (int i = 0; i < itemCount; i++) {
-        lvi.iItem = i;
-        lvi.iSubItem = 0;
-
-        // Write the LVITEM structure to remote process
-        WriteProcessMemory(hProcess, pRemoteLvi, &lvi, sizeof(LVITEMW), nullptr);
-
-        // Get the item text
-        SendMessageW(hListView, LVM_GETITEMTEXTW, i, (LPARAM)pRemoteLvi);
-
-        // Read the text back
-        ReadProcessMemory(hProcess, pRemoteBuffer, localBuffer, MAX_PATH * sizeof(wchar_t), nullptr);
+    // 序列化後 persistentIcons_ 改讀自己的副本，映射必須先關閉才能取代檔案
+    std::string data = persistentIcons_.Serialize(&retain);
+    iconCacheFile_.Close();
+    persistence_.Submit(cachePath, std::move(data));
+}
 
-        // Compare with the file name (case-insensitive)
-        // 嘗試完整檔名和不帶副檔名的檔名
-        if (_wcsicmp(localBuffer, fileName.c_str()) == 0 ||
-            _wcsicmp(localBuffer, fileNameWithoutExt.c_str()) == 0) {
-            VirtualFreeEx(hProcess, pRemoteLvi, 0, MEM_RELEASE);
-            VirtualFreeEx(hProcess, pRemoteBuffer, 0, MEM_RELEASE);
-            CloseHandle(hProcess);
-            return i;
+void FencesWidget::ReleaseIcons(DesktopIcon& icon) {
+    for (HICON* slot : { &icon.hIcon32, &icon.hIcon48, &icon.hIcon64, &icon.hIcon96, &icon.hIcon128, &icon.hIcon256 }) {
+        if (*slot) {
+            iconCache_.Release(*slot);
+            *slot = nullptr;
         }
     }
+}
 
-    VirtualFreeEx(hProcess, pRemoteLvi, 0, MEM_RELEASE);
-    VirtualFreeEx(hProcess, pRemoteBuffer, 0, MEM_RELEASE);
-    CloseHandle(hProcess);
-    return -1;
+IconCache::Stats FencesWidget::GetIconCacheStats() const {
+    return iconCache_.GetStats();
 }
 
-bool FencesWidget::HideDesktopIcon(const std::wstring& filePath) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView) {
-        return false;
+void FencesWidget::SetIconBudget(size_t maxBytes, size_t maxHandles) {
+    IconBudget::Limits limits;
+    limits.maxBytes = maxBytes;
+    limits.maxHandles = maxHandles;
+    iconBudget_.SetLimits(limits);
+    if (iconBudget_.IsOverBudget(GetIconMemoryUsage())) {
+        EnforceIconBudget();
     }
+}
 
-    int iconIndex = FindDesktopIconIndex(filePath);
-    if (iconIndex < 0) {
-        return false;
+IconBudget::Tier FencesWidget::GetIconTier(const Fence& fence, bool shown, int clientBottom, size_t iconIndex,
+                                           int size) {
+    if (size != fence.iconSize) {
+        return IconBudget::TIER_UNUSED_SIZE;
+    }
+    if (!shown) {
+        return IconBudget::TIER_COLLAPSED;
     }
 
-    // Hide the item by removing it from view (not actually deleting it)
-    // We use LVM_SETITEMPOSITION to move it far off-screen
-    POINT offScreen = { -10000, -10000 };
-    SendMessageW(hListView, LVM_SETITEMPOSITION, iconIndex, MAKELPARAM(offScreen.x, offScreen.y));
-
-    // Refresh the desktop
-    InvalidateRect(hListView, nullptr, TRUE);
-    UpdateWindow(hListView);
-
-    return true;
+    // 與 PaintFence 相同的可見與預取範圍
+    int visibleHeight = clientBottom - TITLE_BAR_HEIGHT;
+    int adjustedY = fence.icons.GetPosition(iconIndex).y - fence.scrollOffset;
+    if (adjustedY + fence.iconSize + FenceIconGrid::LABEL_HEIGHT >= TITLE_BAR_HEIGHT && adjustedY < clientBottom) {
+        return IconBudget::TIER_VISIBLE;
+    }
+    if (adjustedY + fence.iconSize + FenceIconGrid::LABEL_HEIGHT >= TITLE_BAR_HEIGHT - visibleHeight &&
+        adjustedY < clientBottom + visibleHeight) {
+        return IconBudget::TIER_NEARBY;
+    }
+    return IconBudget::TIER_OFFSCREEN;
 }
 
-bool FencesWidget::ShowDesktopIcon(const std::wstring& filePath) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView) {
-        return false;
+IconBudget::Usage FencesWidget::GetIconMemoryUsage() const {
+    IconBudget::Usage usage = iconCache_.GetUsage();
+    for (const auto& fence : fences_) {
+        usage.bytes += fence.atlas.GetMemoryBytes();
     }
+    usage.bytes += persistentIcons_.GetPendingBytes();
+    return usage;
+}
 
-    int iconIndex = FindDesktopIconIndex(filePath);
-    if (iconIndex < 0) {
-        return false;
+void FencesWidget::EnforceIconBudget(uint64_t keepUsedAfter) {
+    // 共用的圖示取所有使用位置中最高的層級
+    // 可見狀態與客戶區每個柵欄只查詢一次（每個位置各查一次會變成數千次視窗呼叫）
+    // 圖集的格子與圖示一起釋放：用量加上各柵欄中以它為來源的格子
+    std::unordered_map<HICON, IconBudget::Tier> tiers;
+    std::unordered_map<HICON, size_t> atlasBytes;
+    for (auto& fence : fences_) {
+        bool shown = !fence.isCollapsed && fence.hwnd && IsWindowVisible(fence.hwnd);
+        RECT clientRect = { 0, 0, 0, 0 };
+        if (shown) {
+            GetClientRect(fence.hwnd, &clientRect);
+        }
+        size_t cellBytes = size_t(fence.atlas.GetCellSize()) * fence.atlas.GetCellSize() * sizeof(uint32_t);
+        std::unordered_set<HICON> inAtlas;
+        for (size_t i = 0; i < fence.icons.size(); ++i) {
+            for (int size : ICON_SLOT_SIZES) {
+                HICON* slot = GetIconSlot(fence.icons[i], size);
+                if (!*slot) {
+                    continue;
+                }
+                IconBudget::Tier tier = GetIconTier(fence, shown, clientRect.bottom, i, size);
+                auto it = tiers.emplace(*slot, tier).first;
+                it->second = (std::max)(it->second, tier);
+                if (size == fence.iconSize && fence.atlas.Contains(fence.icons[i].iconKey) &&
+                    inAtlas.insert(*slot).second) {
+                    atlasBytes[*slot] += cellBytes;
+                }
+            }
+        }
     }
 
-    // Restore the item to its auto-arranged position
-    // Tell Windows to auto-arrange the icons
-    SendMessageW(hListView, LVM_ARRANGE, LVA_DEFAULT, 0);
+    // 全部都在畫面上時沒有可淘汰的圖示
+    bool anyEvictable = false;
+    for (const auto& pair : tiers) {
+        if (pair.second < IconBudget::TIER_VISIBLE) {
+            anyEvictable = true;
+            break;
+        }
+    }
+    if (!anyEvictable) {
+        return;
+    }
 
-    // Refresh the desktop
-    InvalidateRect(hListView, nullptr, TRUE);
-    UpdateWindow(hListView);
+    std::vector<IconBudget::Candidate> candidates;
+    candidates.reserve(tiers.size());
+    for (const auto& pair : tiers) {
+        IconCache::EntryInfo info;
+        if (!iconCache_.GetEntryInfo(pair.first, info) || info.lastUse > keepUsedAfter) {
+            continue;
+        }
+        auto atlas = atlasBytes.find(pair.first);
+        if (atlas != atlasBytes.end()) {
+            info.usage.bytes += atlas->second;
+        }
+        candidates.push_back({ (uint64_t)(uintptr_t)pair.first, pair.second, info.lastUse, info.usage });
+    }
 
-    return true;
-}
+    std::vector<uint64_t> victims;
+    iconBudget_.SelectVictims(candidates, GetIconMemoryUsage(), victims);
+    if (victims.empty()) {
+        return;
+    }
 
-bool FencesWidget::ShowDesktopIconAtPosition(const std::wstring& filePath, int x, int y) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView) {
-        return false;
+    std::unordered_set<HICON> evicted;
+    for (uint64_t victim : victims) {
+        evicted.insert((HICON)(uintptr_t)victim);
     }
 
-    int iconIndex = FindDesktopIconIndex(filePath);
-    if (iconIndex < 0) {
-        return false;
+    // 清除引用的位置（之後繪製時重新取得），並移除圖集中以這些圖示為來源的格子：
+    // 控制代碼釋放後可能被新的圖示重複使用，圖集不能再以它辨識來源
+    for (auto& fence : fences_) {
+        for (auto& icon : fence.icons) {
+            for (int size : ICON_SLOT_SIZES) {
+                HICON* slot = GetIconSlot(icon, size);
+                if (*slot && evicted.count(*slot)) {
+                    if (size == fence.iconSize) {
+                        fence.atlas.Remove(icon.iconKey);
+                    }
+                    *slot = nullptr;
+                }
+            }
+        }
+        // 收合的柵欄不會繪製，圖集整個釋放；其餘的把移除後空出的格子還給系統
+        if (fence.isCollapsed && fence.atlas.GetCellCount() > 0) {
+            fence.atlas.Reset(0);
+        } else {
+            fence.atlas.Compact();
+        }
+    }
+    for (HICON icon : evicted) {
+        iconCache_.Evict(icon);
     }
+}
 
-    // 將螢幕座標轉換為桌面ListView座標
-    POINT pt = { x, y };
-    ScreenToClient(hListView, &pt);
+HICON FencesWidget::DrawIconLabel(HDC hdc, HWND hwnd, DesktopIcon& icon, int x, int y, int iconSize,
+                                  bool selected, const FencePaintStyles& styles) {
+    // Calculate text area width - ensure enough space to avoid overlap
+    const int textWidth = max(70, iconSize + 20);
+    const int textLeft = x - (textWidth - iconSize) / 2;
+    const int textRight = textLeft + textWidth;
 
-    // 設定圖示位置到指定座標
-    SendMessageW(hListView, LVM_SETITEMPOSITION, iconIndex, MAKELPARAM(pt.x, pt.y));
+    // Draw selection background if selected
+    if (selected) {
+        RECT selRect = { textLeft - 2, y - 2, textRight + 2, y + iconSize + 35 };
+        ScopedPaintResource selBrush(paintResources_, styles.labelSelection);
+        FillRect(hdc, &selRect, ToBrush(selBrush.Get()));
+    }
 
-    // 重新整理桌面
-    InvalidateRect(hListView, nullptr, TRUE);
-    UpdateWindow(hListView);
+    // 延遲建立：第一次繪製時才計算顯示名稱、載入圖示
+    if (!icon.materialized) {
+        MaterializeIcon(icon);
+    }
 
-    return true;
-}
+    // 使用共用快取或持久快取的圖示；都沒有時交給背景執行緒，完成前先畫預設圖示
+    HICON* hIconCache = GetIconSlot(icon, iconSize);
+    if (hIconCache && !*hIconCache) {
+        *hIconCache = AcquireIcon(hwnd, icon, iconSize, IconExtractionPool::PRIORITY_VISIBLE);
+    }
 
-// 批次隱藏桌面圖示（避免多次重繪）
-void FencesWidget::HideDesktopIconsBatch(const std::vector<std::wstring>& filePaths) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView || filePaths.empty()) {
-        return;
+    HICON hIconToUse = (hIconCache && *hIconCache) ? *hIconCache : nullptr;
+    if (hIconToUse) {
+        iconCache_.Touch(hIconToUse);
+    } else {
+        hIconToUse = GetPlaceholderIcon(iconSize);
     }
 
-    // 暫停桌面重繪
-    SendMessageW(hListView, WM_SETREDRAW, FALSE, 0);
+    // Draw display name with proper width
+    RECT textRect = { textLeft, y + iconSize + 2, textRight, y + iconSize + 40 };
+    SetBkMode(hdc, TRANSPARENT);
+
+    ScopedPaintResource labelFont(paintResources_, styles.labelFont);
+    HFONT oldFont = (HFONT)SelectObject(hdc, ToFont(labelFont.Get()));
 
-    // 批次隱藏所有圖示
-    POINT offScreen = { -10000, -10000 };
-    for (const auto& filePath : filePaths) {
-        int iconIndex = FindDesktopIconIndex(filePath);
-        if (iconIndex >= 0) {
-            SendMessageW(hListView, LVM_SETITEMPOSITION, iconIndex, MAKELPARAM(offScreen.x, offScreen.y));
-        }
-    }
+    // Draw text with shadow for better visibility
+    SetTextColor(hdc, RGB(255, 255, 255));
+    RECT shadowRect = textRect;
+    OffsetRect(&shadowRect, 1, 1);
+    DrawTextW(hdc, icon.displayName.c_str(), -1, &shadowRect,
+        DT_CENTER | DT_TOP | DT_WORDBREAK | DT_END_ELLIPSIS);
+
+    SetTextColor(hdc, RGB(0, 0, 0));
+    DrawTextW(hdc, icon.displayName.c_str(), -1, &textRect,
+        DT_CENTER | DT_TOP | DT_WORDBREAK | DT_END_ELLIPSIS);
 
-    // 恢復重繪並一次性刷新
-    SendMessageW(hListView, WM_SETREDRAW, TRUE, 0);
-    InvalidateRect(hListView, nullptr, TRUE);
-    UpdateWindow(hListView);
+    SelectObject(hdc, oldFont);
+    return hIconToUse;
 }
 
-// 批次顯示桌面圖示（避免多次重繪）
-void FencesWidget::ShowDesktopIconsBatch(const std::vector<std::wstring>& filePaths) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView || filePaths.empty()) {
-        return;
+int FencesWidget::GetAtlasCell(Fence* fence, DesktopIcon& icon, HICON hIcon) {
+    if (!hIcon) {
+        return -1;
+    }
+    if (fence->atlas.GetCellSize() != (uint32_t)fence->iconSize) {
+        fence->atlas.Reset((uint32_t)fence->iconSize);
     }
 
-    // 暫停桌面重繪
-    SendMessageW(hListView, WM_SETREDRAW, FALSE, 0);
+    // 快取的圖示以快取鍵識別（同類型的檔案共用一格）；預設圖示共用空字串鍵
+    static const std::wstring placeholderKey;
+    HICON* slot = GetIconSlot(icon, fence->iconSize);
+    const std::wstring& key = (slot && *slot == hIcon) ? icon.iconKey : placeholderKey;
+    uint64_t sourceId = (uint64_t)(uintptr_t)hIcon;
 
-    // 批次顯示所有圖示
-    for (const auto& filePath : filePaths) {
-        int iconIndex = FindDesktopIconIndex(filePath);
-        if (iconIndex >= 0) {
-            // 這裡可以恢復到原始位置，或讓系統自動排列
-            SendMessageW(hListView, LVM_ARRANGE, LVA_DEFAULT, 0);
+    int cell = fence->atlas.Find(key, sourceId);
+    if (cell < 0) {
+        std::vector<uint32_t> pixels;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        if (CaptureIconPixels(hIcon, pixels, width, height)) {
+            cell = fence->atlas.Put(key, sourceId, pixels.data(), width, height);
         }
     }
-
-    // 恢復重繪並一次性刷新
-    SendMessageW(hListView, WM_SETREDRAW, TRUE, 0);
-    InvalidateRect(hListView, nullptr, TRUE);
-    UpdateWindow(hListView);
+    return cell;
 }
 
-// 批次恢復桌面圖示到指定位置（避免多次重繪）
-void FencesWidget::RestoreDesktopIconsBatch(const std::vector<std::pair<std::wstring, POINT>>& iconData) {
-    HWND hListView = GetDesktopListView();
-    if (!hListView || iconData.empty()) {
+void FencesWidget::ShowFenceContextMenu(Fence* fence, int x, int y) {
+    // 設定滑鼠游標為箭頭
+    SetCursor(LoadCursor(nullptr, IDC_ARROW));
+
+    HMENU hMenu = CreatePopupMenu();
+    if (!hMenu) {
         return;
     }
 
-    // 暫停桌面重繪
-    SendMessageW(hListView, WM_SETREDRAW, FALSE, 0);
+    AppendMenuW(hMenu, MF_STRING, IDM_RENAME_FENCE, L"重新命名柵欄");
+    AppendMenuW(hMenu, MF_STRING, IDM_CHANGE_COLOR, L"變更背景顏色...");
+    AppendMenuW(hMenu, MF_STRING, IDM_CHANGE_TITLE_COLOR, L"變更標題顏色...");
+    AppendMenuW(hMenu, MF_STRING, IDM_CHANGE_TRANSPARENCY, L"調整透明度");
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, nullptr);
 
-    // 批次恢復所有圖示到原始位置
-    for (const auto& data : iconData) {
-        int iconIndex = FindDesktopIconIndex(data.first);
-        if (iconIndex >= 0) {
-            if (data.second.x >= 0 && data.second.y >= 0) {
-                // 將螢幕座標轉換為桌面ListView座標
-                POINT pt = data.second;
-                ScreenToClient(hListView, &pt);
+    // 圖示大小子選單
+    HMENU hSizeMenu = CreatePopupMenu();
+    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 32 ? MF_CHECKED : 0), IDM_ICON_SIZE_32, L"小 (32px)");
+    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 48 ? MF_CHECKED : 0), IDM_ICON_SIZE_48, L"中 (48px)");
+    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 64 ? MF_CHECKED : 0), IDM_ICON_SIZE_64, L"大 (64px)");
+    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 96 ? MF_CHECKED : 0), IDM_ICON_SIZE_96, L"特大 (96px)");
+    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 128 ? MF_CHECKED : 0), IDM_ICON_SIZE_128, L"超大 (128px)");
+    AppendMenuW(hSizeMenu, MF_STRING | (fence->iconSize == 256 ? MF_CHECKED : 0), IDM_ICON_SIZE_256, L"巨大 (256px)");
+    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hSizeMenu, L"圖示大小");
 
-                // 設定圖示位置到指定座標
-                SendMessageW(hListView, LVM_SETITEMPOSITION, iconIndex, MAKELPARAM(pt.x, pt.y));
-            } else {
-                // 如果沒有原始位置，讓系統自動排列
-                SendMessageW(hListView, LVM_ARRANGE, LVA_DEFAULT, 0);
-            }
-        }
-    }
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, nullptr);
+    AppendMenuW(hMenu, MF_STRING, IDM_AUTO_CATEGORIZE, L"自動分類桌面圖示");
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, nullptr);
+    AppendMenuW(hMenu, MF_STRING, IDM_CREATE_FENCE, L"建立新柵欄");
+    AppendMenuW(hMenu, MF_STRING, IDM_DELETE_FENCE, L"刪除柵欄");
 
-    // 恢復重繪並一次性刷新
-    SendMessageW(hListView, WM_SETREDRAW, TRUE, 0);
-    InvalidateRect(hListView, nullptr, TRUE);
-    UpdateWindow(hListView);
+    TrackPopupMenu(hMenu, TPM_RIGHTBUTTON, x, y, 0, fence->hwnd, nullptr);
+    DestroyMenu(hMenu);
 }
 
 int FencesWidget::FindIconAtPosition(Fence* fence, int x, int y) {
@@ -3052,28 +3465,8 @@ int FencesWidget::FindIconAtPosition(Fence* fence, int x, int y) {
         return -1;
     }
 
-    for (size_t i = 0; i < fence->icons.size(); i++) {
-        const auto& icon = fence->icons[i];
-
-        // Apply scroll offset to icon position
-        int adjustedY = icon.position.y - fence->scrollOffset;
-
-        // Calculate icon bounding box
-        RECT iconRect = {
-            icon.position.x - 5,
-            adjustedY - 5,
-            icon.position.x + fence->iconSize + 15,
-            adjustedY + fence->iconSize + 35
-        };
-
-        // Check if click is within icon bounds
-        if (x >= iconRect.left && x <= iconRect.right &&
-            y >= iconRect.top && y <= iconRect.bottom) {
-            return (int)i;
-        }
-    }
-
-    return -1;
+    return FenceIconGrid::HitTest(fence->icons.GetPositions(), fence->icons.size(), fence->iconSize,
+                                  fence->scrollOffset, x, y);
 }
 
 void FencesWidget::ShowIconContextMenu(Fence* fence, int iconIndex, int x, int y) {
@@ -3185,7 +3578,7 @@ void FencesWidget::ShowIconContextMenu(Fence* fence, int iconIndex, int x, int y
 
 extern "C" {
     WIDGET_API IWidget* CreateWidget(void* params) {
-        (void)params;  // FencesWidget 不需要 HINSTANCE 參數
+        (void)params;  // FencesWidget 不需要 HINSTANCE；佈局存於可映射的快照檔，不使用共用儲存
         return new FencesWidget();
     }
 
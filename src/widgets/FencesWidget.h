@@ -1,23 +1,49 @@
 #pragma once
 
 #include "core/IWidget.h"
+#include "core/MappedFile.h"
+#include "core/PersistenceWorker.h"
+#include "core/MutationJournal.h"
+#include "DesktopIconController.h"
+#include "DesktopIndex.h"
+#include "FenceBackBuffer.h"
+#include "FenceIconList.h"
+#include "FencePaintStyles.h"
+#include "IconAtlas.h"
+#include "IconBudget.h"
+#include "IconCache.h"
+#include "IconCacheStore.h"
+#include "IconExtractionPool.h"
+#include "PaintResourceCache.h"
+#include "Win32DesktopFolderWatcher.h"
+#include "Win32DesktopIconHost.h"
+#include "Win32PaintResourceFactory.h"
 #include <windows.h>
 #include <shellapi.h>
 #include <shlobj.h>
+#include <map>
+#include <set>
 #include <vector>
 #include <string>
 
-// Desktop icon information
+struct FenceLayout;
+struct FenceLayoutFence;
+
+// Desktop icon information (cold data; position and selection live in FenceIconList's packed arrays)
+// Icons restored from the config only carry their path and desktop data;
+// display name and icon handles are materialized on first paint.
 struct DesktopIcon {
     std::wstring filePath;        // Full path to file/folder
-    std::wstring displayName;     // Display name
-    HICON hIcon;                  // Icon handle (cached)
-    HICON hIcon32;                // 32px cached icon
-    HICON hIcon48;                // 48px cached icon
-    HICON hIcon64;                // 64px cached icon
+    std::wstring displayName;     // Display name (valid once materialized)
+    bool materialized;            // Display name computed
+    HICON hIcon32;                // 32px icon (reference held in the shared icon cache)
+    HICON hIcon48;                // 48px icon (reference held in the shared icon cache)
+    HICON hIcon64;                // 64px icon (reference held in the shared icon cache)
+    HICON hIcon96;                // 96px icon (reference held in the shared icon cache)
+    HICON hIcon128;               // 128px icon (reference held in the shared icon cache)
+    HICON hIcon256;               // 256px icon (reference held in the shared icon cache)
+    std::wstring iconKey;         // Shared icon cache key (valid once materialized)
     int cachedIconSize;           // Currently cached icon size
-    POINT position;               // Position within fence
-    bool selected;                // Selection state
     POINT originalDesktopPos;     // Original position on desktop (for restoration)
     int originalDesktopIndex;     // Original index on desktop
 };
@@ -35,9 +61,11 @@ struct Fence {
     bool isResizing;              // Is resizing
     bool isDragging;              // Is dragging (fence itself)
     POINT dragOffset;             // Drag offset
-    std::vector<DesktopIcon> icons; // Icons in this fence
+    FenceIconList<DesktopIcon> icons; // Icons in this fence (positions packed apart from paths and handles)
     int iconSpacing;              // Spacing between icons
     int iconSize;                 // Icon size (32, 48, etc)
+    IconAtlas atlas;              // Icons at iconSize, composited straight into the back buffer
+    FenceBackBuffer backBuffer;   // Retained paint surface (reallocated only when the client area outgrows it)
 
     // Icon dragging state
     bool isDraggingIcon;          // Is dragging an icon
@@ -83,18 +111,31 @@ public:
     // Get fence count
     size_t GetFenceCount() const;
 
+    // Shared icon cache counters (hits, misses, distinct icons held)
+    IconCache::Stats GetIconCacheStats() const;
+
+    // Limit the bytes and GDI handles held by cached icons; icons least likely to be drawn
+    // (unused sizes, collapsed fences, rows scrolled out of view) are released first and reloaded on demand
+    void SetIconBudget(size_t maxBytes, size_t maxHandles);
+
     // Update fence title
     bool UpdateFenceTitle(size_t index, const std::wstring& newTitle);
 
     // Update fence style
     bool UpdateFenceStyle(size_t index, COLORREF bgColor, COLORREF borderColor, int alpha);
 
-    // Save configuration to JSON file
+    // Export configuration to JSON file
     bool SaveConfiguration(const std::wstring& filePath);
 
-    // Load configuration from JSON file
+    // Save binary layout snapshot (memory-mappable)
+    bool SaveSnapshot(const std::wstring& filePath);
+
+    // Load configuration from a binary layout snapshot or JSON file
     bool LoadConfiguration(const std::wstring& filePath);
 
+    // Queue a background save of the current configuration (full snapshot)
+    void MarkConfigDirty();
+
     // Restore all desktop icons to original positions
     void RestoreAllDesktopIcons();
 
@@ -105,8 +146,32 @@ public:
     void ClearAllData();
 
 private:
+    // Get path of a file in the config directory (creates the directory if needed)
+    std::wstring GetConfigFilePath(const wchar_t* fileName = L"config.json") const;
+
+    // Copy current fences into the file-format independent layout model
+    void BuildLayout(FenceLayout& layout) const;
+
+    // Create the fence window and append it to fences_ without journaling (CreateFence journals)
+    bool CreateFenceWindow(int x, int y, int width, int height, const std::wstring& title);
+
+    // Recreate a fence from stored settings; icons are added with AddLoadedIcon
+    Fence* RestoreFence(const FenceLayoutFence& settings);
+    void AddLoadedIcon(Fence* fence, std::wstring filePath, int originalX, int originalY, int originalIndex);
+    void FinishLoadedFence(Fence* fence);
+
+    // Journal helpers: append a mutation record, compacting when needed
+    int GetFenceIndex(const Fence* fence) const;
+    void AppendJournal(uint16_t type, const JournalPayloadWriter& payload);
+    void JournalFenceStyle(Fence* fence);
+    void JournalFenceIconSize(Fence* fence);
+
     // Get category for file
-    std::wstring GetFileCategory(const std::wstring& filePath);
+    std::wstring GetFileCategory(const std::wstring& filePath, bool isDirectory);
+
+    // Index the desktop folders on first use, then apply pending change notifications;
+    // returns false when no desktop folder could be read
+    bool UpdateDesktopIndex();
 
     // Get file extension
     std::wstring GetFileExtension(const std::wstring& filePath);
@@ -122,8 +187,8 @@ private:
     // Handle window messages
     LRESULT HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
-    // Paint fence
-    void PaintFence(HWND hwnd, HDC hdc);
+    // Paint fence (only dirtyRect is redrawn into the retained back buffer and copied to hdc)
+    void PaintFence(HWND hwnd, HDC hdc, const RECT& dirtyRect);
 
     // Find fence by window handle
     Fence* FindFence(HWND hwnd);
@@ -152,8 +217,10 @@ private:
     // Check if in scrollbar area
     bool IsInScrollbarArea(Fence* fence, int x, int y, RECT* outThumbRect = nullptr) const;
 
-    // Add icon to fence
-    bool AddIconToFence(Fence* fence, const std::wstring& filePath);
+    // Add icons to fence, recording their desktop positions in one batch; returns how many were added.
+    // desktopPositions: positions of all desktop items (from GetAllDesktopIconPositions), if already read
+    size_t AddIconsToFence(Fence* fence, const std::vector<std::wstring>& filePaths,
+                           const std::vector<DesktopIconPoint>* desktopPositions = nullptr);
 
     // Remove icon from fence
     bool RemoveIconFromFence(Fence* fence, size_t iconIndex);
@@ -161,27 +228,65 @@ private:
     // Arrange icons in fence
     void ArrangeIcons(Fence* fence);
 
-    // Get icon from file
-    HICON GetFileIcon(const std::wstring& filePath, int size);
+    // Get icon from file (shell calls that may block; runs on iconPool_ workers only)
+    static HICON GetFileIcon(const std::wstring& filePath, int size);
 
-    // Draw icon with text
-    void DrawIcon(HDC hdc, DesktopIcon& icon, int x, int y, int iconSize);
+    // Resample a shell image-list icon to exactly size x size with IconScaler (takes ownership of the source)
+    static HICON ScaleIcon(HICON hSourceIcon, int size);
 
-    // Show fence context menu
-    void ShowFenceContextMenu(Fence* fence, int x, int y);
+    // iconPool_ extractor: icon plus the source stamp and bitmap kept in the persistent cache;
+    // skips extraction when the source still matches `unchanged`
+    static bool ExtractFileIcon(const std::wstring& filePath, int size, const IconCacheStamp* unchanged,
+                                IconExtractionPool::Result& result);
+
+    // Cache slot for the given icon size (nullptr for sizes that are not cached)
+    static HICON* GetIconSlot(DesktopIcon& icon, int size);
 
-    // Desktop icon management
-    HWND GetDesktopListView();
-    bool HideDesktopIcon(const std::wstring& filePath);
-    bool ShowDesktopIcon(const std::wstring& filePath);
-    bool ShowDesktopIconAtPosition(const std::wstring& filePath, int x, int y);
-    int FindDesktopIconIndex(const std::wstring& filePath);
-    POINT GetDesktopIconPosition(int iconIndex);
+    // Drop the icon's cache references
+    void ReleaseIcons(DesktopIcon& icon);
 
-    // Batch desktop icon operations (faster)
-    void HideDesktopIconsBatch(const std::vector<std::wstring>& filePaths);
-    void ShowDesktopIconsBatch(const std::vector<std::wstring>& filePaths);
-    void RestoreDesktopIconsBatch(const std::vector<std::pair<std::wstring, POINT>>& iconData);
+    // Generic icon drawn until the real icon has been extracted (shared, never destroyed)
+    HICON GetPlaceholderIcon(int size);
+
+    // Icon for a cache slot: shared cache first, then the persistent cache (rechecked in the background),
+    // otherwise requested from iconPool_ (returns nullptr until it arrives)
+    HICON AcquireIcon(HWND hwnd, DesktopIcon& icon, int size, IconExtractionPool::Priority priority);
+
+    // Store icons extracted in the background into the slots of every fence waiting on them
+    void ApplyExtractedIcons(std::vector<IconExtractionPool::Result>& results);
+
+    // Swap a re-extracted icon into every slot still showing the persisted one
+    void ApplyRefreshedIcon(IconExtractionPool::Result& result);
+
+    // How likely the icon's slot for `size` is to be drawn soon (eviction order);
+    // `shown` and `clientBottom` are queried once per fence by the caller
+    static IconBudget::Tier GetIconTier(const Fence& fence, bool shown, int clientBottom, size_t iconIndex, int size);
+
+    // Bytes and handles counted against iconBudget_: cached icons, every fence's atlas
+    // and bitmaps waiting to be written to icons.cache
+    IconBudget::Usage GetIconMemoryUsage() const;
+
+    // Release cached icons and their atlas cells until usage is back under iconBudget_
+    // (visible icons, and icons used after `keepUsedAfter` on iconCache_'s clock, are kept)
+    void EnforceIconBudget(uint64_t keepUsedAfter = UINT64_MAX);
+
+    // Map icons.cache / write it back when new icons were extracted
+    void LoadPersistentIcons();
+    void SavePersistentIcons();
+
+    // Draw selection and label with GDI; returns the icon to composite
+    // (a missing icon is requested from iconPool_ and shown as a placeholder)
+    HICON DrawIconLabel(HDC hdc, HWND hwnd, DesktopIcon& icon, int x, int y, int iconSize, bool selected,
+                        const FencePaintStyles& styles);
+
+    // Atlas cell holding hIcon for the fence's icon size (rasterized on first use, -1 on failure)
+    int GetAtlasCell(Fence* fence, DesktopIcon& icon, HICON hIcon);
+
+    // Compute display name on first use
+    static void MaterializeIcon(DesktopIcon& icon);
+
+    // Show fence context menu
+    void ShowFenceContextMenu(Fence* fence, int x, int y);
 
     // Icon interaction
     int FindIconAtPosition(Fence* fence, int x, int y);
@@ -194,7 +299,23 @@ private:
     const wchar_t* windowClassName_;
     bool classRegistered_;
     HWND desktopWindow_;
-    HWND desktopListView_;
+    Win32DesktopIconHost desktopHost_;       // Desktop ListView in explorer (must outlive desktopIcons_)
+    DesktopIconController desktopIcons_;     // Hide / restore algorithms on top of desktopHost_
+    Win32DesktopFolderWatcher desktopFolderWatcher_;  // Change notifications (must outlive desktopIndex_)
+    DesktopIndex desktopIndex_;              // User, public and OneDrive desktop items
+    IconCache iconCache_;                    // Icons shared by all fences (must outlive iconPool_)
+    IconExtractionPool iconPool_;            // Background icon extraction, results posted to fences
+    IconBudget iconBudget_;                  // Byte / handle limits for iconCache_
+    Win32PaintResourceFactory paintFactory_; // GDI brushes, pens and fonts (must outlive paintResources_)
+    PaintResourceCache paintResources_;      // Paint objects reused across frames, keyed by style
+    std::map<int, HICON> placeholderIcons_;  // Placeholder icon per size
+    MappedFile iconCacheFile_;               // Mapped icons.cache (closed once persistentIcons_ is serialized)
+    IconCacheStore persistentIcons_;         // Icon bitmaps kept across runs (reads from iconCacheFile_)
+    std::set<std::pair<std::wstring, int>> refreshedIcons_;  // Persisted icons already re-checked this session
     int selectedIconIndex_;
     Fence* selectedFence_;
+    MutationJournal journal_;        // 變更日誌（必須比 persistence_ 晚解構）
+    PersistenceWorker persistence_;  // 背景寫入設定檔
+    size_t lastConfigSize_;          // 上次輸出大小，用於預先配置緩衝區
+    uint64_t lastSnapshotSequence_;  // 最近一次快照涵蓋到的日誌序號
 };
@@ -0,0 +1,112 @@
+#include "IconAtlas.h"
+#include "IconCompositor.h"
+#include "IconScaler.h"
+#include <algorithm>
+#include <cstring>
+
+IconAtlas::IconAtlas()
+    : cellSize_(0)
+    , cellCapacity_(0) {
+}
+
+void IconAtlas::Reset(uint32_t cellSize) {
+    cellSize_ = cellSize;
+    std::vector<uint32_t>().swap(pixels_);
+    cellsByKey_.clear();
+    freeCells_.clear();
+    cellCapacity_ = 0;
+}
+
+int IconAtlas::Find(const std::wstring& key, uint64_t sourceId) const {
+    auto it = cellsByKey_.find(key);
+    if (it == cellsByKey_.end() || it->second.sourceId != sourceId) {
+        return -1;
+    }
+    return it->second.index;
+}
+
+int IconAtlas::Put(const std::wstring& key, uint64_t sourceId, const uint32_t* pixels,
+                   uint32_t width, uint32_t height) {
+    if (cellSize_ == 0 || width == 0 || height == 0) {
+        return -1;
+    }
+
+    int index;
+    auto it = cellsByKey_.find(key);
+    if (it != cellsByKey_.end()) {
+        index = it->second.index;
+        it->second.sourceId = sourceId;
+    } else {
+        if (!freeCells_.empty()) {
+            index = freeCells_.back();
+            freeCells_.pop_back();
+        } else {
+            index = cellCapacity_++;
+            pixels_.resize(size_t(cellCapacity_) * cellSize_ * cellSize_);
+        }
+        cellsByKey_.emplace(key, Cell{ index, sourceId });
+    }
+
+    uint32_t* cell = GetMutableCellPixels(index);
+    if (width == cellSize_ && height == cellSize_) {
+        std::memcpy(cell, pixels, size_t(cellSize_) * cellSize_ * sizeof(uint32_t));
+    } else {
+        IconScaler::Scale(pixels, width, height, cell, cellSize_, cellSize_);
+    }
+    return index;
+}
+
+void IconAtlas::Remove(const std::wstring& key) {
+    auto it = cellsByKey_.find(key);
+    if (it != cellsByKey_.end()) {
+        freeCells_.push_back(it->second.index);
+        cellsByKey_.erase(it);
+    }
+}
+
+void IconAtlas::Compact() {
+    if (freeCells_.empty()) {
+        return;
+    }
+
+    size_t cellPixels = size_t(cellSize_) * cellSize_;
+    std::vector<uint32_t> pixels(cellsByKey_.size() * cellPixels);
+    int next = 0;
+    for (auto& item : cellsByKey_) {
+        std::memcpy(pixels.data() + size_t(next) * cellPixels, GetCellPixels(item.second.index),
+                    cellPixels * sizeof(uint32_t));
+        item.second.index = next++;
+    }
+    pixels_.swap(pixels);
+    freeCells_.clear();
+    cellCapacity_ = next;
+}
+
+const uint32_t* IconAtlas::GetCellPixels(int cell) const {
+    return pixels_.data() + size_t(cell) * cellSize_ * cellSize_;
+}
+
+uint32_t* IconAtlas::GetMutableCellPixels(int cell) {
+    return pixels_.data() + size_t(cell) * cellSize_ * cellSize_;
+}
+
+void IconAtlas::Draw(int cell, uint32_t* target, size_t targetStride, const IconAtlasRect& clip,
+                     int32_t x, int32_t y) const {
+    if (cell < 0 || cell >= cellCapacity_) {
+        return;
+    }
+
+    // 裁切到 clip 範圍
+    int32_t size = (int32_t)cellSize_;
+    int32_t left = (std::max)(x, clip.left);
+    int32_t top = (std::max)(y, clip.top);
+    int32_t right = (std::min)(x + size, clip.right);
+    int32_t bottom = (std::min)(y + size, clip.bottom);
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    const uint32_t* source = GetCellPixels(cell) + size_t(top - y) * cellSize_ + (left - x);
+    IconCompositor::BlendOver(target + size_t(top) * targetStride + left, targetStride,
+                              source, cellSize_, uint32_t(right - left), uint32_t(bottom - top));
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 繪製目標上的矩形（像素，right / bottom 不含）
+struct IconAtlasRect {
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+// 單一柵欄的圖示圖集：目前圖示尺寸下每個不同圖示一格，內容為預乘 alpha 的 BGRA
+// 每格以快取鍵識別，並記錄來源（HICON 等）的識別值；來源改變（例如背景重新提取後取代）時
+// Find 視為不存在，由呼叫者重新放入。繪製時直接以 IconCompositor 合成到背景緩衝區，
+// 不必對每個圖示呼叫 DrawIconEx。不依賴 Windows。
+class IconAtlas {
+public:
+    IconAtlas();
+
+    // 清空（釋放像素記憶體）並改用新的格子尺寸
+    void Reset(uint32_t cellSize);
+
+    uint32_t GetCellSize() const { return cellSize_; }
+    size_t GetCellCount() const { return cellsByKey_.size(); }
+    size_t GetFreeCellCount() const { return freeCells_.size(); }
+
+    // 像素記憶體的位元組（含移除後留待重複使用的格子）
+    size_t GetMemoryBytes() const { return pixels_.capacity() * sizeof(uint32_t); }
+
+    // 是否有 key 的格子（不論來源）
+    bool Contains(const std::wstring& key) const { return cellsByKey_.count(key) != 0; }
+
+    // key 的格子（來源必須相同）；沒有時回傳 -1
+    int Find(const std::wstring& key, uint64_t sourceId) const;
+
+    // 放入 key 的圖示（width × height 的預乘 BGRA，以 IconScaler 縮放到格子尺寸），回傳格子；
+    // 已有 key 時覆寫同一格
+    int Put(const std::wstring& key, uint64_t sourceId, const uint32_t* pixels, uint32_t width, uint32_t height);
+
+    // 移除 key（格子留待重複使用）
+    void Remove(const std::wstring& key);
+
+    // 把使用中的格子移到前面並釋放其餘的像素記憶體；格子編號會改變，之前取得的編號失效
+    void Compact();
+
+    // 將格子合成到 target（stride 以像素為單位）的 (x, y)，只畫 clip 範圍內的部分（clip 須在 target 之內）
+    void Draw(int cell, uint32_t* target, size_t targetStride, const IconAtlasRect& clip, int32_t x, int32_t y) const;
+
+    // 格子的像素（cellSize × cellSize）
+    const uint32_t* GetCellPixels(int cell) const;
+
+private:
+    struct Cell {
+        int index;
+        uint64_t sourceId;
+    };
+
+    uint32_t* GetMutableCellPixels(int cell);
+
+    uint32_t cellSize_;
+    std::vector<uint32_t> pixels_;      // 各格依序相接，每格 cellSize × cellSize
+    std::unordered_map<std::wstring, Cell> cellsByKey_;
+    std::vector<int> freeCells_;
+    int cellCapacity_;
+};
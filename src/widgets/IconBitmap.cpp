@@ -0,0 +1,98 @@
+#include "IconBitmap.h"
+#include "IconCacheStore.h"
+#include <cstring>
+
+namespace {
+
+void InitBitmapInfo(BITMAPINFO& info, uint32_t width, uint32_t height) {
+    ZeroMemory(&info, sizeof(info));
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = (LONG)width;
+    info.bmiHeader.biHeight = -(LONG)height;   // 由上而下
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+}
+
+} // namespace
+
+bool CaptureIconPixels(HICON icon, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height) {
+    ICONINFO iconInfo;
+    if (!GetIconInfo(icon, &iconInfo)) {
+        return false;
+    }
+
+    bool captured = false;
+    BITMAP bitmap = {};
+    if (iconInfo.hbmColor && GetObjectW(iconInfo.hbmColor, sizeof(bitmap), &bitmap) &&
+        bitmap.bmWidth > 0 && bitmap.bmHeight > 0 &&
+        (uint32_t)bitmap.bmWidth <= ICON_CACHE_MAX_DIMENSION && (uint32_t)bitmap.bmHeight <= ICON_CACHE_MAX_DIMENSION) {
+        width = (uint32_t)bitmap.bmWidth;
+        height = (uint32_t)bitmap.bmHeight;
+
+        BITMAPINFO info;
+        InitBitmapInfo(info, width, height);
+        pixels.resize(size_t(width) * height);
+
+        HDC hdc = GetDC(nullptr);
+        captured = GetDIBits(hdc, iconInfo.hbmColor, 0, height, pixels.data(), &info, DIB_RGB_COLORS) == (int)height;
+
+        bool hasAlpha = false;
+        for (size_t i = 0; captured && !hasAlpha && i < pixels.size(); ++i) {
+            hasAlpha = (pixels[i] >> 24) != 0;
+        }
+
+        // 舊式圖示：遮罩為白色的像素透明，其餘不透明
+        if (captured && !hasAlpha) {
+            std::vector<uint32_t> mask(pixels.size());
+            captured = GetDIBits(hdc, iconInfo.hbmMask, 0, height, mask.data(), &info, DIB_RGB_COLORS) == (int)height;
+            for (size_t i = 0; captured && i < pixels.size(); ++i) {
+                pixels[i] = (mask[i] & 0x00FFFFFF) ? 0 : (pixels[i] | 0xFF000000);
+            }
+        }
+        ReleaseDC(nullptr, hdc);
+    }
+
+    if (iconInfo.hbmColor) {
+        DeleteObject(iconInfo.hbmColor);
+    }
+    if (iconInfo.hbmMask) {
+        DeleteObject(iconInfo.hbmMask);
+    }
+
+    if (!captured) {
+        pixels.clear();
+        return false;
+    }
+    IconCacheStore::Premultiply(pixels.data(), pixels.size());
+    return true;
+}
+
+HICON CreateIconFromPixels(const uint32_t* pixels, uint32_t width, uint32_t height) {
+    BITMAPINFO info;
+    InitBitmapInfo(info, width, height);
+
+    void* bits = nullptr;
+    HBITMAP color = CreateDIBSection(nullptr, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!color) {
+        return nullptr;
+    }
+
+    // 圖示的彩色點陣圖使用直通 alpha
+    size_t count = size_t(width) * height;
+    std::memcpy(bits, pixels, count * sizeof(uint32_t));
+    IconCacheStore::Unpremultiply(static_cast<uint32_t*>(bits), count);
+
+    ICONINFO iconInfo = {};
+    iconInfo.fIcon = TRUE;
+    iconInfo.hbmColor = color;
+    iconInfo.hbmMask = CreateBitmap((int)width, (int)height, 1, 1, nullptr);
+
+    HICON icon = iconInfo.hbmMask ? CreateIconIndirect(&iconInfo) : nullptr;
+
+    if (iconInfo.hbmMask) {
+        DeleteObject(iconInfo.hbmMask);
+    }
+    DeleteObject(color);
+    return icon;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <vector>
+
+// HICON 與預乘 alpha 的 BGRA 點陣圖（由上而下）互轉，供持久圖示快取使用
+
+// 讀出圖示的彩色點陣圖；沒有 alpha 通道的舊式圖示以遮罩決定透明度（不支援單色圖示）
+bool CaptureIconPixels(HICON icon, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height);
+
+// 以點陣圖建立新的圖示（呼叫者負責 DestroyIcon）；失敗時回傳 nullptr
+HICON CreateIconFromPixels(const uint32_t* pixels, uint32_t width, uint32_t height);
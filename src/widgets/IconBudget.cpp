@@ -0,0 +1,55 @@
+#include "IconBudget.h"
+#include <algorithm>
+
+IconBudget::IconBudget() {
+    limits_.maxBytes = DEFAULT_MAX_BYTES;
+    limits_.maxHandles = DEFAULT_MAX_HANDLES;
+}
+
+bool IconBudget::IsOverBudget(const Usage& usage) const {
+    return usage.bytes > limits_.maxBytes || usage.handles > limits_.maxHandles;
+}
+
+bool IconBudget::IsAboveLowWatermark(const Usage& usage) const {
+    return usage.bytes > limits_.maxBytes / 100 * LOW_WATERMARK_PERCENT ||
+           usage.handles > limits_.maxHandles * LOW_WATERMARK_PERCENT / 100;
+}
+
+IconBudget::Usage IconBudget::SelectVictims(std::vector<Candidate>& candidates, Usage usage,
+                                            std::vector<uint64_t>& victims) const {
+    if (!IsOverBudget(usage)) {
+        return usage;
+    }
+
+    size_t targetBytes = limits_.maxBytes / 100 * LOW_WATERMARK_PERCENT;
+    size_t targetHandles = limits_.maxHandles * LOW_WATERMARK_PERCENT / 100;
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.tier != b.tier) {
+            return a.tier < b.tier;
+        }
+        return a.lastUse < b.lastUse;
+    });
+
+    for (const auto& candidate : candidates) {
+        if (usage.bytes <= targetBytes && usage.handles <= targetHandles) {
+            break;
+        }
+        if (candidate.tier == TIER_VISIBLE) {
+            break;
+        }
+        victims.push_back(candidate.id);
+        usage.bytes -= (std::min)(usage.bytes, candidate.usage.bytes);
+        usage.handles -= (std::min)(usage.handles, candidate.usage.handles);
+    }
+    return usage;
+}
+
+IconBudget::Usage IconBudget::GetIconUsage(uint32_t size) {
+    // 遮罩每列補齊到 16 位元
+    size_t maskStride = ((size_t(size) + 15) / 16) * 2;
+    Usage usage;
+    usage.bytes = size_t(size) * size * 4 + maskStride * size;
+    usage.handles = 2;
+    return usage;
+}
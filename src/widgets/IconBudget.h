@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 圖示記憶體預算（位元組與 GDI 控制代碼數）與淘汰順序（不依賴 Windows）
+//
+// 呼叫者列出目前持有的每個圖示（識別值、所屬的層級、最近使用時間與用量），
+// SelectVictims 依「層級由低到高、同層級由久未使用到最近使用」選出要釋放的圖示，
+// 直到用量降到上限的 LOW_WATERMARK_PERCENT 以下（留一段空間，避免每次加入都觸發淘汰）。
+// 畫面上看得到的圖示（TIER_VISIBLE）永不淘汰：可見的圖示數受螢幕面積限制，用量自然有上限。
+// 被淘汰的圖示之後需要時重新取得（持久快取內有點陣圖時不必呼叫殼層）。
+class IconBudget {
+public:
+    enum Tier {
+        TIER_UNUSED_SIZE = 0,   // 柵欄已改用其他尺寸，這個尺寸不再繪製
+        TIER_COLLAPSED = 1,     // 柵欄已收合
+        TIER_OFFSCREEN = 2,     // 捲動範圍外（上下一頁以外）
+        TIER_NEARBY = 3,        // 上下一頁內（捲動時會先在背景預取）
+        TIER_VISIBLE = 4        // 目前畫面上
+    };
+
+    struct Limits {
+        size_t maxBytes;        // 圖示點陣圖的位元組（含圖集與待寫入持久快取的點陣圖）
+        size_t maxHandles;      // GDI 控制代碼（每個彩色圖示為色彩與遮罩兩個點陣圖）
+    };
+
+    struct Usage {
+        size_t bytes;
+        size_t handles;
+    };
+
+    struct Candidate {
+        uint64_t id;
+        Tier tier;
+        uint64_t lastUse;       // 越大越近
+        Usage usage;
+    };
+
+    static const size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+    static const size_t DEFAULT_MAX_HANDLES = 2000;     // 每個程序上限 10000
+    static const size_t LOW_WATERMARK_PERCENT = 75;
+
+    IconBudget();
+
+    void SetLimits(const Limits& limits) { limits_ = limits; }
+    const Limits& GetLimits() const { return limits_; }
+
+    // 用量是否超過上限
+    bool IsOverBudget(const Usage& usage) const;
+
+    // 用量是否超過淘汰的目標（上限的 LOW_WATERMARK_PERCENT）：此時不再預取
+    bool IsAboveLowWatermark(const Usage& usage) const;
+
+    // 從 candidates（順序會被改變）選出要淘汰的識別值附加到 victims，回傳淘汰後的預估用量
+    Usage SelectVictims(std::vector<Candidate>& candidates, Usage usage, std::vector<uint64_t>& victims) const;
+
+    // size × size 的彩色圖示（32 位元色彩點陣圖加單色遮罩）的用量
+    static Usage GetIconUsage(uint32_t size);
+
+private:
+    Limits limits_;
+};
@@ -0,0 +1,183 @@
+#include "IconCache.h"
+#include <cwctype>
+
+namespace {
+
+// 圖示來自檔案本身（或其目標）的副檔名，必須以完整路徑為鍵
+const wchar_t* const PER_FILE_EXTENSIONS[] = {
+    L"exe", L"lnk", L"ico", L"cur", L"ani", L"url", L"dll", L"cpl", L"scr", L"msc", L"appref-ms", L"website"
+};
+
+} // namespace
+
+IconCache::IconCache()
+    : hits_(0)
+    , misses_(0)
+    , inserts_(0)
+    , evictions_(0)
+    , clock_(0)
+    , bytes_(0) {
+}
+
+IconCache::~IconCache() {
+    Clear();
+}
+
+std::wstring IconCache::MakeKey(const std::wstring& filePath) {
+    size_t nameStart = filePath.find_last_of(L"\\/");
+    nameStart = (nameStart != std::wstring::npos) ? nameStart + 1 : 0;
+    size_t dot = filePath.find_last_of(L'.');
+    if (dot == std::wstring::npos || dot < nameStart || dot + 1 >= filePath.size()) {
+        return filePath;
+    }
+
+    std::wstring extension = filePath.substr(dot + 1);
+    for (auto& ch : extension) {
+        ch = static_cast<wchar_t>(std::towlower(ch));
+    }
+    for (const wchar_t* perFile : PER_FILE_EXTENSIONS) {
+        if (extension == perFile) {
+            return filePath;
+        }
+    }
+
+    // 「*.」開頭不會是合法路徑，與路徑鍵不會衝突
+    return L"*." + extension;
+}
+
+HICON IconCache::Acquire(const std::wstring& key, int size) {
+    auto it = entries_.find(Key(key, size));
+    if (it == entries_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    ++it->second.references;
+    it->second.lastUse = ++clock_;
+    return it->second.icon;
+}
+
+HICON IconCache::Insert(const std::wstring& key, int size, HICON icon) {
+    Key entryKey(key, size);
+    auto it = entries_.find(entryKey);
+    if (it != entries_.end()) {
+        // 其他柵欄已先提取到相同的圖示
+        DestroyIcon(icon);
+        ++it->second.references;
+        it->second.lastUse = ++clock_;
+        return it->second.icon;
+    }
+
+    ++inserts_;
+    bytes_ += IconBudget::GetIconUsage((uint32_t)size).bytes;
+    entries_.emplace(entryKey, Entry{ icon, 1, ++clock_ });
+    keysByIcon_.emplace(icon, std::move(entryKey));
+    return icon;
+}
+
+HICON IconCache::Replace(const std::wstring& key, int size, HICON icon) {
+    auto it = entries_.find(Key(key, size));
+    if (it == entries_.end()) {
+        DestroyIcon(icon);
+        return nullptr;
+    }
+
+    HICON previous = it->second.icon;
+    keysByIcon_.erase(previous);
+    keysByIcon_.emplace(icon, it->first);
+    it->second.icon = icon;
+    return previous;
+}
+
+void IconCache::Release(HICON icon) {
+    auto keyIt = keysByIcon_.find(icon);
+    if (keyIt == keysByIcon_.end()) {
+        return;
+    }
+
+    auto it = entries_.find(keyIt->second);
+    if (it != entries_.end() && --it->second.references == 0) {
+        bytes_ -= IconBudget::GetIconUsage((uint32_t)it->first.second).bytes;
+        DestroyIcon(it->second.icon);
+        entries_.erase(it);
+        keysByIcon_.erase(keyIt);
+    }
+}
+
+void IconCache::Touch(HICON icon) {
+    auto keyIt = keysByIcon_.find(icon);
+    if (keyIt == keysByIcon_.end()) {
+        return;
+    }
+
+    auto it = entries_.find(keyIt->second);
+    if (it != entries_.end()) {
+        it->second.lastUse = ++clock_;
+    }
+}
+
+void IconCache::Evict(HICON icon) {
+    auto keyIt = keysByIcon_.find(icon);
+    if (keyIt == keysByIcon_.end()) {
+        return;
+    }
+
+    auto it = entries_.find(keyIt->second);
+    if (it != entries_.end()) {
+        ++evictions_;
+        bytes_ -= IconBudget::GetIconUsage((uint32_t)it->first.second).bytes;
+        DestroyIcon(it->second.icon);
+        entries_.erase(it);
+    }
+    keysByIcon_.erase(keyIt);
+}
+
+bool IconCache::GetEntryInfo(HICON icon, EntryInfo& info) const {
+    auto keyIt = keysByIcon_.find(icon);
+    if (keyIt == keysByIcon_.end()) {
+        return false;
+    }
+
+    auto it = entries_.find(keyIt->second);
+    if (it == entries_.end()) {
+        return false;
+    }
+
+    info.key = &it->first.first;
+    info.size = it->first.second;
+    info.lastUse = it->second.lastUse;
+    info.usage = IconBudget::GetIconUsage((uint32_t)it->first.second);
+    return true;
+}
+
+IconBudget::Usage IconCache::GetUsage() const {
+    IconBudget::Usage usage;
+    usage.bytes = bytes_;
+    usage.handles = entries_.size() * IconBudget::GetIconUsage(0).handles;
+    return usage;
+}
+
+void IconCache::Clear() {
+    for (auto& pair : entries_) {
+        DestroyIcon(pair.second.icon);
+    }
+    entries_.clear();
+    keysByIcon_.clear();
+    bytes_ = 0;
+}
+
+IconCache::Stats IconCache::GetStats() const {
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.inserts = inserts_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    stats.evictions = evictions_;
+    stats.references = 0;
+    for (const auto& pair : entries_) {
+        stats.references += pair.second.references;
+    }
+    return stats;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "IconBudget.h"
+#include <windows.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// 跨柵欄共用的圖示快取（引用計數）
+// 同一類型的檔案（例如所有 .txt）共用同一個 HICON，提取次數與 GDI 用量只與不同圖示的數量相關。
+// 鍵在 UI 執行緒上只由路徑算出（不呼叫殼層）：一般檔案以副檔名為鍵，
+// 自帶圖示的檔案（.exe、.lnk、.ico 等）與沒有副檔名的項目（多半是資料夾）以完整路徑為鍵。
+class IconCache {
+public:
+    struct Stats {
+        uint64_t hits;      // Acquire 找到已快取的圖示
+        uint64_t misses;    // Acquire 找不到，需要提取
+        uint64_t inserts;   // 實際加入的提取結果
+        size_t entries;     // 目前持有的 HICON 數量
+        size_t references;  // 所有圖示的引用總數
+        size_t bytes;       // 所有圖示的點陣圖位元組（依尺寸估算）
+        uint64_t evictions; // 因超出預算而釋放的圖示
+    };
+
+    // 單一圖示的淘汰資訊
+    struct EntryInfo {
+        const std::wstring* key;
+        int size;
+        uint64_t lastUse;
+        IconBudget::Usage usage;
+    };
+
+    IconCache();
+    ~IconCache();
+
+    IconCache(const IconCache&) = delete;
+    IconCache& operator=(const IconCache&) = delete;
+
+    // 檔案對應的快取鍵
+    static std::wstring MakeKey(const std::wstring& filePath);
+
+    // 是否為檔案類型的鍵（「*.ext」）；類型圖示取決於檔案關聯，與個別檔案的修改時間無關
+    static bool IsTypeKey(const std::wstring& key) { return key.compare(0, 2, L"*.") == 0; }
+
+    // 取得快取的圖示並增加引用；沒有時回傳 nullptr
+    HICON Acquire(const std::wstring& key, int size);
+
+    // 加入提取結果（取得 icon 的擁有權）並增加一次引用；已有相同鍵時釋放 icon、回傳既有的圖示
+    HICON Insert(const std::wstring& key, int size, HICON icon);
+
+    // 以新的提取結果取代既有的圖示（取得 icon 的擁有權，引用數不變），回傳被取代的圖示：
+    // 呼叫者須把引用它的位置改為 icon 後再釋放它。沒有相同鍵時釋放 icon 並回傳 nullptr
+    HICON Replace(const std::wstring& key, int size, HICON icon);
+
+    // 減少引用，歸零時釋放圖示
+    void Release(HICON icon);
+
+    // 記錄圖示被繪製（淘汰時以最近使用時間排序）
+    void Touch(HICON icon);
+
+    // 不論引用立即釋放圖示；呼叫者須先清除所有引用它的位置
+    void Evict(HICON icon);
+
+    bool GetEntryInfo(HICON icon, EntryInfo& info) const;
+
+    // 目前持有的所有圖示的用量
+    IconBudget::Usage GetUsage() const;
+
+    // 目前的使用時間：之後 Acquire / Insert / Touch 的圖示，lastUse 都大於它
+    uint64_t GetClock() const { return clock_; }
+
+    // 釋放所有圖示（不論引用）
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        HICON icon;
+        size_t references;
+        uint64_t lastUse;
+    };
+
+    using Key = std::pair<std::wstring, int>;   // 快取鍵、尺寸
+
+    std::map<Key, Entry> entries_;
+    std::unordered_map<HICON, Key> keysByIcon_;
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t inserts_;
+    uint64_t evictions_;
+    uint64_t clock_;        // 每次使用遞增
+    size_t bytes_;
+};
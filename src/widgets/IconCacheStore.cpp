@@ -0,0 +1,343 @@
+#include "IconCacheStore.h"
+#include "core/StringCodec.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace {
+
+// 檢查 [offset, offset + length) 是否落在 [0, limit) 之內
+bool InRange(uint64_t offset, uint64_t length, uint64_t limit) {
+    return offset <= limit && length <= limit - offset;
+}
+
+// 點陣圖資料起點的對齊（方便以 SIMD 處理整列像素）
+const uint64_t PIXEL_DATA_ALIGNMENT = 16;
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+IconCacheStore::IconCacheStore()
+    : header_(nullptr)
+    , records_(nullptr)
+    , stringPool_(nullptr)
+    , pixelData_(nullptr)
+    , pendingBytes_(0)
+    , pendingLimit_(ICON_CACHE_MAX_PENDING_BYTES) {
+}
+
+uint64_t IconCacheStore::HashKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::set<IconCacheStore::Key> IconCacheStore::ToUtf8Keys(const RetainKeys& retain) {
+    std::set<Key> keys;
+    for (const auto& item : retain) {
+        keys.emplace(StringCodec::ToUtf8(item.first), item.second);
+    }
+    return keys;
+}
+
+bool IconCacheStore::Attach(const char* data, size_t size) {
+    ownedBuffer_.clear();
+    return AttachBuffer(data, size);
+}
+
+bool IconCacheStore::AttachBuffer(const char* data, size_t size) {
+    Detach();
+
+    if (size < sizeof(IconCacheFileHeader) ||
+        std::memcmp(data, ICON_CACHE_MAGIC, sizeof(ICON_CACHE_MAGIC)) != 0 ||
+        reinterpret_cast<uintptr_t>(data) % alignof(IconCacheFileHeader) != 0) {
+        return false;
+    }
+
+    const IconCacheFileHeader* header = reinterpret_cast<const IconCacheFileHeader*>(data);
+    if (header->version != ICON_CACHE_VERSION || header->headerSize < sizeof(IconCacheFileHeader)) {
+        return false;
+    }
+
+    // 只檢查表格範圍與對齊；各紀錄在查詢到時才檢查
+    if (header->recordTableOffset % alignof(IconCacheRecord) != 0 ||
+        header->pixelDataOffset % PIXEL_DATA_ALIGNMENT != 0 ||
+        !InRange(header->recordTableOffset, uint64_t(header->recordCount) * sizeof(IconCacheRecord), size) ||
+        !InRange(header->stringPoolOffset, header->stringPoolSize, size) ||
+        !InRange(header->pixelDataOffset, header->pixelDataSize, size)) {
+        return false;
+    }
+
+    header_ = header;
+    records_ = reinterpret_cast<const IconCacheRecord*>(data + header->recordTableOffset);
+    stringPool_ = data + header->stringPoolOffset;
+    pixelData_ = data + header->pixelDataOffset;
+    return true;
+}
+
+void IconCacheStore::Detach() {
+    header_ = nullptr;
+    records_ = nullptr;
+    stringPool_ = nullptr;
+    pixelData_ = nullptr;
+}
+
+bool IconCacheStore::IsRecordValid(const IconCacheRecord& record) const {
+    if (record.width == 0 || record.height == 0 ||
+        record.width > ICON_CACHE_MAX_DIMENSION || record.height > ICON_CACHE_MAX_DIMENSION ||
+        record.pixelOffset % sizeof(uint32_t) != 0) {
+        return false;
+    }
+    uint64_t pixelBytes = uint64_t(record.width) * record.height * sizeof(uint32_t);
+    return InRange(record.keyOffset, record.keyLength, header_->stringPoolSize) &&
+           InRange(record.pixelOffset, pixelBytes, header_->pixelDataSize);
+}
+
+const IconCacheRecord* IconCacheStore::FindRecord(const std::string& key, uint64_t hash,
+                                                  uint32_t requestedSize) const {
+    if (!header_) {
+        return nullptr;
+    }
+
+    const IconCacheRecord* end = records_ + header_->recordCount;
+    const IconCacheRecord* it = std::lower_bound(records_, end, std::make_pair(hash, requestedSize),
+        [](const IconCacheRecord& record, const std::pair<uint64_t, uint32_t>& value) {
+            return std::tie(record.keyHash, record.requestedSize) < std::tie(value.first, value.second);
+        });
+
+    // 雜湊相同時逐一比對鍵
+    for (; it != end && it->keyHash == hash && it->requestedSize == requestedSize; ++it) {
+        if (IsRecordValid(*it) && it->keyLength == key.size() &&
+            std::memcmp(stringPool_ + it->keyOffset, key.data(), key.size()) == 0) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+bool IconCacheStore::Find(const std::wstring& key, uint32_t requestedSize, IconCacheImage& image) {
+    std::string utf8Key = StringCodec::ToUtf8(key);
+
+    auto pendingIt = pending_.find(Key(utf8Key, requestedSize));
+    if (pendingIt != pending_.end()) {
+        image.stamp = pendingIt->second.stamp;
+        image.width = pendingIt->second.width;
+        image.height = pendingIt->second.height;
+        image.pixels = pendingIt->second.pixels.data();
+        return true;
+    }
+
+    const IconCacheRecord* record = FindRecord(utf8Key, HashKey(utf8Key), requestedSize);
+    if (!record) {
+        return false;
+    }
+    image.stamp.lastWriteTime = record->lastWriteTime;
+    image.stamp.fileSize = record->fileSize;
+    image.width = record->width;
+    image.height = record->height;
+    image.pixels = reinterpret_cast<const uint32_t*>(pixelData_ + record->pixelOffset);
+    return true;
+}
+
+bool IconCacheStore::Put(const std::wstring& key, uint32_t requestedSize, const IconCacheStamp& stamp,
+                         uint32_t width, uint32_t height, const uint32_t* pixels) {
+    if (width == 0 || height == 0 || width > ICON_CACHE_MAX_DIMENSION || height > ICON_CACHE_MAX_DIMENSION) {
+        return false;
+    }
+
+    Key pendingKey(StringCodec::ToUtf8(key), requestedSize);
+    size_t bytes = size_t(width) * height * sizeof(uint32_t);
+    auto it = pending_.find(pendingKey);
+    size_t replaced = (it != pending_.end()) ? it->second.pixels.size() * sizeof(uint32_t) : 0;
+    if (pendingBytes_ - replaced + bytes > pendingLimit_) {
+        return false;
+    }
+
+    Pending& entry = (it != pending_.end()) ? it->second : pending_[std::move(pendingKey)];
+    pendingBytes_ = pendingBytes_ - replaced + bytes;
+    entry.stamp = stamp;
+    entry.width = width;
+    entry.height = height;
+    entry.pixels.assign(pixels, pixels + size_t(width) * height);
+    return true;
+}
+
+uint32_t IconCacheStore::CountUnretained(const RetainKeys& retain) const {
+    std::set<Key> keys = ToUtf8Keys(retain);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < GetAttachedCount(); ++i) {
+        const IconCacheRecord& record = records_[i];
+        if (IsRecordValid(record) &&
+            !keys.count(Key(std::string(stringPool_ + record.keyOffset, record.keyLength), record.requestedSize))) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+std::string IconCacheStore::Serialize(const RetainKeys* retain, uint64_t maxPixelBytes) {
+    struct Source {
+        const std::string* key;
+        uint64_t hash;
+        uint32_t requestedSize;
+        IconCacheStamp stamp;
+        uint32_t width;
+        uint32_t height;
+        const char* pixels;
+    };
+
+    std::set<Key> retainKeys;
+    if (retain) {
+        retainKeys = ToUtf8Keys(*retain);
+    }
+
+    std::vector<Source> sources;
+    sources.reserve(pending_.size() + GetAttachedCount());
+
+    for (const auto& item : pending_) {
+        if (retain && !retainKeys.count(item.first)) {
+            continue;
+        }
+        const Pending& entry = item.second;
+        sources.push_back({ &item.first.first, HashKey(item.first.first), item.first.second, entry.stamp,
+                            entry.width, entry.height, reinterpret_cast<const char*>(entry.pixels.data()) });
+    }
+
+    // 附加的紀錄中有效且未被取代的（預先配置容量，sources 內的指標不會失效）
+    std::vector<std::string> attachedKeys;
+    attachedKeys.reserve(GetAttachedCount());
+    for (uint32_t i = 0; i < GetAttachedCount(); ++i) {
+        const IconCacheRecord& record = records_[i];
+        if (!IsRecordValid(record)) {
+            continue;
+        }
+        Key recordKey(std::string(stringPool_ + record.keyOffset, record.keyLength), record.requestedSize);
+        if (pending_.count(recordKey) || HashKey(recordKey.first) != record.keyHash ||
+            (retain && !retainKeys.count(recordKey))) {
+            continue;
+        }
+
+        IconCacheStamp stamp;
+        stamp.lastWriteTime = record.lastWriteTime;
+        stamp.fileSize = record.fileSize;
+        attachedKeys.push_back(std::move(recordKey.first));
+        sources.push_back({ &attachedKeys.back(), record.keyHash, record.requestedSize, stamp,
+                            record.width, record.height, pixelData_ + record.pixelOffset });
+    }
+
+    // 超過總量上限時保留尺寸較小的（一筆 256px 的點陣圖相當於 16 筆 64px）；
+    // Put 加入的排在前面，同尺寸時優先保留
+    uint64_t totalPixelBytes = 0;
+    for (const auto& source : sources) {
+        totalPixelBytes += uint64_t(source.width) * source.height * sizeof(uint32_t);
+    }
+    if (totalPixelBytes > maxPixelBytes) {
+        std::stable_sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+            return uint64_t(a.width) * a.height < uint64_t(b.width) * b.height;
+        });
+        uint64_t keptBytes = 0;
+        size_t kept = 0;
+        while (kept < sources.size()) {
+            uint64_t bytes = uint64_t(sources[kept].width) * sources[kept].height * sizeof(uint32_t);
+            if (keptBytes + bytes > maxPixelBytes) {
+                break;
+            }
+            keptBytes += bytes;
+            ++kept;
+        }
+        sources.resize(kept);
+    }
+
+    std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+        return std::tie(a.hash, a.requestedSize, *a.key) < std::tie(b.hash, b.requestedSize, *b.key);
+    });
+
+    std::vector<IconCacheRecord> recordTable;
+    std::string stringPool;
+    uint64_t pixelDataSize = 0;
+    recordTable.reserve(sources.size());
+    for (const auto& source : sources) {
+        IconCacheRecord record = {};
+        record.keyHash = source.hash;
+        record.lastWriteTime = source.stamp.lastWriteTime;
+        record.fileSize = source.stamp.fileSize;
+        record.pixelOffset = pixelDataSize;
+        record.keyOffset = static_cast<uint32_t>(stringPool.size());
+        record.keyLength = static_cast<uint32_t>(source.key->size());
+        record.requestedSize = source.requestedSize;
+        record.width = source.width;
+        record.height = source.height;
+        stringPool += *source.key;
+        pixelDataSize += uint64_t(source.width) * source.height * sizeof(uint32_t);
+        recordTable.push_back(record);
+    }
+
+    IconCacheFileHeader header = {};
+    std::memcpy(header.magic, ICON_CACHE_MAGIC, sizeof(header.magic));
+    header.version = ICON_CACHE_VERSION;
+    header.headerSize = sizeof(IconCacheFileHeader);
+    header.recordCount = static_cast<uint32_t>(recordTable.size());
+    header.recordTableOffset = sizeof(IconCacheFileHeader);
+    header.stringPoolOffset = header.recordTableOffset +
+                              header.recordCount * static_cast<uint32_t>(sizeof(IconCacheRecord));
+    header.stringPoolSize = static_cast<uint32_t>(stringPool.size());
+    header.pixelDataOffset = AlignUp(uint64_t(header.stringPoolOffset) + header.stringPoolSize,
+                                     PIXEL_DATA_ALIGNMENT);
+    header.pixelDataSize = pixelDataSize;
+
+    std::string output;
+    output.reserve(header.pixelDataOffset + pixelDataSize);
+    output.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.append(reinterpret_cast<const char*>(recordTable.data()),
+                  recordTable.size() * sizeof(IconCacheRecord));
+    output += stringPool;
+    output.resize(header.pixelDataOffset, '\0');
+    for (const auto& source : sources) {
+        output.append(source.pixels, size_t(source.width) * source.height * sizeof(uint32_t));
+    }
+
+    // 改為附加到新的結果（原本附加的緩衝區與 Put 的資料都已複製進去）
+    pending_.clear();
+    pendingBytes_ = 0;
+    ownedBuffer_ = std::move(output);
+    AttachBuffer(ownedBuffer_.data(), ownedBuffer_.size());
+    return ownedBuffer_;
+}
+
+void IconCacheStore::Premultiply(uint32_t* pixels, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pixel = pixels[i];
+        uint32_t alpha = pixel >> 24;
+        if (alpha == 255) {
+            continue;
+        }
+        // (c * a + 127) / 255 的整數近似，三個色彩通道分別處理
+        uint32_t b = ((pixel & 0xFF) * alpha + 127) / 255;
+        uint32_t g = (((pixel >> 8) & 0xFF) * alpha + 127) / 255;
+        uint32_t r = (((pixel >> 16) & 0xFF) * alpha + 127) / 255;
+        pixels[i] = (alpha << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+void IconCacheStore::Unpremultiply(uint32_t* pixels, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pixel = pixels[i];
+        uint32_t alpha = pixel >> 24;
+        if (alpha == 255) {
+            continue;
+        }
+        if (alpha == 0) {
+            pixels[i] = 0;
+            continue;
+        }
+        uint32_t b = (std::min)(((pixel & 0xFF) * 255 + alpha / 2) / alpha, 255u);
+        uint32_t g = (std::min)((((pixel >> 8) & 0xFF) * 255 + alpha / 2) / alpha, 255u);
+        uint32_t r = (std::min)((((pixel >> 16) & 0xFF) * 255 + alpha / 2) / alpha, 255u);
+        pixels[i] = (alpha << 24) | (r << 16) | (g << 8) | b;
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 持久的圖示快取檔案（icons.cache，不依賴 Windows，可在 Linux 上讀寫與測試）
+//
+// 每筆紀錄是一個快取鍵（IconCache::MakeKey）在某個請求尺寸下的圖示點陣圖，
+// 連同提取時來源檔案的修改時間與大小。啟動時映射檔案後直接以這些點陣圖建立圖示，
+// 不必再呼叫殼層；來源是否變更由背景提取重新檢查。
+//
+// 格式（小端序；所有偏移量皆相對於檔案開頭）：固定標頭 + 紀錄表（依鍵雜湊與尺寸排序，
+// 可直接二分搜尋）+ 字串池 + 點陣圖資料（預乘 alpha 的 BGRA，由上而下，16 位元組對齊）。
+// Attach 只檢查標頭與表格範圍，各紀錄的字串與像素範圍在第一次查詢到時才檢查。
+
+const char ICON_CACHE_MAGIC[8] = { 'I', 'K', 'I', 'C', 'A', 'C', 'H', 'E' };
+const uint32_t ICON_CACHE_VERSION = 1;
+
+// 單一圖示的邊長上限（超過的紀錄視為損壞）
+const uint32_t ICON_CACHE_MAX_DIMENSION = 1024;
+
+// Serialize 寫出的點陣圖總量上限（超過時先捨棄尺寸最大的紀錄）
+const uint64_t ICON_CACHE_MAX_PIXEL_BYTES = 64ull << 20;
+
+// Put 暫存於記憶體、尚未寫出的點陣圖總量上限（超過時不再暫存，下次執行重新提取）
+const size_t ICON_CACHE_MAX_PENDING_BYTES = size_t(32) << 20;
+
+struct IconCacheFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordCount;
+    uint32_t recordTableOffset;
+    uint32_t stringPoolOffset;
+    uint32_t stringPoolSize;
+    uint64_t pixelDataOffset;
+    uint64_t pixelDataSize;
+};
+
+struct IconCacheRecord {
+    uint64_t keyHash;       // 快取鍵（UTF-8）的 FNV-1a 雜湊
+    uint64_t lastWriteTime; // 來源檔案的修改時間（平台原生單位）
+    uint64_t fileSize;      // 來源檔案的大小
+    uint64_t pixelOffset;   // 點陣圖資料內的偏移
+    uint32_t keyOffset;     // 字串池內的偏移（UTF-8）
+    uint32_t keyLength;
+    uint32_t requestedSize; // 請求的圖示尺寸
+    uint32_t width;         // 點陣圖實際的寬高（提取結果不一定等於請求尺寸）
+    uint32_t height;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(IconCacheFileHeader) == 48, "IconCacheFileHeader layout changed");
+static_assert(sizeof(IconCacheRecord) == 56, "IconCacheRecord layout changed");
+
+// 來源檔案的版本戳記：任一欄位不同即視為圖示可能已變更
+struct IconCacheStamp {
+    uint64_t lastWriteTime = 0;
+    uint64_t fileSize = 0;
+
+    bool operator==(const IconCacheStamp& other) const {
+        return lastWriteTime == other.lastWriteTime && fileSize == other.fileSize;
+    }
+    bool operator!=(const IconCacheStamp& other) const { return !(*this == other); }
+};
+
+// 查詢結果；pixels 指向映射的檔案或 IconCacheStore 內部的緩衝區，
+// 在下一次 Put / Serialize / Attach 之前有效
+struct IconCacheImage {
+    IconCacheStamp stamp;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    const uint32_t* pixels = nullptr;   // 預乘 alpha 的 BGRA，width * height 個像素
+};
+
+class IconCacheStore {
+public:
+    // Serialize 要保留的紀錄：（快取鍵, 請求尺寸）
+    using RetainKeys = std::set<std::pair<std::wstring, uint32_t>>;
+
+    IconCacheStore();
+
+    IconCacheStore(const IconCacheStore&) = delete;
+    IconCacheStore& operator=(const IconCacheStore&) = delete;
+
+    // 附加讀取的快取檔案（通常是 MappedFile）；緩衝區在 Detach 或下一次 Serialize 之前必須保持有效。
+    // 格式不符時回傳 false，之後的查詢只看 Put 加入的圖示
+    bool Attach(const char* data, size_t size);
+
+    // 不再引用附加的緩衝區（其中的紀錄一併捨棄）
+    void Detach();
+
+    // 查詢 key 在 requestedSize 下的圖示（Put 加入的優先）；紀錄損壞時視為不存在
+    bool Find(const std::wstring& key, uint32_t requestedSize, IconCacheImage& image);
+
+    // 加入或取代圖示；pixels 為預乘 alpha 的 BGRA（width * height 個像素）。
+    // 暫存的點陣圖會超過 GetPendingLimit 時不加入，回傳 false
+    bool Put(const std::wstring& key, uint32_t requestedSize, const IconCacheStamp& stamp,
+             uint32_t width, uint32_t height, const uint32_t* pixels);
+
+    // 自上次 Serialize（或建立）後是否有 Put
+    bool IsDirty() const { return !pending_.empty(); }
+
+    // Put 暫存的點陣圖位元組數與其上限
+    size_t GetPendingBytes() const { return pendingBytes_; }
+    size_t GetPendingLimit() const { return pendingLimit_; }
+    void SetPendingLimit(size_t maxBytes) { pendingLimit_ = maxBytes; }
+
+    // 附加的有效紀錄中不在 retain 內的筆數（Serialize 時會被捨棄）
+    uint32_t CountUnretained(const RetainKeys& retain) const;
+
+    // 合併附加的紀錄（有效且未被取代的）與 Put 加入的圖示，序列化為新的快取檔案。
+    // retain 不為 nullptr 時只保留其中的（快取鍵, 尺寸）；點陣圖總量超過 maxPixelBytes 時
+    // 先捨棄尺寸最大的紀錄（同尺寸時保留 Put 加入的）。
+    // 之後改為附加到內部保存的結果：原本附加的緩衝區不再被引用，可以關閉或覆寫
+    std::string Serialize(const RetainKeys* retain = nullptr, uint64_t maxPixelBytes = ICON_CACHE_MAX_PIXEL_BYTES);
+
+    // 是否已附加快取檔案或 Serialize 的結果
+    bool IsAttached() const { return header_ != nullptr; }
+
+    // 附加的紀錄數（不含 Put 加入的）
+    uint32_t GetAttachedCount() const { return header_ ? header_->recordCount : 0; }
+
+    // 直通 alpha 與預乘 alpha 互轉（就地處理 count 個 BGRA 像素）
+    static void Premultiply(uint32_t* pixels, size_t count);
+    static void Unpremultiply(uint32_t* pixels, size_t count);
+
+private:
+    struct Pending {
+        IconCacheStamp stamp;
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint32_t> pixels;
+    };
+
+    using Key = std::pair<std::string, uint32_t>;   // 快取鍵（UTF-8）、請求尺寸
+
+    static uint64_t HashKey(const std::string& key);
+
+    // retain 的鍵轉為 UTF-8
+    static std::set<Key> ToUtf8Keys(const RetainKeys& retain);
+
+    // 紀錄的字串與像素範圍（第一次查詢到時檢查）
+    bool IsRecordValid(const IconCacheRecord& record) const;
+    const IconCacheRecord* FindRecord(const std::string& key, uint64_t hash, uint32_t requestedSize) const;
+
+    bool AttachBuffer(const char* data, size_t size);
+
+    const IconCacheFileHeader* header_;
+    const IconCacheRecord* records_;
+    const char* stringPool_;
+    const char* pixelData_;
+
+    std::map<Key, Pending> pending_;
+    size_t pendingBytes_;       // pending_ 內點陣圖的位元組數
+    size_t pendingLimit_;
+    std::string ownedBuffer_;   // Serialize 的結果（之後附加到這裡）
+};
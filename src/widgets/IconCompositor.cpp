@@ -0,0 +1,269 @@
+#include "IconCompositor.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ICON_COMPOSITOR_SSE2 1
+#endif
+
+// AVX2 只在 x64 上提供，執行時確認 CPU 與作業系統支援後才使用
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define ICON_COMPOSITOR_AVX2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ICON_COMPOSITOR_AVX2_TARGET
+#else
+#define ICON_COMPOSITOR_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ICON_COMPOSITOR_NEON 1
+#endif
+
+namespace {
+
+// x / 255 四捨五入（x 不超過 255 * 255），所有版本共用同一個近似
+inline uint32_t Div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+inline uint32_t BlendPixel(uint32_t src, uint32_t dst) {
+    uint32_t alpha = src >> 24;
+    if (alpha == 255) {
+        return src;
+    }
+    if (src == 0) {
+        return dst;
+    }
+
+    uint32_t inverse = 255 - alpha;
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t channel = ((src >> shift) & 0xFF) + Div255(((dst >> shift) & 0xFF) * inverse);
+        result |= ((channel > 255) ? 255 : channel) << shift;
+    }
+    return result;
+}
+
+void BlendRowScalar(uint32_t* dst, const uint32_t* src, uint32_t width) {
+    for (uint32_t x = 0; x < width; ++x) {
+        dst[x] = BlendPixel(src[x], dst[x]);
+    }
+}
+
+#ifdef ICON_COMPOSITOR_SSE2
+
+// 兩個像素（8 個 16 位元通道）的 dst * (255 - alpha) / 255
+inline __m128i ScaleSse2(__m128i dst16, __m128i src16) {
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src16, _MM_SHUFFLE(3, 3, 3, 3)),
+                                        _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i product = _mm_mullo_epi16(dst16, _mm_sub_epi16(_mm_set1_epi16(255), alpha));
+    product = _mm_add_epi16(product, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+void BlendRowSse2(uint32_t* dst, const uint32_t* src, uint32_t width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi32(255);
+    uint32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+
+        // 圖示多半是整片透明或不透明：四個像素都是時不必計算
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), opaque)) == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), s);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF) {
+            continue;
+        }
+
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+        __m128i low = ScaleSse2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero));
+        __m128i high = ScaleSse2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_adds_epu8(s, _mm_packus_epi16(low, high)));
+    }
+    BlendRowScalar(dst + x, src + x, width - x);
+}
+
+#endif
+
+#ifdef ICON_COMPOSITOR_AVX2
+
+ICON_COMPOSITOR_AVX2_TARGET
+inline __m256i ScaleAvx2(__m256i dst16, __m256i src16) {
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(src16, _MM_SHUFFLE(3, 3, 3, 3)),
+                                           _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i product = _mm256_mullo_epi16(dst16, _mm256_sub_epi16(_mm256_set1_epi16(255), alpha));
+    product = _mm256_add_epi16(product, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+// 與 SSE2 版本相同，一次八個像素（拆開與壓縮都在各自的 128 位元半部內進行，順序不變）
+ICON_COMPOSITOR_AVX2_TARGET
+void BlendRowAvx2(uint32_t* dst, const uint32_t* src, uint32_t width) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi32(255);
+    uint32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_srli_epi32(s, 24), opaque)) == -1) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), s);
+            continue;
+        }
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(s, zero)) == -1) {
+            continue;
+        }
+
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + x));
+        __m256i low = ScaleAvx2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero));
+        __m256i high = ScaleAvx2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x),
+                            _mm256_adds_epu8(s, _mm256_packus_epi16(low, high)));
+    }
+    // 尾端呼叫非 VEX 編碼的函式前清除上半部，避免 AVX / SSE 轉換的延遲
+    _mm256_zeroupper();
+    BlendRowScalar(dst + x, src + x, width - x);
+}
+
+bool DetectAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // 作業系統須保存 YMM 暫存器（OSXSAVE 與 XCR0 的 SSE / AVX 狀態）
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif
+
+#ifdef ICON_COMPOSITOR_NEON
+
+void BlendRowNeon(uint32_t* dst, const uint32_t* src, uint32_t width) {
+    // 每個像素的 alpha 位元組複製到該像素的四個通道
+    static const uint8_t ALPHA_INDEX[16] = { 3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15 };
+    const uint8x16_t alphaIndex = vld1q_u8(ALPHA_INDEX);
+    const uint16x8_t bias = vdupq_n_u16(128);
+    uint32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        uint8x16_t s = vld1q_u8(reinterpret_cast<const uint8_t*>(src + x));
+        uint32x4_t s32 = vreinterpretq_u32_u8(s);
+        if (vminvq_u32(vshrq_n_u32(s32, 24)) == 255) {
+            vst1q_u8(reinterpret_cast<uint8_t*>(dst + x), s);
+            continue;
+        }
+        if (vmaxvq_u32(s32) == 0) {
+            continue;
+        }
+
+        uint8x16_t d = vld1q_u8(reinterpret_cast<const uint8_t*>(dst + x));
+        uint8x16_t inverse = vmvnq_u8(vqtbl1q_u8(s, alphaIndex));
+        uint16x8_t low = vaddq_u16(vmull_u8(vget_low_u8(d), vget_low_u8(inverse)), bias);
+        uint16x8_t high = vaddq_u16(vmull_high_u8(d, inverse), bias);
+        low = vaddq_u16(low, vshrq_n_u16(low, 8));
+        high = vaddq_u16(high, vshrq_n_u16(high, 8));
+        uint8x16_t scaled = vshrn_high_n_u16(vshrn_n_u16(low, 8), high, 8);
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + x), vqaddq_u8(s, scaled));
+    }
+    BlendRowScalar(dst + x, src + x, width - x);
+}
+
+#endif
+
+using BlendRowFunction = void (*)(uint32_t*, const uint32_t*, uint32_t);
+
+BlendRowFunction GetBlendRow(IconCompositor::Kernel kernel) {
+    if (!IconCompositor::IsSupported(kernel)) {
+        return &BlendRowScalar;
+    }
+
+    switch (kernel) {
+#ifdef ICON_COMPOSITOR_SSE2
+    case IconCompositor::KERNEL_SSE2:
+        return &BlendRowSse2;
+#endif
+#ifdef ICON_COMPOSITOR_AVX2
+    case IconCompositor::KERNEL_AVX2:
+        return &BlendRowAvx2;
+#endif
+#ifdef ICON_COMPOSITOR_NEON
+    case IconCompositor::KERNEL_NEON:
+        return &BlendRowNeon;
+#endif
+    default:
+        return &BlendRowScalar;
+    }
+}
+
+} // namespace
+
+bool IconCompositor::IsSupported(Kernel kernel) {
+    switch (kernel) {
+    case KERNEL_SCALAR:
+        return true;
+#ifdef ICON_COMPOSITOR_SSE2
+    case KERNEL_SSE2:
+        return true;
+#endif
+#ifdef ICON_COMPOSITOR_AVX2
+    case KERNEL_AVX2: {
+        static const bool supported = DetectAvx2();
+        return supported;
+    }
+#endif
+#ifdef ICON_COMPOSITOR_NEON
+    case KERNEL_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+IconCompositor::Kernel IconCompositor::GetDefaultKernel() {
+    static const Kernel kernel = IsSupported(KERNEL_AVX2) ? KERNEL_AVX2
+                               : IsSupported(KERNEL_SSE2) ? KERNEL_SSE2
+                               : IsSupported(KERNEL_NEON) ? KERNEL_NEON
+                               : KERNEL_SCALAR;
+    return kernel;
+}
+
+const char* IconCompositor::GetKernelName(Kernel kernel) {
+    switch (kernel) {
+    case KERNEL_SSE2:
+        return "sse2";
+    case KERNEL_AVX2:
+        return "avx2";
+    case KERNEL_NEON:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+void IconCompositor::BlendOver(uint32_t* dst, size_t dstStride, const uint32_t* src, size_t srcStride,
+                               uint32_t width, uint32_t height) {
+    BlendOver(GetDefaultKernel(), dst, dstStride, src, srcStride, width, height);
+}
+
+void IconCompositor::BlendOver(Kernel kernel, uint32_t* dst, size_t dstStride, const uint32_t* src,
+                               size_t srcStride, uint32_t width, uint32_t height) {
+    BlendRowFunction blendRow = GetBlendRow(kernel);
+    for (uint32_t y = 0; y < height; ++y) {
+        blendRow(dst + y * dstStride, src + y * srcStride, width);
+    }
+}
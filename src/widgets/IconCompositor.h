@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 預乘 alpha 的 BGRA 合成（來源覆蓋目的：dst = src + dst * (255 - srcAlpha) / 255）
+// 依平台提供 SSE2（x86 / x64）、AVX2（執行時偵測）與 NEON（ARM）版本，另有純量版本作為參考；
+// 所有版本的除以 255 都使用相同的整數近似，結果逐位元相同。
+// 不依賴 Windows，可在 Linux 上測試與量測。
+class IconCompositor {
+public:
+    enum Kernel {
+        KERNEL_SCALAR,
+        KERNEL_SSE2,
+        KERNEL_AVX2,
+        KERNEL_NEON
+    };
+
+    // 目前的 CPU 與編譯目標是否支援該版本
+    static bool IsSupported(Kernel kernel);
+
+    // 執行時選用的版本（支援的版本中最快的）
+    static Kernel GetDefaultKernel();
+    static const char* GetKernelName(Kernel kernel);
+
+    // 將 width × height 的來源合成到目的；stride 以像素為單位
+    static void BlendOver(uint32_t* dst, size_t dstStride, const uint32_t* src, size_t srcStride,
+                          uint32_t width, uint32_t height);
+
+    // 指定版本（不支援時改用純量版本），供測試與量測比較
+    static void BlendOver(Kernel kernel, uint32_t* dst, size_t dstStride, const uint32_t* src, size_t srcStride,
+                          uint32_t width, uint32_t height);
+};
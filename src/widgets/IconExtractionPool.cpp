@@ -0,0 +1,238 @@
+#include "IconExtractionPool.h"
+#include <objbase.h>
+#include <algorithm>
+#include <tuple>
+
+bool IconExtractionPool::Key::operator<(const Key& other) const {
+    return std::tie(size, key) < std::tie(other.size, other.key);
+}
+
+bool IconExtractionPool::Job::operator<(const Job& other) const {
+    // 堆積頂端為可見度最高、序號最新的請求
+    if (priority != other.priority) {
+        return priority < other.priority;
+    }
+    return sequence < other.sequence;
+}
+
+IconExtractionPool::IconExtractionPool(Extractor extractor, UINT completionMessage, size_t workerCount)
+    : extractor_(extractor)
+    , completionMessage_(completionMessage)
+    , workerCount_((std::max)(workerCount, size_t(1)))
+    , nextSequence_(0)
+    , stopping_(false) {
+}
+
+IconExtractionPool::~IconExtractionPool() {
+    Stop();
+}
+
+void IconExtractionPool::Request(HWND target, const std::wstring& key, const std::wstring& filePath, int size,
+                                 Priority priority, const IconCacheStamp* unchanged) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+
+        Key jobKey = { size, key };
+        auto it = states_.find(jobKey);
+        if (it != states_.end()) {
+            std::vector<HWND>& targets = it->second.targets;
+            if (std::find(targets.begin(), targets.end(), target) == targets.end()) {
+                targets.push_back(target);
+            }
+            if (it->second.failed) {
+                // 最近失敗過：重試間隔內繼續顯示預設圖示
+                if (GetTickCount64() - it->second.failedAt < FAILED_RETRY_MS) {
+                    return;
+                }
+                it->second.failed = false;
+            } else if (it->second.running || it->second.priority >= priority) {
+                // 已在提取，或佇列中的優先權已足夠
+                return;
+            }
+        } else {
+            it = states_.emplace(jobKey, State()).first;
+            it->second.running = false;
+            it->second.failed = false;
+            it->second.targets.push_back(target);
+        }
+
+        it->second.sequence = ++nextSequence_;
+        it->second.priority = priority;
+        queue_.push_back({ priority, it->second.sequence, std::move(jobKey), filePath, unchanged != nullptr,
+                           unchanged ? *unchanged : IconCacheStamp() });
+        std::push_heap(queue_.begin(), queue_.end());
+
+        // 第一次請求時才啟動背景執行緒
+        if (workers_.empty()) {
+            for (size_t i = 0; i < workerCount_; ++i) {
+                workers_.emplace_back(&IconExtractionPool::ThreadProc, this);
+            }
+        }
+    }
+    wakeCondition_.notify_one();
+}
+
+void IconExtractionPool::TakeCompleted(HWND target, std::vector<Result>& results) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    notified_.erase(target);
+
+    auto split = std::stable_partition(completed_.begin(), completed_.end(),
+                                       [target](const Completed& item) { return item.target != target; });
+    for (auto it = split; it != completed_.end(); ++it) {
+        results.push_back(std::move(it->result));
+    }
+    completed_.erase(split, completed_.end());
+}
+
+void IconExtractionPool::Cancel(HWND target) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    notified_.erase(target);
+
+    // 沒有其他視窗等待時捨棄請求：佇列中的 Job 留在堆積裡，取出時因找不到狀態而略過；
+    // 提取中的完成後直接釋放
+    for (auto it = states_.begin(); it != states_.end();) {
+        std::vector<HWND>& targets = it->second.targets;
+        targets.erase(std::remove(targets.begin(), targets.end(), target), targets.end());
+        if (targets.empty()) {
+            it = states_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 已完成但尚未取走的結果改交給下一個等待的視窗
+    std::vector<Result> orphaned;
+    auto split = std::stable_partition(completed_.begin(), completed_.end(),
+                                       [target](const Completed& item) { return item.target != target; });
+    for (auto it = split; it != completed_.end(); ++it) {
+        orphaned.push_back(std::move(it->result));
+    }
+    completed_.erase(split, completed_.end());
+    for (auto& result : orphaned) {
+        result.targets.erase(std::remove(result.targets.begin(), result.targets.end(), target), result.targets.end());
+        Complete(std::move(result));
+    }
+}
+
+void IconExtractionPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+        states_.clear();
+    }
+    wakeCondition_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    for (auto& item : completed_) {
+        if (item.result.icon) {
+            DestroyIcon(item.result.icon);
+        }
+    }
+    completed_.clear();
+    notified_.clear();
+}
+
+void IconExtractionPool::Complete(Result&& result) {
+    // 每個視窗同時只有一則未處理的通知；已有通知或通知送達的視窗負責取走結果
+    for (HWND target : result.targets) {
+        bool pending = notified_.count(target) != 0;
+        if (!pending && PostMessageW(target, completionMessage_, 0, 0)) {
+            notified_.insert(target);
+            pending = true;
+        }
+        if (pending) {
+            completed_.push_back({ target, std::move(result) });
+            return;
+        }
+    }
+
+    // 沒有視窗能接收
+    if (result.icon) {
+        DestroyIcon(result.icon);
+    }
+}
+
+void IconExtractionPool::ThreadProc() {
+    // 殼層圖示介面需要 COM；降低優先權，避免與 UI 執行緒競爭
+    HRESULT comResult = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wakeCondition_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+            break;
+        }
+
+        std::pop_heap(queue_.begin(), queue_.end());
+        Job job = std::move(queue_.back());
+        queue_.pop_back();
+
+        // 已取消或被較新的請求取代
+        auto it = states_.find(job.key);
+        if (it == states_.end() || it->second.running || it->second.sequence != job.sequence) {
+            continue;
+        }
+        it->second.running = true;
+
+        lock.unlock();
+        Result result = {};
+        result.key = job.key.key;
+        result.size = job.key.size;
+        result.refresh = job.priority == PRIORITY_REFRESH;
+        bool extracted = extractor_(job.filePath, job.key.size, job.hasUnchanged ? &job.unchanged : nullptr, result);
+        lock.lock();
+
+        // 提取期間被取消（視窗已銷毀）或整個服務已停止
+        it = states_.find(job.key);
+        if (it == states_.end() || stopping_) {
+            if (result.icon) {
+                DestroyIcon(result.icon);
+            }
+            if (stopping_) {
+                break;
+            }
+            continue;
+        }
+
+        if (!extracted || !result.icon) {
+            if (result.icon) {
+                DestroyIcon(result.icon);
+                result.icon = nullptr;
+            }
+
+            // 重新檢查時來源未變更（或檢查失敗）：已顯示的圖示仍然有效
+            if (result.refresh) {
+                states_.erase(it);
+                continue;
+            }
+
+            // 保留失敗狀態，重試間隔內的請求直接忽略；通知視窗此圖示已有結果
+            it->second.running = false;
+            it->second.failed = true;
+            it->second.failedAt = GetTickCount64();
+            result.failed = true;
+            result.pixels.clear();
+            result.targets = it->second.targets;
+            Complete(std::move(result));
+            continue;
+        }
+
+        result.targets = std::move(it->second.targets);
+        states_.erase(it);
+        Complete(std::move(result));
+    }
+    lock.unlock();
+
+    if (SUCCEEDED(comResult)) {
+        CoUninitialize();
+    }
+}
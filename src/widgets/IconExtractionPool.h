@@ -0,0 +1,124 @@
+#pragma once
+
+#include "IconCacheStore.h"
+#include <windows.h>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 背景圖示提取
+// 殼層呼叫（PrivateExtractIconsW、SHGetFileInfoW 等）遇到網路磁碟的捷徑時可能阻塞數秒，
+// 因此一律交給背景執行緒（各自初始化 COM）。請求依可見度排序，同一可見度時較新的先做；
+// 完成的圖示暫存在這裡，並以一則訊息通知目標視窗，由 UI 執行緒呼叫 TakeCompleted 取走。
+// 請求以（快取鍵, 尺寸）合併：多個視窗等待同一個圖示時只提取一次，結果交給其中一個視窗，
+// 並在 Result::targets 列出所有等待的視窗。
+// 從持久快取載入的圖示以最低的優先權重新檢查：來源未變更時不產生結果。
+// 提取失敗時記下失敗時間並送出失敗的結果；重試間隔內同一請求直接忽略，不會每次繪製都重新排入佇列。
+class IconExtractionPool {
+public:
+    enum Priority {
+        PRIORITY_REFRESH = 0,   // 已從持久快取顯示，檢查來源是否變更
+        PRIORITY_PREFETCH = 1,  // 接近可視範圍，預先提取
+        PRIORITY_VISIBLE = 2    // 正在畫面上
+    };
+
+    struct Result {
+        std::wstring key;               // 請求時的快取鍵
+        int size;
+        HICON icon;
+        bool refresh;                   // PRIORITY_REFRESH 的結果（取代已顯示的圖示）
+        bool failed;                    // 提取失敗（icon 為 nullptr），繼續顯示預設圖示
+        IconCacheStamp stamp;           // 提取時來源檔案的戳記
+        uint32_t width;                 // pixels 的寬高（0 表示無法取得點陣圖）
+        uint32_t height;
+        std::vector<uint32_t> pixels;   // 預乘 alpha 的 BGRA，寫入持久快取
+        std::vector<HWND> targets;      // 等待這個結果的所有視窗（接收者套用到每一個）
+    };
+
+    // 提取函式（在背景執行緒呼叫）：填入 result 的 icon、stamp 與點陣圖，回傳的圖示交由接收者釋放。
+    // unchanged 不為 nullptr 時，來源戳記與其相同就不必提取，回傳 false（提取失敗亦同）
+    using Extractor = bool (*)(const std::wstring& filePath, int size, const IconCacheStamp* unchanged,
+                               Result& result);
+
+    // completionMessage：有完成的圖示時送給目標視窗的訊息（wParam、lParam 不使用）
+    IconExtractionPool(Extractor extractor, UINT completionMessage, size_t workerCount = 4);
+    ~IconExtractionPool();
+
+    IconExtractionPool(const IconExtractionPool&) = delete;
+    IconExtractionPool& operator=(const IconExtractionPool&) = delete;
+
+    // 要求提取 filePath 的圖示；同一快取鍵與尺寸已在佇列中時加入等待的視窗並更新優先權，提取中時只加入
+    // 等待的視窗，距上次失敗未滿 FAILED_RETRY_MS 時忽略（同一鍵的其他檔案共用結果，見 IconCache::MakeKey）。
+    // PRIORITY_REFRESH 時 unchanged 為已顯示圖示的來源戳記（nullptr 表示一律重新提取）
+    void Request(HWND target, const std::wstring& key, const std::wstring& filePath, int size,
+                 Priority priority, const IconCacheStamp* unchanged = nullptr);
+
+    // 取走送往 target 的已完成圖示
+    void TakeCompleted(HWND target, std::vector<Result>& results);
+
+    // 不再把結果送往 target（視窗即將銷毀）：沒有其他視窗等待的請求與圖示一併捨棄
+    void Cancel(HWND target);
+
+    // 停止所有執行緒並釋放尚未取走的圖示
+    void Stop();
+
+    // 提取失敗後，同一請求至少間隔這麼久才重試（毫秒）
+    static const uint64_t FAILED_RETRY_MS = 60 * 1000;
+
+private:
+    struct Key {
+        int size;
+        std::wstring key;
+
+        bool operator<(const Key& other) const;
+    };
+
+    struct Job {
+        int priority;
+        uint64_t sequence;  // 同一 Key 以最新的序號為準，較舊的 Job 取出時略過
+        Key key;
+        std::wstring filePath;
+        bool hasUnchanged;
+        IconCacheStamp unchanged;
+
+        bool operator<(const Job& other) const;
+    };
+
+    struct State {
+        uint64_t sequence;
+        int priority;
+        bool running;
+        bool failed;
+        uint64_t failedAt;  // 失敗時的 GetTickCount64
+        std::vector<HWND> targets;  // 等待結果的視窗（依請求順序）
+    };
+
+    struct Completed {
+        HWND target;
+        Result result;
+    };
+
+    void ThreadProc();
+
+    // 加入已完成的結果，交給第一個能接收通知的等待視窗（呼叫時須持有 mutex_）
+    void Complete(Result&& result);
+
+    Extractor extractor_;
+    UINT completionMessage_;
+    size_t workerCount_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    std::vector<Job> queue_;            // 以 Job::operator< 排序的堆積
+    std::map<Key, State> states_;       // 排隊中、提取中或最近失敗的請求（每個快取鍵與尺寸一個）
+    std::vector<Completed> completed_;
+    std::set<HWND> notified_;           // 已送出通知、尚未取走的視窗
+    std::vector<std::thread> workers_;
+    uint64_t nextSequence_;
+    bool stopping_;
+};
@@ -0,0 +1,480 @@
+#include "IconScaler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ICON_SCALER_SSE2 1
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define ICON_SCALER_AVX2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ICON_SCALER_AVX2_TARGET
+#else
+#define ICON_SCALER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// 濾波權重的定點精度（權重總和為 1 << WEIGHT_BITS）
+const int WEIGHT_BITS = 14;
+const int32_t WEIGHT_ROUNDING = 1 << (WEIGHT_BITS - 1);
+
+const double LANCZOS_RADIUS = 3.0;
+const double PI = 3.14159265358979323846;
+
+double Sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= PI;
+    return std::sin(x) / x;
+}
+
+double Lanczos(double x) {
+    return (std::fabs(x) < LANCZOS_RADIUS) ? Sinc(x) * Sinc(x / LANCZOS_RADIUS) : 0.0;
+}
+
+// 一個方向的濾波表：每個輸出位置 tapCount 個（偶數，不足補 0）來源索引與權重
+struct FilterTable {
+    int tapCount;
+    std::vector<int32_t> indices;
+    std::vector<int16_t> weights;
+};
+
+void BuildFilter(uint32_t srcSize, uint32_t dstSize, FilterTable& table) {
+    double scale = double(srcSize) / dstSize;
+    double filterScale = (std::max)(scale, 1.0);
+    double support = LANCZOS_RADIUS * filterScale;
+
+    int tapCount = (int)std::ceil(support) * 2 + 1;
+    tapCount += tapCount & 1;
+    table.tapCount = tapCount;
+    table.indices.assign(size_t(dstSize) * tapCount, 0);
+    table.weights.assign(size_t(dstSize) * tapCount, 0);
+
+    std::vector<double> weights(tapCount);
+    for (uint32_t i = 0; i < dstSize; ++i) {
+        double center = (i + 0.5) * scale - 0.5;
+        int first = (int)std::floor(center - support) + 1;
+
+        double total = 0.0;
+        for (int k = 0; k < tapCount; ++k) {
+            weights[k] = Lanczos((first + k - center) / filterScale);
+            total += weights[k];
+        }
+
+        // 定點化後把誤差加到最大的權重上，確保總和精確（平坦區域不會變色）
+        int32_t* indices = &table.indices[size_t(i) * tapCount];
+        int16_t* fixedWeights = &table.weights[size_t(i) * tapCount];
+        int32_t fixedTotal = 0;
+        int largest = 0;
+        for (int k = 0; k < tapCount; ++k) {
+            indices[k] = (std::min)((std::max)(first + k, 0), (int)srcSize - 1);
+            fixedWeights[k] = (int16_t)std::lround(weights[k] / total * (1 << WEIGHT_BITS));
+            fixedTotal += fixedWeights[k];
+            if (fixedWeights[k] > fixedWeights[largest]) {
+                largest = k;
+            }
+        }
+        fixedWeights[largest] = (int16_t)(fixedWeights[largest] + ((1 << WEIGHT_BITS) - fixedTotal));
+    }
+}
+
+// 圖示尺寸只有少數幾種組合，濾波表（計算 sin）依尺寸快取；提取在多個背景執行緒上進行，每個執行緒各自一份
+const size_t FILTER_CACHE_LIMIT = 16;
+
+const FilterTable& GetFilter(uint32_t srcSize, uint32_t dstSize) {
+    thread_local std::unordered_map<uint64_t, FilterTable> filters;
+    uint64_t key = (uint64_t(srcSize) << 32) | dstSize;
+    auto it = filters.find(key);
+    if (it != filters.end()) {
+        return it->second;
+    }
+    if (filters.size() >= FILTER_CACHE_LIMIT) {
+        filters.clear();
+    }
+    FilterTable& table = filters[key];
+    BuildFilter(srcSize, dstSize, table);
+    return table;
+}
+
+inline uint32_t ClampChannel(int32_t sum) {
+    int32_t value = (sum + WEIGHT_ROUNDING) >> WEIGHT_BITS;
+    return (uint32_t)((value < 0) ? 0 : (value > 255) ? 255 : value);
+}
+
+// 色彩通道不超過 alpha（負瓣造成的溢出會讓預乘值不合法）
+inline uint32_t ClampToAlpha(uint32_t pixel) {
+    uint32_t alpha = pixel >> 24;
+    uint32_t result = pixel & 0xFF000000;
+    for (int shift = 0; shift < 24; shift += 8) {
+        result |= (std::min)((pixel >> shift) & 0xFF, alpha) << shift;
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// 純量版本
+
+void HalveRowScalar(const uint32_t* row0, const uint32_t* row1, uint32_t* dst, uint32_t dstWidth) {
+    for (uint32_t x = 0; x < dstWidth; ++x) {
+        uint32_t a = row0[2 * x], b = row0[2 * x + 1], c = row1[2 * x], d = row1[2 * x + 1];
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t sum = ((a >> shift) & 0xFF) + ((b >> shift) & 0xFF) + ((c >> shift) & 0xFF) +
+                           ((d >> shift) & 0xFF);
+            result |= ((sum + 2) >> 2) << shift;
+        }
+        dst[x] = result;
+    }
+}
+
+uint32_t FilterPixelScalar(const uint32_t* const* sources, size_t offset, const int32_t* indices,
+                           const int16_t* weights, int tapCount, bool horizontal) {
+    int32_t sums[4] = { 0, 0, 0, 0 };
+    for (int k = 0; k < tapCount; ++k) {
+        uint32_t pixel = horizontal ? sources[0][indices[k]] : sources[k][offset];
+        for (int c = 0; c < 4; ++c) {
+            sums[c] += int32_t((pixel >> (c * 8)) & 0xFF) * weights[k];
+        }
+    }
+    uint32_t result = 0;
+    for (int c = 0; c < 4; ++c) {
+        result |= ClampChannel(sums[c]) << (c * 8);
+    }
+    return ClampToAlpha(result);
+}
+
+void HorizontalRowScalar(const uint32_t* src, uint32_t* dst, uint32_t dstWidth, const FilterTable& filter) {
+    for (uint32_t x = 0; x < dstWidth; ++x) {
+        size_t base = size_t(x) * filter.tapCount;
+        dst[x] = FilterPixelScalar(&src, 0, &filter.indices[base], &filter.weights[base], filter.tapCount, true);
+    }
+}
+
+void VerticalRowScalar(const uint32_t* const* rows, const int16_t* weights, int tapCount,
+                       uint32_t* dst, uint32_t width, uint32_t start) {
+    for (uint32_t x = start; x < width; ++x) {
+        dst[x] = FilterPixelScalar(rows, x, nullptr, weights, tapCount, false);
+    }
+}
+
+#ifdef ICON_SCALER_SSE2
+
+// 兩個權重合成一個 32 位元值，搭配 _mm_madd_epi16 一次處理兩個取樣點
+inline int32_t PackWeights(int16_t w0, int16_t w1) {
+    return int32_t((uint32_t(uint16_t(w1)) << 16) | uint16_t(w0));
+}
+
+// 四個像素中每個像素的 alpha 複製到四個通道
+inline __m128i BroadcastAlphaSse2(__m128i pixels) {
+    __m128i alpha = _mm_and_si128(pixels, _mm_set1_epi32(int32_t(0xFF000000)));
+    alpha = _mm_or_si128(alpha, _mm_srli_epi32(alpha, 8));
+    return _mm_or_si128(alpha, _mm_srli_epi32(alpha, 16));
+}
+
+inline __m128i RoundSse2(__m128i sums) {
+    return _mm_srai_epi32(_mm_add_epi32(sums, _mm_set1_epi32(WEIGHT_ROUNDING)), WEIGHT_BITS);
+}
+
+void HalveRowSse2(const uint32_t* row0, const uint32_t* row1, uint32_t* dst, uint32_t dstWidth) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    uint32_t x = 0;
+    for (; x + 4 <= dstWidth; x += 4) {
+        __m128i outputs[2];
+        for (int half = 0; half < 2; ++half) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x + half * 4));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x + half * 4));
+            // 上下兩列相加：前兩個像素與後兩個像素
+            __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            // 左右兩個像素相加
+            __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+            outputs[half] = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(outputs[0], outputs[1]));
+    }
+    HalveRowScalar(row0 + 2 * x, row1 + 2 * x, dst + x, dstWidth - x);
+}
+
+void HorizontalRowSse2(const uint32_t* src, uint32_t* dst, uint32_t dstWidth, const FilterTable& filter) {
+    const __m128i zero = _mm_setzero_si128();
+    for (uint32_t x = 0; x < dstWidth; ++x) {
+        const int32_t* indices = &filter.indices[size_t(x) * filter.tapCount];
+        const int16_t* weights = &filter.weights[size_t(x) * filter.tapCount];
+
+        __m128i sums = zero;
+        for (int k = 0; k < filter.tapCount; k += 2) {
+            // 兩個取樣點的通道交錯：b0 b1 g0 g1 r0 r1 a0 a1
+            __m128i pair = _mm_unpacklo_epi8(_mm_cvtsi32_si128(int32_t(src[indices[k]])),
+                                             _mm_cvtsi32_si128(int32_t(src[indices[k + 1]])));
+            pair = _mm_unpacklo_epi8(pair, zero);
+            sums = _mm_add_epi32(sums, _mm_madd_epi16(pair, _mm_set1_epi32(PackWeights(weights[k], weights[k + 1]))));
+        }
+
+        __m128i packed = _mm_packs_epi32(RoundSse2(sums), zero);
+        packed = _mm_packus_epi16(packed, zero);
+        packed = _mm_min_epu8(packed, BroadcastAlphaSse2(packed));
+        dst[x] = uint32_t(_mm_cvtsi128_si32(packed));
+    }
+}
+
+void VerticalRowSse2(const uint32_t* const* rows, const int16_t* weights, int tapCount,
+                     uint32_t* dst, uint32_t width) {
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i sums[4] = { zero, zero, zero, zero };
+        for (int k = 0; k < tapCount; k += 2) {
+            __m128i weightPair = _mm_set1_epi32(PackWeights(weights[k], weights[k + 1]));
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + x));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + x));
+            // 兩列交錯後每個像素的通道為 [c_k, c_k+1] 成對
+            __m128i low = _mm_unpacklo_epi8(a, b);
+            __m128i high = _mm_unpackhi_epi8(a, b);
+            sums[0] = _mm_add_epi32(sums[0], _mm_madd_epi16(_mm_unpacklo_epi8(low, zero), weightPair));
+            sums[1] = _mm_add_epi32(sums[1], _mm_madd_epi16(_mm_unpackhi_epi8(low, zero), weightPair));
+            sums[2] = _mm_add_epi32(sums[2], _mm_madd_epi16(_mm_unpacklo_epi8(high, zero), weightPair));
+            sums[3] = _mm_add_epi32(sums[3], _mm_madd_epi16(_mm_unpackhi_epi8(high, zero), weightPair));
+        }
+
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(RoundSse2(sums[0]), RoundSse2(sums[1])),
+                                          _mm_packs_epi32(RoundSse2(sums[2]), RoundSse2(sums[3])));
+        packed = _mm_min_epu8(packed, BroadcastAlphaSse2(packed));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), packed);
+    }
+    VerticalRowScalar(rows, weights, tapCount, dst, width, x);
+}
+
+#endif
+
+#ifdef ICON_SCALER_AVX2
+
+ICON_SCALER_AVX2_TARGET
+void HalveRowAvx2(const uint32_t* row0, const uint32_t* row1, uint32_t* dst, uint32_t dstWidth) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i two = _mm256_set1_epi16(2);
+    uint32_t x = 0;
+    for (; x + 8 <= dstWidth; x += 8) {
+        __m256i outputs[2];
+        for (int half = 0; half < 2; ++half) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + 2 * x + half * 8));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + 2 * x + half * 8));
+            __m256i low = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+            __m256i high = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+            __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(low, high), _mm256_unpackhi_epi64(low, high));
+            outputs[half] = _mm256_srli_epi16(_mm256_add_epi16(sum, two), 2);
+        }
+        // 各 128 位元半部內壓縮後的順序為 0 1 4 5 | 2 3 6 7，重排為 0..7
+        __m256i packed = _mm256_packus_epi16(outputs[0], outputs[1]);
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), packed);
+    }
+    // 尾端呼叫非 VEX 編碼的函式前清除上半部，避免 AVX / SSE 轉換的延遲（GCC 在尾端跳躍前不會自動加入）
+    _mm256_zeroupper();
+    HalveRowSse2(row0 + 2 * x, row1 + 2 * x, dst + x, dstWidth - x);
+}
+
+ICON_SCALER_AVX2_TARGET
+void VerticalRowAvx2(const uint32_t* const* rows, const int16_t* weights, int tapCount,
+                     uint32_t* dst, uint32_t width) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rounding = _mm256_set1_epi32(WEIGHT_ROUNDING);
+    uint32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i sums[4] = { zero, zero, zero, zero };
+        for (int k = 0; k < tapCount; k += 2) {
+            __m256i weightPair = _mm256_set1_epi32(PackWeights(weights[k], weights[k + 1]));
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k] + x));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k + 1] + x));
+            __m256i low = _mm256_unpacklo_epi8(a, b);
+            __m256i high = _mm256_unpackhi_epi8(a, b);
+            sums[0] = _mm256_add_epi32(sums[0], _mm256_madd_epi16(_mm256_unpacklo_epi8(low, zero), weightPair));
+            sums[1] = _mm256_add_epi32(sums[1], _mm256_madd_epi16(_mm256_unpackhi_epi8(low, zero), weightPair));
+            sums[2] = _mm256_add_epi32(sums[2], _mm256_madd_epi16(_mm256_unpacklo_epi8(high, zero), weightPair));
+            sums[3] = _mm256_add_epi32(sums[3], _mm256_madd_epi16(_mm256_unpackhi_epi8(high, zero), weightPair));
+        }
+        for (auto& sum : sums) {
+            sum = _mm256_srai_epi32(_mm256_add_epi32(sum, rounding), WEIGHT_BITS);
+        }
+
+        // 拆開與壓縮都在各自的半部內進行，像素順序不變
+        __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(sums[0], sums[1]),
+                                             _mm256_packs_epi32(sums[2], sums[3]));
+        __m256i alpha = _mm256_and_si256(packed, _mm256_set1_epi32(int32_t(0xFF000000)));
+        alpha = _mm256_or_si256(alpha, _mm256_srli_epi32(alpha, 8));
+        alpha = _mm256_or_si256(alpha, _mm256_srli_epi32(alpha, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_min_epu8(packed, alpha));
+    }
+    _mm256_zeroupper();
+    VerticalRowScalar(rows, weights, tapCount, dst, width, x);
+}
+
+#endif
+
+using HalveRowFunction = void (*)(const uint32_t*, const uint32_t*, uint32_t*, uint32_t);
+using HorizontalRowFunction = void (*)(const uint32_t*, uint32_t*, uint32_t, const FilterTable&);
+using VerticalRowFunction = void (*)(const uint32_t* const*, const int16_t*, int, uint32_t*, uint32_t);
+
+struct ScalerKernels {
+    HalveRowFunction halve;
+    HorizontalRowFunction horizontal;
+    VerticalRowFunction vertical;
+};
+
+void VerticalRowScalarFull(const uint32_t* const* rows, const int16_t* weights, int tapCount,
+                           uint32_t* dst, uint32_t width) {
+    VerticalRowScalar(rows, weights, tapCount, dst, width, 0);
+}
+
+// 水平方向每個輸出像素的取樣位置都不同，AVX2 版本沿用 SSE2 的水平濾波
+ScalerKernels GetKernels(IconCompositor::Kernel kernel) {
+    if (!IconCompositor::IsSupported(kernel)) {
+        kernel = IconCompositor::KERNEL_SCALAR;
+    }
+
+    switch (kernel) {
+#ifdef ICON_SCALER_AVX2
+    case IconCompositor::KERNEL_AVX2:
+        return { &HalveRowAvx2, &HorizontalRowSse2, &VerticalRowAvx2 };
+#endif
+#ifdef ICON_SCALER_SSE2
+    case IconCompositor::KERNEL_SSE2:
+        return { &HalveRowSse2, &HorizontalRowSse2, &VerticalRowSse2 };
+#endif
+    default:
+        return { &HalveRowScalar, &HorizontalRowScalar, &VerticalRowScalarFull };
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// IconScaler
+
+void IconScaler::Halve(IconCompositor::Kernel kernel, const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                       uint32_t* dst) {
+    HalveRowFunction halveRow = GetKernels(kernel).halve;
+    uint32_t dstWidth = srcWidth / 2;
+    uint32_t dstHeight = srcHeight / 2;
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        halveRow(src + size_t(2 * y) * srcWidth, src + size_t(2 * y + 1) * srcWidth,
+                 dst + size_t(y) * dstWidth, dstWidth);
+    }
+}
+
+void IconScaler::Resample(IconCompositor::Kernel kernel, const uint32_t* src, uint32_t srcWidth,
+                          uint32_t srcHeight, uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight) {
+    if (srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0) {
+        return;
+    }
+
+    ScalerKernels kernels = GetKernels(kernel);
+    const FilterTable& horizontal = GetFilter(srcWidth, dstWidth);
+    const FilterTable& vertical = GetFilter(srcHeight, dstHeight);
+
+    // 先水平縮放每一列（dstWidth × srcHeight），再垂直合併
+    std::vector<uint32_t> intermediate(size_t(dstWidth) * srcHeight);
+    for (uint32_t y = 0; y < srcHeight; ++y) {
+        kernels.horizontal(src + size_t(y) * srcWidth, intermediate.data() + size_t(y) * dstWidth,
+                           dstWidth, horizontal);
+    }
+
+    std::vector<const uint32_t*> rows(vertical.tapCount);
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        size_t base = size_t(y) * vertical.tapCount;
+        for (int k = 0; k < vertical.tapCount; ++k) {
+            rows[k] = intermediate.data() + size_t(vertical.indices[base + k]) * dstWidth;
+        }
+        kernels.vertical(rows.data(), &vertical.weights[base], vertical.tapCount,
+                         dst + size_t(y) * dstWidth, dstWidth);
+    }
+}
+
+void IconScaler::Scale(const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                       uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight) {
+    Scale(IconCompositor::GetDefaultKernel(), src, srcWidth, srcHeight, dst, dstWidth, dstHeight);
+}
+
+void IconScaler::Scale(IconCompositor::Kernel kernel, const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                       uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight) {
+    if (srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0) {
+        return;
+    }
+
+    // 只縮小到需要的那一層，不建立完整的 mip 鏈
+    std::vector<uint32_t> levels[2];
+    const uint32_t* level = src;
+    uint32_t width = srcWidth;
+    uint32_t height = srcHeight;
+    for (int current = 0; width / 2 >= dstWidth && height / 2 >= dstHeight; current ^= 1) {
+        levels[current].resize(size_t(width / 2) * (height / 2));
+        Halve(kernel, level, width, height, levels[current].data());
+        level = levels[current].data();
+        width /= 2;
+        height /= 2;
+    }
+
+    if (width == dstWidth && height == dstHeight) {
+        std::memcpy(dst, level, size_t(dstWidth) * dstHeight * sizeof(uint32_t));
+        return;
+    }
+    Resample(kernel, level, width, height, dst, dstWidth, dstHeight);
+}
+
+// ---------------------------------------------------------------------------
+// IconMipChain
+
+IconMipChain::IconMipChain() {
+}
+
+void IconMipChain::Build(const uint32_t* pixels, uint32_t width, uint32_t height) {
+    Build(IconCompositor::GetDefaultKernel(), pixels, width, height);
+}
+
+void IconMipChain::Build(IconCompositor::Kernel kernel, const uint32_t* pixels, uint32_t width, uint32_t height) {
+    levels_.clear();
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    levels_.push_back({ width, height, std::vector<uint32_t>(pixels, pixels + size_t(width) * height) });
+    while (levels_.back().width >= 2 && levels_.back().height >= 2) {
+        const Level& previous = levels_.back();
+        Level next = { previous.width / 2, previous.height / 2, {} };
+        next.pixels.resize(size_t(next.width) * next.height);
+        IconScaler::Halve(kernel, previous.pixels.data(), previous.width, previous.height, next.pixels.data());
+        levels_.push_back(std::move(next));
+    }
+}
+
+void IconMipChain::Scale(uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight) const {
+    Scale(IconCompositor::GetDefaultKernel(), dst, dstWidth, dstHeight);
+}
+
+void IconMipChain::Scale(IconCompositor::Kernel kernel, uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight) const {
+    if (levels_.empty() || dstWidth == 0 || dstHeight == 0) {
+        return;
+    }
+
+    // 不小於目標的最小一層（與目標的比例在兩倍以內）；放大時使用原始來源
+    size_t index = 0;
+    while (index + 1 < levels_.size() &&
+           levels_[index + 1].width >= dstWidth && levels_[index + 1].height >= dstHeight) {
+        ++index;
+    }
+
+    const Level& level = levels_[index];
+    if (level.width == dstWidth && level.height == dstHeight) {
+        std::memcpy(dst, level.pixels.data(), size_t(dstWidth) * dstHeight * sizeof(uint32_t));
+        return;
+    }
+    IconScaler::Resample(kernel, level.pixels.data(), level.width, level.height, dst, dstWidth, dstHeight);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "IconCompositor.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 預乘 alpha 的 BGRA 縮放（不依賴 Windows，可在 Linux 上測試與量測）
+//
+// 由單一最大的來源建立 mip 鏈（每層以 2×2 盒狀濾波縮小一半），取不小於目標的最小一層，
+// 再以可分離的 Lanczos-3 濾波重新取樣到目標尺寸（放大也使用同一個濾波）。
+// 每層與目標的比例都在兩倍以內，濾波最多 14 個取樣點；輸出的色彩通道限制在 alpha 以內，
+// 維持合法的預乘值。SSE2 / AVX2 版本與純量版本逐位元相同（版本的選擇同 IconCompositor）；
+// 濾波表依尺寸組合快取在各執行緒內，可在提取執行緒上同時使用。
+class IconMipChain {
+public:
+    IconMipChain();
+
+    // 以 width × height 的來源建立 mip 鏈（複製來源）
+    void Build(const uint32_t* pixels, uint32_t width, uint32_t height);
+    void Build(IconCompositor::Kernel kernel, const uint32_t* pixels, uint32_t width, uint32_t height);
+
+    uint32_t GetWidth() const { return levels_.empty() ? 0 : levels_[0].width; }
+    uint32_t GetHeight() const { return levels_.empty() ? 0 : levels_[0].height; }
+    size_t GetLevelCount() const { return levels_.size(); }
+
+    // 縮放到 dst（dstWidth × dstHeight，緊密排列）
+    void Scale(uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight) const;
+    void Scale(IconCompositor::Kernel kernel, uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight) const;
+
+private:
+    struct Level {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint32_t> pixels;
+    };
+
+    std::vector<Level> levels_;
+};
+
+class IconScaler {
+public:
+    // 單次縮放（建立暫時的 mip 鏈）
+    static void Scale(const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                      uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight);
+    static void Scale(IconCompositor::Kernel kernel, const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                      uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight);
+
+    // 2×2 盒狀濾波縮小一半：dst 為 (srcWidth / 2) × (srcHeight / 2)，奇數時捨去最後一列 / 欄
+    static void Halve(IconCompositor::Kernel kernel, const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                      uint32_t* dst);
+
+    // Lanczos-3 重新取樣（不經 mip 鏈；比例超過兩倍時取樣點會隨之增加）
+    static void Resample(IconCompositor::Kernel kernel, const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                         uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight);
+};
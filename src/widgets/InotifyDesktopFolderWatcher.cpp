@@ -0,0 +1,136 @@
+#include "InotifyDesktopFolderWatcher.h"
+#include "core/StringCodec.h"
+#include <cstring>
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// 會改變項目集合的變更（不含內容與時間戳記）
+const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+DesktopFolderEntry MakeEntry(const char* name, bool isDirectory) {
+    DesktopFolderEntry entry;
+    entry.name = StringCodec::ToWide(name);
+    entry.isDirectory = isDirectory;
+    entry.isHidden = (name[0] == '.');
+    return entry;
+}
+
+} // namespace
+
+InotifyDesktopFolderWatcher::InotifyDesktopFolderWatcher()
+    : fd_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+}
+
+InotifyDesktopFolderWatcher::~InotifyDesktopFolderWatcher() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool InotifyDesktopFolderWatcher::Scan(const std::wstring& folder, std::vector<DesktopFolderEntry>& entries) {
+    std::string path = StringCodec::ToUtf8(folder);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return false;
+    }
+
+    while (dirent* item = readdir(dir)) {
+        // 跳過 . 和 ..
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) {
+            continue;
+        }
+
+        bool isDirectory = (item->d_type == DT_DIR);
+        if (item->d_type == DT_UNKNOWN) {
+            struct stat info;
+            std::string itemPath = path + "/" + item->d_name;
+            isDirectory = (stat(itemPath.c_str(), &info) == 0 && S_ISDIR(info.st_mode));
+        }
+        entries.push_back(MakeEntry(item->d_name, isDirectory));
+    }
+
+    closedir(dir);
+    return true;
+}
+
+int InotifyDesktopFolderWatcher::Watch(const std::wstring& folder) {
+    if (fd_ < 0) {
+        return -1;
+    }
+
+    int descriptor = inotify_add_watch(fd_, StringCodec::ToUtf8(folder).c_str(), WATCH_MASK);
+    if (descriptor < 0) {
+        return -1;
+    }
+    descriptors_.push_back(descriptor);
+    return (int)descriptors_.size() - 1;
+}
+
+void InotifyDesktopFolderWatcher::Unwatch(int watchId) {
+    if (watchId < 0 || watchId >= (int)descriptors_.size() || descriptors_[watchId] < 0) {
+        return;
+    }
+    inotify_rm_watch(fd_, descriptors_[watchId]);
+    descriptors_[watchId] = -1;
+}
+
+int InotifyDesktopFolderWatcher::FindWatch(int descriptor) const {
+    for (size_t i = 0; i < descriptors_.size(); ++i) {
+        if (descriptors_[i] == descriptor) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void InotifyDesktopFolderWatcher::Poll(std::vector<DesktopFolderChange>& changes) {
+    if (fd_ < 0) {
+        return;
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;) {
+        ssize_t bytes = read(fd_, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            break;  // EAGAIN：沒有更多事件
+        }
+
+        for (char* cursor = buffer; cursor < buffer + bytes;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+
+            // 佇列溢位時所有資料夾都可能遺失通知
+            if (event->mask & IN_Q_OVERFLOW) {
+                for (size_t i = 0; i < descriptors_.size(); ++i) {
+                    if (descriptors_[i] >= 0) {
+                        changes.push_back({ (int)i, DesktopFolderChange::OVERFLOWED, {} });
+                    }
+                }
+                continue;
+            }
+
+            int watchId = FindWatch(event->wd);
+            if (watchId < 0 || event->len == 0) {
+                continue;
+            }
+
+            bool isDirectory = (event->mask & IN_ISDIR) != 0;
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                changes.push_back({ watchId, DesktopFolderChange::ADDED, MakeEntry(event->name, isDirectory) });
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                changes.push_back({ watchId, DesktopFolderChange::REMOVED, MakeEntry(event->name, isDirectory) });
+            }
+        }
+    }
+}
+
+std::wstring InotifyDesktopFolderWatcher::JoinPath(const std::wstring& folder, const std::wstring& name) const {
+    if (!folder.empty() && folder.back() != L'/') {
+        return folder + L"/" + name;
+    }
+    return folder + name;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "DesktopFolderWatcher.h"
+#include <vector>
+
+// IDesktopFolderWatcher 的 Linux 實作（inotify），讓 DesktopIndex 能在 Linux 上驗證與量測
+// 路徑為寬字串，與檔案系統之間以 UTF-8 轉換。
+class InotifyDesktopFolderWatcher : public IDesktopFolderWatcher {
+public:
+    InotifyDesktopFolderWatcher();
+    ~InotifyDesktopFolderWatcher() override;
+
+    InotifyDesktopFolderWatcher(const InotifyDesktopFolderWatcher&) = delete;
+    InotifyDesktopFolderWatcher& operator=(const InotifyDesktopFolderWatcher&) = delete;
+
+    // IDesktopFolderWatcher
+    bool Scan(const std::wstring& folder, std::vector<DesktopFolderEntry>& entries) override;
+    int Watch(const std::wstring& folder) override;
+    void Unwatch(int watchId) override;
+    void Poll(std::vector<DesktopFolderChange>& changes) override;
+    std::wstring JoinPath(const std::wstring& folder, const std::wstring& name) const override;
+
+private:
+    int FindWatch(int descriptor) const;
+
+    int fd_;
+    std::vector<int> descriptors_;  // 索引即監看代碼，移除後為 -1
+};
@@ -0,0 +1,96 @@
+#include "PaintResourceCache.h"
+
+PaintResourceCache::PaintResourceCache(IPaintResourceFactory& factory, size_t idleLimit)
+    : factory_(factory)
+    , idleLimit_(idleLimit)
+    , created_(0)
+    , destroyed_(0)
+    , hits_(0) {
+}
+
+PaintResourceCache::~PaintResourceCache() {
+    Clear();
+}
+
+PaintResource PaintResourceCache::Acquire(const PaintStyle& style) {
+    auto it = entries_.find(style);
+    if (it != entries_.end()) {
+        ++hits_;
+        if (it->second.references++ == 0) {
+            idle_.erase(it->second.idlePosition);
+            it->second.idlePosition = idle_.end();
+        }
+        return it->second.resource;
+    }
+
+    PaintResource resource = factory_.Create(style);
+    if (!resource) {
+        return nullptr;
+    }
+
+    ++created_;
+    it = entries_.emplace(style, Entry{ resource, 1, idle_.end() }).first;
+    stylesByResource_.emplace(resource, &it->first);
+    return resource;
+}
+
+void PaintResourceCache::Release(PaintResource resource) {
+    auto styleIt = stylesByResource_.find(resource);
+    if (styleIt == stylesByResource_.end()) {
+        return;
+    }
+
+    auto it = entries_.find(*styleIt->second);
+    if (it == entries_.end() || it->second.references == 0 || --it->second.references > 0) {
+        return;
+    }
+
+    // 留待重複使用；閒置過多時刪除最久未用的
+    it->second.idlePosition = idle_.insert(idle_.end(), it->first);
+    while (idle_.size() > idleLimit_) {
+        PaintStyle oldest = idle_.front();
+        DestroyEntry(oldest);
+    }
+}
+
+void PaintResourceCache::Trim() {
+    while (!idle_.empty()) {
+        PaintStyle oldest = idle_.front();
+        DestroyEntry(oldest);
+    }
+}
+
+void PaintResourceCache::Clear() {
+    for (auto& pair : entries_) {
+        factory_.Destroy(pair.second.resource);
+        ++destroyed_;
+    }
+    entries_.clear();
+    stylesByResource_.clear();
+    idle_.clear();
+}
+
+PaintResourceCache::Stats PaintResourceCache::GetStats() const {
+    Stats stats;
+    stats.created = created_;
+    stats.destroyed = destroyed_;
+    stats.hits = hits_;
+    stats.live = entries_.size();
+    stats.idle = idle_.size();
+    return stats;
+}
+
+void PaintResourceCache::DestroyEntry(const PaintStyle& style) {
+    auto it = entries_.find(style);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    if (it->second.idlePosition != idle_.end()) {
+        idle_.erase(it->second.idlePosition);
+    }
+    stylesByResource_.erase(it->second.resource);
+    factory_.Destroy(it->second.resource);
+    ++destroyed_;
+    entries_.erase(it);
+}
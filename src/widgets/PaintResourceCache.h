@@ -0,0 +1,87 @@
+#pragma once
+
+#include "PaintResourceFactory.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+// 以樣式為鍵、引用計數的繪製資源快取（不依賴 Windows）
+//
+// Acquire 增加引用（沒有時由 factory 建立），Release 減少引用。引用歸零的資源不立即刪除，
+// 而是留在閒置清單內，之後相同樣式的 Acquire 直接取回；閒置資源超過 idleLimit 時刪除最久未用的。
+// 繪製時每一幀取得並釋放同一組樣式，穩定狀態下不再建立任何資源。只在 UI 執行緒上使用。
+class PaintResourceCache {
+public:
+    struct Stats {
+        uint64_t created;       // factory 建立的資源
+        uint64_t destroyed;     // factory 刪除的資源
+        uint64_t hits;          // Acquire 取得既有的資源
+        size_t live;            // 目前持有的資源（含閒置）
+        size_t idle;            // 沒有引用的資源
+    };
+
+    static const size_t DEFAULT_IDLE_LIMIT = 64;
+
+    explicit PaintResourceCache(IPaintResourceFactory& factory, size_t idleLimit = DEFAULT_IDLE_LIMIT);
+    ~PaintResourceCache();
+
+    PaintResourceCache(const PaintResourceCache&) = delete;
+    PaintResourceCache& operator=(const PaintResourceCache&) = delete;
+
+    // 取得樣式的資源並增加引用；建立失敗時回傳 nullptr
+    PaintResource Acquire(const PaintStyle& style);
+
+    // 減少引用（歸零時移到閒置清單）
+    void Release(PaintResource resource);
+
+    // 刪除所有閒置的資源
+    void Trim();
+
+    // 刪除所有資源（不論引用）
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        PaintResource resource;
+        size_t references;
+        std::list<PaintStyle>::iterator idlePosition;   // 閒置時在 idle_ 內的位置
+    };
+
+    void DestroyEntry(const PaintStyle& style);
+
+    IPaintResourceFactory& factory_;
+    size_t idleLimit_;
+    std::unordered_map<PaintStyle, Entry, PaintStyleHash> entries_;
+    std::unordered_map<PaintResource, const PaintStyle*> stylesByResource_;
+    std::list<PaintStyle> idle_;    // 閒置的樣式，最近釋放的在後
+    uint64_t created_;
+    uint64_t destroyed_;
+    uint64_t hits_;
+};
+
+// 在作用範圍內持有一個繪製資源的引用
+class ScopedPaintResource {
+public:
+    ScopedPaintResource(PaintResourceCache& cache, const PaintStyle& style)
+        : cache_(cache)
+        , resource_(cache.Acquire(style)) {
+    }
+
+    ~ScopedPaintResource() {
+        if (resource_) {
+            cache_.Release(resource_);
+        }
+    }
+
+    ScopedPaintResource(const ScopedPaintResource&) = delete;
+    ScopedPaintResource& operator=(const ScopedPaintResource&) = delete;
+
+    PaintResource Get() const { return resource_; }
+
+private:
+    PaintResourceCache& cache_;
+    PaintResource resource_;
+};
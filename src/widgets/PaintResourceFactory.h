@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// 繪製資源（Win32 上為 HBRUSH / HPEN / HFONT）的不透明控制代碼
+using PaintResource = void*;
+
+// 繪製資源的樣式：相同樣式的資源可以共用
+// 色彩為 COLORREF 的排列（0x00BBGGRR）；筆刷只用 color，畫筆用 color 與 width，
+// 字型用 face、size（字元高度）、weight 與 italic。
+struct PaintStyle {
+    enum Kind : uint8_t {
+        KIND_BRUSH,
+        KIND_PEN,
+        KIND_FONT
+    };
+
+    Kind kind;
+    bool italic;
+    uint32_t color;
+    int32_t width;
+    int32_t size;
+    int32_t weight;
+    std::wstring face;
+
+    static PaintStyle Brush(uint32_t color) {
+        return { KIND_BRUSH, false, color, 0, 0, 0, std::wstring() };
+    }
+
+    static PaintStyle Pen(uint32_t color, int32_t width) {
+        return { KIND_PEN, false, color, width, 0, 0, std::wstring() };
+    }
+
+    static PaintStyle Font(const wchar_t* face, int32_t size, int32_t weight, bool italic = false) {
+        return { KIND_FONT, italic, 0, 0, size, weight, face };
+    }
+
+    bool operator==(const PaintStyle& other) const {
+        return kind == other.kind && italic == other.italic && color == other.color && width == other.width &&
+               size == other.size && weight == other.weight && face == other.face;
+    }
+};
+
+struct PaintStyleHash {
+    size_t operator()(const PaintStyle& style) const {
+        size_t hash = std::hash<std::wstring>()(style.face);
+        for (uint64_t value : { (uint64_t)style.kind, (uint64_t)style.italic, (uint64_t)style.color,
+                                (uint64_t)(uint32_t)style.width, (uint64_t)(uint32_t)style.size,
+                                (uint64_t)(uint32_t)style.weight }) {
+            hash = hash * 31 + std::hash<uint64_t>()(value);
+        }
+        return hash;
+    }
+};
+
+// 建立與刪除繪製資源（不依賴 Windows）
+// Win32 實作呼叫 CreateSolidBrush / CreatePen / CreateFontW，
+// CountingPaintResourceFactory 只計數，用於在 Linux 上驗證繪製時不再配置資源。
+class IPaintResourceFactory {
+public:
+    virtual ~IPaintResourceFactory() = default;
+
+    // 失敗時回傳 nullptr
+    virtual PaintResource Create(const PaintStyle& style) = 0;
+    virtual void Destroy(PaintResource resource) = 0;
+};
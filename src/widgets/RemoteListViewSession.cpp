@@ -0,0 +1,189 @@
+#include "RemoteListViewSession.h"
+#include <commctrl.h>
+#include <algorithm>
+
+namespace {
+
+// 暫存區最小配置（一頁即可容納 LVITEMW 加上 MAX_PATH 文字）
+const size_t MIN_ARENA_SIZE = 4096;
+
+// 讀取文字時的遠端佈局
+struct RemoteTextItem {
+    LVITEMW item;
+    wchar_t text[MAX_PATH];
+};
+
+} // namespace
+
+RemoteListViewSession::RemoteListViewSession()
+    : listView_(nullptr)
+    , processId_(0)
+    , process_(nullptr)
+    , arena_(nullptr)
+    , arenaSize_(0) {
+}
+
+RemoteListViewSession::~RemoteListViewSession() {
+    Close();
+}
+
+bool RemoteListViewSession::Connect(HWND listView) {
+    if (!listView) {
+        return false;
+    }
+
+    DWORD processId = 0;
+    GetWindowThreadProcessId(listView, &processId);
+    if (processId == 0) {
+        Close();
+        return false;
+    }
+
+    // explorer 重新啟動時視窗與程序都會改變
+    if (process_ && listView == listView_ && processId == processId_) {
+        return true;
+    }
+
+    Close();
+
+    process_ = OpenProcess(PROCESS_VM_OPERATION | PROCESS_VM_READ | PROCESS_VM_WRITE,
+                           FALSE, processId);
+    if (!process_) {
+        return false;
+    }
+
+    listView_ = listView;
+    processId_ = processId;
+    return true;
+}
+
+void RemoteListViewSession::Close() {
+    if (arena_) {
+        VirtualFreeEx(process_, arena_, 0, MEM_RELEASE);
+        arena_ = nullptr;
+        arenaSize_ = 0;
+    }
+    if (process_) {
+        CloseHandle(process_);
+        process_ = nullptr;
+    }
+    listView_ = nullptr;
+    processId_ = 0;
+}
+
+char* RemoteListViewSession::ReserveArena(size_t size) {
+    if (!process_) {
+        return nullptr;
+    }
+    if (arena_ && arenaSize_ >= size) {
+        return arena_;
+    }
+
+    if (arena_) {
+        VirtualFreeEx(process_, arena_, 0, MEM_RELEASE);
+        arena_ = nullptr;
+        arenaSize_ = 0;
+    }
+
+    // 以倍數成長，避免逐步變大的請求反覆配置
+    size_t newSize = MIN_ARENA_SIZE;
+    while (newSize < size) {
+        newSize *= 2;
+    }
+
+    arena_ = (char*)VirtualAllocEx(process_, nullptr, newSize, MEM_COMMIT, PAGE_READWRITE);
+    if (!arena_) {
+        return nullptr;
+    }
+    arenaSize_ = newSize;
+    return arena_;
+}
+
+int RemoteListViewSession::GetItemCount() const {
+    if (!listView_) {
+        return 0;
+    }
+    return (int)SendMessageW(listView_, LVM_GETITEMCOUNT, 0, 0);
+}
+
+bool RemoteListViewSession::GetItemText(int index, std::wstring& text) {
+    RemoteTextItem* remote = (RemoteTextItem*)ReserveArena(sizeof(RemoteTextItem));
+    if (!remote) {
+        return false;
+    }
+
+    // 每次都重寫 LVITEMW：回呼項目可能改動遠端結構中的 pszText
+    LVITEMW lvi = { 0 };
+    lvi.mask = LVIF_TEXT;
+    lvi.iItem = index;
+    lvi.pszText = remote->text;
+    lvi.cchTextMax = MAX_PATH;
+    if (!WriteProcessMemory(process_, &remote->item, &lvi, sizeof(LVITEMW), nullptr)) {
+        return false;
+    }
+
+    // 回傳值為文字長度，只讀回實際內容
+    int length = (int)SendMessageW(listView_, LVM_GETITEMTEXTW, index, (LPARAM)&remote->item);
+    if (length <= 0) {
+        return false;
+    }
+    length = (std::min)(length, MAX_PATH - 1);
+
+    wchar_t buffer[MAX_PATH];
+    if (!ReadProcessMemory(process_, remote->text, buffer, length * sizeof(wchar_t), nullptr)) {
+        return false;
+    }
+
+    text.assign(buffer, length);
+    return true;
+}
+
+bool RemoteListViewSession::GetItemPosition(int index, POINT& position) {
+    POINT* remote = (POINT*)ReserveArena(sizeof(POINT));
+    if (!remote || index < 0) {
+        return false;
+    }
+
+    if (!SendMessageW(listView_, LVM_GETITEMPOSITION, index, (LPARAM)remote)) {
+        return false;
+    }
+    return ReadProcessMemory(process_, remote, &position, sizeof(POINT), nullptr) != FALSE;
+}
+
+bool RemoteListViewSession::GetItemPositions(const int* indices, size_t count, POINT* positions) {
+    if (count == 0) {
+        return true;
+    }
+
+    POINT* remote = (POINT*)ReserveArena(count * sizeof(POINT));
+    if (!remote) {
+        return false;
+    }
+
+    std::vector<bool> succeeded(count);
+    for (size_t i = 0; i < count; ++i) {
+        succeeded[i] = indices[i] >= 0 &&
+                       SendMessageW(listView_, LVM_GETITEMPOSITION, indices[i], (LPARAM)(remote + i)) != 0;
+    }
+
+    if (!ReadProcessMemory(process_, remote, positions, count * sizeof(POINT), nullptr)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!succeeded[i]) {
+            positions[i] = { -1, -1 };
+        }
+    }
+    return true;
+}
+
+bool RemoteListViewSession::GetAllItemPositions(std::vector<POINT>& positions) {
+    std::vector<int> indices(GetItemCount());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = (int)i;
+    }
+
+    positions.resize(indices.size());
+    return GetItemPositions(indices.data(), indices.size(), positions.data());
+}
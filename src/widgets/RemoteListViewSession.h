@@ -0,0 +1,49 @@
+#pragma once
+
+#include <windows.h>
+#include <string>
+#include <vector>
+
+// 與 explorer 程序內桌面 ListView 溝通的長期工作階段
+// 程序控制代碼只在 ListView 視窗或其程序改變時重新開啟；
+// 遠端暫存區（LVITEMW、文字緩衝區、POINT 陣列）重複使用，容量不足時才重新配置。
+class RemoteListViewSession {
+public:
+    RemoteListViewSession();
+    ~RemoteListViewSession();
+
+    RemoteListViewSession(const RemoteListViewSession&) = delete;
+    RemoteListViewSession& operator=(const RemoteListViewSession&) = delete;
+
+    // 連線到指定 ListView（已連線到同一視窗與程序時直接回傳）
+    bool Connect(HWND listView);
+    void Close();
+
+    bool IsConnected() const { return process_ != nullptr; }
+    HWND GetListView() const { return listView_; }
+
+    int GetItemCount() const;
+
+    // 讀取項目文字（失敗或沒有文字時回傳 false）
+    bool GetItemText(int index, std::wstring& text);
+
+    // 讀取項目位置（ListView 用戶區座標）
+    bool GetItemPosition(int index, POINT& position);
+
+    // 批次讀取位置：每個項目寫入遠端 POINT 陣列的對應位置，最後以一次 ReadProcessMemory 讀回
+    // 索引無效或讀取失敗的項目為 { -1, -1 }
+    bool GetItemPositions(const int* indices, size_t count, POINT* positions);
+
+    // 讀取全部項目位置（positions[i] 對應索引 i）
+    bool GetAllItemPositions(std::vector<POINT>& positions);
+
+private:
+    // 取得至少 size 位元組的遠端暫存區
+    char* ReserveArena(size_t size);
+
+    HWND listView_;
+    DWORD processId_;
+    HANDLE process_;
+    char* arena_;       // 遠端程序內的位址
+    size_t arenaSize_;
+};
@@ -0,0 +1,133 @@
+#include "SimulatedDesktopIconHost.h"
+#include <cstdio>
+
+SimulatedDesktopIconHost::SimulatedDesktopIconHost()
+    : latency_(0)
+    , screenOffset_{ 0, 0 }
+    , changeStamp_(0)
+    , columns_(20)
+    , rows_(1)
+    , available_(true) {
+}
+
+void SimulatedDesktopIconHost::Populate(int count, const std::wstring& prefix, int columns) {
+    items_.clear();
+    items_.reserve(count);
+    columns_ = (columns > 0) ? columns : 1;
+    rows_ = (count + columns_ - 1) / columns_ + 1;
+
+    wchar_t number[16];
+    for (int i = 0; i < count; ++i) {
+        swprintf(number, sizeof(number) / sizeof(number[0]), L"%05d", i);
+        Item item;
+        item.name = prefix + number;
+        item.position = { (i % columns_) * GRID_WIDTH, (i / columns_) * GRID_HEIGHT };
+        items_.push_back(std::move(item));
+    }
+    ++changeStamp_;
+}
+
+void SimulatedDesktopIconHost::AddItem(const std::wstring& name, DesktopIconPoint position) {
+    items_.push_back({ name, position });
+    ++changeStamp_;
+}
+
+void SimulatedDesktopIconHost::RemoveItem(int index) {
+    if (index >= 0 && index < (int)items_.size()) {
+        items_.erase(items_.begin() + index);
+        ++changeStamp_;
+    }
+}
+
+void SimulatedDesktopIconHost::RenameItem(int index, const std::wstring& name) {
+    if (index >= 0 && index < (int)items_.size()) {
+        items_[index].name = name;
+        ++changeStamp_;
+    }
+}
+
+void SimulatedDesktopIconHost::Delay(uint64_t roundTrips) const {
+    if (latency_.count() <= 0 || roundTrips == 0) {
+        return;
+    }
+
+    auto until = std::chrono::steady_clock::now() + latency_ * roundTrips;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+bool SimulatedDesktopIconHost::Connect() {
+    ++counts_.connect;
+    Delay(1);
+    return available_;
+}
+
+int SimulatedDesktopIconHost::GetItemCount() {
+    ++counts_.itemCount;
+    Delay(1);
+    return (int)items_.size();
+}
+
+bool SimulatedDesktopIconHost::GetItemText(int index, std::wstring& text) {
+    ++counts_.itemText;
+    Delay(1);
+    if (index < 0 || index >= (int)items_.size() || items_[index].name.empty()) {
+        return false;
+    }
+    text = items_[index].name;
+    return true;
+}
+
+bool SimulatedDesktopIconHost::GetItemPositions(const int* indices, size_t count, DesktopIconPoint* positions) {
+    ++counts_.positionQueries;
+    counts_.positionsRead += count;
+    Delay(count + 1);
+
+    for (size_t i = 0; i < count; ++i) {
+        int index = indices[i];
+        positions[i] = (index >= 0 && index < (int)items_.size())
+            ? items_[index].position
+            : DesktopIconPoint{ -1, -1 };
+    }
+    return true;
+}
+
+void SimulatedDesktopIconHost::SetItemPosition(int index, DesktopIconPoint position) {
+    ++counts_.setPosition;
+    Delay(1);
+    if (index >= 0 && index < (int)items_.size()) {
+        items_[index].position = position;
+    }
+}
+
+bool SimulatedDesktopIconHost::GetGrid(DesktopIconGrid& grid) {
+    ++counts_.grid;
+    Delay(1);
+    grid = { GRID_WIDTH, GRID_HEIGHT, columns_, rows_ };
+    return true;
+}
+
+void SimulatedDesktopIconHost::Arrange() {
+    ++counts_.arrange;
+    Delay(1);
+
+    // 與 LVM_ARRANGE 相同：所有項目（包含移到畫面外的）依索引順序重新排到格線上
+    for (size_t i = 0; i < items_.size(); ++i) {
+        items_[i].position = { int32_t(i % columns_) * GRID_WIDTH, int32_t(i / columns_) * GRID_HEIGHT };
+    }
+}
+
+DesktopIconPoint SimulatedDesktopIconHost::ScreenToList(DesktopIconPoint point) {
+    ++counts_.screenToList;
+    return { point.x - screenOffset_.x, point.y - screenOffset_.y };
+}
+
+void SimulatedDesktopIconHost::BeginUpdate() {
+    ++counts_.beginUpdate;
+    Delay(1);
+}
+
+void SimulatedDesktopIconHost::EndUpdate() {
+    ++counts_.endUpdate;
+    Delay(1);
+}
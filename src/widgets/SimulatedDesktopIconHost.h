@@ -0,0 +1,95 @@
+#pragma once
+
+#include "DesktopIconHost.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 記憶體內的桌面模擬（確定性，不依賴 Windows）
+// 用於在 Linux 上量測隱藏 / 恢復演算法：可設定項目數、注入每次呼叫的延遲，
+// 並精確計算每個操作對宿主的呼叫次數。
+class SimulatedDesktopIconHost : public IDesktopIconHost {
+public:
+    // 各介面方法的呼叫次數
+    struct CallCounts {
+        uint64_t connect = 0;
+        uint64_t itemCount = 0;
+        uint64_t itemText = 0;
+        uint64_t positionQueries = 0;   // GetItemPositions 呼叫次數
+        uint64_t positionsRead = 0;     // GetItemPositions 讀取的項目總數
+        uint64_t setPosition = 0;
+        uint64_t grid = 0;
+        uint64_t arrange = 0;
+        uint64_t screenToList = 0;
+        uint64_t beginUpdate = 0;
+        uint64_t endUpdate = 0;
+
+        // 對應 Win32 上的跨程序往返次數（批次讀取位置每個項目一則訊息，另加一次讀回）
+        uint64_t GetRoundTrips() const {
+            return connect + itemCount + itemText + positionsRead + positionQueries +
+                   setPosition + grid + arrange + beginUpdate + endUpdate;
+        }
+    };
+
+    struct Item {
+        std::wstring name;
+        DesktopIconPoint position;
+    };
+
+    SimulatedDesktopIconHost();
+
+    // 建立 count 個項目，名稱為 prefix + 五位數序號（例如 item00042），位置依 columns 欄的格線排列；
+    // 格線的列數預設多留一列空位
+    void Populate(int count, const std::wstring& prefix = L"item", int columns = 20);
+
+    // 指定格線的列數（可見範圍）
+    void SetRows(int rows) { rows_ = (rows > 0) ? rows : 1; }
+
+    // 變更項目（模擬殼層通知：變更戳記遞增）
+    void AddItem(const std::wstring& name, DesktopIconPoint position);
+    void RemoveItem(int index);
+    void RenameItem(int index, const std::wstring& name);
+
+    const std::vector<Item>& GetItems() const { return items_; }
+
+    // 每次往返的延遲（以忙碌等待實現，結果不受排程器精度影響）
+    void SetLatency(std::chrono::nanoseconds latency) { latency_ = latency; }
+
+    // 螢幕座標相對於清單座標的偏移
+    void SetScreenOffset(DesktopIconPoint offset) { screenOffset_ = offset; }
+
+    // 模擬桌面無法使用（Connect 失敗）
+    void SetAvailable(bool available) { available_ = available; }
+
+    const CallCounts& GetCallCounts() const { return counts_; }
+    void ResetCallCounts() { counts_ = CallCounts(); }
+
+    // IDesktopIconHost
+    bool Connect() override;
+    uint64_t GetChangeStamp() const override { return changeStamp_; }
+    int GetItemCount() override;
+    bool GetItemText(int index, std::wstring& text) override;
+    bool GetItemPositions(const int* indices, size_t count, DesktopIconPoint* positions) override;
+    void SetItemPosition(int index, DesktopIconPoint position) override;
+    bool GetGrid(DesktopIconGrid& grid) override;
+    void Arrange() override;
+    DesktopIconPoint ScreenToList(DesktopIconPoint point) override;
+    void BeginUpdate() override;
+    void EndUpdate() override;
+
+private:
+    void Delay(uint64_t roundTrips) const;
+
+    // 自動排列的格線
+    static const int GRID_WIDTH = 75;
+    static const int GRID_HEIGHT = 100;
+
+    std::vector<Item> items_;
+    CallCounts counts_;
+    std::chrono::nanoseconds latency_;
+    DesktopIconPoint screenOffset_;
+    uint64_t changeStamp_;
+    int columns_;
+    int rows_;
+    bool available_;
+};
@@ -1,11 +1,19 @@
 #include "StickyNotesWidget.h"
 #include "core/WidgetExport.h"
+#include "core/FieldTable.h"
+#include "core/FileWidgetStorage.h"
+#include "core/JsonReader.h"
+#include "core/JsonWriter.h"
 #include <windowsx.h>
 #include <richedit.h>
 #include <shlobj.h>
 #include <dwmapi.h>
 #include <commctrl.h>
 #include <ole2.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
@@ -13,6 +21,10 @@
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "ole32.lib")
 
+// 共用儲存中的鍵
+static const char* NOTE_KEY_PREFIX = "StickyNotesWidget/note/";    // 每個便簽一筆
+static const char* LEGACY_NOTES_KEY = "StickyNotesWidget/notes";   // 舊版：整份清單一筆
+
 // Windows 自黏便箋風格顏色
 const StickyNotesWidget::ColorInfo StickyNotesWidget::NOTE_COLORS[COLOR_COUNT] = {
     { RGB(255, 242, 157), L"黃色(Y)" },      // 黃色
@@ -25,8 +37,9 @@ const StickyNotesWidget::ColorInfo StickyNotesWidget::NOTE_COLORS[COLOR_COUNT] =
     { RGB(255, 228, 196), L"橘色(O)" }       // 橘色
 };
 
-StickyNotesWidget::StickyNotesWidget(HINSTANCE hInstance)
-    : hInstance_(hInstance) {
+StickyNotesWidget::StickyNotesWidget(HINSTANCE hInstance, IWidgetStorage* storage)
+    : hInstance_(hInstance)
+    , storage_(storage) {
 }
 
 StickyNotesWidget::~StickyNotesWidget() {
@@ -37,6 +50,17 @@ bool StickyNotesWidget::Initialize() {
     if (!RegisterWindowClass()) {
         return false;
     }
+
+    // 主程式未提供共用儲存時（舊版主程式只呼叫 CreateWidget），自行開啟同一個儲存檔
+    if (!storage_) {
+        std::wstring configDir = GetConfigDirectory();
+        auto fileStorage = std::make_unique<FileWidgetStorage>();
+        if (!configDir.empty() && fileStorage->Open(configDir + L"\\widgets.store")) {
+            storage_ = fileStorage.get();
+            ownedStorage_ = std::move(fileStorage);
+        }
+    }
+
     LoadConfiguration();
     return true;
 }
@@ -287,6 +311,12 @@ LRESULT StickyNotesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPA
     }
 
     case WM_COMMAND: {
+        // 編輯框內容變動：只標記，保存時才取回文字
+        if (note && HIWORD(wParam) == EN_CHANGE && (HWND)lParam == note->hEdit) {
+            note->contentDirty = true;
+            return 0;
+        }
+
         if (note) {
             int wmId = LOWORD(wParam);
             switch (wmId) {
@@ -321,6 +351,7 @@ LRESULT StickyNotesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPA
                 note->isPinned = !note->isPinned;
                 // 更新按鈕文字（🔒鎖定 / 🔓解鎖）
                 SetWindowTextW(note->hBtnPin, note->isPinned ? L"🔒" : L"🔓");
+                MarkNoteChanged(note);
                 SaveConfiguration();
                 break;
             }
@@ -352,6 +383,7 @@ LRESULT StickyNotesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPA
                     SendMessageW(note->hEdit, WM_SETFONT, (WPARAM)hFont, TRUE);
                     InvalidateRect(note->hEdit, nullptr, TRUE);
                 }
+                MarkNoteChanged(note);
                 SaveConfiguration();
                 break;
             }
@@ -368,6 +400,7 @@ LRESULT StickyNotesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPA
                     SendMessageW(note->hEdit, EM_SETBKGNDCOLOR, 0, note->color);
                 }
                 InvalidateRect(hwnd, nullptr, TRUE);
+                MarkNoteChanged(note);
                 SaveConfiguration();
                 break;
             }
@@ -382,6 +415,14 @@ LRESULT StickyNotesWidget::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPA
         return 0;
     }
 
+    case WM_EXITSIZEMOVE: {
+        // 系統調整大小或拖曳結束
+        if (note) {
+            SaveConfiguration();
+        }
+        return 0;
+    }
+
     case WM_DESTROY: {
         return 0;
     }
@@ -605,6 +646,9 @@ void StickyNotesWidget::CreateNoteControls(StickyNote* note) {
 
         // 子類化 RichEdit 以攔截貼上事件（只允許純文字）
         SetWindowSubclass(note->hEdit, EditSubclassProc, 0, 0);
+
+        // 內容變動時通知父視窗（EN_CHANGE），用於標記需要保存
+        SendMessageW(note->hEdit, EM_SETEVENTMASK, 0, ENM_CHANGE);
     }
 }
 
@@ -729,6 +773,7 @@ void StickyNotesWidget::CreateStickyNote(int x, int y) {
     // 建立控制項
     CreateNoteControls(&note);
 
+    AssignNoteId(note);
     notes_.push_back(note);
     SaveConfiguration();
 }
@@ -737,6 +782,7 @@ void StickyNotesWidget::DeleteStickyNote(HWND hwnd) {
     for (auto it = notes_.begin(); it != notes_.end(); ++it) {
         if (it->hwnd == hwnd) {
             DestroyWindow(hwnd);
+            removedNoteIds_.push_back(it->id);
             notes_.erase(it);
             SaveConfiguration();
             break;
@@ -765,10 +811,10 @@ void StickyNotesWidget::ClearAllNotes() {
     // 清空列表
     notes_.clear();
 
-    // 刪除配置文件
-    std::wstring configPath = GetConfigFilePath();
-    if (!configPath.empty()) {
-        DeleteFileW(configPath.c_str());
+    // 刪除保存的便簽
+    removedNoteIds_.clear();
+    if (storage_) {
+        storage_->RemovePrefix("StickyNotesWidget/");
     }
 
     MessageBoxW(nullptr, L"已清除所有便簽！", L"完成", MB_OK | MB_ICONINFORMATION);
@@ -892,6 +938,8 @@ void StickyNotesWidget::OnMouseMove(int /*x*/, int /*y*/) {
 void StickyNotesWidget::OnLButtonUp() {
     if (dragState_.isDragging) {
         ReleaseCapture();
+        // 拖曳過程已更新 position，在此標記變更
+        MarkNoteChanged(FindNote(dragState_.draggedNote));
         dragState_.isDragging = false;
         dragState_.draggedNote = nullptr;
         SaveConfiguration();
@@ -993,12 +1041,12 @@ void StickyNotesWidget::ShowColorMenu(StickyNote* note, int x, int y) {
     DestroyMenu(hMenu);
 }
 
-std::wstring StickyNotesWidget::GetConfigFilePath() {
+std::wstring StickyNotesWidget::GetConfigDirectory() {
     wchar_t appDataPath[MAX_PATH];
     if (SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appDataPath))) {
         std::wstring configDir = std::wstring(appDataPath) + L"\\FencesWidget";
         CreateDirectoryW(configDir.c_str(), nullptr);
-        return configDir + L"\\sticky_notes_config.json";
+        return configDir;
     }
     return L"";
 }
@@ -1009,86 +1057,201 @@ void StickyNotesWidget::SaveConfiguration() {
         return;
     }
 
-    std::wstring configPath = GetConfigFilePath();
-    if (configPath.empty()) return;
+    WidgetStorageBatch batch;
+    CommitNoteChanges(batch);
+}
+
+bool StickyNotesWidget::CommitNoteChanges(WidgetStorageBatch& batch) {
+    if (!storage_) return false;
+
+    for (auto& note : notes_) {
+        if (note.hwnd) {
+            // 只有編輯框通知過變動時才取回文字
+            if (note.contentDirty && note.hEdit) {
+                std::wstring text;
+                int len = GetWindowTextLengthW(note.hEdit);
+                if (len > 0) {
+                    text.resize(len + 1);
+                    GetWindowTextW(note.hEdit, &text[0], len + 1);
+                    text.resize(len);
+                }
+                if (text != note.content) {
+                    note.content = std::move(text);
+                    MarkNoteChanged(&note);
+                }
+            }
+            note.contentDirty = false;
+
+            // 系統調整大小 / 拖曳標題列不經過我們的拖曳邏輯，在此比對視窗位置
+            RECT rc;
+            if (GetWindowRect(note.hwnd, &rc) &&
+                (rc.left != note.position.x || rc.top != note.position.y ||
+                 rc.right - rc.left != note.size.cx || rc.bottom - rc.top != note.size.cy)) {
+                note.position = { rc.left, rc.top };
+                note.size = { rc.right - rc.left, rc.bottom - rc.top };
+                MarkNoteChanged(&note);
+            }
+        }
+
+        if (note.revision != note.savedRevision) {
+            batch.Put(GetNoteKey(note.id), SerializeNote(note));
+        }
+    }
+
+    for (uint32_t id : removedNoteIds_) {
+        batch.Remove(GetNoteKey(id));
+    }
+
+    if (batch.IsEmpty()) {
+        return true;
+    }
+
+    // 寫入失敗時保留變更標記，下次保存再試
+    if (!storage_->Commit(batch)) {
+        return false;
+    }
 
-    std::wstring config = L"{\n  \"notes\": [\n";
+    for (auto& note : notes_) {
+        note.savedRevision = note.revision;
+    }
+    removedNoteIds_.clear();
+    return true;
+}
 
-    bool first = true;
-    for (size_t i = 0; i < notes_.size(); ++i) {
-        auto& note = notes_[i];
+void StickyNotesWidget::MarkNoteChanged(StickyNote* note) {
+    if (note) {
+        ++note->revision;
+    }
+}
 
-        // 如果視窗不存在，跳過
-        if (!note.hwnd) continue;
+void StickyNotesWidget::AssignNoteId(StickyNote& note) {
+    note.id = nextNoteId_++;
+    MarkNoteChanged(&note);
+}
 
-        // 取得編輯框內容
-        if (note.hEdit) {
-            int len = GetWindowTextLengthW(note.hEdit);
-            if (len > 0) {
-                wchar_t* buffer = new wchar_t[len + 1];
-                GetWindowTextW(note.hEdit, buffer, len + 1);
-                notes_[i].content = buffer;
-                delete[] buffer;
-            } else {
-                notes_[i].content = L"";
-            }
+std::string StickyNotesWidget::GetNoteKey(uint32_t id) {
+    // 固定寬度的十六進位，讓儲存中的鍵順序與建立順序一致
+    char key[48];
+    snprintf(key, sizeof(key), "%s%08X", NOTE_KEY_PREFIX, id);
+    return key;
+}
+
+// 便簽保存的欄位（JSON 鍵名與輸出順序）
+const auto& StickyNotesWidget::GetNoteFields() {
+    static constexpr auto fields = MakeFieldTable(
+        Field("x", &StickyNote::position, &POINT::x),
+        Field("y", &StickyNote::position, &POINT::y),
+        Field("width", &StickyNote::size, &SIZE::cx),
+        Field("height", &StickyNote::size, &SIZE::cy),
+        Field("color", &StickyNote::color),
+        Field("fontSize", &StickyNote::fontSize),
+        Field("isPinned", &StickyNote::isPinned),
+        Field("content", &StickyNote::content));
+    return fields;
+}
+
+std::string StickyNotesWidget::SerializeNote(const StickyNote& note) {
+    JsonWriter writer(128 + note.content.size() * 3);
+    writer.BeginObject();
+    GetNoteFields().WriteJson(writer, note);
+    writer.EndObject();
+    return writer.Release();
+}
+
+void StickyNotesWidget::LoadConfiguration() {
+    if (!storage_) return;
+
+    // 每個便簽一筆紀錄，鍵的順序即建立順序
+    storage_->ForEach(NOTE_KEY_PREFIX, [this](const std::string& key, const std::string& value) {
+        uint32_t id = (uint32_t)strtoul(key.c_str() + strlen(NOTE_KEY_PREFIX), nullptr, 16);
+        if (id == 0) return;
+
+        StickyNote note = {};
+        JsonReader reader(value.data(), value.size());
+        if (reader.Next() != JsonReader::Token::BeginObject || !ParseNote(reader, note)) {
+            return;
         }
 
-        // 取得視窗位置和大小
-        RECT rc;
-        if (!GetWindowRect(note.hwnd, &rc)) continue;
+        note.id = id;
+        notes_.push_back(note);
+        nextNoteId_ = (std::max)(nextNoteId_, id + 1);
+    });
 
-        // 添加逗號分隔符（除了第一個）
-        if (!first) {
-            config += L",\n";
+    if (!notes_.empty()) {
+        return;
+    }
+
+    // 轉換舊格式：整份便簽清單存成單一值，或更早的 sticky_notes_config.json
+    WidgetStorageBatch batch;
+    std::string data;
+    bool importedFile = false;
+    if (storage_->Get(LEGACY_NOTES_KEY, data)) {
+        ParseNotes(data);
+        batch.Remove(LEGACY_NOTES_KEY);
+    } else {
+        importedFile = ImportLegacyConfiguration();
+    }
+
+    for (auto& note : notes_) {
+        AssignNoteId(note);
+    }
+
+    if (CommitNoteChanges(batch) && importedFile) {
+        std::wstring legacyPath = GetConfigDirectory() + L"\\sticky_notes_config.json";
+        DeleteFileW(legacyPath.c_str());
+    }
+}
+
+bool StickyNotesWidget::ParseNote(JsonReader& reader, StickyNote& note) {
+    // 只載入配置數據，不創建視窗（視窗會在 Start() 時創建）
+    note.color = NOTE_COLORS[YELLOW].color;
+    note.position = { 100, 100 };
+    note.size = { 300, 300 };
+    note.fontSize = 20;
+    note.isPinned = false;
+
+    return GetNoteFields().ReadJsonObject(reader, note);
+}
+
+bool StickyNotesWidget::ParseNotes(const std::string& data) {
+    JsonReader reader(data.data(), data.size());
+    if (reader.Next() != JsonReader::Token::BeginObject) {
+        return false;
+    }
+
+    while (reader.Next() == JsonReader::Token::Key) {
+        if (!reader.IsKey("notes")) {
+            if (!reader.SkipValue()) return false;
+            continue;
         }
-        first = false;
-
-        config += L"    {\n";
-        config += L"      \"x\": " + std::to_wstring(rc.left) + L",\n";
-        config += L"      \"y\": " + std::to_wstring(rc.top) + L",\n";
-        config += L"      \"width\": " + std::to_wstring(rc.right - rc.left) + L",\n";
-        config += L"      \"height\": " + std::to_wstring(rc.bottom - rc.top) + L",\n";
-        config += L"      \"color\": " + std::to_wstring(note.color) + L",\n";
-        config += L"      \"fontSize\": " + std::to_wstring(note.fontSize) + L",\n";
-        config += L"      \"isPinned\": " + std::wstring(note.isPinned ? L"true" : L"false") + L",\n";
-
-        // 轉義內容
-        std::wstring escapedContent = note.content;
-        size_t pos = 0;
-        while ((pos = escapedContent.find(L"\"", pos)) != std::wstring::npos) {
-            escapedContent.replace(pos, 1, L"\\\"");
-            pos += 2;
+
+        if (reader.Next() != JsonReader::Token::BeginArray) {
+            return false;
         }
-        pos = 0;
-        while ((pos = escapedContent.find(L"\n", pos)) != std::wstring::npos) {
-            escapedContent.replace(pos, 1, L"\\n");
-            pos += 2;
+
+        while (reader.Next() == JsonReader::Token::BeginObject) {
+            StickyNote note = {};
+            if (!ParseNote(reader, note)) {
+                return false;
+            }
+            notes_.push_back(note);
         }
-        pos = 0;
-        while ((pos = escapedContent.find(L"\r", pos)) != std::wstring::npos) {
-            escapedContent.replace(pos, 1, L"");
+        if (reader.GetToken() != JsonReader::Token::EndArray) {
+            return false;
         }
-
-        config += L"      \"content\": \"" + escapedContent + L"\"\n";
-        config += L"    }";
     }
 
-    config += L"\n  ]\n}\n";
-
-    std::wofstream file(configPath);
-    if (file.is_open()) {
-        file << config;
-        file.close();
-    }
+    return reader.GetToken() == JsonReader::Token::EndObject;
 }
 
-void StickyNotesWidget::LoadConfiguration() {
-    std::wstring configPath = GetConfigFilePath();
-    if (configPath.empty()) return;
+// 讀取舊版 sticky_notes_config.json（內容只轉義了引號與換行，不能用標準 JSON 解析）
+bool StickyNotesWidget::ImportLegacyConfiguration() {
+    std::wstring configDir = GetConfigDirectory();
+    if (configDir.empty()) return false;
 
-    std::wifstream file(configPath);
-    if (!file.is_open()) return;
+    std::wstring legacyPath = configDir + L"\\sticky_notes_config.json";
+    std::wifstream file(legacyPath);
+    if (!file.is_open()) return false;
 
     std::wstringstream buffer;
     buffer << file.rdbuf();
@@ -1180,14 +1343,30 @@ void StickyNotesWidget::LoadConfiguration() {
 
         pos = endPos + 1;
     }
+
+    return true;
 }
 
 // ==================== DLL 導出函式 ====================
 
 extern "C" {
     WIDGET_API IWidget* CreateWidget(void* params) {
-        HINSTANCE hInstance = params ? *(HINSTANCE*)params : GetModuleHandle(nullptr);
-        return new StickyNotesWidget(hInstance);
+        // 沒有 CreateWidgetEx 的舊版主程式：params 只有 HINSTANCE，儲存由 Initialize 自行開啟
+        auto hInstancePtr = static_cast<HINSTANCE*>(params);
+        HINSTANCE hInstance = hInstancePtr ? *hInstancePtr : GetModuleHandle(nullptr);
+        return new StickyNotesWidget(hInstance, nullptr);
+    }
+
+    WIDGET_API IWidget* CreateWidgetEx(const WidgetCreateParams* params) {
+        HINSTANCE hInstance = GetModuleHandle(nullptr);
+        IWidgetStorage* storage = nullptr;
+        if (params && params->HasField(offsetof(WidgetCreateParams, hInstance), sizeof(params->hInstance))) {
+            hInstance = params->hInstance;
+        }
+        if (params && params->HasField(offsetof(WidgetCreateParams, storage), sizeof(params->storage))) {
+            storage = params->storage;
+        }
+        return new StickyNotesWidget(hInstance, storage);
     }
 
     WIDGET_API void DestroyWidget(IWidget* widget) {
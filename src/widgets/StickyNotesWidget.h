@@ -1,12 +1,18 @@
 #pragma once
 #include "core/IWidget.h"
+#include "core/IWidgetStorage.h"
 #include <windows.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 
+class JsonReader;
+
 class StickyNotesWidget : public IWidget {
 public:
-    StickyNotesWidget(HINSTANCE hInstance);
+    // storage 為 nullptr 時自行開啟儲存檔（主程式未提供共用儲存時）
+    StickyNotesWidget(HINSTANCE hInstance, IWidgetStorage* storage);
     ~StickyNotesWidget() override;
 
     bool Initialize() override;
@@ -40,6 +46,12 @@ private:
         HWND hBtnSettings;           // 設定按鈕（×按鈕）
         int fontSize = 20;           // 當前字體大小（預設20px）
         bool isPinned = false;       // 是否釘選（鎖定不能移動）
+
+        // 增量保存
+        uint32_t id = 0;             // 儲存鍵中的識別碼（0 表示尚未分配）
+        uint64_t revision = 0;       // 每次變更遞增
+        uint64_t savedRevision = 0;  // 已寫入儲存的版本
+        bool contentDirty = false;   // 編輯框內容有變動，保存時才取回文字
     };
 
     // 預設便簽顏色（Windows 風格）
@@ -64,6 +76,10 @@ private:
 
     std::vector<StickyNote> notes_;
     HINSTANCE hInstance_;
+    IWidgetStorage* storage_;
+    std::unique_ptr<IWidgetStorage> ownedStorage_;
+    uint32_t nextNoteId_ = 1;
+    std::vector<uint32_t> removedNoteIds_;  // 已刪除但尚未從儲存移除的便簽
     const wchar_t* windowClassName_ = L"StickyNoteWidgetClass";
     bool classRegistered_ = false;
     bool isRunning_ = false;
@@ -112,9 +128,19 @@ private:
     void ShowColorMenu(StickyNote* note, int x, int y);
 
     // 儲存/載入
+    // 每個便簽是一筆獨立紀錄，只有變更過的便簽會重新序列化與寫入
     void SaveConfiguration();
     void LoadConfiguration();
-    std::wstring GetConfigFilePath();
+    bool CommitNoteChanges(WidgetStorageBatch& batch);
+    void MarkNoteChanged(StickyNote* note);
+    void AssignNoteId(StickyNote& note);
+    static std::string GetNoteKey(uint32_t id);
+    static const auto& GetNoteFields();
+    static std::string SerializeNote(const StickyNote& note);
+    static bool ParseNote(JsonReader& reader, StickyNote& note);
+    bool ParseNotes(const std::string& data);
+    bool ImportLegacyConfiguration();
+    std::wstring GetConfigDirectory();
 
     // 選單命令 ID
     enum {
@@ -0,0 +1,176 @@
+#include "Win32DesktopFolderWatcher.h"
+
+namespace {
+
+// 會改變項目集合的變更（不含內容與時間戳記）
+const DWORD WATCH_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME;
+
+DesktopFolderEntry MakeEntry(const wchar_t* name, DWORD attributes) {
+    DesktopFolderEntry entry;
+    entry.name = name;
+    entry.isDirectory = (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    entry.isHidden = (attributes & FILE_ATTRIBUTE_HIDDEN) != 0;
+    return entry;
+}
+
+std::wstring JoinFolderPath(const std::wstring& folder, const std::wstring& name) {
+    if (!folder.empty() && folder.back() != L'\\') {
+        return folder + L"\\" + name;
+    }
+    return folder + name;
+}
+
+} // namespace
+
+Win32DesktopFolderWatcher::Win32DesktopFolderWatcher() {
+}
+
+Win32DesktopFolderWatcher::~Win32DesktopFolderWatcher() {
+    for (auto& watcher : watchers_) {
+        if (watcher) {
+            Close(*watcher);
+        }
+    }
+}
+
+bool Win32DesktopFolderWatcher::Scan(const std::wstring& folder, std::vector<DesktopFolderEntry>& entries) {
+    // 不需要 8.3 短檔名；大量讀取減少核心往返
+    std::wstring searchPath = folder + L"\\*";
+    WIN32_FIND_DATAW findData;
+    HANDLE hFind = FindFirstFileExW(searchPath.c_str(), FindExInfoBasic, &findData,
+                                    FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    do {
+        // 跳過 . 和 ..
+        if (wcscmp(findData.cFileName, L".") == 0 || wcscmp(findData.cFileName, L"..") == 0) {
+            continue;
+        }
+        entries.push_back(MakeEntry(findData.cFileName, findData.dwFileAttributes));
+    } while (FindNextFileW(hFind, &findData));
+
+    FindClose(hFind);
+    return true;
+}
+
+int Win32DesktopFolderWatcher::Watch(const std::wstring& folder) {
+    std::unique_ptr<Watcher> watcher(new Watcher());
+    watcher->folder = folder;
+    watcher->pending = false;
+    watcher->directory = CreateFileW(folder.c_str(), FILE_LIST_DIRECTORY,
+                                     FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                     OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (watcher->directory == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+
+    if (!Issue(*watcher)) {
+        Close(*watcher);
+        return -1;
+    }
+
+    watchers_.push_back(std::move(watcher));
+    return (int)watchers_.size() - 1;
+}
+
+void Win32DesktopFolderWatcher::Unwatch(int watchId) {
+    if (watchId < 0 || watchId >= (int)watchers_.size() || !watchers_[watchId]) {
+        return;
+    }
+    Close(*watchers_[watchId]);
+    watchers_[watchId].reset();
+}
+
+bool Win32DesktopFolderWatcher::Issue(Watcher& watcher) {
+    ZeroMemory(&watcher.overlapped, sizeof(watcher.overlapped));
+    watcher.pending = ReadDirectoryChangesW(watcher.directory, watcher.buffer, sizeof(watcher.buffer),
+                                            FALSE, WATCH_FILTER, nullptr, &watcher.overlapped, nullptr) != FALSE;
+    return watcher.pending;
+}
+
+void Win32DesktopFolderWatcher::Close(Watcher& watcher) {
+    if (watcher.directory == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    // 等待取消完成，核心才不會再寫入 buffer
+    if (watcher.pending) {
+        DWORD bytes = 0;
+        CancelIoEx(watcher.directory, &watcher.overlapped);
+        GetOverlappedResult(watcher.directory, &watcher.overlapped, &bytes, TRUE);
+        watcher.pending = false;
+    }
+    CloseHandle(watcher.directory);
+    watcher.directory = INVALID_HANDLE_VALUE;
+}
+
+void Win32DesktopFolderWatcher::Poll(std::vector<DesktopFolderChange>& changes) {
+    for (size_t i = 0; i < watchers_.size(); ++i) {
+        if (!watchers_[i]) {
+            continue;
+        }
+        Watcher& watcher = *watchers_[i];
+
+        DWORD bytes = 0;
+        if (watcher.pending) {
+            if (!GetOverlappedResult(watcher.directory, &watcher.overlapped, &bytes, FALSE)) {
+                if (GetLastError() == ERROR_IO_INCOMPLETE) {
+                    continue;
+                }
+                bytes = 0;
+            }
+            watcher.pending = false;
+
+            // 回傳 0 位元組表示緩衝區溢位，通知已遺失
+            if (bytes > 0) {
+                ParseChanges((int)i, watcher, bytes, changes);
+            } else {
+                changes.push_back({ (int)i, DesktopFolderChange::OVERFLOWED, {} });
+            }
+        }
+
+        // 重新發出監看；失敗時（資料夾被刪除等）同樣視為需重新掃描
+        if (!Issue(watcher)) {
+            changes.push_back({ (int)i, DesktopFolderChange::OVERFLOWED, {} });
+        }
+    }
+}
+
+void Win32DesktopFolderWatcher::ParseChanges(int watchId, const Watcher& watcher, DWORD bytes,
+                                             std::vector<DesktopFolderChange>& changes) {
+    const BYTE* cursor = reinterpret_cast<const BYTE*>(watcher.buffer);
+    const BYTE* end = cursor + bytes;
+    while (cursor + sizeof(FILE_NOTIFY_INFORMATION) <= end) {
+        const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+        std::wstring name(info->FileName, info->FileNameLength / sizeof(wchar_t));
+
+        switch (info->Action) {
+        case FILE_ACTION_ADDED:
+        case FILE_ACTION_RENAMED_NEW_NAME: {
+            // 通知不含屬性，只查詢這一個項目
+            DWORD attributes = GetFileAttributesW(JoinFolderPath(watcher.folder, name).c_str());
+            if (attributes != INVALID_FILE_ATTRIBUTES) {
+                changes.push_back({ watchId, DesktopFolderChange::ADDED, MakeEntry(name.c_str(), attributes) });
+            }
+            break;
+        }
+        case FILE_ACTION_REMOVED:
+        case FILE_ACTION_RENAMED_OLD_NAME:
+            changes.push_back({ watchId, DesktopFolderChange::REMOVED, MakeEntry(name.c_str(), 0) });
+            break;
+        default:
+            break;
+        }
+
+        if (info->NextEntryOffset == 0) {
+            break;
+        }
+        cursor += info->NextEntryOffset;
+    }
+}
+
+std::wstring Win32DesktopFolderWatcher::JoinPath(const std::wstring& folder, const std::wstring& name) const {
+    return JoinFolderPath(folder, name);
+}
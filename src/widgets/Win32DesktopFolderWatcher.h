@@ -0,0 +1,40 @@
+#pragma once
+
+#include "DesktopFolderWatcher.h"
+#include <windows.h>
+#include <memory>
+
+// IDesktopFolderWatcher 的 Win32 實作
+// 每個資料夾一個重疊式 ReadDirectoryChangesW；Poll 只以 GetOverlappedResult 檢查是否完成，
+// 不阻塞也不需要額外執行緒（必須在同一執行緒呼叫 Watch 與 Poll，I/O 屬於發出它的執行緒）。
+class Win32DesktopFolderWatcher : public IDesktopFolderWatcher {
+public:
+    Win32DesktopFolderWatcher();
+    ~Win32DesktopFolderWatcher() override;
+
+    Win32DesktopFolderWatcher(const Win32DesktopFolderWatcher&) = delete;
+    Win32DesktopFolderWatcher& operator=(const Win32DesktopFolderWatcher&) = delete;
+
+    // IDesktopFolderWatcher
+    bool Scan(const std::wstring& folder, std::vector<DesktopFolderEntry>& entries) override;
+    int Watch(const std::wstring& folder) override;
+    void Unwatch(int watchId) override;
+    void Poll(std::vector<DesktopFolderChange>& changes) override;
+    std::wstring JoinPath(const std::wstring& folder, const std::wstring& name) const override;
+
+private:
+    struct Watcher {
+        std::wstring folder;
+        HANDLE directory;
+        OVERLAPPED overlapped;
+        bool pending;
+        DWORD buffer[16 * 1024];    // FILE_NOTIFY_INFORMATION 需 DWORD 對齊（64 KB）
+    };
+
+    static bool Issue(Watcher& watcher);
+    static void Close(Watcher& watcher);
+    static void ParseChanges(int watchId, const Watcher& watcher, DWORD bytes,
+                             std::vector<DesktopFolderChange>& changes);
+
+    std::vector<std::unique_ptr<Watcher>> watchers_;    // 索引即監看代碼，移除後留空
+};
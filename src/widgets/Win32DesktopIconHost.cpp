@@ -0,0 +1,223 @@
+#include "Win32DesktopIconHost.h"
+#include <commctrl.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const wchar_t* WATCH_WINDOW_CLASS = L"DesktopIconHostWatch";
+const UINT WM_DESKTOP_CHANGED = WM_APP + 1;
+
+// 會改變桌面項目集合或名稱的殼層事件
+const LONG WATCHED_EVENTS = SHCNE_CREATE | SHCNE_DELETE | SHCNE_RENAMEITEM |
+                            SHCNE_MKDIR | SHCNE_RMDIR | SHCNE_RENAMEFOLDER | SHCNE_UPDATEDIR;
+
+} // namespace
+
+Win32DesktopIconHost::Win32DesktopIconHost()
+    : listView_(nullptr)
+    , connectedListView_(nullptr)
+    , changeStamp_(0)
+    , watchWindow_(nullptr)
+    , notifyId_(0)
+    , watchedFolders_{} {
+}
+
+Win32DesktopIconHost::~Win32DesktopIconHost() {
+    StopWatching();
+}
+
+bool Win32DesktopIconHost::StartWatching(HINSTANCE hInstance) {
+    if (watchWindow_) {
+        return true;
+    }
+
+    WNDCLASSEXW wcex = { sizeof(WNDCLASSEXW) };
+    wcex.lpfnWndProc = WatchWndProc;
+    wcex.hInstance = hInstance;
+    wcex.lpszClassName = WATCH_WINDOW_CLASS;
+    if (!RegisterClassExW(&wcex) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
+        return false;
+    }
+
+    // 只接收訊息的隱藏視窗
+    watchWindow_ = CreateWindowExW(0, WATCH_WINDOW_CLASS, nullptr, 0, 0, 0, 0, 0,
+                                   HWND_MESSAGE, nullptr, hInstance, this);
+    if (!watchWindow_) {
+        return false;
+    }
+
+    const int folderIds[WATCHED_FOLDER_COUNT] = { CSIDL_DESKTOPDIRECTORY, CSIDL_COMMON_DESKTOPDIRECTORY };
+    SHChangeNotifyEntry entries[WATCHED_FOLDER_COUNT] = {};
+    int entryCount = 0;
+    for (int i = 0; i < WATCHED_FOLDER_COUNT; ++i) {
+        if (SHGetSpecialFolderLocation(nullptr, folderIds[i], &watchedFolders_[i]) == S_OK) {
+            entries[entryCount].pidl = watchedFolders_[i];
+            entries[entryCount].fRecursive = FALSE;
+            ++entryCount;
+        }
+    }
+
+    if (entryCount > 0) {
+        notifyId_ = SHChangeNotifyRegister(watchWindow_, SHCNRF_ShellLevel | SHCNRF_InterruptLevel,
+                                           WATCHED_EVENTS, WM_DESKTOP_CHANGED, entryCount, entries);
+    }
+
+    // 監看開始前讀取的名稱可能已過時
+    ++changeStamp_;
+    return notifyId_ != 0;
+}
+
+void Win32DesktopIconHost::StopWatching() {
+    if (notifyId_) {
+        SHChangeNotifyDeregister(notifyId_);
+        notifyId_ = 0;
+    }
+
+    for (auto& folder : watchedFolders_) {
+        if (folder) {
+            CoTaskMemFree(folder);
+            folder = nullptr;
+        }
+    }
+
+    if (watchWindow_) {
+        DestroyWindow(watchWindow_);
+        watchWindow_ = nullptr;
+    }
+
+    // 沒有通知時無法得知改名，不再信任已讀取的名稱
+    ++changeStamp_;
+}
+
+LRESULT CALLBACK Win32DesktopIconHost::WatchWndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+    if (message == WM_NCCREATE) {
+        CREATESTRUCTW* create = reinterpret_cast<CREATESTRUCTW*>(lParam);
+        SetWindowLongPtrW(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(create->lpCreateParams));
+    } else if (message == WM_DESKTOP_CHANGED) {
+        Win32DesktopIconHost* host =
+            reinterpret_cast<Win32DesktopIconHost*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+        if (host) {
+            ++host->changeStamp_;
+        }
+        return 0;
+    }
+    return DefWindowProcW(hwnd, message, wParam, lParam);
+}
+
+void Win32DesktopIconHost::Disconnect() {
+    session_.Close();
+    connectedListView_ = nullptr;
+}
+
+HWND Win32DesktopIconHost::GetListView() {
+    // explorer 重新啟動後舊視窗已不存在，需重新尋找
+    if (listView_ && IsWindow(listView_)) {
+        return listView_;
+    }
+    listView_ = nullptr;
+
+    // Find the desktop window
+    HWND hProgman = FindWindowW(L"Progman", nullptr);
+    if (!hProgman) {
+        return nullptr;
+    }
+
+    // Find the SHELLDLL_DefView window
+    HWND hShellViewWin = FindWindowExW(hProgman, nullptr, L"SHELLDLL_DefView", nullptr);
+    if (!hShellViewWin) {
+        // Try WorkerW windows (for Windows 10+)
+        HWND hWorkerW = nullptr;
+        while ((hWorkerW = FindWindowExW(nullptr, hWorkerW, L"WorkerW", nullptr)) != nullptr) {
+            hShellViewWin = FindWindowExW(hWorkerW, nullptr, L"SHELLDLL_DefView", nullptr);
+            if (hShellViewWin) {
+                break;
+            }
+        }
+    }
+
+    if (!hShellViewWin) {
+        return nullptr;
+    }
+
+    // Find the SysListView32 window (the actual desktop icon container)
+    listView_ = FindWindowExW(hShellViewWin, nullptr, L"SysListView32", nullptr);
+    return listView_;
+}
+
+bool Win32DesktopIconHost::Connect() {
+    HWND listView = GetListView();
+    if (!listView || !session_.Connect(listView)) {
+        return false;
+    }
+
+    // 連到不同的 ListView（explorer 重新啟動）時，已讀取的名稱與索引都不再適用
+    if (listView != connectedListView_) {
+        connectedListView_ = listView;
+        ++changeStamp_;
+    }
+    return true;
+}
+
+int Win32DesktopIconHost::GetItemCount() {
+    return session_.GetItemCount();
+}
+
+bool Win32DesktopIconHost::GetItemText(int index, std::wstring& text) {
+    return session_.GetItemText(index, text);
+}
+
+bool Win32DesktopIconHost::GetItemPositions(const int* indices, size_t count, DesktopIconPoint* positions) {
+    std::vector<POINT> points(count);
+    if (!session_.GetItemPositions(indices, count, points.data())) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = ToDesktopIconPoint(points[i]);
+    }
+    return true;
+}
+
+void Win32DesktopIconHost::SetItemPosition(int index, DesktopIconPoint position) {
+    SendMessageW(connectedListView_, LVM_SETITEMPOSITION, index, MAKELPARAM(position.x, position.y));
+}
+
+bool Win32DesktopIconHost::GetGrid(DesktopIconGrid& grid) {
+    // 圖示間距（大圖示檢視）與可見範圍
+    DWORD spacing = (DWORD)SendMessageW(connectedListView_, LVM_GETITEMSPACING, FALSE, 0);
+    RECT client;
+    if (!spacing || !GetClientRect(connectedListView_, &client)) {
+        return false;
+    }
+
+    grid.cellWidth = LOWORD(spacing);
+    grid.cellHeight = HIWORD(spacing);
+    if (grid.cellWidth <= 0 || grid.cellHeight <= 0) {
+        return false;
+    }
+    grid.columns = (std::max)(1, (int)(client.right - client.left) / grid.cellWidth);
+    grid.rows = (std::max)(1, (int)(client.bottom - client.top) / grid.cellHeight);
+    return true;
+}
+
+void Win32DesktopIconHost::Arrange() {
+    SendMessageW(connectedListView_, LVM_ARRANGE, LVA_DEFAULT, 0);
+}
+
+DesktopIconPoint Win32DesktopIconHost::ScreenToList(DesktopIconPoint point) {
+    POINT pt = ToPoint(point);
+    ScreenToClient(connectedListView_, &pt);
+    return ToDesktopIconPoint(pt);
+}
+
+void Win32DesktopIconHost::BeginUpdate() {
+    // 暫停桌面重繪
+    SendMessageW(connectedListView_, WM_SETREDRAW, FALSE, 0);
+}
+
+void Win32DesktopIconHost::EndUpdate() {
+    // 恢復重繪並一次性刷新
+    SendMessageW(connectedListView_, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(connectedListView_, nullptr, TRUE);
+    UpdateWindow(connectedListView_);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "DesktopIconHost.h"
+#include "RemoteListViewSession.h"
+#include <windows.h>
+#include <shlobj.h>
+
+// POINT 與 DesktopIconPoint 互轉
+inline DesktopIconPoint ToDesktopIconPoint(const POINT& point) {
+    return { (int32_t)point.x, (int32_t)point.y };
+}
+
+inline POINT ToPoint(const DesktopIconPoint& point) {
+    return { point.x, point.y };
+}
+
+// IDesktopIconHost 的 Win32 實作：explorer 內的桌面 SysListView32
+// 跨程序記憶體存取透過長期的 RemoteListViewSession；
+// 桌面資料夾的殼層變更通知與重新連線到不同的 ListView 都會遞增變更戳記。
+class Win32DesktopIconHost : public IDesktopIconHost {
+public:
+    Win32DesktopIconHost();
+    ~Win32DesktopIconHost() override;
+
+    Win32DesktopIconHost(const Win32DesktopIconHost&) = delete;
+    Win32DesktopIconHost& operator=(const Win32DesktopIconHost&) = delete;
+
+    // 註冊桌面資料夾（使用者與公用）的殼層變更通知
+    bool StartWatching(HINSTANCE hInstance);
+    void StopWatching();
+
+    // 關閉 explorer 程序控制代碼與遠端暫存區
+    void Disconnect();
+
+    // 目前的桌面 ListView（explorer 重新啟動後重新尋找）
+    HWND GetListView();
+
+    // IDesktopIconHost
+    bool Connect() override;
+    uint64_t GetChangeStamp() const override { return changeStamp_; }
+    int GetItemCount() override;
+    bool GetItemText(int index, std::wstring& text) override;
+    bool GetItemPositions(const int* indices, size_t count, DesktopIconPoint* positions) override;
+    void SetItemPosition(int index, DesktopIconPoint position) override;
+    bool GetGrid(DesktopIconGrid& grid) override;
+    void Arrange() override;
+    DesktopIconPoint ScreenToList(DesktopIconPoint point) override;
+    void BeginUpdate() override;
+    void EndUpdate() override;
+
+private:
+    static LRESULT CALLBACK WatchWndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
+
+    static const int WATCHED_FOLDER_COUNT = 2;
+
+    RemoteListViewSession session_;
+    HWND listView_;
+    HWND connectedListView_;
+    uint64_t changeStamp_;
+
+    HWND watchWindow_;
+    ULONG notifyId_;
+    PIDLIST_ABSOLUTE watchedFolders_[WATCHED_FOLDER_COUNT];
+};
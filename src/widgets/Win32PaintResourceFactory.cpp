@@ -0,0 +1,22 @@
+#include "Win32PaintResourceFactory.h"
+
+PaintResource Win32PaintResourceFactory::Create(const PaintStyle& style) {
+    switch (style.kind) {
+    case PaintStyle::KIND_BRUSH:
+        return CreateSolidBrush((COLORREF)style.color);
+
+    case PaintStyle::KIND_PEN:
+        return CreatePen(PS_SOLID, style.width, (COLORREF)style.color);
+
+    case PaintStyle::KIND_FONT:
+        return CreateFontW(
+            style.size, 0, 0, 0, style.weight, style.italic ? TRUE : FALSE, FALSE, FALSE,
+            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
+            CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, style.face.c_str());
+    }
+    return nullptr;
+}
+
+void Win32PaintResourceFactory::Destroy(PaintResource resource) {
+    DeleteObject(static_cast<HGDIOBJ>(resource));
+}
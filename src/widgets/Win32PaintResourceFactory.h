@@ -0,0 +1,23 @@
+#pragma once
+
+#include "PaintResourceFactory.h"
+#include <windows.h>
+
+// IPaintResourceFactory 的 Win32 實作：實心筆刷、實線畫筆與 ClearType 字型
+class Win32PaintResourceFactory : public IPaintResourceFactory {
+public:
+    PaintResource Create(const PaintStyle& style) override;
+    void Destroy(PaintResource resource) override;
+};
+
+inline HBRUSH ToBrush(PaintResource resource) {
+    return static_cast<HBRUSH>(resource);
+}
+
+inline HPEN ToPen(PaintResource resource) {
+    return static_cast<HPEN>(resource);
+}
+
+inline HFONT ToFont(PaintResource resource) {
+    return static_cast<HFONT>(resource);
+}